@@ -4,110 +4,397 @@
  * 
  * This program benchmarks the performance of matrix multiplication across
  * multiple matrix sizes and runs, recording execution time, CPU usage, and
- * memory consumption to a CSV file.
+ * memory consumption to a CSV file. readme.md describes what each kernel
+ * and output column measures.
  * 
- * Command-line arguments:
- *   argv[1]: Comma-separated matrix sizes (e.g., "64,128,256")
+ * Positional command-line arguments:
+ *   argv[1]: Comma-separated matrix sizes (e.g., "64,128,256"); an entry may
+ *            also be an MxNxK shape triple (e.g., "64,512x512x64")
  *   argv[2]: Number of runs per size (default: 3)
  *   argv[3]: Output CSV file path (default: "results_raw.csv")
  *   argv[4]: Random seed (default: 27)
  * 
- * Example: benchmark.exe "64,128,256" 5 output.csv 42
+ * Options (may appear anywhere on the command line):
+ *   --kernel LIST    Comma-separated kernel names, or "all" (default: naive)
+ *   --tile N         Tile edge for blocked kernels (default: MATRIX_MULT_DEFAULT_TILE)
+ *   --threads LIST   Comma-separated thread counts swept by parallel kernels
+ *                    (default: all logical CPUs)
+ *   --cutoff N       Strassen recursion cutoff (default: MATRIX_MULT_STRASSEN_CUTOFF)
+ *   --batch LIST     Comma-separated matrix counts swept by batched kernels
+ *                    (default: 1,64,1024)
+ *   --autotune       Search tunable kernels' parameters per size before timing
+ *                    and save the winners to the tuning file
+ *   --tune-ms T      Measuring time per autotune candidate (default: 20)
+ *   --tuning PATH    Tuning file (default: tuning_<fingerprint hash>.csv)
+ *   --no-tuning      Ignore the tuning file and run with the defaults
+ *   --check          Record max_err for every kernel, not only inexact ones
+ *   --no-verify      Skip the pass/fail check of every kernel's result
+ *   --verify-max N   Largest cube edge verified element by element; larger
+ *                    shapes use Freivalds' check (default: VERIFY_FULL_MAX)
+ *   --huge-pages     Back the memory arena with huge pages where available
+ *   --arena-mib N    Arena capacity in MiB (default: sized from the largest shape)
+ *   --counters       Record hardware performance counters for every run
+ *   --warmup N       Untimed calls before the timed runs of every kernel and
+ *                    thread count (default: 1)
+ *   --flush-llc      Evict the caches before every timed run
+ *   --flush-mib N    Size of the eviction buffer (default: twice the LLC)
+ *   --min-time-ms T  Repeat the kernel inside each timed run until T ms have
+ *                    passed and report the time per call (default: 0, one call)
+ *   --jsonl PATH     Also write every row as a JSON object per line to PATH
+ *   --binary PATH    Also write every row as a fixed-size binary record to PATH
+ *   --no-roofline    Skip the startup peak FLOP/s and bandwidth probes
+ *   --placement P    Operand placement: serial (one thread initialises) or
+ *                    first-touch (each thread its row band) (default: serial)
+ *   --bind B         Thread pinning: none, compact or scatter (default: none)
+ *   --matrix-dir DIR Map A and B from matrix files in DIR (generated there on
+ *                    first use) and C to a result file instead of the arena
+ *   --ooc-mib N      Memory budget of the out-of-core kernel (default: 256)
+ *   --density D      Fraction of A's elements left nonzero, in (0, 1]
+ *                    (default: 1, dense)
+ *   --queue N        Requests the "pool" kernel keeps in flight per call
+ *                    (default: 16, at most MATRIX_MULT_POOL_QUEUE)
+ *   --list-kernels   Print the kernel table and exit
+ * 
+ * Example: benchmark.exe "64,128,256" 5 output.csv 42 --kernel naive,tiled
+ *          benchmark.exe "1024" 3 scaling.csv 27 --kernel openmp --threads 1,2,4,8
+ *          benchmark.exe "4096x64x4096,64x4096x4096" 3 shapes.csv 27 --kernel gemm
+ *          benchmark.exe "1024,2048,4096" 3 strassen.csv 27 --kernel packed,strassen --cutoff 512
+ *          benchmark.exe "512,1024,2048" 3 tuned.csv 27 --kernel openmp,packed,strassen --autotune
+ *          benchmark.exe "64,128,256" 5 stream.csv 27 --kernel openmp,pool --queue 32 --min-time-ms 100
+ * 
+ * Timing, CPU and memory queries come from platform.c, which has Windows
+ * and Linux/POSIX implementations of the same metrics (see platform.h).
+ * 
+ * Build: gcc -O2 benchmark.c platform.c hw_counters.c roofline.c result_sink.c fingerprint.c
+ *            kernel_registry.c matrix_mult.c matrix_mult_simd.c matrix_mult_packed.c
+ *            matrix_mult_parallel.c matrix_mult_strassen.c matrix_mult_arena.c
+ *            matrix_mult_mixed.c matrix_mult_batched.c matrix_mult_ooc.c tuning.c
+ *            placement.c rng.c matrix_file.c verify.c matrix_mult_sparse.c
+ *            matrix_mult_pool.c -fopenmp -pthread -lm -o benchmark
+ *        cl /O2 /openmp benchmark.c platform.c hw_counters.c roofline.c result_sink.c fingerprint.c
+ *            kernel_registry.c matrix_mult.c matrix_mult_simd.c matrix_mult_packed.c
+ *            matrix_mult_parallel.c matrix_mult_strassen.c matrix_mult_arena.c
+ *            matrix_mult_mixed.c matrix_mult_batched.c matrix_mult_ooc.c tuning.c
+ *            placement.c rng.c matrix_file.c verify.c matrix_mult_sparse.c
+ *            matrix_mult_pool.c
+ *        GPU (CUDA; for HIP use hipcc -x hip and link -lamdhip64 [-lrocblas]):
+ *            nvcc -O2 -c matrix_mult_gpu.cu [-DMATRIX_MULT_GPU_BLAS]
+ *            gcc -O2 -DMATRIX_MULT_GPU ... (sources above) matrix_mult_gpu.o -fopenmp -lm
+ *                -L$CUDA_HOME/lib64 -lcudart [-lcublas] -lstdc++ -o benchmark
+ *        Compile-time sizes (C++11; the object needs no C++ runtime):
+ *            g++ -O2 -c matrix_mult_fixed.cpp
+ *            gcc -O2 -DMATRIX_MULT_FIXED ... (sources above) matrix_mult_fixed.o -fopenmp
+ *                -pthread -lm -o benchmark
  */
 
+#include <limits.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#include <windows.h>
-#include <psapi.h>
 #include "matrix_mult.h"
+#include "kernel_registry.h"
+#include "platform.h"
+#include "hw_counters.h"
+#include "roofline.h"
+#include "result_sink.h"
+#include "fingerprint.h"
+#include "tuning.h"
+#include "placement.h"
+#include "rng.h"
+#include "matrix_file.h"
+#include "verify.h"
+
+/* Maximum number of kernels selectable in one invocation */
+#define MAX_KERNELS 32
 
-/* CSV header format */
-#define HEADER "run_id;language;size;run_idx;time_ms;cpu_pct;peak_mib\n"
+/* Maximum number of entries in the --threads sweep */
+#define MAX_THREAD_COUNTS 32
+
+/* Maximum number of sizes or shapes in one invocation */
+#define MAX_SHAPES 64
+
+/* Maximum number of entries in the --batch sweep */
+#define MAX_BATCH_COUNTS 16
+
+/* Largest square size batched kernels run on (bounds the batch operands' memory) */
+#define BATCH_MAX_SIZE 128
 
 /**
- * @brief Get current time in seconds with high precision
- * @return Current time in seconds as a double
+ * @brief Mark every optional kernel statistic as "not measured"
+ * @param stats Statistics to reset before a kernel call
  */
-static double now_sec(void) {
-    LARGE_INTEGER frequency, counter;
-    QueryPerformanceFrequency(&frequency);
-    QueryPerformanceCounter(&counter);
-    return (double)counter.QuadPart / (double)frequency.QuadPart;
+static void reset_stats(kernel_stats* stats) {
+    stats->pack_ms = -1.0;
+    stats->compute_ms = -1.0;
+    stats->imbalance = -1.0;
+    stats->steals = -1.0;
+    stats->h2d_ms = -1.0;
+    stats->d2h_ms = -1.0;
+    stats->bytes_read = -1.0;
+    stats->bytes_written = -1.0;
+    stats->requests = -1.0;
+    stats->lat_p50_ms = -1.0;
+    stats->lat_p99_ms = -1.0;
 }
 
 /**
- * @brief Get total CPU time consumed by the current process
- * @return CPU time in seconds (user + kernel time)
+ * @brief Parse a comma-separated list of positive integers
+ * @param s List such as "64,128,256"
+ * @param out Receives the values
+ * @param max Capacity of out
+ * @return Number of values stored (entries <= 0 are skipped)
  */
-static double proc_cpu_seconds(void) {
-    FILETIME creation_time, exit_time, kernel_time, user_time;
-    GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, 
-                    &kernel_time, &user_time);
-    
-    /* Convert FILETIME to 64-bit integer (100-nanosecond intervals) */
-    ULONGLONG kernel_ticks = ((ULONGLONG)kernel_time.dwLowDateTime) | 
-                             ((ULONGLONG)kernel_time.dwHighDateTime << 32);
-    ULONGLONG user_ticks = ((ULONGLONG)user_time.dwLowDateTime) | 
-                           ((ULONGLONG)user_time.dwHighDateTime << 32);
-    
-    /* Convert to seconds (1e7 = 100ns per second) */
-    return (kernel_ticks + user_ticks) / 1e7;
+static int parse_int_list(const char* s, int* out, int max) {
+    int count = 0;
+    const char* p = s;
+    while (*p && count < max) {
+        int v = (int)strtol(p, NULL, 10);
+        if (v > 0) out[count++] = v;
+        p = strchr(p, ',');
+        if (!p) break;
+        ++p;
+    }
+    return count;
 }
 
 /**
- * @brief Get number of logical CPU cores
- * @return Number of logical processors, or 1 if detection fails
+ * @brief Parse a comma-separated list of square sizes and MxNxK shapes
+ * @param s List such as "64,128,512x256x64" ('x' or 'X' separates dimensions)
+ * @param out Receives the shapes; a plain size N becomes N×N×N
+ * @param max Capacity of out
+ * @return Number of shapes stored (entries with a zero dimension are skipped)
  */
-static int logical_cpus(void) {
-    SYSTEM_INFO system_info;
-    GetSystemInfo(&system_info);
-    return system_info.dwNumberOfProcessors > 0 ? 
-           (int)system_info.dwNumberOfProcessors : 1;
+static int parse_shape_list(const char* s, shape* out, int max) {
+    int count = 0;
+    const char* p = s;
+    while (*p && count < max) {
+        char* end;
+        size_t d[3];
+        d[0] = (size_t)strtoull(p, &end, 10);
+        d[1] = d[2] = d[0];
+        if (*end == 'x' || *end == 'X') {
+            d[1] = (size_t)strtoull(end + 1, &end, 10);
+            d[2] = 0;
+            if (*end == 'x' || *end == 'X') d[2] = (size_t)strtoull(end + 1, &end, 10);
+        }
+        if (d[0] > 0 && d[1] > 0 && d[2] > 0) {
+            out[count].m = d[0];
+            out[count].n = d[1];
+            out[count].k = d[2];
+            count++;
+        }
+        p = strchr(p, ',');
+        if (!p) break;
+        ++p;
+    }
+    return count;
 }
 
 /**
- * @brief Get current process memory usage in MiB
- * @return Working set size in mebibytes (MiB), or 0.0 on error
+ * @brief Largest absolute element difference between two matrices
+ * @param C Result under test
+ * @param R Reference result
+ * @param len Number of elements
+ * @return max |C[i] - R[i]| (infinite if C contains NaN)
  */
-static double current_mem_mib(void) {
-    PROCESS_MEMORY_COUNTERS pmc;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
-        return pmc.WorkingSetSize / (1024.0 * 1024.0);
+static double max_abs_error(const float* C, const float* R, size_t len) {
+    double err = 0.0;
+    for (size_t i = 0; i < len; i++) {
+        double d = fabs((double)C[i] - (double)R[i]);
+        if (d != d) return HUGE_VAL; /* NaN: as wrong as it gets */
+        if (d > err) err = d;
     }
-    return 0.0;
+    return err;
 }
 
 /**
- * @brief Write CSV header to file if it doesn't exist
- * @param path Path to the output CSV file
+ * @brief Largest absolute element difference from an fp64 reference
  */
-static void write_header_if_needed(const char* path) {
-    FILE* f = fopen(path, "r");
-    if (f) {
-        fclose(f);
-        return; /* File exists, header already written */
+static double max_abs_error_fp64(const float* C, const double* R, size_t len) {
+    double err = 0.0;
+    for (size_t i = 0; i < len; i++) {
+        double d = fabs((double)C[i] - R[i]);
+        if (d != d) return HUGE_VAL;
+        if (d > err) err = d;
     }
-    
-    /* File doesn't exist, create it and write header */
-    f = fopen(path, "a");
-    fputs(HEADER, f);
-    fclose(f);
+    return err;
 }
 
 /**
- * @brief Generate a run identifier string from current local time
- * @param buf Buffer to store the run ID string
- * @param n Size of the buffer
+ * @brief Evict the caches by writing every line of a large buffer
+ * @param buf Buffer larger than the last-level cache
+ * @param len Buffer size in bytes
  * 
- * Format: DD/MM/HH/MM (day/month/hour/minute)
+ * Writing (not just reading) leaves the lines dirty, so the operands of the
+ * next run are evicted from every cache level rather than merely aged.
  */
-static void run_id_str(char* buf, size_t n) {
-    SYSTEMTIME st;
-    GetLocalTime(&st);
-    _snprintf_s(buf, n, _TRUNCATE, "%02d/%02d/%02d/%02d", 
-                st.wDay, st.wMonth, st.wHour, st.wMinute);
+static void flush_caches(unsigned char* buf, size_t len) {
+    /* One read-modify-write per cache line; buf outlives the call, so it is not elided */
+    for (size_t i = 0; i < len; i += 64) buf[i] = (unsigned char)(buf[i] + 1);
+}
+
+/**
+ * @brief Arena capacity that fits the largest shape's operands and scratch
+ * @param shapes Shapes to be benchmarked
+ * @param nshapes Number of shapes
+ * @param check Whether a reference result is allocated for square shapes
+ * @param fp64 Whether the fp64 reference (and its operand copies) is too
+ * @param batch Matrices per operand for square sizes up to BATCH_MAX_SIZE
+ *              (the largest --batch entry, or 1 without batched kernels)
+ * @param files Whether A, B and C are mapped from matrix files instead
+ * @param verify_max Cube edge verified element by element (0: verification off)
+ * @return Capacity in bytes
+ * 
+ * Scratch is estimated as one extra big×big matrix (Strassen's temporaries
+ * need about two thirds of that) plus room for the packing buffers; with an
+ * fp64 reference it grows to the three big×big double matrices of the fp64
+ * kernel's workspace. Matrix files are meant for shapes beyond memory, so
+ * with them neither the operands nor that estimate are reserved (scratch
+ * that does not fit comes from the heap).
+ */
+static size_t arena_bytes_for(const shape* shapes, int nshapes, int check, int fp64,
+                              size_t batch, int files, int verify_max) {
+    const size_t line = 64;
+    size_t best = 0;
+    for (int i = 0; i < nshapes; i++) {
+        const shape d = shapes[i];
+        size_t big = d.m > d.n ? d.m : d.n;
+        if (d.k > big) big = d.k;
+        size_t c_len = d.m * d.n * sizeof(float) + line;
+        int cube = d.m == d.n && d.n == d.k;
+        double edge = (double)verify_max;
+        int full = (double)d.m * (double)d.n * (double)d.k <= edge * edge * edge;
+        size_t copies = cube && d.n <= BATCH_MAX_SIZE ? batch : 1;
+        size_t bytes = (files ? 0 : copies * (d.m * d.k * sizeof(float) + line
+                                            + d.k * d.n * sizeof(float) + line
+                                            + c_len))
+                     + (check && cube ? c_len : 0)
+                     + (fp64 && cube ? 3 * (big * big * sizeof(double) + line) : 0)
+                     + (files ? 0 : big * big * (fp64 ? 3 * sizeof(double) : sizeof(float)))
+                     + (verify_max <= 0 ? 0
+                        : full ? 2 * (d.m * d.n * sizeof(double) + line)
+                               : (d.n + 2 * d.m + 2 * d.k) * sizeof(double) + 5 * line);
+        if (bytes > best) best = bytes;
+    }
+    return best + ((size_t)8 << 20);
+}
+
+/**
+ * @brief Map an input operand from its matrix file, generating the file first if missing
+ * @param f Receives the read-only mapping
+ * @param dir Directory given with --matrix-dir
+ * @param name Operand name in the file name ("A" or "B")
+ * @param rows Rows of the operand
+ * @param cols Columns of the operand
+ * @param seed Run seed (part of the file name)
+ * @param which RNG_MATRIX_* number the operand is generated with
+ * @param threads Threads filling a new file
+ * @return 0 on success, -1 (after a message) if the file cannot be used
+ * 
+ * A new file holds exactly what rng_fill() puts in the arena for the same
+ * seed, so results do not depend on whether the inputs came from a file.
+ */
+static int map_input(matrix_file* f, const char* dir, const char* name, size_t rows, size_t cols,
+                     int seed, uint64_t which, int threads) {
+    char path[1024];
+    if (!matrix_file_path(path, sizeof(path), dir, name, rows, cols, seed)) {
+        fprintf(stderr, "%s: matrix file path too long\n", dir);
+        return -1;
+    }
+    int status = matrix_file_open(f, path, 0);
+    if (status == MATRIX_FILE_MISSING) {
+        if (matrix_file_create(f, path, rows, cols) != 0) {
+            fprintf(stderr, "%s: cannot create matrix file\n", path);
+            return -1;
+        }
+        rng_fill(f->data, rows * cols, (uint64_t)seed, which, 0, threads);
+        matrix_file_close(f);
+        printf("matrix file: generated %s\n", path);
+        status = matrix_file_open(f, path, 0);
+    }
+    if (status == 0 && (f->rows != rows || f->cols != cols)) {
+        matrix_file_close(f);
+        status = MATRIX_FILE_INVALID;
+    }
+    if (status != 0) {
+        fprintf(stderr, "%s: %s, skipping this shape\n", path,
+                status == MATRIX_FILE_INVALID ? "not a matrix file of this shape and byte order"
+                                              : "cannot open or map the matrix file");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Print the kernel table to stdout
+ */
+static void list_kernels(void) {
+    int count;
+    const kernel_entry* table = kernel_table(&count);
+    for (int i = 0; i < count; i++) {
+        printf("  %-10s %s%s\n", table[i].name, table[i].description,
+               table[i].rectangular ? " [MxNxK]" : "");
+    }
+    printf("SIMD micro-kernel on this CPU: %s\n", matrix_mult_simd_isa());
+    printf("Mixed-precision paths: fp16=%s bf16=%s fp64=%s int8=%s\n",
+           matrix_mult_mixed_isa(MATRIX_MULT_FP16), matrix_mult_mixed_isa(MATRIX_MULT_BF16),
+           matrix_mult_mixed_isa(MATRIX_MULT_FP64), matrix_mult_mixed_isa(MATRIX_MULT_INT8));
+}
+
+/**
+ * @brief Print the parameters a kernel runs with after tuning_apply()
+ * @param threads Non-zero if the tuned thread count replaces the --threads sweep
+ */
+static void print_tuned(int size, const kernel_entry* kernel, const tuning_entry* tuned,
+                        const kernel_opts* opts, int threads) {
+    printf("size=%d kernel=%s: tuned for n<=%d:", size, kernel->name, tuned->size_class);
+    if (kernel->tunable & KERNEL_TUNE_TILE) printf(" tile=%d", opts->tile);
+    if (threads) printf(" threads=%d", opts->threads);
+    if (kernel->tunable & KERNEL_TUNE_CUTOFF) printf(" cutoff=%d", opts->cutoff);
+    if (kernel->tunable & KERNEL_TUNE_BLOCKS) {
+        printf(" mc=%d kc=%d nc=%d", opts->mc, opts->kc, opts->nc);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Resolve a comma-separated list of kernel names
+ * @param list Kernel names (e.g. "naive,tiled") or "all"
+ * @param out Receives pointers into the kernel table
+ * @param max Capacity of out
+ * @return Number of kernels selected, or -1 if a name is unknown
+ */
+static int parse_kernel_list(const char* list, const kernel_entry** out, int max) {
+    int count = 0;
+    
+    if (strcmp(list, "all") == 0) {
+        const kernel_entry* table = kernel_table(&count);
+        if (count > max) count = max;
+        for (int i = 0; i < count; i++) out[i] = &table[i];
+        return count;
+    }
+    
+    const char* p = list;
+    while (*p && count < max) {
+        char name[64];
+        size_t len = strcspn(p, ",");
+        if (len >= sizeof(name)) len = sizeof(name) - 1;
+        memcpy(name, p, len);
+        name[len] = '\0';
+        
+        const kernel_entry* k = kernel_find(name);
+        if (!k) {
+            fprintf(stderr, "Unknown kernel '%s'; available kernels:\n", name);
+            list_kernels();
+            return -1;
+        }
+        out[count++] = k;
+        
+        p += strcspn(p, ",");
+        if (*p == ',') ++p;
+    }
+    return count;
 }
 
 /**
@@ -119,43 +406,264 @@ static void run_id_str(char* buf, size_t n) {
 int main(int argc, char** argv) {
     /* Default configuration */
     int sizes_default[] = {64, 128, 256, 512, 1024};
-    int sizes[64];  /* Maximum 64 different sizes */
-    int nsizes = 0;
+    shape shapes[MAX_SHAPES];
+    int nshapes = 0;
     int runs = 3;
     const char* out = "results_raw.csv";
     int seed = 27;
+    const char* kernel_list = "naive";
+    kernel_opts opts = { MATRIX_MULT_DEFAULT_TILE, 0, 0, NULL, 1, 0, 0, 0, 0, 0, 16, NULL, 0 };
+    int check = 0;
+    int verify_max = VERIFY_FULL_MAX;
+    int arena_flags = MATRIX_MULT_ARENA_PREFAULT;
+    int use_counters = 0;
+    int warmup = 1;
+    int flush = 0;
+    size_t flush_mib = 0;
+    double min_time_ms = 0.0;
+    int use_roofline = 1;
+    int placement = PLACEMENT_SERIAL;
+    int bind = PLACEMENT_BIND_NONE;
+    const char* matrix_dir = NULL;
+    size_t ooc_mib = 256;
+    double density = 1.0;
+    const char* jsonl_out = NULL;
+    const char* binary_out = NULL;
+    size_t arena_mib = 0;
+    int thread_counts[MAX_THREAD_COUNTS];
+    int nthread_counts = 0;
+    int batch_counts[MAX_BATCH_COUNTS] = { 1, 64, 1024 };
+    int nbatch_counts = 3;
+    int autotune = 0;
+    int use_tuning = 1;
+    double tune_ms = 20.0;
+    const char* tuning_path = NULL;
+    int keep = 0;           /* TUNING_KEEP_* bits of options given on the command line */
     
-    /* Parse command-line argument 1: comma-separated matrix sizes */
-    if (argc > 1 && argv[1][0]) {
-        const char* p = argv[1];
-        while (*p && nsizes < 64) {
-            sizes[nsizes++] = (int)strtol(p, NULL, 10);
-            p = strchr(p, ',');
-            if (!p) break;
-            ++p;
+    /* Separate --options from positional arguments */
+    const char* pos[4] = { NULL, NULL, NULL, NULL };
+    int npos = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) {
+            kernel_list = argv[++i];
+        } else if (strcmp(argv[i], "--tile") == 0 && i + 1 < argc) {
+            opts.tile = atoi(argv[++i]);
+            keep |= TUNING_KEEP_TILE;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            nthread_counts = parse_int_list(argv[++i], thread_counts, MAX_THREAD_COUNTS);
+            keep |= TUNING_KEEP_THREADS;
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            nbatch_counts = parse_int_list(argv[++i], batch_counts, MAX_BATCH_COUNTS);
+            if (nbatch_counts == 0) {
+                fprintf(stderr, "--batch needs at least one positive count\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--cutoff") == 0 && i + 1 < argc) {
+            opts.cutoff = atoi(argv[++i]);
+            keep |= TUNING_KEEP_CUTOFF;
+        } else if (strcmp(argv[i], "--autotune") == 0) {
+            autotune = 1;
+        } else if (strcmp(argv[i], "--tune-ms") == 0 && i + 1 < argc) {
+            tune_ms = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--tuning") == 0 && i + 1 < argc) {
+            tuning_path = argv[++i];
+        } else if (strcmp(argv[i], "--no-tuning") == 0) {
+            use_tuning = 0;
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check = 1;
+        } else if (strcmp(argv[i], "--no-verify") == 0) {
+            verify_max = 0;
+        } else if (strcmp(argv[i], "--verify-max") == 0 && i + 1 < argc) {
+            verify_max = atoi(argv[++i]);
+            if (verify_max <= 0) {
+                fprintf(stderr, "--verify-max must be positive (use --no-verify to skip verification)\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--counters") == 0) {
+            use_counters = 1;
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--flush-llc") == 0) {
+            flush = 1;
+        } else if (strcmp(argv[i], "--flush-mib") == 0 && i + 1 < argc) {
+            flush_mib = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+            min_time_ms = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--huge-pages") == 0) {
+            arena_flags |= MATRIX_MULT_ARENA_HUGE_PAGES;
+        } else if (strcmp(argv[i], "--arena-mib") == 0 && i + 1 < argc) {
+            arena_mib = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--jsonl") == 0 && i + 1 < argc) {
+            jsonl_out = argv[++i];
+        } else if (strcmp(argv[i], "--binary") == 0 && i + 1 < argc) {
+            binary_out = argv[++i];
+        } else if (strcmp(argv[i], "--no-roofline") == 0) {
+            use_roofline = 0;
+        } else if (strcmp(argv[i], "--placement") == 0 && i + 1 < argc) {
+            placement = placement_parse(argv[++i]);
+            if (placement < 0) {
+                fprintf(stderr, "--placement must be serial or first-touch\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--bind") == 0 && i + 1 < argc) {
+            bind = placement_bind_parse(argv[++i]);
+            if (bind < 0) {
+                fprintf(stderr, "--bind must be none, compact or scatter\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--matrix-dir") == 0 && i + 1 < argc) {
+            matrix_dir = argv[++i];
+        } else if (strcmp(argv[i], "--ooc-mib") == 0 && i + 1 < argc) {
+            ooc_mib = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--density") == 0 && i + 1 < argc) {
+            density = atof(argv[++i]);
+            if (!(density > 0.0 && density <= 1.0)) {
+                fprintf(stderr, "--density must be in (0, 1]\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--queue") == 0 && i + 1 < argc) {
+            int queue = atoi(argv[++i]);
+            if (queue < 1 || queue > MATRIX_MULT_POOL_QUEUE) {
+                fprintf(stderr, "--queue must be between 1 and %d\n", MATRIX_MULT_POOL_QUEUE);
+                return 1;
+            }
+            opts.queue = (size_t)queue;
+        } else if (strcmp(argv[i], "--list-kernels") == 0) {
+            list_kernels();
+            return 0;
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            fprintf(stderr, "Unknown or incomplete option '%s'\n", argv[i]);
+            return 1;
+        } else if (npos < 4) {
+            pos[npos++] = argv[i];
         }
     }
     
+    /* Parse positional argument 1: comma-separated matrix sizes and shapes */
+    if (pos[0] && pos[0][0]) nshapes = parse_shape_list(pos[0], shapes, MAX_SHAPES);
+    
     /* Use default sizes if none specified */
-    if (nsizes == 0) {
-        memcpy(sizes, sizes_default, sizeof(sizes_default));
-        nsizes = (int)(sizeof(sizes_default) / sizeof(sizes_default[0]));
+    if (nshapes == 0) {
+        nshapes = (int)(sizeof(sizes_default) / sizeof(sizes_default[0]));
+        for (int i = 0; i < nshapes; i++) {
+            shapes[i].m = shapes[i].n = shapes[i].k = (size_t)sizes_default[i];
+        }
+    }
+    
+    /* Parse positional argument 2: number of runs */
+    if (pos[1]) runs = atoi(pos[1]);
+    
+    /* Parse positional argument 3: output file path */
+    if (pos[2]) out = pos[2];
+    
+    /* Parse positional argument 4: random seed */
+    if (pos[3]) seed = atoi(pos[3]);
+    
+    /* Resolve the kernels to benchmark */
+    const kernel_entry* kernels[MAX_KERNELS];
+    int nkernels = parse_kernel_list(kernel_list, kernels, MAX_KERNELS);
+    if (nkernels <= 0) return 1;
+    
+    /* Inexact kernels always get their error measured; other dtypes against fp64 too */
+    int fp64_ref = check;
+    int any_batched = 0;
+    int any_ooc = 0;
+    int any_pool = 0;
+    for (int ki = 0; ki < nkernels; ++ki) {
+        if (kernels[ki]->inexact) check = 1;
+        if (kernels[ki]->dtype != MATRIX_MULT_FP32) fp64_ref = 1;
+        if (kernels[ki]->batched && !matrix_dir) any_batched = 1;
+        if (strcmp(kernels[ki]->name, "ooc") == 0) any_ooc = 1;
+        if (strcmp(kernels[ki]->name, "pool") == 0) any_pool = 1;
     }
     
-    /* Parse command-line argument 2: number of runs */
-    if (argc > 2) runs = atoi(argv[2]);
+    /* Mapped operands are placed by the page cache, not by the initialising threads */
+    opts.budget = ooc_mib << 20;
+    opts.mapped = matrix_dir != NULL;
+    if (matrix_dir && placement == PLACEMENT_FIRST_TOUCH) {
+        fprintf(stderr, "--placement first-touch does not apply to --matrix-dir operands; using serial\n");
+        placement = PLACEMENT_SERIAL;
+    }
+    if (matrix_dir && density < 1.0) {
+        fprintf(stderr, "--density does not apply to --matrix-dir operands; using dense A\n");
+        density = 1.0;
+    }
     
-    /* Parse command-line argument 3: output file path */
-    if (argc > 3) out = argv[3];
+    /* Batched kernels get max_batch matrices per operand, laid out back to back */
+    size_t max_batch = 1;
+    if (any_batched) {
+        for (int bi = 0; bi < nbatch_counts; ++bi) {
+            if ((size_t)batch_counts[bi] > max_batch) max_batch = (size_t)batch_counts[bi];
+        }
+    }
+    opts.batch = max_batch;
     
-    /* Parse command-line argument 4: random seed */
-    if (argc > 4) seed = atoi(argv[4]);
+    /* Eviction buffer: twice the LLC so no operand line survives (64 MiB if unknown) */
+    size_t flush_bytes = 0;
+    if (flush) {
+        size_t llc = llc_bytes();
+        flush_bytes = flush_mib > 0 ? flush_mib << 20 : (llc > 0 ? 2 * llc : (size_t)64 << 20);
+    }
     
-    /* Initialize random number generator */
-    srand(seed);
+    /* The pool kernel keeps queue - 1 extra results of the largest C and its latency sample */
+    size_t pool_bytes = 0;
+    if (any_pool) {
+        size_t max_mn = 0;
+        for (int i = 0; i < nshapes; i++) {
+            if (shapes[i].m * shapes[i].n > max_mn) max_mn = shapes[i].m * shapes[i].n;
+        }
+        pool_bytes = (opts.queue - 1) * max_mn * sizeof(float) + ((size_t)1 << 20);
+    }
     
-    /* Prepare output file */
-    write_header_if_needed(out);
+    /* One arena for the whole run; page faults happen here, not in the runs */
+    size_t arena_bytes = arena_mib > 0 ? arena_mib << 20
+                                       : arena_bytes_for(shapes, nshapes, check, fp64_ref, max_batch,
+                                                         matrix_dir != NULL, verify_max)
+                                         + flush_bytes + (any_ooc ? opts.budget : 0) + pool_bytes;
+    
+    /* The triad probe runs above the eviction buffer before any operand is placed */
+    if (arena_mib == 0 && use_roofline && arena_bytes < flush_bytes + roofline_triad_bytes()) {
+        arena_bytes = flush_bytes + roofline_triad_bytes();
+    }
+    matrix_mult_arena* arena = matrix_mult_arena_create(arena_bytes, arena_flags);
+    if (!arena) {
+        fprintf(stderr, "Cannot map a %.1f MiB arena\n", arena_bytes / (1024.0 * 1024.0));
+        return 1;
+    }
+    static const char* const page_kinds[] = { "regular", "transparent huge", "explicit huge" };
+    printf("arena: %.1f MiB, %s pages\n", matrix_mult_arena_capacity(arena) / (1024.0 * 1024.0),
+           page_kinds[matrix_mult_arena_huge_pages(arena)]);
+    opts.arena = arena;
+    
+    /* The eviction buffer stays allocated below every size's operands */
+    unsigned char* flush_buf = NULL;
+    if (flush_bytes > 0) {
+        flush_buf = (unsigned char*)matrix_mult_arena_alloc(arena, flush_bytes);
+        if (!flush_buf) {
+            fprintf(stderr, "Cannot fit a %.1f MiB cache eviction buffer in the arena\n",
+                    flush_bytes / (1024.0 * 1024.0));
+            matrix_mult_arena_destroy(arena);
+            return 1;
+        }
+        printf("cache flush: %.1f MiB before every timed run\n", flush_bytes / (1024.0 * 1024.0));
+    }
+    
+    /* Hardware counters are opened once; OpenMP workers started later are included */
+    hw_counters* counters = NULL;
+    if (use_counters) {
+        counters = hw_counters_open();
+        if (counters) printf("hardware counters: %s\n", hw_counters_backend(counters));
+        else fprintf(stderr, "hardware counters unavailable (perf_event_paranoid or no PAPI); "
+                             "counter columns stay empty\n");
+    }
+    
+    /* Prepare output files; rows are buffered and written once per size */
+    result_sink* sink = result_sink_open(out, jsonl_out, binary_out);
+    if (!sink) {
+        hw_counters_close(counters);
+        matrix_mult_arena_destroy(arena);
+        return 1;
+    }
     
     /* Generate run identifier */
     char run_id[32];
@@ -163,58 +671,477 @@ int main(int argc, char** argv) {
     const char* language = "C";
     const int ncpu = logical_cpus();
     
-    /* Main benchmarking loop: iterate over all matrix sizes */
-    for (int si = 0; si < nsizes; ++si) {
-        int n = sizes[si];
+    /* Host and build description written with every row */
+    machine_fingerprint fp;
+    machine_fingerprint_init(&fp);
+    printf("host: %s, %d CPUs, governor %s, %s, %s [%s] run %s\n", fp.cpu_model, fp.cores,
+           fp.governor[0] ? fp.governor : "unknown", fp.compiler, fp.os_kernel, fp.hash, fp.run_uuid);
+    
+    /* Parallel kernels default to one thread per logical CPU */
+    if (nthread_counts == 0) {
+        thread_counts[0] = ncpu;
+        nthread_counts = 1;
+    }
+    int max_threads = 1;
+    for (int ti = 0; ti < nthread_counts; ++ti) {
+        if (thread_counts[ti] > max_threads) max_threads = thread_counts[ti];
+    }
+    
+    /* NUMA layout, read before any thread is pinned */
+    placement_topology topo;
+    placement_topology_init(&topo);
+    printf("numa: %d node%s, %d CPUs; operands %s, threads bound %s\n", topo.nodes,
+           topo.nodes == 1 ? "" : "s", topo.ncpus, placement_name(placement), placement_bind_name(bind));
+    if (placement == PLACEMENT_FIRST_TOUCH && bind == PLACEMENT_BIND_NONE && topo.nodes > 1) {
+        fprintf(stderr, "first-touch without --bind: the OS may move threads away from their pages\n");
+    }
+    
+    /*
+     * The pool kernel starts its own threads, which would inherit the pinned
+     * main thread's single CPU; it pins worker i where the policy puts thread i
+     */
+    static int bind_cpus[PLACEMENT_MAX_CPUS];
+    if (bind != PLACEMENT_BIND_NONE) {
+        for (int i = 0; i < PLACEMENT_MAX_CPUS; ++i) bind_cpus[i] = placement_cpu_for(&topo, bind, i);
+        opts.cpus = bind_cpus;
+        opts.ncpus = PLACEMENT_MAX_CPUS;
+    }
+    
+    /* Tuned parameters of this host, from an earlier --autotune */
+    static tuning_table tuning;
+    char default_tuning_path[64];
+    const tuning_table* tuned_params = NULL;
+    tuning_init(&tuning, fp.hash);
+    if (!tuning_path) {
+        tuning_default_path(fp.hash, default_tuning_path, sizeof(default_tuning_path));
+        tuning_path = default_tuning_path;
+    }
+    if (use_tuning || autotune) {
+        int loaded = use_tuning ? tuning_load(&tuning, tuning_path) : 0;
+        if (loaded > 0) printf("tuning: %d entries for this host from %s\n", loaded, tuning_path);
+        tuned_params = &tuning;
+    }
+    
+    /* Machine limits for the roofline columns, measured before any kernel */
+    roofline rf;
+    const roofline* rfp = NULL;
+    if (use_roofline) {
+        if (roofline_measure(&rf, max_threads, arena) != 0) {
+            fprintf(stderr, "STREAM triad arrays could not be allocated; bandwidth_gbs stays empty\n");
+        }
+        printf("roofline (%s): peak %.1f GFLOP/s on 1 thread, %.1f GFLOP/s on %d, triad %.1f GB/s\n",
+               rf.isa, rf.peak_gflops_1, rf.peak_gflops, rf.threads, rf.bandwidth_gbs);
+        rfp = &rf;
+    }
+    
+    /* Main benchmarking loop: iterate over all matrix sizes and shapes */
+    for (int si = 0; si < nshapes; ++si) {
+        const shape dims = shapes[si];
+        const int square = dims.m == dims.n && dims.n == dims.k;
+        size_t big = dims.m > dims.n ? dims.m : dims.n;
+        if (dims.k > big) big = dims.k;
+        
+        /* Square-only kernels take an int n; non-square shapes pass 0 */
+        int n = square ? (int)dims.n : 0;
+        
+        /* Equivalent cube size for the size column (2*size^3 FLOPs) */
+        int size = square ? n : (int)(cbrt((double)dims.m * (double)dims.n * (double)dims.k) + 0.5);
+        
+        /* FLOPs and compulsory element traffic (each operand crosses memory once) */
+        const double flops = 2.0 * (double)dims.m * (double)dims.n * (double)dims.k;
+        const double in_elems = (double)dims.m * dims.k + (double)dims.k * dims.n;
+        const double out_elems = (double)dims.m * dims.n;
+        
+        /* Small square sizes hold a whole batch per operand; matrix 0 is what every kernel sees */
+        const size_t copies = square && n <= BATCH_MAX_SIZE && !matrix_dir ? max_batch : 1;
+        
+        /* Allocate matrices A (m×k), B (k×n), and C (m×n) from the arena, or map them */
+        const size_t size_mark = matrix_mult_arena_mark(arena);
+        const size_t a_len = dims.m * dims.k;
+        const size_t b_len = dims.k * dims.n;
+        matrix_file fa, fb, fc;
+        float* A;
+        float* B;
+        float* C;
+        if (matrix_dir) {
+            char c_path[1024];
+            if (map_input(&fa, matrix_dir, "A", dims.m, dims.k, seed, RNG_MATRIX_A, max_threads) != 0) {
+                continue;
+            }
+            if (map_input(&fb, matrix_dir, "B", dims.k, dims.n, seed, RNG_MATRIX_B, max_threads) != 0) {
+                matrix_file_close(&fa);
+                continue;
+            }
+            if (!matrix_file_path(c_path, sizeof(c_path), matrix_dir, "C", dims.m, dims.n, -1)
+                || matrix_file_create(&fc, c_path, dims.m, dims.n) != 0) {
+                fprintf(stderr, "shape %zux%zux%zu: cannot create the result file in %s, skipping\n",
+                        dims.m, dims.n, dims.k, matrix_dir);
+                matrix_file_close(&fa);
+                matrix_file_close(&fb);
+                continue;
+            }
+            A = fa.data;
+            B = fb.data;
+            C = fc.data;
+        } else {
+            A = (float*)matrix_mult_arena_alloc(arena, copies * a_len * sizeof(float));
+            B = (float*)matrix_mult_arena_alloc(arena, copies * b_len * sizeof(float));
+            C = (float*)matrix_mult_arena_alloc(arena, copies * dims.m * dims.n * sizeof(float));
+            if (!A || !B || !C) {
+                fprintf(stderr, "shape %zux%zux%zu: does not fit the arena (see --arena-mib), skipping\n",
+                        dims.m, dims.n, dims.k);
+                matrix_mult_arena_release(arena, size_mark);
+                continue;
+            }
+        }
+        
+        /*
+         * First-touch: hand the pages back, then let every thread fault in the
+         * row band of matrix 0 it computes (and its share of the other batch
+         * matrices), so each band lands on that thread's node
+         */
+        if (placement == PLACEMENT_FIRST_TOUCH) {
+            matrix_mult_arena_discard(arena, size_mark);
+            if (placement_bind_threads(&topo, bind, max_threads) != 0) {
+                fprintf(stderr, "thread pinning failed; placement follows the OS scheduler\n");
+            }
+            placement_first_touch(A, dims.m, dims.k * sizeof(float), max_threads);
+            placement_first_touch(B, dims.k, dims.n * sizeof(float), max_threads);
+            placement_first_touch(C, dims.m, dims.n * sizeof(float), max_threads);
+            if (copies > 1) {
+                placement_first_touch(A + a_len, copies - 1, a_len * sizeof(float), max_threads);
+                placement_first_touch(B + b_len, copies - 1, b_len * sizeof(float), max_threads);
+                placement_first_touch(C + dims.m * dims.n, copies - 1,
+                                      dims.m * dims.n * sizeof(float), max_threads);
+            }
+        }
+        
+        /* Random values in [0, 1) from (seed, matrix, index): identical on every host and thread count */
+        if (!matrix_dir) {
+            rng_fill(A, copies * a_len, (uint64_t)seed, RNG_MATRIX_A, 0, max_threads);
+            rng_fill(B, copies * b_len, (uint64_t)seed, RNG_MATRIX_B, 0, max_threads);
+            rng_sparsify(A, copies * a_len, (uint64_t)seed, RNG_MATRIX_SPARSITY, 0, density, max_threads);
+        }
+        
+        /* Naive reference result for max_err, computed outside the timed region */
+        float* R = NULL;
+        if (check && square) {
+            R = (float*)matrix_mult_arena_alloc(arena, dims.m * dims.n * sizeof(float));
+            if (R) matrix_multiplication(A, B, R, n);
+        }
         
-        /* Allocate matrices A, B, and C */
-        float* A = (float*)malloc((size_t)n * (size_t)n * sizeof(float));
-        float* B = (float*)malloc((size_t)n * (size_t)n * sizeof(float));
-        float* C = (float*)malloc((size_t)n * (size_t)n * sizeof(float));
+        /* fp64 reference for err_fp64; its operand copies are released right away */
+        double* R64 = NULL;
+        if (fp64_ref && square) {
+            const size_t len = dims.m * dims.n;
+            R64 = (double*)matrix_mult_arena_alloc(arena, len * sizeof(double));
+            const size_t ref_mark = matrix_mult_arena_mark(arena);
+            double* A64 = (double*)matrix_mult_arena_alloc(arena, len * sizeof(double));
+            double* B64 = (double*)matrix_mult_arena_alloc(arena, len * sizeof(double));
+            if (R64 && A64 && B64) {
+                for (size_t i = 0; i < len; i++) A64[i] = A[i];
+                for (size_t i = 0; i < len; i++) B64[i] = B[i];
+                matrix_multiplication_fp64(A64, B64, R64, n);
+            } else {
+                R64 = NULL;
+            }
+            matrix_mult_arena_release(arena, ref_mark);
+        }
         
-        /* Initialize matrices with random values in [0, 1] */
-        for (int i = 0; i < n * n; i++) {
-            A[i] = (float)rand() / RAND_MAX;
-            B[i] = (float)rand() / RAND_MAX;
+        /* Verification reference: fp64 A·B for small shapes, Freivalds' projection otherwise */
+        verify_ref vref;
+        memset(&vref, 0, sizeof(vref));
+        if (verify_max > 0
+            && verify_prepare(&vref, A, B, dims.m, dims.n, dims.k, (uint64_t)seed, verify_max,
+                              arena, max_threads) == VERIFY_NONE) {
+            fprintf(stderr, "size=%d: no room for the verification reference, results are unchecked\n",
+                    size);
         }
         
-        /* Perform multiple runs for statistical stability */
-        for (int r = 1; r <= runs; ++r) {
-            /* Capture metrics before execution */
-            double mem_before = current_mem_mib();
-            double cpu0 = proc_cpu_seconds();
-            double t0 = now_sec();
+        /* Kernel scratch is released back to here after each kernel */
+        const size_t scratch_mark = matrix_mult_arena_mark(arena);
+        
+        /* Search the tunable kernels' parameters on this size's operands, before timing */
+        if (autotune && square) {
+            for (int ki = 0; ki < nkernels; ++ki) {
+                tuning_entry best;
+                if (!kernels[ki]->tunable) continue;
+                int tried = tuning_search(kernels[ki], A, B, C, n, &opts, max_threads, tune_ms, &best);
+                if (tried < 0 || tuning_set(&tuning, &best) != 0) {
+                    fprintf(stderr, "autotune n=%d kernel=%s: no result, keeping defaults\n",
+                            n, kernels[ki]->name);
+                    continue;
+                }
+                printf("autotune n=%d kernel=%s: tile=%d threads=%d cutoff=%d mc=%d kc=%d nc=%d "
+                       "%.2f GFLOP/s (%d candidates)\n", n, best.kernel, best.tile, best.threads,
+                       best.cutoff, best.mc, best.kc, best.nc, best.gflops, tried);
+            }
+            matrix_mult_arena_release(arena, scratch_mark);
+        }
+        
+        /* Every selected kernel sees the same inputs for this size */
+        for (int ki = 0; ki < nkernels; ++ki) {
+            const kernel_entry* kernel = kernels[ki];
+            kernel_ctx ctx;
+            
+            /* Operands in the kernel's type; its result is at least 4 bytes (fp32/int32) */
+            const size_t elem = matrix_mult_dtype_size(kernel->dtype);
+            const double min_bytes = elem * in_elems + (elem > 4 ? elem : 4) * out_elems;
+            ctx.state = NULL;
+            ctx.m = dims.m;
+            ctx.n = dims.n;
+            ctx.k = dims.k;
+            
+            if (!square && !kernel->rectangular) {
+                printf("shape %zux%zux%zu: kernel=%s is square-only, skipping\n",
+                       dims.m, dims.n, dims.k, kernel->name);
+                continue;
+            }
+            if (kernel->batched && matrix_dir) {
+                printf("size=%d: kernel=%s needs arena operands (no --matrix-dir), skipping\n",
+                       size, kernel->name);
+                continue;
+            }
+            if (kernel->batched && copies < max_batch) {
+                printf("size=%d: kernel=%s only runs sizes up to %d, skipping\n",
+                       size, kernel->name, BATCH_MAX_SIZE);
+                continue;
+            }
             
-            /* Execute matrix multiplication */
-            matrix_multiplication(A, B, C, n);
+            /* Tuned parameters replace the defaults, not options given on the command line */
+            kernel_opts kopts = opts;
+            const tuning_entry* tuned = tuning_apply(tuned_params, kernel,
+                                                     big > (size_t)INT_MAX ? INT_MAX : (int)big,
+                                                     &kopts, keep);
+            const int tuned_threads = tuned && kernel->parallel && tuned->threads > 0
+                                   && (kernel->tunable & KERNEL_TUNE_THREADS)
+                                   && !(keep & TUNING_KEEP_THREADS);
+            if (tuned) {
+                print_tuned(size, kernel, tuned, &kopts, tuned_threads);
+            }
+            ctx.opts = &kopts;
             
-            /* Capture metrics after execution */
-            double t1 = now_sec();
-            double cpu1 = proc_cpu_seconds();
-            double mem_after = current_mem_mib();
+            /* Allocate per-size scratch outside the timed region, for the largest thread count */
+            if (kernel->prepare) {
+                kernel_opts prep_opts = kopts;
+                if (kernel->parallel && !tuned_threads) prep_opts.threads = max_threads;
+                ctx.state = kernel->prepare(big > (size_t)INT_MAX ? INT_MAX : (int)big, &prep_opts);
+                if (!ctx.state) {
+                    fprintf(stderr, "size=%d kernel=%s: setup failed, skipping\n", size, kernel->name);
+                    continue;
+                }
+            }
             
-            /* Calculate performance metrics */
-            double wall = t1 - t0;                          /* Wall-clock time */
-            double time_ms = wall * 1000.0;                 /* Convert to milliseconds */
-            double cpu_pct = 100.0 * (cpu1 - cpu0) / (wall * ncpu);  /* CPU percentage */
-            double peak_mib = mem_after > mem_before ? mem_after : mem_before;
+            /*
+             * Serial kernels run once; parallel kernels sweep the thread counts
+             * (or run the tuned one), and batched kernels every thread count for
+             * every batch count
+             */
+            const int nthr = kernel->parallel && !tuned_threads ? nthread_counts : 1;
+            const int nsweep = nthr * (kernel->batched ? nbatch_counts : 1);
             
-            /* Print results to console */
-            printf("n=%d run=%d time=%.2f ms CPU=%.1f%% MEM=%.2f MiB\n", 
-                   n, r, time_ms, cpu_pct, peak_mib);
+            for (int ti = 0; ti < nsweep; ++ti) {
+                kernel_opts run_opts = kopts;
+                run_opts.threads = !kernel->parallel ? 1
+                                 : tuned_threads ? kopts.threads : thread_counts[ti % nthr];
+                run_opts.batch = kernel->batched ? (size_t)batch_counts[ti / nthr] : 1;
+                ctx.opts = &run_opts;
+                
+                /*
+                 * Pin this team size, then see where its row bands of A and C live
+                 * (batched kernels split the batch, and pool workers claim whichever
+                 * band comes next, so neither has a fixed band per thread)
+                 */
+                double remote_pct = -1.0;
+                if (bind != PLACEMENT_BIND_NONE) {
+                    placement_pages pages = { 0, 0 };
+                    if (placement_bind_threads(&topo, bind, run_opts.threads) != 0) {
+                        fprintf(stderr, "size=%d kernel=%s: thread pinning failed\n", size, kernel->name);
+                    } else if (!kernel->batched && strcmp(kernel->name, "pool") != 0
+                            && placement_count_pages(&topo, bind, A, dims.m, dims.k * sizeof(float),
+                                                     run_opts.threads, &pages) == 0
+                            && placement_count_pages(&topo, bind, C, dims.m, dims.n * sizeof(float),
+                                                     run_opts.threads, &pages) == 0
+                            && pages.local + pages.remote > 0) {
+                        remote_pct = 100.0 * (double)pages.remote / (double)(pages.local + pages.remote);
+                    }
+                }
+                
+                /* Untimed warm-up: caches, TLB, branch predictors, OpenMP threads */
+                for (int w = 0; w < warmup; ++w) kernel->run(A, B, C, n, &ctx);
+                if (kernel->finish) kernel->finish(ctx.state, &ctx.stats);
+                
+                /* Perform multiple runs for statistical stability */
+                for (int r = 1; r <= runs; ++r) {
+                    if (flush_buf) flush_caches(flush_buf, flush_bytes);
+                    
+                    /* Capture metrics before execution */
+                    double mem_before = current_mem_mib();
+                    double cpu0 = proc_cpu_seconds();
+                    hw_counters_start(counters);
+                    double t0 = now_sec();
+                    double t1;
+                    
+                    /* Execute matrix multiplication, repeated until min_time_ms has passed */
+                    int reps = 0;
+                    double pack_sum = 0.0, compute_sum = 0.0, h2d_sum = 0.0, d2h_sum = 0.0;
+                    do {
+                        reset_stats(&ctx.stats);
+                        kernel->run(A, B, C, n, &ctx);
+                        pack_sum += ctx.stats.pack_ms;
+                        compute_sum += ctx.stats.compute_ms;
+                        h2d_sum += ctx.stats.h2d_ms;
+                        d2h_sum += ctx.stats.d2h_ms;
+                        reps++;
+                        t1 = now_sec();
+                    } while ((t1 - t0) * 1000.0 < min_time_ms);
+                    
+                    /* Capture metrics after execution */
+                    double hw[HW_COUNTER_COUNT];
+                    hw_counters_stop(counters, hw);
+                    double cpu1 = proc_cpu_seconds();
+                    double mem_after = current_mem_mib();
+                    if (kernel->finish) kernel->finish(ctx.state, &ctx.stats);
+                    
+                    /* Report per-call values; unmeasured (negative) fields stay negative */
+                    for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+                        if (hw[i] >= 0.0) hw[i] /= reps;
+                    }
+                    if (ctx.stats.pack_ms >= 0.0) ctx.stats.pack_ms = pack_sum / reps;
+                    if (ctx.stats.compute_ms >= 0.0) ctx.stats.compute_ms = compute_sum / reps;
+                    if (ctx.stats.h2d_ms >= 0.0) ctx.stats.h2d_ms = h2d_sum / reps;
+                    if (ctx.stats.d2h_ms >= 0.0) ctx.stats.d2h_ms = d2h_sum / reps;
+                    const size_t requests = ctx.stats.requests > 0.0 ? (size_t)ctx.stats.requests : 1;
+                    
+                    /* Calculate performance metrics */
+                    double wall = (t1 - t0) / reps;                 /* Wall-clock time per call */
+                    result_row row;
+                    row.run_id = run_id;
+                    row.language = language;
+                    row.size = size;
+                    row.run_idx = r;
+                    row.time_ms = wall * 1000.0;                    /* Convert to milliseconds */
+                    row.cpu_pct = 100.0 * (cpu1 - cpu0) / ((t1 - t0) * ncpu);  /* CPU percentage */
+                    row.peak_mib = mem_after > mem_before ? mem_after : mem_before;
+                    row.kernel = kernel->name;
+                    row.pack_ms = ctx.stats.pack_ms;
+                    row.compute_ms = ctx.stats.compute_ms;
+                    row.threads = run_opts.threads;
+                    row.imbalance = ctx.stats.imbalance;
+                    row.steals = ctx.stats.steals;
+                    row.dims = dims;
+                    row.max_err = R ? max_abs_error(C, R, dims.m * dims.n) : -1.0;
+                    memcpy(row.counters, hw, sizeof(hw));
+                    row.reps = reps;
+                    row.gflops = flops * (double)run_opts.batch * (double)requests / wall * 1e-9;
+                    row.intensity = flops / min_bytes;
+                    row.peak_gflops = rfp ? roofline_peak_for(rfp, run_opts.threads) : -1.0;
+                    row.pct_peak = row.peak_gflops > 0.0 ? 100.0 * row.gflops / row.peak_gflops : -1.0;
+                    row.bandwidth_gbs = rfp ? rfp->bandwidth_gbs : -1.0;
+                    row.fingerprint = fp.hash;
+                    row.cpu_model = fp.cpu_model;
+                    row.cores = fp.cores;
+                    row.governor = fp.governor;
+                    row.compiler = fp.compiler;
+                    row.cflags = fp.cflags;
+                    row.os_kernel = fp.os_kernel;
+                    row.run_uuid = fp.run_uuid;
+                    row.comm_ms = -1.0;
+                    row.ranks = 1;
+                    row.rank = 0;
+                    row.dtype = matrix_mult_dtype_name(kernel->dtype);
+                    row.err_fp64 = R64 ? max_abs_error_fp64(C, R64, dims.m * dims.n) : -1.0;
+                    row.batch = run_opts.batch;
+                    row.h2d_ms = ctx.stats.h2d_ms;
+                    row.d2h_ms = ctx.stats.d2h_ms;
+                    row.placement = placement_name(placement);
+                    row.bind = placement_bind_name(bind);
+                    row.remote_pct = remote_pct;
+                    row.bytes_read = ctx.stats.bytes_read;
+                    row.bytes_written = ctx.stats.bytes_written;
+                    row.verify_err = verify_error(&vref, C, max_threads);
+                    row.density = density;
+                    row.queue = requests;
+                    row.lat_p50_ms = ctx.stats.lat_p50_ms;
+                    row.lat_p99_ms = ctx.stats.lat_p99_ms;
+                    row.verified = row.verify_err < 0.0 ? NULL
+                                 : row.verify_err <= verify_tolerance(kernel->dtype, kernel->inexact,
+                                                                      dims.k) ? "pass" : "fail";
+                    
+                    /* Print results to console */
+                    if (square) printf("n=%d", n);
+                    else printf("shape=%zux%zux%zu", dims.m, dims.n, dims.k);
+                    printf(" kernel=%s threads=%d", kernel->name, row.threads);
+                    if (kernel->batched) printf(" batch=%zu", row.batch);
+                    if (density < 1.0) printf(" density=%.4g", density);
+                    printf(" run=%d time=%.2f ms CPU=%.1f%% MEM=%.2f MiB",
+                           r, row.time_ms, row.cpu_pct, row.peak_mib);
+                    if (row.bytes_read >= 0.0) {
+                        printf(" read=%.1f MiB written=%.1f MiB", row.bytes_read / (1024.0 * 1024.0),
+                               row.bytes_written / (1024.0 * 1024.0));
+                    }
+                    if (row.pack_ms >= 0.0) {
+                        printf(" pack=%.2f ms compute=%.2f ms", row.pack_ms, row.compute_ms);
+                    }
+                    if (row.h2d_ms >= 0.0) {
+                        printf(" h2d=%.2f ms kernel=%.2f ms d2h=%.2f ms",
+                               row.h2d_ms, row.compute_ms, row.d2h_ms);
+                    }
+                    if (row.imbalance >= 0.0) {
+                        printf(" imbalance=%.3f steals=%.0f", row.imbalance, row.steals);
+                    }
+                    if (row.lat_p50_ms >= 0.0) {
+                        printf(" queue=%zu p50=%.3f ms p99=%.3f ms (%.0f req/s)", row.queue,
+                               row.lat_p50_ms, row.lat_p99_ms, (double)row.queue / wall);
+                    }
+                    printf(" GFLOP/s=%.2f", row.gflops);
+                    if (row.pct_peak >= 0.0) printf(" (%.1f%% of peak)", row.pct_peak);
+                    if (row.max_err >= 0.0) printf(" max_err=%.3e", row.max_err);
+                    if (row.err_fp64 >= 0.0) printf(" err_fp64=%.3e", row.err_fp64);
+                    if (row.verified) {
+                        printf(" verify=%s (%s %.2e)", strcmp(row.verified, "pass") == 0 ? "pass" : "FAIL",
+                               verify_method_name(vref.method), row.verify_err);
+                    }
+                    if (row.remote_pct >= 0.0) printf(" remote=%.1f%%", row.remote_pct);
+                    if (reps > 1) printf(" reps=%d", reps);
+                    if (hw[HW_CYCLES] > 0.0 && hw[HW_INSTRUCTIONS] >= 0.0) {
+                        printf(" IPC=%.2f", hw[HW_INSTRUCTIONS] / hw[HW_CYCLES]);
+                    }
+                    printf("\n");
+                    if (kernel->report) kernel->report(ctx.state);
+                    
+                    /* Buffer the row; files are written after this size */
+                    result_sink_add(sink, &row);
+                }
+            }
             
-            /* Append results to CSV file */
-            FILE* f = fopen(out, "a");
-            fprintf(f, "%s;%s;%d;%d;%.3f;%.1f;%.2f\n", 
-                    run_id, language, n, r, time_ms, cpu_pct, peak_mib);
-            fclose(f);
+            if (kernel->release) kernel->release(ctx.state);
+            matrix_mult_arena_release(arena, scratch_mark);
         }
         
-        /* Free allocated matrices */
-        free(A);
-        free(B);
-        free(C);
+        /* Free allocated matrices; the result file keeps the last kernel's C */
+        matrix_mult_arena_release(arena, size_mark);
+        if (matrix_dir) {
+            matrix_file_close(&fa);
+            matrix_file_close(&fb);
+            matrix_file_close(&fc);
+        }
+        
+        /* Write this size's rows now, away from any timed region */
+        result_sink_flush(sink);
     }
     
-    return 0;
-}
\ No newline at end of file
+    /* Winners of this run replace this host's earlier entries for the same size classes */
+    if (autotune) {
+        if (tuning_save(&tuning, tuning_path) == 0) {
+            printf("tuning: %d entries for this host saved to %s\n", tuning.count, tuning_path);
+        }
+    }
+    
+    printf("arena high-water mark: %.1f MiB, process peak memory: %.1f MiB\n",
+           matrix_mult_arena_high_water(arena) / (1024.0 * 1024.0), peak_mem_mib());
+    int status = result_sink_close(sink) == 0 ? 0 : 1;
+    hw_counters_close(counters);
+    matrix_mult_arena_destroy(arena);
+    return status;
+}
@@ -0,0 +1,618 @@
+/**
+ * @file benchmark_mpi.c
+ * @brief Distributed (SUMMA over MPI) matrix multiplication benchmark
+ *
+ * Separate target from benchmark.c: it needs an MPI compiler wrapper and
+ * launcher, and every rank runs the same program on its own block of the
+ * matrices (see matrix_mult_summa.h).
+ *
+ * Positional command-line arguments (same as benchmark.c):
+ *   argv[1]: Comma-separated matrix sizes (e.g., "1024,2048,4096")
+ *   argv[2]: Number of runs per size (default: 3)
+ *   argv[3]: Output CSV file path (default: "results_raw.csv")
+ *   argv[4]: Random seed (default: 27)
+ *
+ * Options:
+ *   --panel N        Panel depth per SUMMA step (default: MATRIX_MULT_SUMMA_PANEL)
+ *   --mode LIST      Broadcast schemes to run, "blocking" and/or "overlap"
+ *                    (default: blocking,overlap)
+ *   --steps PATH     Also write every rank's comm and compute time of every
+ *                    SUMMA step to PATH (semicolon CSV, STEPS_HEADER columns)
+ *   --weak           Treat sizes as the block edge per rank (weak scaling): the
+ *                    global size becomes round(size * sqrt(ranks))
+ *   --warmup N       Untimed multiplications before the timed runs (default: 1)
+ *   --check          Record max_err of every rank's block against a
+ *                    double-precision reference
+ *   --huge-pages     Back each rank's arena with huge pages where available
+ *   --arena-mib N    Arena capacity per rank in MiB (default: sized from the
+ *                    largest block)
+ *   --jsonl PATH     Also write every row as a JSON object per line to PATH
+ *   --binary PATH    Also write every row as a fixed-size binary record to PATH
+ *   --no-roofline    Skip the per-rank peak FLOP/s and bandwidth probes
+ *
+ * Every timed run writes one row per rank with kernel "summa" (blocking
+ * MPI_Bcast() per step) or "summa_overlap" (the next step's MPI_Ibcast()
+ * posted into a second panel buffer during this step's product): time_ms is
+ * the rank's total time for the multiplication, compute_ms its local
+ * gemm_with_pack() time and comm_ms its panel copy and broadcast time
+ * (which includes waiting for slower ranks; with overlap only the part
+ * not hidden behind the product), ranks the communicator size
+ * and rank the rank. The slowest rank's time_ms is the time of the
+ * distributed multiplication; aggregate_results.py collapses the rank rows
+ * of a run to it. threads is 1: each rank runs the serial packed kernel,
+ * so start one rank per core for a whole-node run. gflops is the global
+ * 2*n^3 divided by the rank's time, and pct_peak compares it against
+ * ranks times the single-thread peak the rank measured on its own host.
+ *
+ * When both schemes run, rank 0 prints after every size how much of the
+ * blocking communication time the overlap hid (mean per rank); --steps
+ * gives the same comparison per step and per rank.
+ *
+ * Elements are a hash of (seed, matrix, row, column) (rng.c), so every rank
+ * fills its block without communication and the inputs, like the result, do
+ * not depend on the number of ranks. They are the same matrices benchmark.c
+ * generates for the same seed.
+ *
+ * Rank 0 gathers the measurements after every run and is the only rank
+ * that writes files or prints per-run lines. Each rank's fingerprint
+ * (fingerprint.c) describes its own host; all ranks share rank 0's run_id
+ * and run_uuid. Measurements are exchanged as raw bytes, which assumes a
+ * homogeneous cluster (same architecture and compiler on every node).
+ *
+ * Example: mpirun -np 4 ./benchmark_mpi "2048,4096" 3 results_raw.csv 27
+ *          mpirun -np 16 ./benchmark_mpi "1024" 3 weak.csv 27 --weak
+ *          mpirun -np 16 ./benchmark_mpi "8192" 3 raw.csv 27 --steps results_steps.csv
+ *
+ * Build: mpicc -O2 benchmark_mpi.c matrix_mult_summa.c platform.c roofline.c result_sink.c
+ *            fingerprint.c matrix_mult.c matrix_mult_simd.c matrix_mult_packed.c
+ *            matrix_mult_arena.c rng.c -fopenmp -lm -o benchmark_mpi
+ *        (MS-MPI: cl /O2 /openmp /I"%MSMPI_INC%" ... msmpi.lib)
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "matrix_mult.h"
+#include "matrix_mult_summa.h"
+#include "platform.h"
+#include "roofline.h"
+#include "result_sink.h"
+#include "fingerprint.h"
+#include "rng.h"
+
+/* Maximum number of sizes in one invocation */
+#define MAX_SIZES 64
+
+/* Header of the --steps file */
+#define STEPS_HEADER "run_id;run_uuid;kernel;size;ranks;rank;run_idx;step;comm_ms;compute_ms\n"
+
+/**
+ * @brief Broadcast scheme selectable with --mode
+ */
+typedef struct summa_mode {
+    const char* name;       /* --mode name */
+    const char* kernel;     /* Value of the kernel column */
+    int flags;              /* matrix_mult_summa_create() flags */
+} summa_mode;
+
+static const summa_mode MODES[] = {
+    { "blocking", "summa",         0 },
+    { "overlap",  "summa_overlap", MATRIX_MULT_SUMMA_OVERLAP },
+};
+
+#define MAX_MODES ((int)(sizeof(MODES) / sizeof(MODES[0])))
+
+/**
+ * @brief One rank's measurements of one timed run, gathered on rank 0
+ */
+typedef struct rank_sample {
+    double time_ms;
+    double compute_ms;
+    double comm_ms;
+    double cpu_pct;
+    double peak_mib;
+    double max_err;         /* Negative without --check */
+    double peak_gflops;     /* Single-thread peak of the rank's host, negative if not measured */
+    double bandwidth_gbs;   /* Triad bandwidth of the rank's host, negative if not measured */
+} rank_sample;
+
+/**
+ * @brief Parse a comma-separated list of positive sizes
+ * @return Number of values stored (entries <= 0 are skipped)
+ */
+static int parse_size_list(const char* s, size_t* out, int max) {
+    int count = 0;
+    const char* p = s;
+    while (*p && count < max) {
+        size_t v = (size_t)strtoull(p, NULL, 10);
+        if (v > 0) out[count++] = v;
+        p = strchr(p, ',');
+        if (!p) break;
+        ++p;
+    }
+    return count;
+}
+
+/**
+ * @brief Resolve a comma-separated list of --mode names
+ * @return Number of modes stored, or -1 if a name is unknown
+ */
+static int parse_mode_list(const char* list, const summa_mode** out) {
+    int count = 0;
+    const char* p = list;
+    while (*p && count < MAX_MODES) {
+        size_t len = strcspn(p, ",");
+        const summa_mode* found = NULL;
+        for (int i = 0; i < MAX_MODES; i++) {
+            if (strlen(MODES[i].name) == len && strncmp(p, MODES[i].name, len) == 0) found = &MODES[i];
+        }
+        if (!found) return -1;
+        out[count++] = found;
+        p += len;
+        if (*p == ',') ++p;
+    }
+    return count;
+}
+
+/**
+ * @brief Append the per-step times of one size and mode to the --steps file
+ * @param all Step times gathered on rank 0: for every run, for every rank,
+ *            `steps` comm seconds followed by `steps` compute seconds
+ * @return 0 on success, -1 if the file cannot be written
+ */
+static int write_steps(const char* path, const char* run_id, const char* run_uuid,
+                       const char* kernel, size_t n, int ranks, int runs, int steps,
+                       const double* all) {
+    FILE* f = fopen(path, "a");
+    if (!f) {
+        fprintf(stderr, "Cannot open %s for writing\n", path);
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    if (ftell(f) == 0) fputs(STEPS_HEADER, f);
+    for (int r = 0; r < runs; r++) {
+        for (int q = 0; q < ranks; q++) {
+            const double* comm = all + ((size_t)r * ranks + q) * 2 * steps;
+            for (int st = 0; st < steps; st++) {
+                fprintf(f, "%s;%s;%s;%zu;%d;%d;%d;%d;%.4f;%.4f\n", run_id, run_uuid, kernel, n,
+                        ranks, q, r, st, comm[st] * 1000.0, comm[steps + st] * 1000.0);
+            }
+        }
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Fill rows [row0, row0+rows) × columns [col0, col0+cols) of matrix `which`
+ *
+ * Elements come from rng.c by their global row-major index, so any rank
+ * can generate any block independently.
+ */
+static void fill_block(float* M, uint64_t seed, uint64_t which, size_t n,
+                       size_t row0, size_t rows, size_t col0, size_t cols) {
+    for (size_t i = 0; i < rows; i++)
+        rng_fill(M + i * cols, cols, seed, which, (uint64_t)(row0 + i) * n + col0, 1);
+}
+
+/**
+ * @brief Double-precision reference for this rank's block of C
+ * @param R Receives rows×cols reference values
+ * @param acc Scratch row of cols doubles
+ * @param a_row Scratch row of n floats
+ * @param b_strip Scratch n×cols floats
+ *
+ * Regenerates the full A row strip and B column strip the block depends
+ * on, so the reference involves no communication.
+ */
+static void reference_block(float* R, double* acc, float* a_row, float* b_strip, uint64_t seed,
+                            size_t n, size_t row0, size_t rows, size_t col0, size_t cols) {
+    fill_block(b_strip, seed, RNG_MATRIX_B, n, 0, n, col0, cols);
+    for (size_t i = 0; i < rows; i++) {
+        fill_block(a_row, seed, RNG_MATRIX_A, n, row0 + i, 1, 0, n);
+        for (size_t j = 0; j < cols; j++) acc[j] = 0.0;
+        for (size_t p = 0; p < n; p++) {
+            const double a = a_row[p];
+            const float* b = b_strip + p * cols;
+            for (size_t j = 0; j < cols; j++) acc[j] += a * b[j];
+        }
+        for (size_t j = 0; j < cols; j++) R[i * cols + j] = (float)acc[j];
+    }
+}
+
+/**
+ * @brief Largest absolute element difference (infinite if C contains NaN)
+ */
+static double max_abs_error(const float* C, const float* R, size_t len) {
+    double err = 0.0;
+    for (size_t i = 0; i < len; i++) {
+        double d = fabs((double)C[i] - (double)R[i]);
+        if (d != d) return HUGE_VAL;
+        if (d > err) err = d;
+    }
+    return err;
+}
+
+/**
+ * @brief Global size of a run: size itself, or size * sqrt(ranks) with --weak
+ */
+static size_t global_size(size_t size, int ranks, int weak) {
+    return weak ? (size_t)((double)size * sqrt((double)ranks) + 0.5) : size;
+}
+
+/**
+ * @brief Arena capacity for the largest block of any size on a grid
+ *
+ * A, B and C blocks, the optional reference block and its scratch strips,
+ * and the panels of a blocking and an overlapped grid (one and two panel
+ * pairs); the packing buffers fit in the slack.
+ */
+static size_t arena_bytes_for(const size_t* sizes, int nsizes, int ranks, int weak,
+                              int panel, int check) {
+    int dims[2] = { 0, 0 };
+    MPI_Dims_create(ranks, 2, dims);
+    const size_t line = 64;
+    size_t best = 0;
+    for (int i = 0; i < nsizes; i++) {
+        size_t n = global_size(sizes[i], ranks, weak);
+        size_t rows = (n + dims[0] - 1) / dims[0];
+        size_t cols = (n + dims[1] - 1) / dims[1];
+        size_t bytes = 3 * (rows * cols * sizeof(float) + line)
+                     + 3 * ((size_t)panel * (rows + cols) * sizeof(float) + 2 * line);
+        if (check) {
+            bytes += rows * cols * sizeof(float) + cols * sizeof(double)
+                   + n * sizeof(float) + n * cols * sizeof(float) + 3 * line;
+        }
+        if (bytes > best) best = bytes;
+    }
+    return best + ((size_t)8 << 20);
+}
+
+/**
+ * @brief Distributed benchmarking entry point (every rank runs it)
+ */
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+    int rank, ranks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+
+    /* Default configuration */
+    size_t sizes[MAX_SIZES] = { 512, 1024, 2048 };
+    int nsizes = 0;
+    int runs = 3;
+    const char* out = "results_raw.csv";
+    int seed = 27;
+    int panel = MATRIX_MULT_SUMMA_PANEL;
+    int weak = 0;
+    int warmup = 1;
+    int check = 0;
+    int use_roofline = 1;
+    int arena_flags = MATRIX_MULT_ARENA_PREFAULT;
+    size_t arena_mib = 0;
+    const char* jsonl_out = NULL;
+    const char* binary_out = NULL;
+    const char* steps_out = NULL;
+    const char* mode_list = "blocking,overlap";
+
+    /* Separate --options from positional arguments */
+    const char* pos[4] = { NULL, NULL, NULL, NULL };
+    int npos = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--panel") == 0 && i + 1 < argc) {
+            panel = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+            mode_list = argv[++i];
+        } else if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            steps_out = argv[++i];
+        } else if (strcmp(argv[i], "--weak") == 0) {
+            weak = 1;
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check = 1;
+        } else if (strcmp(argv[i], "--huge-pages") == 0) {
+            arena_flags |= MATRIX_MULT_ARENA_HUGE_PAGES;
+        } else if (strcmp(argv[i], "--arena-mib") == 0 && i + 1 < argc) {
+            arena_mib = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--jsonl") == 0 && i + 1 < argc) {
+            jsonl_out = argv[++i];
+        } else if (strcmp(argv[i], "--binary") == 0 && i + 1 < argc) {
+            binary_out = argv[++i];
+        } else if (strcmp(argv[i], "--no-roofline") == 0) {
+            use_roofline = 0;
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            if (rank == 0) fprintf(stderr, "Unknown or incomplete option '%s'\n", argv[i]);
+            MPI_Finalize();
+            return 1;
+        } else if (npos < 4) {
+            pos[npos++] = argv[i];
+        }
+    }
+    if (pos[0] && pos[0][0]) nsizes = parse_size_list(pos[0], sizes, MAX_SIZES);
+    if (nsizes == 0) nsizes = 3;
+    if (pos[1]) runs = atoi(pos[1]);
+    if (pos[2]) out = pos[2];
+    if (pos[3]) seed = atoi(pos[3]);
+    if (panel <= 0) panel = MATRIX_MULT_SUMMA_PANEL;
+    const summa_mode* modes[MAX_MODES];
+    int nmodes = parse_mode_list(mode_list, modes);
+    if (nmodes <= 0) {
+        if (rank == 0) fprintf(stderr, "Unknown --mode '%s'; use blocking, overlap or both\n", mode_list);
+        MPI_Finalize();
+        return 1;
+    }
+
+    /* One arena per rank, mapped and prefaulted before any timing */
+    size_t arena_bytes = arena_mib > 0 ? arena_mib << 20
+                                       : arena_bytes_for(sizes, nsizes, ranks, weak, panel, check);
+    if (arena_mib == 0 && use_roofline && arena_bytes < roofline_triad_bytes()) {
+        arena_bytes = roofline_triad_bytes();   /* The triad probe runs before any operand */
+    }
+    matrix_mult_arena* arena = matrix_mult_arena_create(arena_bytes, arena_flags);
+    int ok = arena != NULL, all_ok = 0;
+    if (!ok) fprintf(stderr, "rank %d: cannot map a %.1f MiB arena\n", rank,
+                     arena_bytes / (1024.0 * 1024.0));
+
+    /* Only rank 0 writes results */
+    result_sink* sink = NULL;
+    if (rank == 0 && ok) {
+        sink = result_sink_open(out, jsonl_out, binary_out);
+        ok = sink != NULL;
+    }
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (!all_ok) {
+        result_sink_close(sink);
+        matrix_mult_arena_destroy(arena);
+        MPI_Finalize();
+        return 1;
+    }
+
+    /* Per-rank host description; run_id and run_uuid are rank 0's */
+    char run_id[32];
+    run_id_str(run_id, sizeof(run_id));
+    machine_fingerprint fp;
+    machine_fingerprint_init(&fp);
+    MPI_Bcast(run_id, (int)sizeof(run_id), MPI_CHAR, 0, MPI_COMM_WORLD);
+    MPI_Bcast(fp.run_uuid, (int)sizeof(fp.run_uuid), MPI_CHAR, 0, MPI_COMM_WORLD);
+    machine_fingerprint* fps = NULL;
+    rank_sample* samples = NULL;
+    if (rank == 0) {
+        fps = (machine_fingerprint*)malloc((size_t)ranks * sizeof(*fps));
+        samples = (rank_sample*)malloc((size_t)ranks * sizeof(*samples));
+        if (!fps || !samples) MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    MPI_Gather(&fp, (int)sizeof(fp), MPI_BYTE, fps, (int)sizeof(fp), MPI_BYTE, 0, MPI_COMM_WORLD);
+
+    /* Single-thread roofline of every rank, one rank at a time so ranks
+     * sharing a node do not disturb each other's probes */
+    roofline rf;
+    int have_roofline = 0;
+    if (use_roofline) {
+        for (int r = 0; r < ranks; r++) {
+            if (r == rank) have_roofline = roofline_measure(&rf, 1, arena) == 0;
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+    }
+
+    const int ncpu = logical_cpus();
+    if (rank == 0) {
+        int dims[2] = { 0, 0 };
+        MPI_Dims_create(ranks, 2, dims);
+        printf("host: %s, %d CPUs, %s [%s] run %s\n", fp.cpu_model, fp.cores, fp.os_kernel,
+               fp.hash, fp.run_uuid);
+        printf("summa: %d ranks on a %dx%d grid, panel %d%s\n", ranks, dims[0], dims[1], panel,
+               weak ? ", weak scaling" : "");
+        if (have_roofline) {
+            printf("roofline rank 0 (%s): peak %.1f GFLOP/s per rank, triad %.1f GB/s\n",
+                   rf.isa, rf.peak_gflops_1, rf.bandwidth_gbs);
+        }
+    }
+
+    int status = 0;
+    for (int si = 0; si < nsizes && status == 0; ++si) {
+        const size_t n = global_size(sizes[si], ranks, weak);
+        const double flops = 2.0 * (double)n * (double)n * (double)n;
+        const double min_bytes = 3.0 * sizeof(float) * (double)n * (double)n;
+        const size_t size_mark = matrix_mult_arena_mark(arena);
+
+        /* One grid per mode; they share the block layout and the operands */
+        matrix_mult_summa* summa[MAX_MODES] = { NULL };
+        ok = 1;
+        for (int mi = 0; mi < nmodes && ok; ++mi) {
+            summa[mi] = matrix_mult_summa_create(MPI_COMM_WORLD, n, panel, modes[mi]->flags, arena);
+            ok = summa[mi] != NULL;
+        }
+        if (!ok) {
+            if (rank == 0) fprintf(stderr, "n=%zu: cannot allocate SUMMA buffers; skipped\n", n);
+            for (int mi = 0; mi < nmodes; ++mi) matrix_mult_summa_destroy(summa[mi]);
+            matrix_mult_arena_release(arena, size_mark);
+            continue;
+        }
+        size_t row0, rows, col0, cols;
+        matrix_mult_summa_block(summa[0], &row0, &rows, &col0, &cols);
+        const int steps = matrix_mult_summa_steps(summa[0]);
+
+        /* Operand blocks, per-step times, plus the reference block with --check */
+        float* A = (float*)matrix_mult_arena_alloc(arena, rows * cols * sizeof(float));
+        float* B = (float*)matrix_mult_arena_alloc(arena, rows * cols * sizeof(float));
+        float* C = (float*)matrix_mult_arena_alloc(arena, rows * cols * sizeof(float));
+        double* step_times = (double*)matrix_mult_arena_alloc(arena, 2 * (size_t)steps * sizeof(double));
+        float* R = NULL;
+        ok = A && B && C && step_times;
+        if (ok && check) {
+            R = (float*)matrix_mult_arena_alloc(arena, rows * cols * sizeof(float));
+            double* acc = (double*)matrix_mult_arena_alloc(arena, cols * sizeof(double));
+            float* a_row = (float*)matrix_mult_arena_alloc(arena, n * sizeof(float));
+            float* b_strip = (float*)matrix_mult_arena_alloc(arena, n * cols * sizeof(float));
+            ok = R && acc && a_row && b_strip;
+            if (ok) reference_block(R, acc, a_row, b_strip, (uint64_t)seed, n, row0, rows, col0, cols);
+        }
+
+        /* Every rank's step times of every run, for --steps (rank 0 only) */
+        double* all_steps = NULL;
+        if (rank == 0 && steps_out) {
+            all_steps = (double*)malloc((size_t)runs * ranks * 2 * steps * sizeof(double));
+            ok = ok && all_steps;
+        }
+        MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        if (!all_ok) {
+            if (rank == 0) fprintf(stderr, "n=%zu: blocks do not fit the arena; skipped\n", n);
+            free(all_steps);
+            for (int mi = 0; mi < nmodes; ++mi) matrix_mult_summa_destroy(summa[mi]);
+            matrix_mult_arena_release(arena, size_mark);
+            continue;
+        }
+        fill_block(A, (uint64_t)seed, RNG_MATRIX_A, n, row0, rows, col0, cols);
+        fill_block(B, (uint64_t)seed, RNG_MATRIX_B, n, row0, rows, col0, cols);
+
+        double mean_comm[MAX_MODES];
+        for (int mi = 0; mi < nmodes && status == 0; ++mi) {
+            const summa_mode* mode = modes[mi];
+            double comm_total = 0.0;
+
+            for (int w = 0; w < warmup && status == 0; ++w) {
+                if (matrix_mult_summa_run(summa[mi], A, B, C, NULL) != 0) status = 1;
+            }
+
+            for (int r = 0; r < runs && status == 0; ++r) {
+                /* Start together so total times are comparable across ranks */
+                MPI_Barrier(MPI_COMM_WORLD);
+                double cpu0 = proc_cpu_seconds();
+                double mem_before = current_mem_mib();
+                summa_times t;
+                t.step_comm_sec = step_times;
+                t.step_compute_sec = step_times + steps;
+                if (matrix_mult_summa_run(summa[mi], A, B, C, &t) != 0) status = 1;
+                double cpu1 = proc_cpu_seconds();
+                double mem_after = current_mem_mib();
+
+                rank_sample mine;
+                mine.time_ms = t.total_sec * 1000.0;
+                mine.compute_ms = t.compute_sec * 1000.0;
+                mine.comm_ms = t.comm_sec * 1000.0;
+                mine.cpu_pct = 100.0 * (cpu1 - cpu0) / (t.total_sec * ncpu);
+                mine.peak_mib = mem_after > mem_before ? mem_after : mem_before;
+                mine.max_err = R ? max_abs_error(C, R, rows * cols) : -1.0;
+                mine.peak_gflops = have_roofline ? rf.peak_gflops_1 : -1.0;
+                mine.bandwidth_gbs = have_roofline ? rf.bandwidth_gbs : -1.0;
+                MPI_Gather(&mine, (int)sizeof(mine), MPI_BYTE, samples, (int)sizeof(mine), MPI_BYTE,
+                           0, MPI_COMM_WORLD);
+                if (steps_out) {
+                    double* dst = all_steps ? all_steps + (size_t)r * ranks * 2 * steps : NULL;
+                    MPI_Gather(step_times, 2 * steps, MPI_DOUBLE, dst, 2 * steps, MPI_DOUBLE,
+                               0, MPI_COMM_WORLD);
+                }
+                if (rank != 0) continue;
+
+                double slowest = 0.0, compute_sum = 0.0, comm_sum = 0.0, err = -1.0;
+                for (int q = 0; q < ranks; q++) {
+                    const rank_sample* sq = &samples[q];
+                    const machine_fingerprint* fq = &fps[q];
+                    result_row row;
+                    row.run_id = run_id;
+                    row.language = "C";
+                    row.size = (int)n;
+                    row.run_idx = r;
+                    row.time_ms = sq->time_ms;
+                    row.cpu_pct = sq->cpu_pct;
+                    row.peak_mib = sq->peak_mib;
+                    row.kernel = mode->kernel;
+                    row.pack_ms = -1.0;
+                    row.compute_ms = sq->compute_ms;
+                    row.threads = 1;
+                    row.imbalance = -1.0;
+                    row.steals = -1.0;
+                    row.dims.m = row.dims.n = row.dims.k = n;
+                    row.max_err = sq->max_err;
+                    for (int c = 0; c < HW_COUNTER_COUNT; c++) row.counters[c] = -1.0;
+                    row.reps = 1;
+                    row.gflops = flops / (sq->time_ms * 1e6);
+                    row.intensity = flops / min_bytes;
+                    row.peak_gflops = sq->peak_gflops > 0.0 ? sq->peak_gflops * ranks : -1.0;
+                    row.pct_peak = row.peak_gflops > 0.0 ? 100.0 * row.gflops / row.peak_gflops : -1.0;
+                    row.bandwidth_gbs = sq->bandwidth_gbs;
+                    row.fingerprint = fq->hash;
+                    row.cpu_model = fq->cpu_model;
+                    row.cores = fq->cores;
+                    row.governor = fq->governor;
+                    row.compiler = fq->compiler;
+                    row.cflags = fq->cflags;
+                    row.os_kernel = fq->os_kernel;
+                    row.run_uuid = fp.run_uuid;
+                    row.comm_ms = sq->comm_ms;
+                    row.ranks = ranks;
+                    row.rank = q;
+                    row.dtype = "fp32";
+                    row.err_fp64 = sq->max_err;     /* The --check reference is already fp64 */
+                    row.batch = 1;
+                    row.h2d_ms = -1.0;
+                    row.d2h_ms = -1.0;
+                    row.placement = "serial";
+                    row.bind = "none";
+                    row.remote_pct = -1.0;
+                    row.bytes_read = -1.0;
+                    row.bytes_written = -1.0;
+                    row.verified = NULL;
+                    row.verify_err = -1.0;
+                    row.density = 1.0;
+                    row.queue = 1;
+                    row.lat_p50_ms = -1.0;
+                    row.lat_p99_ms = -1.0;
+                    result_sink_add(sink, &row);
+
+                    if (sq->time_ms > slowest) slowest = sq->time_ms;
+                    compute_sum += sq->compute_ms;
+                    comm_sum += sq->comm_ms;
+                    if (sq->max_err > err) err = sq->max_err;
+                }
+                comm_total += comm_sum / ranks;
+                printf("n=%zu kernel=%s ranks=%d run=%d time=%.2f ms (slowest rank) compute=%.2f ms "
+                       "comm=%.2f ms (mean per rank) steps=%d GFLOP/s=%.2f", n, mode->kernel, ranks,
+                       r, slowest, compute_sum / ranks, comm_sum / ranks, t.steps,
+                       flops / (slowest * 1e6));
+                if (err >= 0.0) printf(" max_err=%.3e", err);
+                printf("\n");
+            }
+            mean_comm[mi] = runs > 0 ? comm_total / runs : 0.0;
+
+            /* Step detail is written between modes, away from the timed runs */
+            if (rank == 0 && status == 0 && steps_out &&
+                write_steps(steps_out, run_id, fp.run_uuid, mode->kernel, n, ranks, runs, steps,
+                            all_steps) != 0) {
+                status = 1;
+            }
+        }
+
+        /* Communication the overlap hid, relative to the blocking broadcasts */
+        if (rank == 0 && status == 0) {
+            int blocking = -1, overlap = -1;
+            for (int mi = 0; mi < nmodes; ++mi) {
+                if (modes[mi]->flags & MATRIX_MULT_SUMMA_OVERLAP) overlap = mi;
+                else blocking = mi;
+            }
+            if (blocking >= 0 && overlap >= 0 && mean_comm[blocking] > 0.0) {
+                printf("n=%zu overlap: exposed comm %.2f ms vs %.2f ms blocking (mean per rank), "
+                       "%.1f%% hidden\n", n, mean_comm[overlap], mean_comm[blocking],
+                       100.0 * (1.0 - mean_comm[overlap] / mean_comm[blocking]));
+            }
+        }
+
+        free(all_steps);
+        for (int mi = 0; mi < nmodes; ++mi) matrix_mult_summa_destroy(summa[mi]);
+        matrix_mult_arena_release(arena, size_mark);
+
+        /* Write this size's rows now, away from any timed region */
+        if (rank == 0 && result_sink_flush(sink) != 0) status = 1;
+        MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    }
+
+    if (rank == 0 && result_sink_close(sink) != 0) status = 1;
+    free(fps);
+    free(samples);
+    matrix_mult_arena_destroy(arena);
+    MPI_Finalize();
+    return status;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file fingerprint.c
+ * @brief Fingerprint collection and hashing behind fingerprint.h
+ *
+ * Host facts come from platform.c; the compiler name and version and the
+ * code-generation flags are taken from the predefined macros of the
+ * compiler building this file, which is the same one that builds the
+ * kernels when the harness is compiled in one command.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "fingerprint.h"
+#include "platform.h"
+
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+/* ==================== Build description ==================== */
+
+static void compiler_str(char* buf, size_t n) {
+#if defined(__clang__)
+    snprintf(buf, n, "clang %d.%d.%d", __clang_major__, __clang_minor__, __clang_patchlevel__);
+#elif defined(__INTEL_LLVM_COMPILER)
+    snprintf(buf, n, "icx %d", __INTEL_LLVM_COMPILER);
+#elif defined(__GNUC__)
+    snprintf(buf, n, "gcc %d.%d.%d", __GNUC__, __GNUC_MINOR__, __GNUC_PATCHLEVEL__);
+#elif defined(_MSC_VER)
+    snprintf(buf, n, "msvc %d", _MSC_FULL_VER);
+#else
+    snprintf(buf, n, "unknown");
+#endif
+}
+
+/**
+ * @brief Flags the build was compiled with
+ *
+ * Without BENCH_CFLAGS the options themselves are not visible to the
+ * program, so the macros they define are listed instead (optimisation,
+ * fast-math, OpenMP, vector ISA baseline, PAPI).
+ */
+static void cflags_str(char* buf, size_t n) {
+#if defined(BENCH_CFLAGS)
+    snprintf(buf, n, "%s", BENCH_CFLAGS);
+#else
+    size_t len = 0;
+    buf[0] = '\0';
+#define ADD_FLAG(s) \
+    do { if (len < n) len += (size_t)snprintf(buf + len, n - len, "%s%s", len ? " " : "", s); } while (0)
+#if defined(__OPTIMIZE_SIZE__)
+    ADD_FLAG("-Os");
+#elif defined(__OPTIMIZE__)
+    ADD_FLAG("-O");
+#elif defined(_MSC_VER) && !defined(_DEBUG)
+    ADD_FLAG("/O");
+#else
+    ADD_FLAG("-O0");
+#endif
+#if defined(__FAST_MATH__)
+    ADD_FLAG("-ffast-math");
+#endif
+#if defined(_OPENMP)
+    ADD_FLAG("openmp");
+#endif
+#if defined(__AVX512F__)
+    ADD_FLAG("avx512f");
+#elif defined(__AVX2__)
+    ADD_FLAG("avx2");
+#elif defined(__AVX__)
+    ADD_FLAG("avx");
+#elif defined(__SSE4_2__)
+    ADD_FLAG("sse4.2");
+#endif
+#if defined(__FMA__)
+    ADD_FLAG("fma");
+#endif
+#if defined(__ARM_NEON)
+    ADD_FLAG("neon");
+#endif
+#if defined(HAVE_PAPI)
+    ADD_FLAG("papi");
+#endif
+#undef ADD_FLAG
+#endif
+}
+
+/* ==================== Helpers ==================== */
+
+/**
+ * @brief Make a string safe for a semicolon CSV field
+ */
+static void csv_safe(char* s) {
+    for (; *s; s++) {
+        if (*s == ';') *s = ',';
+        else if (*s == '\n' || *s == '\r' || *s == '\t') *s = ' ';
+    }
+}
+
+static unsigned long long fnv1a(unsigned long long h, const char* s) {
+    for (; *s; s++) {
+        h ^= (unsigned char)*s;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+/* ==================== Public API ==================== */
+
+void machine_fingerprint_init(machine_fingerprint* fp) {
+    memset(fp, 0, sizeof(*fp));
+    cpu_model_str(fp->cpu_model, sizeof(fp->cpu_model));
+    fp->cores = logical_cpus();
+    cpu_governor_str(fp->governor, sizeof(fp->governor));
+    compiler_str(fp->compiler, sizeof(fp->compiler));
+    cflags_str(fp->cflags, sizeof(fp->cflags));
+    os_kernel_str(fp->os_kernel, sizeof(fp->os_kernel));
+    random_uuid_str(fp->run_uuid, sizeof(fp->run_uuid));
+
+    csv_safe(fp->cpu_model);
+    csv_safe(fp->governor);
+    csv_safe(fp->compiler);
+    csv_safe(fp->cflags);
+    csv_safe(fp->os_kernel);
+
+    /* Hash the fields as they appear in the CSV, separators included */
+    char cores[16];
+    snprintf(cores, sizeof(cores), "%d", fp->cores);
+    const char* fields[] = { fp->cpu_model, cores, fp->governor, fp->compiler, fp->cflags, fp->os_kernel };
+    unsigned long long h = FNV_OFFSET;
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        if (i) h = fnv1a(h, ";");
+        h = fnv1a(h, fields[i]);
+    }
+    snprintf(fp->hash, sizeof(fp->hash), "%016llx", h);
+}
@@ -0,0 +1,45 @@
+/**
+ * @file fingerprint.h
+ * @brief Machine and build fingerprint written with every result row
+ *
+ * Results from many machines end up in one CSV. The fingerprint pins each
+ * row to the hardware, frequency policy, OS and build that produced it,
+ * and a random run UUID tells apart processes that share a run_id.
+ *
+ * The hash is FNV-1a (64-bit) over "cpu_model;cores;governor;compiler;
+ * cflags;os_kernel" exactly as written to the CSV, printed as 16 lowercase
+ * hex digits; the Java and Python harnesses compute it the same way.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Host and build description (all strings are CSV-safe: no ';' or newlines)
+ */
+typedef struct machine_fingerprint {
+    char hash[17];          /**< FNV-1a 64 of the fields below, hex */
+    char cpu_model[128];    /**< e.g. "AMD EPYC 7763 64-Core Processor" */
+    int cores;              /**< Logical CPUs available to the process */
+    char governor[48];      /**< cpufreq governor or Windows power scheme, "" if unknown */
+    char compiler[96];      /**< e.g. "gcc 12.2.0" */
+    char cflags[256];       /**< BENCH_CFLAGS, or a summary of the code-generation macros */
+    char os_kernel[128];    /**< e.g. "Linux 6.8.0-45-generic" */
+    char run_uuid[37];      /**< Random UUID of this process */
+} machine_fingerprint;
+
+/**
+ * @brief Collect the fingerprint of this machine and build
+ * @param fp Receives the description; never fails (unknown fields stay empty)
+ *
+ * Define BENCH_CFLAGS when compiling fingerprint.c to record the exact
+ * flags, e.g. -DBENCH_CFLAGS="\"-O3 -march=native -fopenmp\"".
+ */
+void machine_fingerprint_init(machine_fingerprint* fp);
+
+#ifdef __cplusplus
+}
+#endif
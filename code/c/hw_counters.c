@@ -0,0 +1,239 @@
+/**
+ * @file hw_counters.c
+ * @brief perf_event_open and PAPI backends of hw_counters.h
+ *
+ * perf_event: each event is opened as its own counter (not a group) so
+ * inherit can follow worker threads; reads return value, time enabled and
+ * time running, and deltas are scaled by enabled/running when the kernel
+ * had to multiplex counters. Needs perf_event_paranoid <= 2 (user space
+ * only counting) or CAP_PERFMON.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* syscall() */
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include "hw_counters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HW_PERF_EVENT 1
+#endif
+
+#ifdef HAVE_PAPI
+#include <papi.h>
+#endif
+
+static const char* const COUNTER_NAMES[HW_COUNTER_COUNT] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "fp_ops"
+};
+
+/* Values of hw_counters::kind */
+enum { BACKEND_PERF = 1, BACKEND_PAPI };
+
+/**
+ * @brief Open counters of one backend
+ */
+struct hw_counters {
+    int kind;                                   /* BACKEND_* */
+    const char* backend;
+#ifdef HW_PERF_EVENT
+    int fd[HW_COUNTER_COUNT];                   /* -1 if the event is unavailable */
+    unsigned long long start[HW_COUNTER_COUNT][3];  /* value, enabled, running */
+#endif
+#ifdef HAVE_PAPI
+    int event_set;
+    int papi_index[HW_COUNTER_COUNT];           /* Position in the event set, or -1 */
+    int papi_count;
+#endif
+};
+
+/* ==================== perf_event backend ==================== */
+
+#ifdef HW_PERF_EVENT
+
+/* Generic cache event: cache id, read operation, miss result */
+#define HW_CACHE_READ_MISS(cache) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static int perf_open(unsigned type, unsigned long long config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.inherit = 1;           /* Follow threads created after opening */
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static int perf_read(int fd, unsigned long long out[3]) {
+    return read(fd, out, 3 * sizeof(out[0])) == (ssize_t)(3 * sizeof(out[0]));
+}
+
+static int perf_backend_open(hw_counters* hc) {
+    int opened = 0;
+
+    hc->fd[HW_CYCLES] = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    hc->fd[HW_INSTRUCTIONS] = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    hc->fd[HW_L1D_MISSES] = perf_open(PERF_TYPE_HW_CACHE, HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D));
+    hc->fd[HW_LLC_MISSES] = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    hc->fd[HW_DTLB_MISSES] = perf_open(PERF_TYPE_HW_CACHE, HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_DTLB));
+    hc->fd[HW_FP_OPS] = -1; /* No generic event; see hw_counters.h */
+
+    for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+        if (hc->fd[i] >= 0) opened++;
+    }
+    if (opened == 0) return 0;
+    hc->kind = BACKEND_PERF;
+    hc->backend = "perf_event";
+    return 1;
+}
+
+static void perf_backend_close(hw_counters* hc) {
+    for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+        if (hc->fd[i] >= 0) close(hc->fd[i]);
+    }
+}
+
+static void perf_backend_start(hw_counters* hc) {
+    for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+        if (hc->fd[i] >= 0 && !perf_read(hc->fd[i], hc->start[i])) {
+            memset(hc->start[i], 0, sizeof(hc->start[i]));
+        }
+    }
+}
+
+static void perf_backend_stop(hw_counters* hc, double values[HW_COUNTER_COUNT]) {
+    for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+        unsigned long long now[3];
+        values[i] = -1.0;
+        if (hc->fd[i] < 0 || !perf_read(hc->fd[i], now)) continue;
+
+        double value = (double)(now[0] - hc->start[i][0]);
+        double enabled = (double)(now[1] - hc->start[i][1]);
+        double running = (double)(now[2] - hc->start[i][2]);
+        if (running <= 0.0) continue; /* Never scheduled on the PMU */
+        values[i] = running < enabled ? value * enabled / running : value;
+    }
+}
+
+#endif /* HW_PERF_EVENT */
+
+/* ==================== PAPI backend ==================== */
+
+#ifdef HAVE_PAPI
+
+static int papi_backend_open(hw_counters* hc) {
+    static const int events[HW_COUNTER_COUNT] = {
+        PAPI_TOT_CYC, PAPI_TOT_INS, PAPI_L1_DCM, PAPI_L3_TCM, PAPI_TLB_DM, PAPI_SP_OPS
+    };
+
+    if (PAPI_is_initialized() == PAPI_NOT_INITED &&
+        PAPI_library_init(PAPI_VER_CURRENT) != PAPI_VER_CURRENT) {
+        return 0;
+    }
+    hc->event_set = PAPI_NULL;
+    if (PAPI_create_eventset(&hc->event_set) != PAPI_OK) return 0;
+
+    /* Add events one by one so unsupported ones are simply skipped */
+    hc->papi_count = 0;
+    for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+        hc->papi_index[i] = -1;
+        if (PAPI_add_event(hc->event_set, events[i]) == PAPI_OK) {
+            hc->papi_index[i] = hc->papi_count++;
+        }
+    }
+    if (hc->papi_count == 0 || PAPI_start(hc->event_set) != PAPI_OK) {
+        PAPI_cleanup_eventset(hc->event_set);
+        PAPI_destroy_eventset(&hc->event_set);
+        return 0;
+    }
+    hc->kind = BACKEND_PAPI;
+    hc->backend = "papi";
+    return 1;
+}
+
+static void papi_backend_close(hw_counters* hc) {
+    long long scratch[HW_COUNTER_COUNT];
+    PAPI_stop(hc->event_set, scratch);
+    PAPI_cleanup_eventset(hc->event_set);
+    PAPI_destroy_eventset(&hc->event_set);
+}
+
+static void papi_backend_start(hw_counters* hc) {
+    PAPI_reset(hc->event_set);
+}
+
+static void papi_backend_stop(hw_counters* hc, double values[HW_COUNTER_COUNT]) {
+    long long raw[HW_COUNTER_COUNT];
+    int ok = PAPI_read(hc->event_set, raw) == PAPI_OK;
+    for (int i = 0; i < HW_COUNTER_COUNT; i++) {
+        values[i] = ok && hc->papi_index[i] >= 0 ? (double)raw[hc->papi_index[i]] : -1.0;
+    }
+}
+
+#endif /* HAVE_PAPI */
+
+/* ==================== Public API ==================== */
+
+hw_counters* hw_counters_open(void) {
+    hw_counters* hc = (hw_counters*)calloc(1, sizeof(*hc));
+    if (!hc) return NULL;
+
+#ifdef HW_PERF_EVENT
+    if (perf_backend_open(hc)) return hc;
+#endif
+#ifdef HAVE_PAPI
+    if (papi_backend_open(hc)) return hc;
+#endif
+
+    free(hc);
+    return NULL;
+}
+
+void hw_counters_close(hw_counters* hc) {
+    if (!hc) return;
+#ifdef HW_PERF_EVENT
+    if (hc->kind == BACKEND_PERF) perf_backend_close(hc);
+#endif
+#ifdef HAVE_PAPI
+    if (hc->kind == BACKEND_PAPI) papi_backend_close(hc);
+#endif
+    free(hc);
+}
+
+const char* hw_counters_backend(const hw_counters* hc) {
+    return hc ? hc->backend : "none";
+}
+
+const char* hw_counter_name(int i) {
+    return i >= 0 && i < HW_COUNTER_COUNT ? COUNTER_NAMES[i] : "";
+}
+
+void hw_counters_start(hw_counters* hc) {
+    if (!hc) return;
+#ifdef HW_PERF_EVENT
+    if (hc->kind == BACKEND_PERF) perf_backend_start(hc);
+#endif
+#ifdef HAVE_PAPI
+    if (hc->kind == BACKEND_PAPI) papi_backend_start(hc);
+#endif
+}
+
+void hw_counters_stop(hw_counters* hc, double values[HW_COUNTER_COUNT]) {
+    for (int i = 0; i < HW_COUNTER_COUNT; i++) values[i] = -1.0;
+    if (!hc) return;
+#ifdef HW_PERF_EVENT
+    if (hc->kind == BACKEND_PERF) perf_backend_stop(hc, values);
+#endif
+#ifdef HAVE_PAPI
+    if (hc->kind == BACKEND_PAPI) papi_backend_stop(hc, values);
+#endif
+}
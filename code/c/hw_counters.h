@@ -0,0 +1,74 @@
+/**
+ * @file hw_counters.h
+ * @brief Optional hardware performance counters around a timed region
+ *
+ * Backends, tried in order by hw_counters_open():
+ * - perf_event_open (Linux): counts the calling thread and every thread it
+ *   creates afterwards (OpenMP workers included), user space only, scaled
+ *   for multiplexing. Generic perf events have no portable FP-operation
+ *   count, so HW_FP_OPS is not measured by this backend.
+ * - PAPI (any OS, build with -DHAVE_PAPI and -lpapi): preset events
+ *   including PAPI_SP_OPS for FP ops; counts the calling thread only.
+ *
+ * Events a CPU or backend does not support are reported as -1 so the
+ * harness can leave their CSV fields empty.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Indices of the counter values filled in by hw_counters_stop() */
+enum {
+    HW_CYCLES,          /**< Core cycles */
+    HW_INSTRUCTIONS,    /**< Instructions retired */
+    HW_L1D_MISSES,      /**< L1 data cache read misses */
+    HW_LLC_MISSES,      /**< Last-level cache misses */
+    HW_DTLB_MISSES,     /**< Data TLB (read) misses */
+    HW_FP_OPS,          /**< Single-precision floating-point operations */
+    HW_COUNTER_COUNT
+};
+
+/** Opaque set of open counters */
+typedef struct hw_counters hw_counters;
+
+/**
+ * @brief Open every available counter
+ * @return Counter set, or NULL if no backend could open any counter
+ *         (e.g. not Linux and no PAPI, or perf_event_paranoid too strict)
+ */
+hw_counters* hw_counters_open(void);
+
+/**
+ * @brief Close the counters (NULL is ignored)
+ */
+void hw_counters_close(hw_counters* hc);
+
+/**
+ * @brief Name of the backend in use ("perf_event" or "papi")
+ */
+const char* hw_counters_backend(const hw_counters* hc);
+
+/**
+ * @brief CSV column name of counter i (e.g. "cycles")
+ */
+const char* hw_counter_name(int i);
+
+/**
+ * @brief Snapshot the counters at the start of the measured region
+ */
+void hw_counters_start(hw_counters* hc);
+
+/**
+ * @brief Counts accumulated since hw_counters_start()
+ * @param hc Counter set, or NULL (every value is then -1)
+ * @param values Receives HW_COUNTER_COUNT values; -1 marks counters that
+ *               are unavailable
+ */
+void hw_counters_stop(hw_counters* hc, double values[HW_COUNTER_COUNT]);
+
+#ifdef __cplusplus
+}
+#endif
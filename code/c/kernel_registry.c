@@ -0,0 +1,638 @@
+/**
+ * @file kernel_registry.c
+ * @brief Kernel table mapping names to matrix multiplication entry points
+ * 
+ * Each kernel in matrix_mult.h gets a thin adapter with the common
+ * kernel_fn signature. To add a kernel, write its adapter (plus prepare and
+ * release functions if it needs scratch memory) and append one line to the
+ * KERNELS table; the harness picks it up automatically.
+ * 
+ * The GPU kernels are only registered when built with -DMATRIX_MULT_GPU
+ * and linked against matrix_mult_gpu.cu (see matrix_mult_gpu.h), and the
+ * C++ fixed-size kernel only with -DMATRIX_MULT_FIXED and
+ * matrix_mult_fixed.cpp (see matrix_mult_fixed.h).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel_registry.h"
+#include "matrix_mult.h"
+#include "matrix_mult_internal.h"
+#ifdef MATRIX_MULT_GPU
+#include "matrix_mult_gpu.h"
+#endif
+#ifdef MATRIX_MULT_FIXED
+#include "matrix_mult_fixed.h"
+#endif
+
+/* ==================== Adapters ==================== */
+
+static void run_naive(const float* A, const float* B, float* C, int n,
+                      kernel_ctx* ctx) {
+    (void)ctx;
+    matrix_multiplication(A, B, C, n);
+}
+
+static void run_ikj(const float* A, const float* B, float* C, int n,
+                    kernel_ctx* ctx) {
+    (void)ctx;
+    matrix_multiplication_ikj(A, B, C, n);
+}
+
+static void run_tiled(const float* A, const float* B, float* C, int n,
+                      kernel_ctx* ctx) {
+    matrix_multiplication_tiled(A, B, C, n, ctx->opts->tile);
+}
+
+static void run_simd(const float* A, const float* B, float* C, int n,
+                     kernel_ctx* ctx) {
+    matrix_multiplication_simd(A, B, C, n, ctx->opts->tile);
+}
+
+static void* prepare_packed(int n, const kernel_opts* opts) {
+    return matrix_mult_pack_create(n, opts->mc, opts->kc, opts->nc, opts->arena);
+}
+
+static void release_packed(void* state) {
+    matrix_mult_pack_destroy((matrix_mult_pack*)state);
+}
+
+static void run_packed(const float* A, const float* B, float* C, int n,
+                       kernel_ctx* ctx) {
+    matrix_mult_pack* pack = (matrix_mult_pack*)ctx->state;
+    double pack_sec, compute_sec;
+    
+    matrix_mult_pack_reset_times(pack);
+    matrix_multiplication_packed(A, B, C, n, pack);
+    matrix_mult_pack_times(pack, &pack_sec, &compute_sec);
+    
+    ctx->stats.pack_ms = pack_sec * 1000.0;
+    ctx->stats.compute_ms = compute_sec * 1000.0;
+}
+
+static void run_gemm(const float* A, const float* B, float* C, int n,
+                     kernel_ctx* ctx) {
+    matrix_mult_pack* pack = (matrix_mult_pack*)ctx->state;
+    double pack_sec, compute_sec;
+    (void)n;
+    
+    matrix_mult_pack_reset_times(pack);
+    gemm_with_pack(ctx->m, ctx->n, ctx->k, 1.0f, A, ctx->k, B, ctx->n,
+                   0.0f, C, ctx->n, pack);
+    matrix_mult_pack_times(pack, &pack_sec, &compute_sec);
+    
+    ctx->stats.pack_ms = pack_sec * 1000.0;
+    ctx->stats.compute_ms = compute_sec * 1000.0;
+}
+
+static void* prepare_strassen(int n, const kernel_opts* opts) {
+    return matrix_mult_strassen_create(n, opts->cutoff, opts->arena);
+}
+
+static void release_strassen(void* state) {
+    matrix_mult_strassen_destroy((matrix_mult_strassen*)state);
+}
+
+static void run_strassen(const float* A, const float* B, float* C, int n,
+                         kernel_ctx* ctx) {
+    matrix_multiplication_strassen(A, B, C, n, (matrix_mult_strassen*)ctx->state);
+}
+
+static void run_openmp(const float* A, const float* B, float* C, int n,
+                       kernel_ctx* ctx) {
+    matrix_multiplication_parallel(A, B, C, n, ctx->opts->tile, ctx->opts->threads);
+}
+
+static void* prepare_steal(int n, const kernel_opts* opts) {
+    (void)n;
+    (void)opts;
+    return calloc(1, sizeof(matrix_mult_sched_stats));
+}
+
+static void run_steal(const float* A, const float* B, float* C, int n,
+                      kernel_ctx* ctx) {
+    matrix_mult_sched_stats* st = (matrix_mult_sched_stats*)ctx->state;
+    double busy_sum = 0.0, busy_max = 0.0;
+    int steals = 0;
+    
+    matrix_multiplication_stealing(A, B, C, n, ctx->opts->tile, ctx->opts->threads, st);
+    
+    for (int t = 0; t < st->threads; t++) {
+        busy_sum += st->busy_sec[t];
+        if (st->busy_sec[t] > busy_max) busy_max = st->busy_sec[t];
+        steals += st->steals[t];
+    }
+    ctx->stats.steals = steals;
+    ctx->stats.imbalance = busy_sum > 0.0 ? busy_max * st->threads / busy_sum : 1.0;
+}
+
+static void report_steal(const void* state) {
+    const matrix_mult_sched_stats* st = (const matrix_mult_sched_stats*)state;
+    for (int t = 0; t < st->threads; t++) {
+        printf("    thread %3d: busy=%.2f ms tiles=%d steals=%d\n",
+               t, st->busy_sec[t] * 1000.0, st->tiles[t], st->steals[t]);
+    }
+}
+
+static void* prepare_fp16(int n, const kernel_opts* opts) {
+    return matrix_mult_mixed_create(n, MATRIX_MULT_FP16, opts->arena);
+}
+
+static void* prepare_bf16(int n, const kernel_opts* opts) {
+    return matrix_mult_mixed_create(n, MATRIX_MULT_BF16, opts->arena);
+}
+
+static void* prepare_fp64(int n, const kernel_opts* opts) {
+    return matrix_mult_mixed_create(n, MATRIX_MULT_FP64, opts->arena);
+}
+
+static void* prepare_int8(int n, const kernel_opts* opts) {
+    return matrix_mult_mixed_create(n, MATRIX_MULT_INT8, opts->arena);
+}
+
+static void release_mixed(void* state) {
+    matrix_mult_mixed_destroy((matrix_mult_mixed*)state);
+}
+
+static void run_mixed(const float* A, const float* B, float* C, int n,
+                      kernel_ctx* ctx) {
+    matrix_mult_mixed* ws = (matrix_mult_mixed*)ctx->state;
+    double convert_sec, compute_sec;
+    
+    matrix_multiplication_mixed(A, B, C, n, ws);
+    matrix_mult_mixed_times(ws, &convert_sec, &compute_sec);
+    
+    /* Operand and result conversions are reported as packing */
+    ctx->stats.pack_ms = convert_sec * 1000.0;
+    ctx->stats.compute_ms = compute_sec * 1000.0;
+}
+
+static void run_batch(const float* A, const float* B, float* C, int n,
+                      kernel_ctx* ctx) {
+    const size_t nn = (size_t)n * (size_t)n;
+    matrix_multiplication_batched(A, nn, B, nn, C, nn, n, ctx->opts->batch, ctx->opts->threads);
+}
+
+/**
+ * @brief Pointer arrays for batch_ptr, rebuilt when the operands or batch change
+ */
+typedef struct batch_ptrs {
+    size_t cap;             /* Entries allocated (largest batch of the sweep) */
+    size_t count;           /* Entries valid for base_a/b/c */
+    const float* base_a;
+    const float* base_b;
+    float* base_c;
+    const float** a;
+    const float** b;
+    float** c;
+} batch_ptrs;
+
+static void* prepare_batch_ptr(int n, const kernel_opts* opts) {
+    const size_t cap = opts->batch > 0 ? opts->batch : 1;
+    batch_ptrs* st = (batch_ptrs*)calloc(1, sizeof(*st));
+    (void)n;
+    if (!st) return NULL;
+    st->cap = cap;
+    st->a = (const float**)malloc(cap * sizeof(*st->a));
+    st->b = (const float**)malloc(cap * sizeof(*st->b));
+    st->c = (float**)malloc(cap * sizeof(*st->c));
+    if (!st->a || !st->b || !st->c) {
+        free((void*)st->a);
+        free((void*)st->b);
+        free(st->c);
+        free(st);
+        return NULL;
+    }
+    return st;
+}
+
+static void release_batch_ptr(void* state) {
+    batch_ptrs* st = (batch_ptrs*)state;
+    if (!st) return;
+    free((void*)st->a);
+    free((void*)st->b);
+    free(st->c);
+    free(st);
+}
+
+/*
+ * Point entry i at a fixed pseudo-random matrix of the batch (a Fisher-Yates
+ * shuffle from a constant seed), so the kernel walks memory out of order as
+ * it would for matrices scattered by an application.
+ */
+static void build_batch_ptrs(batch_ptrs* st, const float* A, const float* B, float* C,
+                             size_t nn, size_t count) {
+    unsigned int seed = 12345u;
+    for (size_t i = 0; i < count; i++) {
+        st->a[i] = A + i * nn;
+        st->b[i] = B + i * nn;
+        st->c[i] = C + i * nn;
+    }
+    for (size_t i = count; i > 1; i--) {
+        size_t j;
+        const float* ta;
+        const float* tb;
+        float* tc;
+        seed = seed * 1103515245u + 12345u;
+        j = (size_t)(seed >> 8) % i;
+        ta = st->a[i - 1]; st->a[i - 1] = st->a[j]; st->a[j] = ta;
+        tb = st->b[i - 1]; st->b[i - 1] = st->b[j]; st->b[j] = tb;
+        tc = st->c[i - 1]; st->c[i - 1] = st->c[j]; st->c[j] = tc;
+    }
+    st->base_a = A;
+    st->base_b = B;
+    st->base_c = C;
+    st->count = count;
+}
+
+static void run_batch_ptr(const float* A, const float* B, float* C, int n,
+                          kernel_ctx* ctx) {
+    batch_ptrs* st = (batch_ptrs*)ctx->state;
+    size_t count = ctx->opts->batch;
+    if (count > st->cap) count = st->cap;
+    
+    /* The first (warm-up) call of a sweep entry pays for the rebuild */
+    if (st->base_a != A || st->base_b != B || st->base_c != C || st->count != count) {
+        build_batch_ptrs(st, A, B, C, (size_t)n * (size_t)n, count);
+    }
+    matrix_multiplication_batched_ptr(st->a, st->b, (float* const*)st->c, n, count,
+                                      ctx->opts->threads);
+}
+
+static void run_batch_loop(const float* A, const float* B, float* C, int n,
+                           kernel_ctx* ctx) {
+    const size_t nn = (size_t)n * (size_t)n;
+    for (size_t b = 0; b < ctx->opts->batch; b++) {
+        matrix_multiplication_simd(A + b * nn, B + b * nn, C + b * nn, n, ctx->opts->tile);
+    }
+}
+
+static void* prepare_ooc(int n, const kernel_opts* opts) {
+    return matrix_mult_ooc_create(n, opts->budget, opts->mapped ? MATRIX_MULT_OOC_MAPPED : 0,
+                                  opts->arena);
+}
+
+static void release_ooc(void* state) {
+    matrix_mult_ooc_destroy((matrix_mult_ooc*)state);
+}
+
+static void run_ooc(const float* A, const float* B, float* C, int n,
+                    kernel_ctx* ctx) {
+    matrix_mult_ooc* ooc = (matrix_mult_ooc*)ctx->state;
+    (void)n;
+    
+    /* A budget too small for the shape leaves the stats empty, like a failed offload */
+    if (gemm_ooc(ctx->m, ctx->n, ctx->k, A, B, C, ooc) != 0) return;
+    matrix_mult_ooc_traffic(ooc, &ctx->stats.bytes_read, &ctx->stats.bytes_written);
+}
+
+static void report_ooc(const void* state) {
+    size_t tm, tk, bytes;
+    matrix_mult_ooc_tiles((const matrix_mult_ooc*)state, &tm, &tk, &bytes);
+    if (tm == 0) {
+        printf("    ooc: budget too small for one row of C and a panel of B\n");
+        return;
+    }
+    printf("    ooc: C bands of %zu rows, B panels of %zu rows, %.1f MiB of buffers\n",
+           tm, tk, bytes / (1024.0 * 1024.0));
+}
+
+/* CSR form of the dense A the harness passes, built once per size */
+typedef struct csr_state {
+    matrix_mult_arena* arena;
+    const float* src;           /* Dense A the cached matrix was compressed from */
+    size_t m, k;
+    matrix_mult_csr* csr;
+    double convert_ms;
+} csr_state;
+
+static void* prepare_csr(int n, const kernel_opts* opts) {
+    csr_state* st = (csr_state*)calloc(1, sizeof(*st));
+    (void)n;
+    if (st) st->arena = opts->arena;
+    return st;
+}
+
+static void release_csr(void* state) {
+    csr_state* st = (csr_state*)state;
+    if (!st) return;
+    matrix_mult_csr_destroy(st->csr);
+    free(st);
+}
+
+static void run_csr(const float* A, const float* B, float* C, int n,
+                    kernel_ctx* ctx) {
+    csr_state* st = (csr_state*)ctx->state;
+    (void)n;
+    
+    /* Sparse operands would arrive compressed; the first (warm-up) call pays, in pack_ms */
+    if (!st->csr || st->src != A || st->m != ctx->m || st->k != ctx->k) {
+        double t0 = matrix_mult_now();
+        matrix_mult_csr_destroy(st->csr);
+        st->csr = matrix_mult_csr_from_dense(A, ctx->m, ctx->k, st->arena, ctx->opts->threads);
+        st->src = A;
+        st->m = ctx->m;
+        st->k = ctx->k;
+        st->convert_ms = (matrix_mult_now() - t0) * 1000.0;
+        ctx->stats.pack_ms = st->convert_ms;
+        if (!st->csr) return;
+    }
+    double t0 = matrix_mult_now();
+    spmm_csr(ctx->n, st->csr, B, C, ctx->opts->threads);
+    ctx->stats.compute_ms = (matrix_mult_now() - t0) * 1000.0;
+}
+
+static void report_csr(const void* state) {
+    const csr_state* st = (const csr_state*)state;
+    if (!st->csr) {
+        printf("    csr: out of memory for the compressed A\n");
+        return;
+    }
+    const double cells = (double)st->csr->rows * (double)st->csr->cols;
+    printf("    csr: nnz=%zu (density %.4f), %.1f MiB compressed, built in %.2f ms\n",
+           st->csr->nnz, cells > 0.0 ? (double)st->csr->nnz / cells : 0.0,
+           ((double)st->csr->nnz * (sizeof(float) + sizeof(uint32_t))
+            + (double)(st->csr->rows + 1) * sizeof(size_t)) / (1024.0 * 1024.0),
+           st->convert_ms);
+}
+
+/* Persistent workers plus the result buffers of the requests after the first */
+typedef struct pool_state {
+    matrix_mult_pool* pool;
+    matrix_mult_arena* arena;
+    float* results;             /* (queue - 1) results of up to n×n */
+    size_t queue;               /* Requests per call */
+    int threads;                /* Active workers of the last call */
+    double* latency_ms;         /* Sample of the run's latencies, POOL_LATENCY_SAMPLES long */
+    size_t count;               /* Latencies in the sample */
+    size_t seen;                /* Requests of the run so far */
+    int finished;               /* finish_pool() ran: the next call starts a new sample */
+    unsigned long long rng;     /* Reservoir sampling state */
+} pool_state;
+
+/* Latencies kept per run; longer runs keep a uniform random subset (reservoir) */
+#define POOL_LATENCY_SAMPLES 16384
+
+static size_t pool_queue(const kernel_opts* opts) {
+    if (opts->queue < 1) return 1;
+    return opts->queue > MATRIX_MULT_POOL_QUEUE ? MATRIX_MULT_POOL_QUEUE : opts->queue;
+}
+
+static void release_pool(void* state) {
+    pool_state* st = (pool_state*)state;
+    if (!st) return;
+    matrix_mult_pool_destroy(st->pool);
+    matrix_mult_scratch_free(st->arena, st->latency_ms);
+    matrix_mult_scratch_free(st->arena, st->results);
+    free(st);
+}
+
+/* Workers start here, for the largest thread count, so no timed call pays for them */
+static void* prepare_pool(int n, const kernel_opts* opts) {
+    pool_state* st = (pool_state*)calloc(1, sizeof(*st));
+    if (!st) return NULL;
+    st->arena = opts->arena;
+    st->queue = pool_queue(opts);
+    st->rng = 0x9e3779b97f4a7c15ULL;
+    
+    /* Touched here so the timed calls do not fault the pages in */
+    const size_t floats = (st->queue - 1) * (size_t)n * (size_t)n;
+    if (floats > 0) {
+        st->results = (float*)matrix_mult_scratch_alloc(st->arena, floats * sizeof(float));
+        if (!st->results) {
+            release_pool(st);
+            return NULL;
+        }
+        memset(st->results, 0, floats * sizeof(float));
+    }
+    st->latency_ms = (double*)matrix_mult_scratch_alloc(st->arena, POOL_LATENCY_SAMPLES * sizeof(double));
+    st->pool = matrix_mult_pool_create(opts->threads, n, st->arena, opts->cpus, opts->ncpus);
+    if (!st->latency_ms || !st->pool) {
+        release_pool(st);
+        return NULL;
+    }
+    st->threads = matrix_mult_pool_threads(st->pool);
+    return st;
+}
+
+static int compare_double(const void* a, const void* b) {
+    const double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Nearest-rank percentile of count ascending values
+ */
+static double percentile(const double* sorted, size_t count, size_t pct) {
+    const size_t rank = (pct * count + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+/**
+ * @brief Add one request's latency to the run's sample (Algorithm R)
+ */
+static void pool_sample(pool_state* st, double ms) {
+    const size_t seen = st->seen++;
+    if (st->count < POOL_LATENCY_SAMPLES) {
+        st->latency_ms[st->count++] = ms;
+        return;
+    }
+    st->rng ^= st->rng << 13;
+    st->rng ^= st->rng >> 7;
+    st->rng ^= st->rng << 17;
+    const size_t slot = (size_t)(st->rng % (seen + 1));
+    if (slot < POOL_LATENCY_SAMPLES) st->latency_ms[slot] = ms;
+}
+
+static void run_pool(const float* A, const float* B, float* C, int n,
+                     kernel_ctx* ctx) {
+    pool_state* st = (pool_state*)ctx->state;
+    const size_t mn = ctx->m * ctx->n;
+    const size_t queue = st->queue;
+    const int threads = ctx->opts->threads > 0 ? ctx->opts->threads : matrix_mult_max_threads();
+    long long tickets[MATRIX_MULT_POOL_QUEUE];
+    (void)n;
+    
+    /* Smaller sweep entries park the surplus workers instead of restarting the pool */
+    if (threads != st->threads) st->threads = matrix_mult_pool_set_active(st->pool, threads);
+    if (st->finished) {
+        st->count = 0;
+        st->seen = 0;
+        st->finished = 0;
+    }
+    
+    /* The whole queue is in flight at once; request 0 writes the C the harness checks */
+    for (size_t q = 0; q < queue; q++) {
+        tickets[q] = gemm_submit(st->pool, ctx->m, ctx->n, ctx->k, 1.0f, A, ctx->k, B, ctx->n,
+                                 0.0f, q == 0 ? C : st->results + (q - 1) * mn, ctx->n);
+    }
+    for (size_t q = 0; q < queue; q++) {
+        double sec;
+        gemm_wait(st->pool, tickets[q], &sec);
+        pool_sample(st, sec * 1000.0);
+    }
+    ctx->stats.requests = (double)queue;
+}
+
+/* Percentiles over every request of the run, not per call */
+static void finish_pool(void* state, kernel_stats* stats) {
+    pool_state* st = (pool_state*)state;
+    st->finished = 1;
+    if (st->count == 0) return;
+    qsort(st->latency_ms, st->count, sizeof(double), compare_double);
+    stats->lat_p50_ms = percentile(st->latency_ms, st->count, 50);
+    stats->lat_p99_ms = percentile(st->latency_ms, st->count, 99);
+}
+
+static void report_pool(const void* state) {
+    const pool_state* st = (const pool_state*)state;
+    if (st->count == 0) return;
+    printf("    pool: %d of %d workers, %zu requests per call, %zu latencies%s, min %.3f / max %.3f ms\n",
+           st->threads, matrix_mult_pool_threads(st->pool), st->queue, st->seen,
+           st->seen > st->count ? " (sampled)" : "", st->latency_ms[0], st->latency_ms[st->count - 1]);
+}
+
+#ifdef MATRIX_MULT_FIXED
+/* The size is kept only to report which path ran */
+static void* prepare_fixed(int n, const kernel_opts* opts) {
+    int* st = (int*)malloc(sizeof(*st));
+    (void)opts;
+    if (st) *st = n;
+    return st;
+}
+
+static void run_fixed(const float* A, const float* B, float* C, int n,
+                      kernel_ctx* ctx) {
+    (void)ctx;
+    matrix_multiplication_fixed(A, B, C, n);
+}
+
+static void report_fixed(const void* state) {
+    const int n = *(const int*)state;
+    if (matrix_mult_fixed_size(n)) {
+        printf("    fixed: matmul<%d>, specialised at compile time\n", n);
+    } else {
+        printf("    fixed: no matmul<%d> specialisation, ran the runtime-n simd kernel\n", n);
+    }
+}
+#endif
+
+#ifdef MATRIX_MULT_GPU
+static void* prepare_gpu(int n, const kernel_opts* opts) {
+    (void)opts;
+    return matrix_mult_gpu_create(n, 0);
+}
+
+static void* prepare_gpu_blas(int n, const kernel_opts* opts) {
+    (void)opts;
+    return matrix_mult_gpu_create(n, MATRIX_MULT_GPU_BLAS_KERNEL);
+}
+
+static void release_gpu(void* state) {
+    matrix_mult_gpu_destroy((matrix_mult_gpu*)state);
+}
+
+static void run_gpu(const float* A, const float* B, float* C, int n,
+                    kernel_ctx* ctx) {
+    gpu_times t;
+    
+    /* A failed call leaves the stats empty; max_err shows the garbage in C */
+    if (matrix_multiplication_gpu(A, B, C, n, (matrix_mult_gpu*)ctx->state, &t) != 0) return;
+    ctx->stats.h2d_ms = t.h2d_sec * 1000.0;
+    ctx->stats.compute_ms = t.kernel_sec * 1000.0;
+    ctx->stats.d2h_ms = t.d2h_sec * 1000.0;
+}
+#endif
+
+/* ==================== Table ==================== */
+
+static const kernel_entry KERNELS[] = {
+    { .name = "naive", .run = run_naive,
+      .description = "classical i-j-k triple loop (cross-language baseline)" },
+    { .name = "ikj", .run = run_ikj,
+      .description = "loop-interchanged i-k-j order, unit-stride inner loop" },
+    { .name = "tiled", .run = run_tiled,
+      .description = "i/j/k cache blocking with i-j-k order inside tiles",
+      .tunable = KERNEL_TUNE_TILE },
+    { .name = "simd", .run = run_simd,
+      .description = "tiled + register-blocked AVX2/NEON micro-kernel, runtime dispatch",
+      .tunable = KERNEL_TUNE_TILE },
+    { .name = "packed", .run = run_packed,
+      .description = "Goto/BLIS packed A/B panels feeding the SIMD micro-kernel",
+      .prepare = prepare_packed, .release = release_packed, .tunable = KERNEL_TUNE_BLOCKS },
+    { .name = "openmp", .run = run_openmp,
+      .description = "SIMD tiles of C split statically across OpenMP threads",
+      .parallel = 1, .tunable = KERNEL_TUNE_TILE | KERNEL_TUNE_THREADS },
+    { .name = "steal", .run = run_steal,
+      .description = "SIMD tiles of C on per-thread deques with work stealing",
+      .prepare = prepare_steal, .release = free, .parallel = 1, .report = report_steal,
+      .tunable = KERNEL_TUNE_TILE | KERNEL_TUNE_THREADS },
+    { .name = "gemm", .run = run_gemm,
+      .description = "rectangular size_t gemm() on the packed driver (any MxNxK shape)",
+      .prepare = prepare_packed, .release = release_packed, .rectangular = 1,
+      .tunable = KERNEL_TUNE_BLOCKS },
+    { .name = "strassen", .run = run_strassen,
+      .description = "Strassen-Winograd recursion down to --cutoff, then packed gemm()",
+      .prepare = prepare_strassen, .release = release_strassen, .inexact = 1,
+      .tunable = KERNEL_TUNE_CUTOFF },
+    { .name = "fp16", .run = run_mixed,
+      .description = "fp16 operands, fp32 accumulation (F16C/NEON conversions + FMA)",
+      .prepare = prepare_fp16, .release = release_mixed, .inexact = 1, .dtype = MATRIX_MULT_FP16 },
+    { .name = "bf16", .run = run_mixed,
+      .description = "bf16 operands, fp32 accumulation (AVX-512 BF16 / BFDOT dot products)",
+      .prepare = prepare_bf16, .release = release_mixed, .inexact = 1, .dtype = MATRIX_MULT_BF16 },
+    { .name = "fp64", .run = run_mixed,
+      .description = "fp64 operands and accumulation (AVX2 FMA), result rounded to fp32",
+      .prepare = prepare_fp64, .release = release_mixed, .dtype = MATRIX_MULT_FP64 },
+    { .name = "int8", .run = run_mixed,
+      .description = "int8 operands (per-matrix scale), int32 accumulation (VNNI / SDOT)",
+      .prepare = prepare_int8, .release = release_mixed, .inexact = 1, .dtype = MATRIX_MULT_INT8 },
+    { .name = "batch", .run = run_batch,
+      .description = "strided batch of small matrices, fixed-size kernels for 8-64, threads over the batch",
+      .parallel = 1, .batched = 1 },
+    { .name = "batch_ptr", .run = run_batch_ptr,
+      .description = "pointer-array batch (shuffled order), same kernels as batch",
+      .prepare = prepare_batch_ptr, .release = release_batch_ptr, .parallel = 1, .batched = 1 },
+    { .name = "batch_loop", .run = run_batch_loop,
+      .description = "baseline: one simd call per matrix of the batch, single thread",
+      .batched = 1 },
+    { .name = "ooc", .run = run_ooc,
+      .description = "out-of-core gemm: row panels streamed through the --ooc-mib budget",
+      .prepare = prepare_ooc, .release = release_ooc, .report = report_ooc, .rectangular = 1 },
+    { .name = "csr", .run = run_csr,
+      .description = "CSR sparse A x dense B (SpMM), rows across OpenMP threads; see --density",
+      .prepare = prepare_csr, .release = release_csr, .parallel = 1, .report = report_csr,
+      .rectangular = 1 },
+    { .name = "pool", .run = run_pool,
+      .description = "--queue gemm_submit() requests in flight on a persistent thread pool",
+      .prepare = prepare_pool, .release = release_pool, .parallel = 1, .report = report_pool,
+      .rectangular = 1, .finish = finish_pool },
+#ifdef MATRIX_MULT_FIXED
+    { .name = "fixed", .run = run_fixed,
+      .description = "C++ matmul<N> templates for n = 16/32/64/128 (compile-time bounds), else simd",
+      .prepare = prepare_fixed, .release = free, .report = report_fixed },
+#endif
+#ifdef MATRIX_MULT_GPU
+    { .name = "gpu", .run = run_gpu,
+      .description = "CUDA/HIP offload: shared-memory 32x32 tiled kernel, transfers timed apart",
+      .prepare = prepare_gpu, .release = release_gpu },
+    { .name = "gpu_blas", .run = run_gpu,
+      .description = "CUDA/HIP offload through cuBLAS/rocBLAS sgemm (-DMATRIX_MULT_GPU_BLAS)",
+      .prepare = prepare_gpu_blas, .release = release_gpu },
+#endif
+};
+
+const kernel_entry* kernel_table(int* count) {
+    *count = (int)(sizeof(KERNELS) / sizeof(KERNELS[0]));
+    return KERNELS;
+}
+
+const kernel_entry* kernel_find(const char* name) {
+    int count;
+    const kernel_entry* table = kernel_table(&count);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(table[i].name, name) == 0) return &table[i];
+    }
+    return NULL;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file kernel_registry.h
+ * @brief Table of named matrix multiplication kernels for the benchmark harness
+ * 
+ * Every kernel declared in matrix_mult.h is exposed here through one common
+ * function-pointer signature, so the harness can select kernels by name and
+ * time all of them with exactly the same measurement loop.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "matrix_mult.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Tuning options passed to every kernel invocation
+ * 
+ * Kernels ignore the fields that do not apply to them.
+ */
+typedef struct kernel_opts {
+    int tile;       /**< Tile edge for blocked kernels (<= 0 selects the default) */
+    int threads;    /**< Thread count for parallel kernels (<= 0 selects the default; prepare() sees the largest) */
+    int cutoff;     /**< Recursion cutoff for Strassen (<= 0 selects the default) */
+    matrix_mult_arena* arena; /**< Arena for per-size scratch, or NULL for the heap */
+    size_t batch;   /**< Matrices per call for batched kernels (prepare() sees the largest) */
+    int mc, kc, nc; /**< Packing block sizes (<= 0 selects MATRIX_MULT_PACK_MC/KC/NC) */
+    size_t budget;  /**< Memory budget of the out-of-core kernel in bytes (0 selects the default) */
+    int mapped;     /**< Non-zero if A, B and C are file mappings rather than arena memory */
+    size_t queue;   /**< Requests per call of the thread-pool kernel (at most MATRIX_MULT_POOL_QUEUE) */
+    const int* cpus; /**< CPU of thread i under the harness's --bind policy, or NULL if unpinned */
+    int ncpus;      /**< Entries in cpus */
+} kernel_opts;
+
+/**
+ * @brief Optional per-call phase timings reported by a kernel
+ * 
+ * The harness sets every field to -1 before each call; kernels that can
+ * split their run time fill in the phases they measure. Negative values
+ * are written to the CSV as empty fields.
+ */
+typedef struct kernel_stats {
+    double pack_ms;     /**< Time spent packing operands */
+    double compute_ms;  /**< Time spent in the arithmetic kernel */
+    double imbalance;   /**< Max / mean per-thread busy time (1 = perfectly balanced) */
+    double steals;      /**< Tile ranges stolen between threads */
+    double h2d_ms;      /**< Host-to-device copies of an offloading kernel */
+    double d2h_ms;      /**< Device-to-host copy of an offloading kernel */
+    double bytes_read;  /**< Operand bytes an out-of-core kernel copied in */
+    double bytes_written; /**< Result bytes an out-of-core kernel copied out */
+    double requests;    /**< Multiplies completed by the call, when it queues several */
+    double lat_p50_ms;  /**< Median submit-to-completion latency over the run's requests (set by finish) */
+    double lat_p99_ms;  /**< 99th percentile (nearest rank) of the same latencies (set by finish) */
+} kernel_stats;
+
+/**
+ * @brief Per-call context handed to every kernel
+ */
+typedef struct kernel_ctx {
+    const kernel_opts* opts;  /**< Tuning options (never NULL) */
+    void* state;              /**< Per-size state returned by prepare(), or NULL */
+    kernel_stats stats;       /**< Phase timings filled in by the kernel */
+    size_t m, n, k;           /**< Problem shape: A is m×k, B is k×n, C is m×n */
+} kernel_ctx;
+
+/**
+ * @brief Common signature of all registered kernels
+ * 
+ * @param A Pointer to first input matrix (n×n floats, row-major)
+ * @param B Pointer to second input matrix (n×n floats, row-major)
+ * @param C Pointer to output matrix (n×n floats, row-major, will be overwritten)
+ * @param n Dimension of the square matrices, or 0 for a non-square shape
+ * @param ctx Options, per-size state, stats output and shape (never NULL)
+ * 
+ * Square-only kernels are only called when ctx->m == ctx->n == ctx->k == n.
+ * Kernels flagged rectangular read the shape from ctx instead; A, B and C
+ * are then dense row-major m×k, k×n and m×n matrices.
+ */
+typedef void (*kernel_fn)(const float* A, const float* B, float* C, int n,
+                          kernel_ctx* ctx);
+
+/**
+ * @brief Allocate per-size state (scratch buffers) before the timed runs
+ * 
+ * Scratch should come from opts->arena when it is set; the harness rewinds
+ * the arena after release(), so release() must not free arena blocks.
+ * 
+ * @param n Matrix dimension (largest of m, n, k for rectangular shapes)
+ * @return State stored in kernel_ctx::state, or NULL on failure
+ */
+typedef void* (*kernel_prepare_fn)(int n, const kernel_opts* opts);
+
+/**
+ * @brief Release state returned by the matching prepare function
+ */
+typedef void (*kernel_release_fn)(void* state);
+
+/**
+ * @brief Print per-call details (e.g. per-thread load) after a timed run
+ */
+typedef void (*kernel_report_fn)(const void* state);
+
+/**
+ * @brief Turn samples gathered over all calls of a run into run statistics
+ * 
+ * Called outside the timed region after the warm-up calls and after the
+ * calls of every timed run; the next call starts a new sample.
+ */
+typedef void (*kernel_finish_fn)(void* state, kernel_stats* stats);
+
+/** kernel_entry::tunable bits */
+#define KERNEL_TUNE_TILE    0x1     /**< opts->tile */
+#define KERNEL_TUNE_THREADS 0x2     /**< opts->threads */
+#define KERNEL_TUNE_CUTOFF  0x4     /**< opts->cutoff */
+#define KERNEL_TUNE_BLOCKS  0x8     /**< opts->mc, kc and nc */
+
+/**
+ * @brief One entry of the kernel table
+ * 
+ * prepare and release are optional; kernels that need scratch memory
+ * allocate it once per matrix size so the timed runs only measure the
+ * multiply itself. Only kernels with the parallel flag are run for every
+ * entry of the harness's --threads sweep; the others run once, on one thread.
+ * Only kernels with the rectangular flag are run on non-square shapes.
+ * For kernels flagged inexact the harness always measures the max error
+ * against the naive kernel; for the others only when asked to.
+ * Kernels flagged batched multiply opts->batch independent n×n matrices
+ * per call, stored back to back from A, B and C; the harness runs them for
+ * every entry of its --batch sweep.
+ * The optional report hook is called after each run, outside the timed region;
+ * the optional finish hook before it, for statistics over all calls of the run.
+ * The tunable mask lists the options the autotuner (tuning.h) may search.
+ */
+typedef struct kernel_entry {
+    const char* name;           /**< Name used on the command line and in the CSV */
+    kernel_fn run;              /**< Kernel entry point */
+    const char* description;    /**< One-line summary printed by --list-kernels */
+    kernel_prepare_fn prepare;  /**< Per-size setup, or NULL */
+    kernel_release_fn release;  /**< Per-size teardown, or NULL */
+    int parallel;               /**< Non-zero if the kernel honours opts->threads */
+    kernel_report_fn report;    /**< Per-run detail printer, or NULL */
+    int rectangular;            /**< Non-zero if the kernel handles m×k by k×n shapes */
+    int inexact;                /**< Non-zero if it trades accuracy for speed */
+    matrix_mult_dtype dtype;    /**< Element type it computes in (0: MATRIX_MULT_FP32) */
+    int batched;                /**< Non-zero if one call multiplies opts->batch matrices */
+    int tunable;                /**< KERNEL_TUNE_* bits of the options it honours */
+    kernel_finish_fn finish;    /**< Per-run statistics over all calls, or NULL */
+} kernel_entry;
+
+/**
+ * @brief Get the kernel table
+ * @param count Receives the number of entries
+ * @return Pointer to the first entry (static storage, never NULL)
+ */
+const kernel_entry* kernel_table(int* count);
+
+/**
+ * @brief Look up a kernel by name
+ * @param name Kernel name (case-sensitive)
+ * @return Matching entry, or NULL if no kernel has that name
+ */
+const kernel_entry* kernel_find(const char* name);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,253 @@
+/**
+ * @file matrix_file.c
+ * @brief Linux/POSIX and Windows implementations of matrix_file.h
+ *
+ * Build: compiled together with benchmark.c; no extra libraries.
+ */
+
+/* open(), ftruncate() and mmap() are not ISO C; 64-bit offsets on 32-bit hosts */
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+#if !defined(_WIN32) && !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include "matrix_file.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char MAGIC[8] = { 'M', 'M', 'A', 'T', 'R', 'I', 'X', '1' };
+#define ORDER_MARK 0x01020304u
+
+/**
+ * @brief Header fields at the offsets of the table in matrix_file.h
+ */
+typedef struct file_header {
+    char magic[8];
+    uint32_t order;
+    uint32_t dtype;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t offset;
+    unsigned char reserved[24];
+} file_header;
+
+typedef char header_is_64_bytes[sizeof(file_header) == MATRIX_FILE_HEADER_BYTES ? 1 : -1];
+
+/* ==================== Shared helpers ==================== */
+
+/**
+ * @brief Total file length for rows×cols fp32, or 0 on overflow
+ */
+static size_t file_bytes(size_t rows, size_t cols) {
+    if (cols != 0 && rows > (SIZE_MAX - MATRIX_FILE_HEADER_BYTES) / sizeof(float) / cols) return 0;
+    return MATRIX_FILE_HEADER_BYTES + rows * cols * sizeof(float);
+}
+
+/**
+ * @brief Check a mapped header against the file length and fill in the shape
+ */
+static int check_header(matrix_file* f, size_t file_len) {
+    file_header h;
+    if (file_len < sizeof(h)) return MATRIX_FILE_INVALID;
+    memcpy(&h, f->base, sizeof(h));
+    if (memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.order != ORDER_MARK
+        || h.dtype != MATRIX_FILE_FP32 || h.offset != MATRIX_FILE_HEADER_BYTES) {
+        return MATRIX_FILE_INVALID;
+    }
+    if (h.rows > SIZE_MAX || h.cols > SIZE_MAX) return MATRIX_FILE_INVALID;
+    size_t need = file_bytes((size_t)h.rows, (size_t)h.cols);
+    if (need == 0 || need > file_len) return MATRIX_FILE_INVALID;
+    f->rows = (size_t)h.rows;
+    f->cols = (size_t)h.cols;
+    f->data = (float*)((unsigned char*)f->base + MATRIX_FILE_HEADER_BYTES);
+    return 0;
+}
+
+static void write_header(void* base, size_t rows, size_t cols) {
+    file_header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.order = ORDER_MARK;
+    h.dtype = MATRIX_FILE_FP32;
+    h.rows = rows;
+    h.cols = cols;
+    h.offset = MATRIX_FILE_HEADER_BYTES;
+    memcpy(base, &h, sizeof(h));
+}
+
+char* matrix_file_path(char* buf, size_t len, const char* dir, const char* name,
+                       size_t rows, size_t cols, int seed) {
+    int w = seed >= 0 ? snprintf(buf, len, "%s/%s_%zux%zu_s%d.mat", dir, name, rows, cols, seed)
+                      : snprintf(buf, len, "%s/%s_%zux%zu.mat", dir, name, rows, cols);
+    return w >= 0 && (size_t)w < len ? buf : NULL;
+}
+
+#if defined(_WIN32)
+
+/* ==================== Windows ==================== */
+
+/**
+ * @brief Map the first bytes of an open file
+ */
+static int map_view(matrix_file* f, HANDLE file, size_t bytes, int writable) {
+    HANDLE mapping = CreateFileMappingA(file, NULL, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                        (DWORD)((unsigned long long)bytes >> 32), (DWORD)bytes, NULL);
+    if (!mapping) return MATRIX_FILE_ERROR;
+    void* base = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, bytes);
+    if (!base) {
+        CloseHandle(mapping);
+        return MATRIX_FILE_ERROR;
+    }
+    f->base = base;
+    f->handle = (intptr_t)file;
+    f->mapping = (intptr_t)mapping;
+    f->bytes = bytes;
+    f->writable = writable;
+    return 0;
+}
+
+int matrix_file_create(matrix_file* f, const char* path, size_t rows, size_t cols) {
+    size_t bytes = file_bytes(rows, cols);
+    LARGE_INTEGER end;
+    memset(f, 0, sizeof(*f));
+    if (bytes == 0) return MATRIX_FILE_ERROR;
+
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return MATRIX_FILE_ERROR;
+    end.QuadPart = (LONGLONG)bytes;
+    if (!SetFilePointerEx(file, end, NULL, FILE_BEGIN) || !SetEndOfFile(file)
+        || map_view(f, file, bytes, 1) != 0) {
+        CloseHandle(file);
+        memset(f, 0, sizeof(*f));
+        return MATRIX_FILE_ERROR;
+    }
+    write_header(f->base, rows, cols);
+    f->rows = rows;
+    f->cols = cols;
+    f->data = (float*)((unsigned char*)f->base + MATRIX_FILE_HEADER_BYTES);
+    return 0;
+}
+
+int matrix_file_open(matrix_file* f, const char* path, int writable) {
+    LARGE_INTEGER len;
+    memset(f, 0, sizeof(*f));
+    HANDLE file = CreateFileA(path, GENERIC_READ | (writable ? GENERIC_WRITE : 0), FILE_SHARE_READ,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        DWORD err = GetLastError();
+        return err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND ? MATRIX_FILE_MISSING
+                                                                          : MATRIX_FILE_ERROR;
+    }
+    if (!GetFileSizeEx(file, &len) || len.QuadPart < MATRIX_FILE_HEADER_BYTES
+        || (unsigned long long)len.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return MATRIX_FILE_INVALID;
+    }
+    if (map_view(f, file, (size_t)len.QuadPart, writable) != 0) {
+        CloseHandle(file);
+        memset(f, 0, sizeof(*f));
+        return MATRIX_FILE_ERROR;
+    }
+    int status = check_header(f, (size_t)len.QuadPart);
+    if (status != 0) matrix_file_close(f);
+    return status;
+}
+
+int matrix_file_flush(matrix_file* f) {
+    if (!f->base || !f->writable) return 0;
+    return FlushViewOfFile(f->base, f->bytes) && FlushFileBuffers((HANDLE)f->handle) ? 0 : -1;
+}
+
+void matrix_file_close(matrix_file* f) {
+    if (f->base) {
+        matrix_file_flush(f);
+        UnmapViewOfFile(f->base);
+    }
+    if (f->mapping) CloseHandle((HANDLE)f->mapping);
+    if (f->handle) CloseHandle((HANDLE)f->handle);
+    memset(f, 0, sizeof(*f));
+}
+
+#else /* Linux / POSIX */
+
+/* ==================== Linux / POSIX ==================== */
+
+static int map_fd(matrix_file* f, int fd, size_t bytes, int writable) {
+    void* base = mmap(NULL, bytes, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) return MATRIX_FILE_ERROR;
+    f->base = base;
+    f->handle = fd;
+    f->bytes = bytes;
+    f->writable = writable;
+    return 0;
+}
+
+int matrix_file_create(matrix_file* f, const char* path, size_t rows, size_t cols) {
+    size_t bytes = file_bytes(rows, cols);
+    memset(f, 0, sizeof(*f));
+    f->handle = -1;
+    if (bytes == 0) return MATRIX_FILE_ERROR;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return MATRIX_FILE_ERROR;
+    if (ftruncate(fd, (off_t)bytes) != 0 || map_fd(f, fd, bytes, 1) != 0) {
+        close(fd);
+        f->handle = -1;
+        return MATRIX_FILE_ERROR;
+    }
+    write_header(f->base, rows, cols);
+    f->rows = rows;
+    f->cols = cols;
+    f->data = (float*)((unsigned char*)f->base + MATRIX_FILE_HEADER_BYTES);
+    return 0;
+}
+
+int matrix_file_open(matrix_file* f, const char* path, int writable) {
+    struct stat st;
+    memset(f, 0, sizeof(*f));
+    f->handle = -1;
+    int fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) return errno == ENOENT ? MATRIX_FILE_MISSING : MATRIX_FILE_ERROR;
+    if (fstat(fd, &st) != 0 || st.st_size < MATRIX_FILE_HEADER_BYTES
+        || (unsigned long long)st.st_size > SIZE_MAX) {
+        close(fd);
+        return MATRIX_FILE_INVALID;
+    }
+    if (map_fd(f, fd, (size_t)st.st_size, writable) != 0) {
+        close(fd);
+        return MATRIX_FILE_ERROR;
+    }
+    int status = check_header(f, (size_t)st.st_size);
+    if (status != 0) matrix_file_close(f);
+    return status;
+}
+
+int matrix_file_flush(matrix_file* f) {
+    if (!f->base || !f->writable) return 0;
+    return msync(f->base, f->bytes, MS_SYNC) == 0 ? 0 : -1;
+}
+
+void matrix_file_close(matrix_file* f) {
+    if (f->base) {
+        matrix_file_flush(f);
+        munmap(f->base, f->bytes);
+    }
+    if (f->handle >= 0) close((int)f->handle);
+    memset(f, 0, sizeof(*f));
+    f->handle = -1;
+}
+
+#endif
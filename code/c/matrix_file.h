@@ -0,0 +1,100 @@
+/**
+ * @file matrix_file.h
+ * @brief Memory-mapped binary matrix files shared by the harnesses
+ *
+ * A matrix file is a 64-byte header followed by the elements, row-major:
+ *
+ * | Offset | Size | Field                                                |
+ * |--------|------|------------------------------------------------------|
+ * | 0      | 8    | magic "MMATRIX1"                                     |
+ * | 8      | 4    | byte-order mark 0x01020304, in the writer's order    |
+ * | 12     | 4    | element type: 0 = fp32 (the only one written so far) |
+ * | 16     | 8    | rows                                                 |
+ * | 24     | 8    | columns                                              |
+ * | 32     | 8    | offset of element 0 (64)                             |
+ * | 40     | 24   | reserved, zero                                       |
+ *
+ * Integers and elements are in the writer's byte order; readers check the
+ * mark and reject files from a host of the other order rather than
+ * swapping. Element (i, j) is at offset + 4*(i*columns + j), so the payload
+ * can be mapped and used in place: benchmark.c maps A and B read-only and
+ * C read-write instead of allocating them, which lifts the operands'
+ * size limit from RAM to disk (see gemm_ooc()) and lets the Java and
+ * Python harnesses read exactly the inputs the C benchmark generated.
+ *
+ * | Function    | Linux / POSIX         | Windows                              |
+ * |-------------|-----------------------|--------------------------------------|
+ * | map         | open + mmap MAP_SHARED| CreateFile + CreateFileMapping + MapViewOfFile |
+ * | grow (new)  | ftruncate             | SetFilePointerEx + SetEndOfFile      |
+ * | flush       | msync(MS_SYNC)        | FlushViewOfFile + FlushFileBuffers   |
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Bytes before element 0 */
+#define MATRIX_FILE_HEADER_BYTES 64
+
+/** Element type codes of the header */
+#define MATRIX_FILE_FP32 0
+
+/** matrix_file_open() outcomes besides 0 */
+#define MATRIX_FILE_MISSING (-1)    /**< No such file */
+#define MATRIX_FILE_INVALID (-2)    /**< Not a matrix file, other byte order or type, or truncated */
+#define MATRIX_FILE_ERROR   (-3)    /**< The OS refused to open or map it */
+
+/**
+ * @brief One mapped matrix file
+ */
+typedef struct matrix_file {
+    float* data;        /**< Element 0 inside the mapping */
+    size_t rows;        /**< Rows from the header */
+    size_t cols;        /**< Columns from the header */
+    int writable;       /**< Non-zero if mapped read-write */
+    void* base;         /**< Start of the mapping (the header) */
+    size_t bytes;       /**< Mapped length: header plus payload */
+    intptr_t handle;    /**< File descriptor (POSIX) or HANDLE (Windows) */
+    intptr_t mapping;   /**< File-mapping HANDLE (Windows only) */
+} matrix_file;
+
+/**
+ * @brief Create (or truncate) a rows×cols fp32 file and map it read-write
+ * @return 0 on success, MATRIX_FILE_ERROR otherwise; the payload reads as zero
+ */
+int matrix_file_create(matrix_file* f, const char* path, size_t rows, size_t cols);
+
+/**
+ * @brief Map an existing matrix file
+ * @param writable Non-zero to map it read-write (changes reach the file)
+ * @return 0, MATRIX_FILE_MISSING, MATRIX_FILE_INVALID or MATRIX_FILE_ERROR
+ */
+int matrix_file_open(matrix_file* f, const char* path, int writable);
+
+/**
+ * @brief Write a read-write mapping's changes through to the file
+ * @return 0 on success, -1 on failure (read-only mappings always succeed)
+ */
+int matrix_file_flush(matrix_file* f);
+
+/**
+ * @brief Flush (if writable) and unmap; the struct is zeroed
+ */
+void matrix_file_close(matrix_file* f);
+
+/**
+ * @brief Path of a benchmark operand file: <dir>/<name>_<rows>x<cols>[_s<seed>].mat
+ * @param seed Seed of a generated input; negative omits it (results)
+ * @return buf, or NULL if the path does not fit
+ */
+char* matrix_file_path(char* buf, size_t len, const char* dir, const char* name,
+                       size_t rows, size_t cols, int seed);
+
+#ifdef __cplusplus
+}
+#endif
@@ -11,6 +11,9 @@
  * - Parallel execution
  * 
  * This ensures a fair baseline comparison across programming languages.
+ * 
+ * The optimised variants in this file (e.g. the tiled kernel) are provided
+ * as separate entry points so the baseline above stays untouched.
  */
 
 #include "matrix_mult.h"
@@ -51,4 +54,87 @@ void matrix_multiplication(const float* A, const float* B, float* C, int n) {
             C[row + j] = acc;
         }
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Multiply two square matrices using the loop-interchanged i-k-j order
+ * 
+ * Implementation details:
+ * - Row i of C is cleared, then receives A[i,k] * (row k of B) for every k
+ * - The inner j loop reads B[k*n + j] and updates C[row + j] with unit
+ *   stride, replacing the column walk of the baseline
+ * - The inner loop has no loop-carried dependency, so it auto-vectorises
+ * 
+ * @param A Pointer to first input matrix (n×n floats, row-major)
+ * @param B Pointer to second input matrix (n×n floats, row-major)
+ * @param C Pointer to output matrix (n×n floats, row-major, will be overwritten)
+ * @param n Dimension of the square matrices
+ */
+void matrix_multiplication_ikj(const float* A, const float* B, float* C, int n) {
+    for (int i = 0; i < n; i++) {               /* Iterate over rows of A and C */
+        int row = i * n;                        /* Precompute row offset for A and C */
+        float* c_row = C + row;
+        
+        for (int j = 0; j < n; j++) c_row[j] = 0.0f;
+        
+        for (int k = 0; k < n; k++) {           /* Iterate over common dimension */
+            float a = A[row + k];               /* Broadcast A[i,k] */
+            const float* b_row = B + k * n;     /* Row k of B */
+            
+            for (int j = 0; j < n; j++) {       /* Stream along row k of B */
+                c_row[j] += a * b_row[j];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Multiply two square matrices using i/j/k cache blocking
+ * 
+ * Implementation details:
+ * - C is cleared first, then every (ii, kk, jj) block step accumulates the
+ *   partial product of one tile of A and one tile of B into one tile of C
+ * - The kk loop sits between ii and jj so the A tile is reused across the
+ *   whole row of C tiles before moving on
+ * - Inside a block the loop order is i-j-k, matching matrix_multiplication()
+ * - Block bounds are clipped at n, so any n is accepted
+ * 
+ * @param A Pointer to first input matrix (n×n floats, row-major)
+ * @param B Pointer to second input matrix (n×n floats, row-major)
+ * @param C Pointer to output matrix (n×n floats, row-major, will be overwritten)
+ * @param n Dimension of the square matrices
+ * @param tile Tile edge in elements (<= 0 selects MATRIX_MULT_DEFAULT_TILE)
+ */
+void matrix_multiplication_tiled(const float* A, const float* B, float* C, int n, int tile) {
+    if (tile <= 0) tile = MATRIX_MULT_DEFAULT_TILE;
+    
+    /* Partial products are accumulated across k-blocks, so start from zero */
+    for (int i = 0; i < n * n; i++) C[i] = 0.0f;
+    
+    for (int ii = 0; ii < n; ii += tile) {          /* Block row of A and C */
+        int i_end = ii + tile < n ? ii + tile : n;
+        
+        for (int kk = 0; kk < n; kk += tile) {      /* Block of the common dimension */
+            int k_end = kk + tile < n ? kk + tile : n;
+            
+            for (int jj = 0; jj < n; jj += tile) {  /* Block column of B and C */
+                int j_end = jj + tile < n ? jj + tile : n;
+                
+                /* Multiply the A[ii.., kk..] tile by the B[kk.., jj..] tile */
+                for (int i = ii; i < i_end; i++) {
+                    int row = i * n;
+                    
+                    for (int j = jj; j < j_end; j++) {
+                        float acc = C[row + j];     /* Resume the partial sum */
+                        
+                        for (int k = kk; k < k_end; k++) {
+                            acc += A[row + k] * B[k * n + j];
+                        }
+                        
+                        C[row + j] = acc;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -1,15 +1,33 @@
 
 /**
  * @file matrix_mult.h
- * @brief Header file for basic matrix multiplication implementation
+ * @brief Public API of the C matrix multiplication kernels
  * 
- * This header declares the matrix multiplication function using the
- * classical triple-loop algorithm. The implementation is designed for
- * benchmarking purposes and intentionally avoids SIMD or other optimizations.
+ * Every matrix is fp32 and row-major unless its declaration says otherwise.
+ * The header declares, in order:
+ * - Square n×n kernels computing C = A × B: the classical triple loop
+ *   matrix_multiplication() (the unoptimised baseline that the others are
+ *   checked against), loop-interchanged, tiled, SIMD, Strassen, OpenMP
+ *   and work-stealing variants, the packed kernel and typed fp16, bf16,
+ *   fp64 and int8 variants
+ * - Rectangular gemm(), C = alpha*A*B + beta*C for an m×k A and a k×n B
+ *   with leading dimensions lda, ldb and ldc
+ * - Batched kernels that multiply many small n×n matrices per call, as
+ *   strided arrays or as pointer arrays
+ * - Out-of-core gemm_ooc(), which streams operands through a fixed budget
+ * - spmm_csr(), a CSR sparse A times a dense B
+ * - A persistent thread pool with asynchronous gemm_submit()/gemm_wait()
+ * 
+ * It also declares the scratch objects the kernels reuse across calls: the
+ * memory arena and the packing, Strassen, mixed-precision and out-of-core
+ * workspaces.
  */
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -48,6 +66,774 @@ extern "C" {
  */
 void matrix_multiplication(const float* A, const float* B, float* C, int n);
 
+/**
+ * @brief Multiply two square matrices with the loops interchanged to i-k-j
+ * 
+ * Computes the same C = A × B as matrix_multiplication(), but the innermost
+ * loop runs over j: A[i,k] is broadcast while row k of B and row i of C are
+ * streamed with unit stride. No blocking or intrinsics are used, so the
+ * difference to the baseline measures what memory layout alone buys
+ * (including whatever the compiler auto-vectorises).
+ * 
+ * @param A Pointer to first input matrix (n×n elements in row-major order)
+ * @param B Pointer to second input matrix (n×n elements in row-major order)
+ * @param C Pointer to output matrix (n×n elements, will be overwritten)
+ * @param n Dimension of the square matrices (all are n×n)
+ */
+void matrix_multiplication_ikj(const float* A, const float* B, float* C, int n);
+
+/** Default tile edge used by matrix_multiplication_tiled() when tile <= 0 */
+#define MATRIX_MULT_DEFAULT_TILE 64
+
+/**
+ * @brief Multiply two square matrices using cache blocking (tiling)
+ * 
+ * Computes the same C = A × B as matrix_multiplication(), but iterates over
+ * tile×tile blocks of i, j and k so that the working set of one block step
+ * (one tile of A, B and C) stays resident in L1/L2. Inside a block the loop
+ * order is the same i-j-k as the baseline, so the difference in run time
+ * measures cache behaviour rather than a change of algorithm.
+ * 
+ * With the default tile of 64, three tiles occupy 48 KiB, which targets L2
+ * on current desktop and server cores; a tile of 32 (12 KiB) targets L1.
+ * 
+ * @param A Pointer to first input matrix (n×n elements in row-major order)
+ * @param B Pointer to second input matrix (n×n elements in row-major order)
+ * @param C Pointer to output matrix (n×n elements, will be overwritten)
+ * @param n Dimension of the square matrices (all are n×n)
+ * @param tile Tile edge in elements; values <= 0 select MATRIX_MULT_DEFAULT_TILE
+ * 
+ * @note n does not need to be a multiple of tile; edge blocks are clipped
+ */
+void matrix_multiplication_tiled(const float* A, const float* B, float* C, int n, int tile);
+
+/**
+ * @brief Multiply two square matrices with a register-blocked SIMD micro-kernel
+ * 
+ * Uses the same i/j/k tiling as matrix_multiplication_tiled(), but each
+ * tile product is computed by a micro-kernel that holds an MR×NR block of C
+ * in vector registers: 6×16 with AVX2/FMA, 8×8 with NEON, or a portable
+ * 4×8 scalar fallback. The implementation is selected once at first call
+ * from the CPU's reported features (see matrix_mult_simd_isa()).
+ * 
+ * @param A Pointer to first input matrix (n×n elements in row-major order)
+ * @param B Pointer to second input matrix (n×n elements in row-major order)
+ * @param C Pointer to output matrix (n×n elements, will be overwritten)
+ * @param n Dimension of the square matrices (all are n×n)
+ * @param tile Tile edge in elements; values <= 0 select MATRIX_MULT_DEFAULT_TILE
+ * 
+ * @note Results may differ from the baseline in the last bits because FMA
+ *       and the blocked summation order round differently
+ */
+void matrix_multiplication_simd(const float* A, const float* B, float* C, int n, int tile);
+
+/**
+ * @brief Name of the micro-kernel selected for this CPU
+ * 
+ * Set the environment variable MATRIX_MULT_ISA=scalar before the first call
+ * to force the portable fallback.
+ * 
+ * @return "avx2", "neon" or "scalar" (static string)
+ */
+const char* matrix_mult_simd_isa(void);
+
+/** Huge page kinds reported by matrix_mult_arena_huge_pages() */
+#define MATRIX_MULT_HUGE_NONE        0  /**< Regular pages */
+#define MATRIX_MULT_HUGE_TRANSPARENT 1  /**< Transparent huge pages requested (madvise) */
+#define MATRIX_MULT_HUGE_EXPLICIT    2  /**< Reserved huge pages (MAP_HUGETLB / MEM_LARGE_PAGES) */
+
+/** matrix_mult_arena_create() flag: try to back the arena with huge pages */
+#define MATRIX_MULT_ARENA_HUGE_PAGES 0x1
+
+/** matrix_mult_arena_create() flag: touch every page at creation */
+#define MATRIX_MULT_ARENA_PREFAULT   0x2
+
+/**
+ * @brief Bump allocator over one preallocated region
+ * 
+ * Every block is 64-byte aligned. Blocks are not freed individually;
+ * record matrix_mult_arena_mark() before a group of allocations and hand
+ * it to matrix_mult_arena_release() afterwards. Not thread-safe.
+ */
+typedef struct matrix_mult_arena matrix_mult_arena;
+
+/**
+ * @brief Map an arena region
+ * 
+ * @param bytes Usable capacity
+ * @param flags Bitwise OR of MATRIX_MULT_ARENA_HUGE_PAGES and
+ *              MATRIX_MULT_ARENA_PREFAULT, or 0
+ * @return New arena, or NULL if the region cannot be mapped
+ * 
+ * Huge pages are best effort; the arena silently falls back to regular
+ * pages when the system does not provide them.
+ */
+matrix_mult_arena* matrix_mult_arena_create(size_t bytes, int flags);
+
+/**
+ * @brief Unmap an arena and everything allocated from it (NULL is ignored)
+ */
+void matrix_mult_arena_destroy(matrix_mult_arena* arena);
+
+/**
+ * @brief Allocate a 64-byte aligned block
+ * @return Block inside the arena, or NULL if it does not fit (or arena is NULL)
+ */
+void* matrix_mult_arena_alloc(matrix_mult_arena* arena, size_t bytes);
+
+/**
+ * @brief Current allocation offset, to be passed to matrix_mult_arena_release()
+ */
+size_t matrix_mult_arena_mark(const matrix_mult_arena* arena);
+
+/**
+ * @brief Free every block allocated after the given mark
+ */
+void matrix_mult_arena_release(matrix_mult_arena* arena, size_t mark);
+
+/**
+ * @brief Hand the physical pages above a mark back to the OS
+ * @param arena Arena (NULL is ignored)
+ * @param mark Offset from matrix_mult_arena_mark(); pages holding bytes below it stay
+ * @return Non-zero if pages were discarded, 0 where the OS or mapping cannot
+ *
+ * The region stays mapped: the next write faults in a zeroed page on the
+ * NUMA node of the writing thread, so a caller can place each size's
+ * operands afresh instead of reusing pages the prefault put on one node.
+ */
+int matrix_mult_arena_discard(matrix_mult_arena* arena, size_t mark);
+
+/**
+ * @brief Whether p points into the arena's region
+ */
+int matrix_mult_arena_owns(const matrix_mult_arena* arena, const void* p);
+
+/**
+ * @brief Usable capacity in bytes
+ */
+size_t matrix_mult_arena_capacity(const matrix_mult_arena* arena);
+
+/**
+ * @brief Largest number of bytes in use at any time since creation
+ */
+size_t matrix_mult_arena_high_water(const matrix_mult_arena* arena);
+
+/**
+ * @brief Kind of pages backing the arena (MATRIX_MULT_HUGE_*)
+ */
+int matrix_mult_arena_huge_pages(const matrix_mult_arena* arena);
+
+/** Default size at and below which Strassen recursion hands over to gemm() */
+#define MATRIX_MULT_STRASSEN_CUTOFF 512
+
+/** Workspace (arena of recursion temporaries) for matrix_multiplication_strassen() */
+typedef struct matrix_mult_strassen matrix_mult_strassen;
+
+/**
+ * @brief Allocate the recursion workspace for matrices up to n×n
+ * 
+ * All temporaries of all recursion levels come from one buffer of about
+ * (2/3)·n² floats, allocated here so the multiply itself never allocates.
+ * 
+ * @param n Largest matrix dimension the workspace will serve
+ * @param cutoff Recurse while the block edge exceeds this; values <= 0
+ *               select MATRIX_MULT_STRASSEN_CUTOFF
+ * @param arena Arena to allocate from (heap if NULL or full)
+ * @return New workspace, or NULL if allocation fails
+ */
+matrix_mult_strassen* matrix_mult_strassen_create(int n, int cutoff, matrix_mult_arena* arena);
+
+/**
+ * @brief Release a workspace from matrix_mult_strassen_create() (NULL is ignored)
+ */
+void matrix_mult_strassen_destroy(matrix_mult_strassen* ws);
+
+/**
+ * @brief Multiply two square matrices with Strassen-Winograd recursion
+ * 
+ * Performs 7 half-size products per level instead of 8 down to the
+ * workspace's cutoff, then uses the packed SIMD gemm(). Odd sizes are
+ * handled by peeling the last row and column.
+ * 
+ * @param A Pointer to first input matrix (n×n elements in row-major order)
+ * @param B Pointer to second input matrix (n×n elements in row-major order)
+ * @param C Pointer to output matrix (n×n elements, will be overwritten)
+ * @param n Dimension of the square matrices (all are n×n)
+ * @param ws Workspace from matrix_mult_strassen_create(n, cutoff), or NULL
+ *           to allocate one with the default cutoff for this call
+ * 
+ * @note Trades accuracy for speed: the error grows with the number of
+ *       recursion levels and is noticeably larger than the classical kernels'
+ */
+void matrix_multiplication_strassen(const float* A, const float* B, float* C, int n,
+                                    matrix_mult_strassen* ws);
+
+/**
+ * @brief Multiply two square matrices with the C tile grid split across threads
+ * 
+ * Each thread computes whole tiles of C with the SIMD micro-kernel, using
+ * a static OpenMP schedule. When built without OpenMP the kernel runs on
+ * the calling thread.
+ * 
+ * @param A Pointer to first input matrix (n×n elements in row-major order)
+ * @param B Pointer to second input matrix (n×n elements in row-major order)
+ * @param C Pointer to output matrix (n×n elements, will be overwritten)
+ * @param n Dimension of the square matrices (all are n×n)
+ * @param tile Tile edge in elements; values <= 0 select MATRIX_MULT_DEFAULT_TILE
+ * @param threads Number of threads; values <= 0 use matrix_mult_max_threads()
+ */
+void matrix_multiplication_parallel(const float* A, const float* B, float* C, int n,
+                                    int tile, int threads);
+
+/** Largest thread count matrix_multiplication_stealing() will use */
+#define MATRIX_MULT_MAX_THREADS 256
+
+/**
+ * @brief Per-thread load statistics of one matrix_multiplication_stealing() call
+ * 
+ * Only the first `threads` entries of each array are valid.
+ */
+typedef struct matrix_mult_sched_stats {
+    int threads;                                /**< Threads that took part */
+    double busy_sec[MATRIX_MULT_MAX_THREADS];   /**< Time spent computing tiles */
+    int tiles[MATRIX_MULT_MAX_THREADS];         /**< Tiles computed */
+    int steals[MATRIX_MULT_MAX_THREADS];        /**< Successful steals */
+} matrix_mult_sched_stats;
+
+/**
+ * @brief Multiply two square matrices with a work-stealing tile scheduler
+ * 
+ * Same tiles and micro-kernel as matrix_multiplication_parallel(), but each
+ * thread starts with its own deque of C tiles and, once it runs out, steals
+ * half of the remaining tiles of another thread. This keeps all threads busy
+ * when tiles differ in cost (ragged edges) or when some cores are shared
+ * with other processes.
+ * 
+ * @param A Pointer to first input matrix (n×n elements in row-major order)
+ * @param B Pointer to second input matrix (n×n elements in row-major order)
+ * @param C Pointer to output matrix (n×n elements, will be overwritten)
+ * @param n Dimension of the square matrices (all are n×n)
+ * @param tile Tile edge in elements; values <= 0 select MATRIX_MULT_DEFAULT_TILE
+ * @param threads Number of threads; values <= 0 use matrix_mult_max_threads(),
+ *                values above MATRIX_MULT_MAX_THREADS are clamped
+ * @param stats Receives per-thread busy time, tiles and steals (may be NULL)
+ */
+void matrix_multiplication_stealing(const float* A, const float* B, float* C, int n,
+                                    int tile, int threads, matrix_mult_sched_stats* stats);
+
+/**
+ * @brief Default thread count of the parallel kernels
+ * @return OpenMP's maximum thread count, or 1 when built without OpenMP
+ */
+int matrix_mult_max_threads(void);
+
+/** Default block sizes of the packed kernel (rounded to the micro-kernel shape) */
+#define MATRIX_MULT_PACK_MC 96      /**< Rows of A per packed block (L2 resident) */
+#define MATRIX_MULT_PACK_KC 256     /**< Depth of each packed slice (L1 resident sliver) */
+#define MATRIX_MULT_PACK_NC 2048    /**< Columns of B per packed panel (L3 resident) */
+
+/**
+ * @brief Opaque packing buffers for matrix_multiplication_packed()
+ * 
+ * Holds one aligned MC×KC block of A and one KC×NC panel of B, plus the
+ * time spent packing and computing since the last reset.
+ */
+typedef struct matrix_mult_pack matrix_mult_pack;
+
+/**
+ * @brief Allocate packing buffers sized for matrices around n×n
+ * 
+ * The buffers work for any problem size; n only caps the block sizes so
+ * small problems do not allocate full-size panels.
+ * 
+ * @param n Typical largest matrix dimension the buffers will serve
+ * @param mc Rows of A per block (<= 0 selects MATRIX_MULT_PACK_MC)
+ * @param kc Depth of each slice (<= 0 selects MATRIX_MULT_PACK_KC)
+ * @param nc Columns of B per panel (<= 0 selects MATRIX_MULT_PACK_NC)
+ * @param arena Arena to allocate from (heap if NULL or full)
+ * @return New buffers, or NULL if allocation fails
+ */
+matrix_mult_pack* matrix_mult_pack_create(int n, int mc, int kc, int nc,
+                                          matrix_mult_arena* arena);
+
+/**
+ * @brief Free buffers from matrix_mult_pack_create() (NULL is ignored)
+ */
+void matrix_mult_pack_destroy(matrix_mult_pack* pack);
+
+/**
+ * @brief Reset the accumulated packing and compute times to zero
+ */
+void matrix_mult_pack_reset_times(matrix_mult_pack* pack);
+
+/**
+ * @brief Read the packing and compute time accumulated since the last reset
+ * @param pack Buffers passed to matrix_multiplication_packed()
+ * @param pack_sec Receives seconds spent packing A and B (may be NULL)
+ * @param compute_sec Receives seconds spent outside packing (may be NULL)
+ */
+void matrix_mult_pack_times(const matrix_mult_pack* pack, double* pack_sec, double* compute_sec);
+
+/**
+ * @brief Multiply two square matrices through packed, aligned A and B panels
+ * 
+ * Goto/BLIS-style blocking on top of the SIMD micro-kernel: panels of B and
+ * blocks of A are copied into contiguous buffers in the order the
+ * micro-kernel consumes them, so its loads are unit stride for any n.
+ * 
+ * @param A Pointer to first input matrix (n×n elements in row-major order)
+ * @param B Pointer to second input matrix (n×n elements in row-major order)
+ * @param C Pointer to output matrix (n×n elements, will be overwritten)
+ * @param n Dimension of the square matrices (all are n×n)
+ * @param pack Buffers from matrix_mult_pack_create(n, ...) reused across
+ *             calls, or NULL to allocate temporary buffers for this call
+ */
+void matrix_multiplication_packed(const float* A, const float* B, float* C, int n,
+                                  matrix_mult_pack* pack);
+
+/**
+ * @brief General single-precision matrix multiply: C = alpha*A*B + beta*C
+ * 
+ * A is m×k, B is k×n and C is m×n, all row-major inside possibly larger
+ * buffers: element (i,j) of A is at A[i*lda + j], and likewise for B
+ * (ldb) and C (ldc). All indexing uses size_t, so dimensions and offsets
+ * are not limited by int.
+ * 
+ * Uses the packed-panel driver and SIMD micro-kernel of
+ * matrix_multiplication_packed(), with packing buffers allocated per call.
+ * 
+ * @param m Rows of A and C
+ * @param n Columns of B and C
+ * @param k Columns of A and rows of B
+ * @param alpha Scale applied to A*B
+ * @param A Pointer to the first element of A
+ * @param lda Row stride of A in elements (>= k)
+ * @param B Pointer to the first element of B
+ * @param ldb Row stride of B in elements (>= n)
+ * @param beta Scale applied to the previous C; when 0, C is not read
+ * @param C Pointer to the first element of C
+ * @param ldc Row stride of C in elements (>= n)
+ * 
+ * @example
+ * // Update the top-left 2×2 block of a 4×4 buffer: C = A*B + C
+ * gemm(2, 2, 3, 1.0f, A, 3, B, 2, 1.0f, C4x4, 4);
+ */
+void gemm(size_t m, size_t n, size_t k, float alpha,
+          const float* A, size_t lda, const float* B, size_t ldb,
+          float beta, float* C, size_t ldc);
+
+/**
+ * @brief gemm() with caller-owned packing buffers reused across calls
+ * 
+ * @param pack Buffers from matrix_mult_pack_create(), or NULL for per-call buffers
+ * 
+ * The phase times of the call are added to the buffers' packing and compute
+ * timers (see matrix_mult_pack_times()).
+ */
+void gemm_with_pack(size_t m, size_t n, size_t k, float alpha,
+                    const float* A, size_t lda, const float* B, size_t ldb,
+                    float beta, float* C, size_t ldc, matrix_mult_pack* pack);
+
+/**
+ * @brief Element types of the mixed-precision kernels
+ */
+typedef enum matrix_mult_dtype {
+    MATRIX_MULT_FP32 = 0,   /**< IEEE binary32, the type of every other kernel */
+    MATRIX_MULT_FP16,       /**< IEEE binary16 inputs, fp32 accumulation and output */
+    MATRIX_MULT_BF16,       /**< bfloat16 inputs, fp32 accumulation and output */
+    MATRIX_MULT_FP64,       /**< IEEE binary64 inputs, accumulation and output */
+    MATRIX_MULT_INT8        /**< int8 inputs, int32 accumulation and output */
+} matrix_mult_dtype;
+
+/**
+ * @brief Short name of a dtype ("fp32", "fp16", "bf16", "fp64", "int8")
+ */
+const char* matrix_mult_dtype_name(matrix_mult_dtype dtype);
+
+/**
+ * @brief Bytes per input element of a dtype
+ */
+size_t matrix_mult_dtype_size(matrix_mult_dtype dtype);
+
+/** @brief Round a float to IEEE binary16 bits (nearest, ties to even; overflow gives Inf) */
+uint16_t matrix_mult_to_fp16(float x);
+
+/** @brief Widen IEEE binary16 bits to float (exact) */
+float matrix_mult_from_fp16(uint16_t h);
+
+/** @brief Round a float to bfloat16 bits (nearest, ties to even) */
+uint16_t matrix_mult_to_bf16(float x);
+
+/** @brief Widen bfloat16 bits to float (exact) */
+float matrix_mult_from_bf16(uint16_t h);
+
+/**
+ * @brief Quantize to int8 with one symmetric scale for the whole array
+ * @param x Values to quantize
+ * @param q Receives x / scale rounded to nearest (ties away from zero),
+ *          clamped to [-127, 127]
+ * @param len Number of elements
+ * @return The scale max|x| / 127 (1 if every x is zero); x ~ q * scale
+ */
+float matrix_mult_quantize_int8(const float* x, int8_t* q, size_t len);
+
+/**
+ * @brief Kernel path a dtype uses on this CPU (detected once, on first call)
+ * @return "avx512-bf16", "avx512-vnni", "f16c", "avx2", "neon", "neon-bf16",
+ *         "neon-dotprod" or "scalar" (portable i-k-j); MATRIX_MULT_FP32
+ *         reports matrix_mult_simd_isa()
+ */
+const char* matrix_mult_mixed_isa(matrix_mult_dtype dtype);
+
+/**
+ * @brief Converted operands and scratch for matrix_multiplication_mixed()
+ */
+typedef struct matrix_mult_mixed matrix_mult_mixed;
+
+/**
+ * @brief Multiply two square fp16 matrices, accumulating in fp32
+ * 
+ * @param A First input matrix (n×n binary16 bit patterns, row-major)
+ * @param B Second input matrix (n×n binary16 bit patterns, row-major)
+ * @param C Output matrix (n×n floats, will be overwritten)
+ * @param n Dimension of the square matrices
+ */
+void matrix_multiplication_fp16(const uint16_t* A, const uint16_t* B, float* C, int n);
+
+/**
+ * @brief Multiply two square bf16 matrices, accumulating in fp32
+ * 
+ * @param A First input matrix (n×n bfloat16 bit patterns, row-major)
+ * @param B Second input matrix (n×n bfloat16 bit patterns, row-major)
+ * @param C Output matrix (n×n floats, will be overwritten)
+ * @param n Dimension of the square matrices
+ * @param ws Workspace from matrix_mult_mixed_create(>= n, MATRIX_MULT_BF16)
+ *           for the interleaved copy of B, or NULL to allocate it per call
+ */
+void matrix_multiplication_bf16(const uint16_t* A, const uint16_t* B, float* C, int n,
+                                matrix_mult_mixed* ws);
+
+/**
+ * @brief Multiply two square fp64 matrices
+ * 
+ * @param A First input matrix (n×n doubles, row-major)
+ * @param B Second input matrix (n×n doubles, row-major)
+ * @param C Output matrix (n×n doubles, will be overwritten)
+ * @param n Dimension of the square matrices
+ */
+void matrix_multiplication_fp64(const double* A, const double* B, double* C, int n);
+
+/**
+ * @brief Multiply two square int8 matrices, accumulating exactly in int32
+ * 
+ * @param A First input matrix (n×n, row-major)
+ * @param B Second input matrix (n×n, row-major)
+ * @param C Output matrix (n×n int32, will be overwritten)
+ * @param n Dimension of the square matrices (sums must fit int32:
+ *          n·127² < 2^31 holds up to n = 133000)
+ * @param ws Workspace from matrix_mult_mixed_create(>= n, MATRIX_MULT_INT8)
+ *           for the interleaved copy of B, or NULL to allocate it per call
+ */
+void matrix_multiplication_int8(const int8_t* A, const int8_t* B, int32_t* C, int n,
+                                matrix_mult_mixed* ws);
+
+/**
+ * @brief Allocate the workspace of one dtype for matrices up to n×n
+ * 
+ * Holds A and B in the dtype, the fp64 or int32 product before conversion
+ * and the interleaved B of the dot-product kernels, so the multiply itself
+ * never allocates.
+ * 
+ * @param n Largest matrix dimension the workspace will serve
+ * @param dtype MATRIX_MULT_FP16, _BF16, _FP64 or _INT8 (fp32 has its own kernels)
+ * @param arena Arena to allocate from (heap if NULL or full)
+ * @return New workspace, or NULL if dtype is fp32 or allocation fails
+ */
+matrix_mult_mixed* matrix_mult_mixed_create(int n, matrix_mult_dtype dtype, matrix_mult_arena* arena);
+
+/**
+ * @brief Release a workspace from matrix_mult_mixed_create() (NULL is ignored)
+ */
+void matrix_mult_mixed_destroy(matrix_mult_mixed* ws);
+
+/**
+ * @brief The dtype a workspace was created for
+ */
+matrix_mult_dtype matrix_mult_mixed_dtype(const matrix_mult_mixed* ws);
+
+/**
+ * @brief Phase times of the last matrix_multiplication_mixed() call
+ * @param ws Workspace passed to the call
+ * @param convert_sec Receives seconds spent converting A, B and C (may be NULL)
+ * @param compute_sec Receives seconds spent in the typed kernel (may be NULL)
+ */
+void matrix_mult_mixed_times(const matrix_mult_mixed* ws, double* convert_sec, double* compute_sec);
+
+/**
+ * @brief C = A × B through the workspace's dtype, for fp32 operands
+ * 
+ * Converts A and B to the dtype (int8: one symmetric scale per matrix, see
+ * matrix_mult_quantize_int8()), runs the typed kernel and converts the
+ * product back to fp32, so the result carries the dtype's rounding error.
+ * 
+ * @param A Pointer to first input matrix (n×n elements in row-major order)
+ * @param B Pointer to second input matrix (n×n elements in row-major order)
+ * @param C Pointer to output matrix (n×n elements, will be overwritten)
+ * @param n Dimension of the square matrices; at most the workspace's n
+ * @param ws Workspace from matrix_mult_mixed_create()
+ */
+void matrix_multiplication_mixed(const float* A, const float* B, float* C, int n,
+                                 matrix_mult_mixed* ws);
+
+/* ==================== Batched small matrices ==================== */
+
+/**
+ * @brief C[b] = A[b] × B[b] for a batch of n×n matrices at fixed strides
+ * 
+ * Meant for many small products (8 to 64): the kernel for n is chosen once
+ * per call, and sizes 8, 16, 32, 48 and 64 use fully unrolled kernels
+ * specialised at compile time (see matrix_mult_batched_fixed()). The batch
+ * is split across threads; each product runs on one thread.
+ * 
+ * @param A First matrix of the batch (n×n, row-major)
+ * @param stride_a Elements from one A to the next; 0 uses the same A for every product
+ * @param B First B of the batch
+ * @param stride_b Elements from one B to the next; 0 shares B
+ * @param C First output matrix, overwritten
+ * @param stride_c Elements from one C to the next (at least n*n)
+ * @param n Dimension of every matrix
+ * @param batch Number of products
+ * @param threads Number of threads; values <= 0 use matrix_mult_max_threads()
+ */
+void matrix_multiplication_batched(const float* A, size_t stride_a,
+                                   const float* B, size_t stride_b,
+                                   float* C, size_t stride_c,
+                                   int n, size_t batch, int threads);
+
+/**
+ * @brief C[b] = A[b] × B[b] for a batch of n×n matrices given by pointer arrays
+ * 
+ * Same kernels as matrix_multiplication_batched(), for batches whose
+ * matrices are scattered in memory (the cuBLAS "batched" layout).
+ * 
+ * @param A batch pointers to n×n row-major matrices
+ * @param B batch pointers to n×n row-major matrices
+ * @param C batch pointers to n×n output matrices, overwritten
+ * @param n Dimension of every matrix
+ * @param batch Number of products
+ * @param threads Number of threads; values <= 0 use matrix_mult_max_threads()
+ */
+void matrix_multiplication_batched_ptr(const float* const* A, const float* const* B,
+                                       float* const* C, int n, size_t batch, int threads);
+
+/**
+ * @brief Whether the batched kernels have a compile-time specialisation for n
+ * @return Non-zero for 8, 16, 32, 48 and 64; other sizes use the generic SIMD block product
+ */
+int matrix_mult_batched_fixed(int n);
+
+/* ==================== Out-of-core ==================== */
+
+#define MATRIX_MULT_OOC_DEFAULT_BUDGET ((size_t)256 << 20) /**< Bytes when budget is 0 */
+#define MATRIX_MULT_OOC_PANEL 256   /**< Deepest panel of B streamed per step (rows) */
+#define MATRIX_MULT_OOC_MAPPED 0x1  /**< Operands are file mappings: drop their pages after use */
+
+/**
+ * @brief Budgeted buffers for gemm_ooc()
+ */
+typedef struct matrix_mult_ooc matrix_mult_ooc;
+
+/**
+ * @brief Allocate the buffers of the out-of-core kernel within a memory budget
+ *
+ * The budget covers the packing buffers and the C band, B panel and A
+ * block buffers; nothing else is allocated per call. It is capped to what
+ * an n×n problem can use.
+ *
+ * @param n Largest matrix dimension the buffers will serve
+ * @param budget Bytes available (0 selects MATRIX_MULT_OOC_DEFAULT_BUDGET)
+ * @param flags MATRIX_MULT_OOC_* bits
+ * @param arena Arena to allocate from (heap if NULL or full)
+ * @return New buffers, or NULL if the budget cannot even hold the packing buffers
+ */
+matrix_mult_ooc* matrix_mult_ooc_create(int n, size_t budget, int flags, matrix_mult_arena* arena);
+
+/**
+ * @brief Free buffers from matrix_mult_ooc_create() (NULL is ignored)
+ */
+void matrix_mult_ooc_destroy(matrix_mult_ooc* ooc);
+
+/**
+ * @brief C = A*B for operands that need not fit in memory, in bounded memory
+ *
+ * Bands of C are accumulated in the budget while the panels of B stream
+ * past; A, B and C are only touched by contiguous row copies, so they may
+ * be mappings of files larger than RAM.
+ *
+ * @param m Rows of A and C
+ * @param n Columns of B and C
+ * @param k Columns of A, rows of B
+ * @param A m×k row-major input
+ * @param B k×n row-major input
+ * @param C m×n row-major output, overwritten
+ * @param ooc Buffers from matrix_mult_ooc_create()
+ * @return 0 on success, -1 if not one row of C plus a panel of B fits the budget
+ */
+int gemm_ooc(size_t m, size_t n, size_t k, const float* A, const float* B, float* C,
+             matrix_mult_ooc* ooc);
+
+/**
+ * @brief Operand bytes copied in and result bytes copied out by the last gemm_ooc()
+ */
+void matrix_mult_ooc_traffic(const matrix_mult_ooc* ooc, double* bytes_read, double* bytes_written);
+
+/**
+ * @brief Tiling of the last gemm_ooc() call and the buffer space it planned in
+ * @param tm Receives the rows of C per band
+ * @param tk Receives the rows of B per panel
+ * @param buffer_bytes Receives the bytes of the band/panel/block buffers
+ */
+void matrix_mult_ooc_tiles(const matrix_mult_ooc* ooc, size_t* tm, size_t* tk, size_t* buffer_bytes);
+
+/* ==================== Sparse (CSR) × dense ==================== */
+
+/**
+ * @brief Sparse matrix in compressed sparse row form
+ *
+ * The nonzeros of row i are values[row_ptr[i] .. row_ptr[i + 1]), in
+ * ascending column order, with their columns in col_idx.
+ */
+typedef struct matrix_mult_csr {
+    size_t rows;                /**< Rows of the matrix */
+    size_t cols;                /**< Columns of the matrix (at most UINT32_MAX) */
+    size_t nnz;                 /**< Stored nonzeros */
+    size_t* row_ptr;            /**< rows + 1 offsets into col_idx and values */
+    uint32_t* col_idx;          /**< Column of every nonzero */
+    float* values;              /**< Value of every nonzero */
+    matrix_mult_arena* arena;   /**< Arena the arrays came from (heap if NULL) */
+} matrix_mult_csr;
+
+/**
+ * @brief Compress the nonzeros of a dense row-major matrix
+ * @param A rows×cols row-major matrix; exact zeros are dropped
+ * @param rows Rows of A
+ * @param cols Columns of A (at most UINT32_MAX)
+ * @param arena Arena for the arrays (heap if NULL or full)
+ * @param threads Threads counting and copying rows; values <= 0 use matrix_mult_max_threads()
+ * @return New matrix, or NULL if out of memory or cols is too large
+ */
+matrix_mult_csr* matrix_mult_csr_from_dense(const float* A, size_t rows, size_t cols,
+                                            matrix_mult_arena* arena, int threads);
+
+/**
+ * @brief Free a matrix from matrix_mult_csr_from_dense() (NULL is ignored)
+ */
+void matrix_mult_csr_destroy(matrix_mult_csr* csr);
+
+/**
+ * @brief C = A × B for a CSR A and a dense B (SpMM)
+ *
+ * Rows of C are distributed across threads in chunks (dynamic schedule,
+ * so rows of uneven length balance). Each row of C is built from the rows
+ * of B its nonzeros select, 32 columns at a time in registers (AVX2 when
+ * the SIMD micro-kernel selected it, portable i-k-j otherwise), so the
+ * work is 2*nnz*n FLOPs instead of the dense 2*m*k*n.
+ *
+ * @param n Columns of B and C
+ * @param A m×k sparse operand
+ * @param B k×n row-major dense operand
+ * @param C m×n row-major output, overwritten
+ * @param threads Number of threads; values <= 0 use matrix_mult_max_threads()
+ */
+void spmm_csr(size_t n, const matrix_mult_csr* A, const float* B, float* C, int threads);
+
+/* ==================== Thread pool and asynchronous gemm ==================== */
+
+#define MATRIX_MULT_POOL_QUEUE 64       /**< Requests in flight per pool (submit blocks beyond) */
+#define MATRIX_MULT_POOL_MIN_ROWS 64    /**< Fewest rows of C a request is split into per task */
+
+/**
+ * @brief Persistent worker threads and their request queue
+ *
+ * The workers are started once by matrix_mult_pool_create() and sleep on a
+ * condition variable between requests, so a multiply submitted to the
+ * pool pays no thread creation or OpenMP team start-up. Each worker owns
+ * its packing buffers for the whole lifetime of the pool.
+ */
+typedef struct matrix_mult_pool matrix_mult_pool;
+
+/**
+ * @brief Start a pool of worker threads
+ * @param threads Number of workers; values <= 0 use matrix_mult_max_threads()
+ * @param n Typical largest matrix dimension, sizes the workers' packing
+ *          buffers as in matrix_mult_pack_create() (any shape still works)
+ * @param arena Arena for the packing buffers (heap if NULL or full); it must
+ *              outlive the pool
+ * @param cpus CPU to pin worker i to for i < ncpus (negative: not pinned), or
+ *             NULL to leave every worker with the calling thread's affinity
+ * @param ncpus Entries in cpus
+ * @return New pool, or NULL if a thread or buffer cannot be created
+ */
+matrix_mult_pool* matrix_mult_pool_create(int threads, int n, matrix_mult_arena* arena,
+                                          const int* cpus, int ncpus);
+
+/**
+ * @brief Finish every queued request, stop the workers and free the pool (NULL is ignored)
+ */
+void matrix_mult_pool_destroy(matrix_mult_pool* pool);
+
+/**
+ * @brief Number of worker threads of a pool
+ */
+int matrix_mult_pool_threads(const matrix_mult_pool* pool);
+
+/**
+ * @brief Let only the first threads workers take requests
+ *
+ * The other workers stay parked, so one pool started with the largest team
+ * serves any smaller thread count without starting threads again. Bands
+ * already claimed finish on their worker; requests submitted afterwards
+ * are cut into at most threads bands.
+ *
+ * @param threads Active workers, clamped to 1..matrix_mult_pool_threads()
+ * @return The active worker count now in effect
+ */
+int matrix_mult_pool_set_active(matrix_mult_pool* pool, int threads);
+
+/**
+ * @brief Queue C = alpha*A*B + beta*C and return without waiting for it
+ *
+ * Same operands and layout as gemm(). Requests leave the queue in
+ * submission order: the rows of C are cut into bands of at least
+ * MATRIX_MULT_POOL_MIN_ROWS, at most one per worker, and a worker that
+ * finishes its band takes the next band of the same or a later request,
+ * so small requests run side by side while a large one is shared by all
+ * workers. A, B and C must stay valid, and C untouched, until gemm_wait()
+ * returns for the request.
+ *
+ * When MATRIX_MULT_POOL_QUEUE requests are already in flight, the call
+ * blocks until the oldest one finishes.
+ *
+ * @return Ticket for gemm_wait() (>= 0), or -1 if pool is NULL
+ */
+long long gemm_submit(matrix_mult_pool* pool, size_t m, size_t n, size_t k, float alpha,
+                      const float* A, size_t lda, const float* B, size_t ldb,
+                      float beta, float* C, size_t ldc);
+
+/**
+ * @brief Block until a submitted request has finished
+ *
+ * Requests may be waited for in any order, by any thread, and more than once.
+ *
+ * @param pool Pool the request was submitted to
+ * @param ticket Value returned by gemm_submit()
+ * @param latency_sec Receives the seconds from submission to completion, or
+ *                    -1 once MATRIX_MULT_POOL_QUEUE later requests have
+ *                    reused its slot (may be NULL)
+ * @return 0 once the request is done, -1 for a ticket never issued by pool
+ */
+int gemm_wait(matrix_mult_pool* pool, long long ticket, double* latency_sec);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,187 @@
+/**
+ * @file matrix_mult.hpp
+ * @brief Header-only C++ kernels specialised at compile time for fixed sizes
+ *
+ * matrix_mult::matmul<N>() multiplies N×N row-major matrices with N as a
+ * template argument, so every loop bound and stride is a constant: the
+ * compiler unrolls the register block completely, keeps the block of C in
+ * vector registers over the whole depth and emits no edge handling (the
+ * rows left over by the block height are one more block of constant
+ * height, chosen at compile time).
+ * - AVX2 + FMA (x86-64): 6×16 blocks of C in 12 ymm accumulators, walked
+ *   down each 16-column panel of B so the N×16 panel stays in L1
+ * - Portable: i-k-j over a row accumulator with constant bounds, which
+ *   the compiler vectorises for the target (NEON on AArch64)
+ * The AVX2 path runs when the C library's SIMD micro-kernel selected AVX2
+ * (matrix_mult_simd_isa()), so MATRIX_MULT_ISA=scalar selects the
+ * portable one here too.
+ *
+ * matrix_mult::matmul(A, B, C, n) picks matmul<16>, <32>, <64> or <128>
+ * when n is one of them and calls matrix_multiplication_simd() otherwise,
+ * for callers whose n is only known at run time.
+ *
+ * Everything else comes from the C API in matrix_mult.h, whose extern "C"
+ * guards make it usable from C++ directly. C callers (the benchmark) reach
+ * these kernels through matrix_mult_fixed.h.
+ *
+ * Build: any C++11 compiler; no flags needed (AVX2 is enabled per function).
+ *
+ * @example
+ * float A[64 * 64], B[64 * 64], C[64 * 64];
+ * matrix_mult::matmul<64>(A, B, C);        // size fixed at compile time
+ * matrix_mult::matmul(A, B, C, n);         // specialised if n is 16/32/64/128
+ */
+
+#pragma once
+
+#include <cstring>
+#include "matrix_mult.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MATRIX_MULT_HPP_X86_64 1
+#include <immintrin.h>
+#endif
+
+/* GCC and Clang need the ISA enabled per function; MSVC accepts intrinsics anywhere */
+#if defined(MATRIX_MULT_HPP_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define MATRIX_MULT_HPP_AVX2 __attribute__((target("avx2,fma")))
+#define MATRIX_MULT_HPP_INLINE_AVX2 inline __attribute__((always_inline, target("avx2,fma")))
+#else
+#define MATRIX_MULT_HPP_AVX2
+#define MATRIX_MULT_HPP_INLINE_AVX2 inline
+#endif
+
+/* Complete unrolling of the loops over the rows of a register block */
+#if defined(__clang__)
+#define MATRIX_MULT_HPP_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+#define MATRIX_MULT_HPP_UNROLL _Pragma("GCC unroll 16")
+#else
+#define MATRIX_MULT_HPP_UNROLL
+#endif
+
+namespace matrix_mult {
+
+namespace detail {
+
+/**
+ * @brief Portable C = A × B for N×N with constant bounds
+ */
+template <int N>
+inline void matmul_portable(const float* __restrict A, const float* __restrict B,
+                            float* __restrict C) {
+    for (int i = 0; i < N; i++) {
+        float acc[N];
+        for (int j = 0; j < N; j++) acc[j] = 0.0f;
+        for (int k = 0; k < N; k++) {
+            const float a = A[i * N + k];
+            for (int j = 0; j < N; j++) acc[j] += a * B[k * N + j];
+        }
+        for (int j = 0; j < N; j++) C[i * N + j] = acc[j];
+    }
+}
+
+#if defined(MATRIX_MULT_HPP_X86_64)
+/**
+ * @brief MR×16 block of C over the full depth N, all of it in ymm registers
+ */
+template <int N, int MR>
+MATRIX_MULT_HPP_INLINE_AVX2 void block_avx2(const float* A, const float* B, float* C) {
+    __m256 c[MR][2];
+    MATRIX_MULT_HPP_UNROLL
+    for (int r = 0; r < MR; r++) c[r][0] = c[r][1] = _mm256_setzero_ps();
+
+    for (int k = 0; k < N; k++) {
+        const __m256 b0 = _mm256_loadu_ps(B + k * N);
+        const __m256 b1 = _mm256_loadu_ps(B + k * N + 8);
+        MATRIX_MULT_HPP_UNROLL
+        for (int r = 0; r < MR; r++) {
+            const __m256 a = _mm256_broadcast_ss(A + r * N + k);
+            c[r][0] = _mm256_fmadd_ps(a, b0, c[r][0]);
+            c[r][1] = _mm256_fmadd_ps(a, b1, c[r][1]);
+        }
+    }
+
+    MATRIX_MULT_HPP_UNROLL
+    for (int r = 0; r < MR; r++) {
+        _mm256_storeu_ps(C + r * N, c[r][0]);
+        _mm256_storeu_ps(C + r * N + 8, c[r][1]);
+    }
+}
+
+/**
+ * @brief AVX2 C = A × B for N×N, N a multiple of 16
+ */
+template <int N>
+MATRIX_MULT_HPP_AVX2 void matmul_avx2(const float* A, const float* B, float* C) {
+    const int MR = 6;
+    const int full = N / MR * MR;
+    const int rest = N % MR;
+
+    for (int j = 0; j < N; j += 16) {
+        for (int i = 0; i < full; i += MR) block_avx2<N, MR>(A + i * N, B + j, C + i * N + j);
+
+        /* A constant condition: the leftover rows are one block of height rest, or nothing */
+        if (rest > 0) block_avx2<N, (rest > 0 ? rest : 1)>(A + full * N, B + j, C + full * N + j);
+    }
+}
+#endif
+
+} // namespace detail
+
+/**
+ * @brief Whether matmul(A, B, C, n) has a compile-time specialisation for n
+ */
+constexpr bool matmul_specialised(int n) {
+    return n == 16 || n == 32 || n == 64 || n == 128;
+}
+
+/**
+ * @brief C = A × B for N×N row-major matrices, N fixed at compile time
+ *
+ * @tparam N Matrix dimension, a positive multiple of 16
+ * @param A Pointer to first input matrix (N×N elements in row-major order)
+ * @param B Pointer to second input matrix (N×N elements in row-major order)
+ * @param C Pointer to output matrix (N×N elements, will be overwritten)
+ *
+ * @note Results may differ from the baseline in the last bits because FMA
+ *       and the blocked summation order round differently
+ */
+template <int N>
+inline void matmul(const float* A, const float* B, float* C) {
+    static_assert(N > 0 && N % 16 == 0, "matmul<N> needs N to be a positive multiple of 16");
+#if defined(MATRIX_MULT_HPP_X86_64)
+    if (std::strcmp(matrix_mult_simd_isa(), "avx2") == 0) {
+        detail::matmul_avx2<N>(A, B, C);
+        return;
+    }
+#endif
+    detail::matmul_portable<N>(A, B, C);
+}
+
+/**
+ * @brief C = A × B, through matmul<n>() when n is specialised
+ *
+ * Other sizes run matrix_multiplication_simd() with the default tile.
+ *
+ * @param A Pointer to first input matrix (n×n elements in row-major order)
+ * @param B Pointer to second input matrix (n×n elements in row-major order)
+ * @param C Pointer to output matrix (n×n elements, will be overwritten)
+ * @param n Dimension of the square matrices
+ */
+inline void matmul(const float* A, const float* B, float* C, int n) {
+    switch (n) {
+    case 16:  matmul<16>(A, B, C); break;
+    case 32:  matmul<32>(A, B, C); break;
+    case 64:  matmul<64>(A, B, C); break;
+    case 128: matmul<128>(A, B, C); break;
+    default:  matrix_multiplication_simd(A, B, C, n, 0); break;
+    }
+}
+
+} // namespace matrix_mult
+
+#undef MATRIX_MULT_HPP_UNROLL
+#undef MATRIX_MULT_HPP_INLINE_AVX2
+#undef MATRIX_MULT_HPP_AVX2
+#undef MATRIX_MULT_HPP_X86_64
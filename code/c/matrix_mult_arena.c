@@ -0,0 +1,258 @@
+/**
+ * @file matrix_mult_arena.c
+ * @brief 64-byte aligned bump arena for benchmark operands and kernel scratch
+ *
+ * The arena maps one region up front and hands out cache-line aligned
+ * blocks from it; individual blocks are never freed, the caller instead
+ * rewinds to a mark. With MATRIX_MULT_ARENA_PREFAULT every page is touched
+ * at creation, so the resident set no longer changes while benchmarks
+ * allocate and release matrices. matrix_mult_arena_discard() drops the
+ * pages above a mark again, so they are re-placed by their next writer.
+ *
+ * Huge pages (MATRIX_MULT_ARENA_HUGE_PAGES), best effort:
+ * - Linux: explicit MAP_HUGETLB pages first (needs vm.nr_hugepages), then
+ *   transparent huge pages via madvise(MADV_HUGEPAGE)
+ * - Windows: MEM_LARGE_PAGES (needs the "Lock pages in memory" privilege,
+ *   which is enabled here if the account holds it)
+ * - Elsewhere, or if the above fail: regular pages
+ * matrix_mult_arena_huge_pages() reports which kind was obtained.
+ */
+
+/* MAP_ANONYMOUS and madvise() are not ISO C; expose them under -std=c11 too */
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_mult.h"
+#include "matrix_mult_internal.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "advapi32.lib")
+#endif
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define ARENA_MMAP 1
+#endif
+
+/* Explicit huge page size assumed for MAP_HUGETLB rounding (x86-64, arm64) */
+#define ARENA_HUGE_PAGE_BYTES ((size_t)2 << 20)
+
+/**
+ * @brief Arena state: one mapped region and a bump offset
+ */
+struct matrix_mult_arena {
+    unsigned char* base;    /* Start of the region (MATRIX_MULT_ALIGN aligned) */
+    size_t capacity;        /* Usable bytes */
+    size_t used;            /* Bytes handed out so far */
+    size_t high_water;      /* Largest value of used since creation */
+    size_t mapped;          /* Bytes actually mapped (capacity rounded to pages) */
+    int huge;               /* Huge page kind obtained (see matrix_mult_arena_huge_pages) */
+    int method;             /* How base was obtained, for destroy */
+};
+
+/* Values of matrix_mult_arena::method */
+enum { ARENA_HEAP, ARENA_MAPPED, ARENA_VIRTUAL };
+
+/* ==================== Helpers ==================== */
+
+static size_t round_up_bytes(size_t x, size_t m) {
+    return (x + m - 1) / m * m;
+}
+
+#if defined(_WIN32)
+/**
+ * @brief Enable SeLockMemoryPrivilege for this process if the account has it
+ * @return Non-zero on success
+ */
+static int enable_lock_memory_privilege(void) {
+    HANDLE token;
+    TOKEN_PRIVILEGES tp;
+    int ok = 0;
+
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+        return 0;
+    }
+    if (LookupPrivilegeValue(NULL, SE_LOCK_MEMORY_NAME, &tp.Privileges[0].Luid)) {
+        tp.PrivilegeCount = 1;
+        tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+        /* AdjustTokenPrivileges "succeeds" without the privilege; check the error */
+        ok = AdjustTokenPrivileges(token, FALSE, &tp, 0, NULL, NULL) &&
+             GetLastError() == ERROR_SUCCESS;
+    }
+    CloseHandle(token);
+    return ok;
+}
+#endif
+
+/**
+ * @brief Map the arena region, preferring huge pages when requested
+ */
+static int arena_map(matrix_mult_arena* arena, size_t bytes, int want_huge) {
+#if defined(_WIN32)
+    if (want_huge) {
+        SIZE_T large = GetLargePageMinimum();
+        if (large > 0 && enable_lock_memory_privilege()) {
+            size_t len = round_up_bytes(bytes, (size_t)large);
+            void* p = VirtualAlloc(NULL, len, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                   PAGE_READWRITE);
+            if (p) {
+                arena->base = (unsigned char*)p;
+                arena->mapped = len;
+                arena->huge = MATRIX_MULT_HUGE_EXPLICIT;
+                arena->method = ARENA_VIRTUAL;
+                return 1;
+            }
+        }
+    }
+    {
+        void* p = VirtualAlloc(NULL, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (!p) return 0;
+        arena->base = (unsigned char*)p;
+        arena->mapped = bytes;
+        arena->method = ARENA_VIRTUAL;
+        return 1;
+    }
+#elif defined(ARENA_MMAP)
+#ifdef MAP_HUGETLB
+    if (want_huge) {
+        size_t len = round_up_bytes(bytes, ARENA_HUGE_PAGE_BYTES);
+        void* p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            arena->base = (unsigned char*)p;
+            arena->mapped = len;
+            arena->huge = MATRIX_MULT_HUGE_EXPLICIT;
+            arena->method = ARENA_MAPPED;
+            return 1;
+        }
+    }
+#endif
+    {
+        /* Round to 2 MiB so transparent huge pages can back the whole region */
+        size_t len = want_huge ? round_up_bytes(bytes, ARENA_HUGE_PAGE_BYTES) : bytes;
+        void* p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return 0;
+        arena->base = (unsigned char*)p;
+        arena->mapped = len;
+        arena->method = ARENA_MAPPED;
+#ifdef MADV_HUGEPAGE
+        if (want_huge && madvise(p, len, MADV_HUGEPAGE) == 0) {
+            arena->huge = MATRIX_MULT_HUGE_TRANSPARENT;
+        }
+#endif
+        return 1;
+    }
+#else
+    (void)want_huge;
+    arena->base = (unsigned char*)matrix_mult_aligned_alloc(bytes);
+    if (!arena->base) return 0;
+    arena->mapped = bytes;
+    arena->method = ARENA_HEAP;
+    return 1;
+#endif
+}
+
+/* ==================== Public API ==================== */
+
+matrix_mult_arena* matrix_mult_arena_create(size_t bytes, int flags) {
+    matrix_mult_arena* arena = (matrix_mult_arena*)calloc(1, sizeof(*arena));
+    if (!arena) return NULL;
+
+    bytes = round_up_bytes(bytes > 0 ? bytes : 1, MATRIX_MULT_ALIGN);
+    if (!arena_map(arena, bytes, (flags & MATRIX_MULT_ARENA_HUGE_PAGES) != 0)) {
+        free(arena);
+        return NULL;
+    }
+    arena->capacity = bytes;
+
+    /* Fault every page in now rather than inside a timed run */
+    if (flags & MATRIX_MULT_ARENA_PREFAULT) memset(arena->base, 0, arena->mapped);
+    return arena;
+}
+
+void matrix_mult_arena_destroy(matrix_mult_arena* arena) {
+    if (!arena) return;
+    switch (arena->method) {
+#if defined(_WIN32)
+    case ARENA_VIRTUAL:
+        VirtualFree(arena->base, 0, MEM_RELEASE);
+        break;
+#elif defined(ARENA_MMAP)
+    case ARENA_MAPPED:
+        munmap(arena->base, arena->mapped);
+        break;
+#endif
+    default:
+        matrix_mult_aligned_free(arena->base);
+        break;
+    }
+    free(arena);
+}
+
+void* matrix_mult_arena_alloc(matrix_mult_arena* arena, size_t bytes) {
+    size_t len = round_up_bytes(bytes > 0 ? bytes : 1, MATRIX_MULT_ALIGN);
+    if (!arena || len > arena->capacity - arena->used) return NULL;
+
+    void* p = arena->base + arena->used;
+    arena->used += len;
+    if (arena->used > arena->high_water) arena->high_water = arena->used;
+    return p;
+}
+
+size_t matrix_mult_arena_mark(const matrix_mult_arena* arena) {
+    return arena ? arena->used : 0;
+}
+
+void matrix_mult_arena_release(matrix_mult_arena* arena, size_t mark) {
+    if (arena && mark <= arena->used) arena->used = mark;
+}
+
+int matrix_mult_arena_discard(matrix_mult_arena* arena, size_t mark) {
+#if defined(ARENA_MMAP) && defined(MADV_DONTNEED)
+    if (!arena || arena->method != ARENA_MAPPED) return 0;
+    size_t page = arena->huge == MATRIX_MULT_HUGE_EXPLICIT ? ARENA_HUGE_PAGE_BYTES
+                                                           : (size_t)sysconf(_SC_PAGESIZE);
+    size_t lo = round_up_bytes(mark, page);
+    if (lo >= arena->mapped) return 0;
+    return madvise(arena->base + lo, arena->mapped - lo, MADV_DONTNEED) == 0;
+#else
+    (void)arena; (void)mark;
+    return 0;
+#endif
+}
+
+int matrix_mult_arena_owns(const matrix_mult_arena* arena, const void* p) {
+    if (!arena || !p) return 0;
+    uintptr_t a = (uintptr_t)p, lo = (uintptr_t)arena->base;
+    return a >= lo && a < lo + arena->capacity;
+}
+
+size_t matrix_mult_arena_capacity(const matrix_mult_arena* arena) {
+    return arena ? arena->capacity : 0;
+}
+
+size_t matrix_mult_arena_high_water(const matrix_mult_arena* arena) {
+    return arena ? arena->high_water : 0;
+}
+
+int matrix_mult_arena_huge_pages(const matrix_mult_arena* arena) {
+    return arena ? arena->huge : MATRIX_MULT_HUGE_NONE;
+}
+
+/* ==================== Kernel scratch ==================== */
+
+void* matrix_mult_scratch_alloc(matrix_mult_arena* arena, size_t bytes) {
+    void* p = matrix_mult_arena_alloc(arena, bytes);
+    return p ? p : matrix_mult_aligned_alloc(bytes);
+}
+
+void matrix_mult_scratch_free(const matrix_mult_arena* arena, void* p) {
+    /* Arena blocks are reclaimed by matrix_mult_arena_release() */
+    if (!matrix_mult_arena_owns(arena, p)) matrix_mult_aligned_free(p);
+}
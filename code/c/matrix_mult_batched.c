@@ -0,0 +1,256 @@
+/**
+ * @file matrix_mult_batched.c
+ * @brief Batched multiplication of many small square matrices
+ *
+ * For thousands of independent 8×8 to 64×64 products the per-call work of
+ * the single-matrix kernels (tile set-up, micro-kernel dispatch, edge
+ * checks) costs as much as the arithmetic. The batched entry points resolve
+ * one kernel for the common size n before the loop and then call it for
+ * every matrix, parallelising across the batch with OpenMP.
+ *
+ * Sizes 8, 16, 32, 48 and 64 have kernels specialised at compile time: the
+ * size is a literal inside each generated function, so every loop bound,
+ * stride and offset is a constant and there are no edge cases.
+ * - AVX2 + FMA (x86-64): 8×8 keeps all of C in 8 ymm registers; multiples
+ *   of 16 walk 4×16 blocks of C in 8 ymm accumulators over the full depth
+ * - Portable: i-k-j loops over a row accumulator with constant bounds,
+ *   which the compiler unrolls and vectorises for the target (NEON on
+ *   AArch64)
+ * Other sizes clear C and run the SIMD block product (matrix_mult_simd_block())
+ * once over the whole matrix.
+ *
+ * The AVX2 kernels are used when the SIMD micro-kernel selected AVX2 (so
+ * MATRIX_MULT_ISA=scalar also selects the portable ones here).
+ *
+ * Build with OpenMP enabled (gcc/clang -fopenmp, MSVC /openmp); without it
+ * the batch runs on the calling thread.
+ */
+
+#include <string.h>
+#include "matrix_mult.h"
+#include "matrix_mult_internal.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MM_X86_64 1
+#include <immintrin.h>
+#endif
+
+/* GCC and Clang need the ISA enabled per function; MSVC accepts intrinsics anywhere */
+#if defined(MM_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define MM_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define MM_INLINE_AVX2 static inline __attribute__((always_inline, target("avx2,fma")))
+#else
+#define MM_TARGET_AVX2
+#define MM_INLINE_AVX2 static __inline
+#endif
+
+#if defined(_MSC_VER)
+#define MM_RESTRICT __restrict
+#else
+#define MM_RESTRICT restrict
+#endif
+
+/**
+ * @brief Kernel for one n×n product C = A × B (n is ignored by fixed-size kernels)
+ */
+typedef void (*batch_kernel)(const float* A, const float* B, float* C, int n);
+
+/* ==================== Portable fixed-size kernels ==================== */
+
+/**
+ * @brief Define batch_N_portable(): C = A × B for N×N with constant bounds
+ *
+ * restrict tells the compiler the three matrices do not overlap, so the
+ * j loop vectorises without run-time alias checks.
+ */
+#define DEFINE_FIXED_PORTABLE(N)                                                \
+static void batch_##N##_portable(const float* MM_RESTRICT A,                    \
+                                 const float* MM_RESTRICT B,                    \
+                                 float* MM_RESTRICT C, int n) {                 \
+    (void)n;                                                                    \
+    for (int i = 0; i < N; i++) {                                               \
+        float acc[N];                                                           \
+        for (int j = 0; j < N; j++) acc[j] = 0.0f;                              \
+        for (int k = 0; k < N; k++) {                                           \
+            const float a = A[i * N + k];                                       \
+            for (int j = 0; j < N; j++) acc[j] += a * B[k * N + j];             \
+        }                                                                       \
+        for (int j = 0; j < N; j++) C[i * N + j] = acc[j];                      \
+    }                                                                           \
+}
+
+DEFINE_FIXED_PORTABLE(8)
+DEFINE_FIXED_PORTABLE(16)
+DEFINE_FIXED_PORTABLE(32)
+DEFINE_FIXED_PORTABLE(48)
+DEFINE_FIXED_PORTABLE(64)
+
+/* ==================== AVX2 fixed-size kernels ==================== */
+
+#if defined(MM_X86_64)
+/* Broadcast A[r, k] and update both ymm accumulators of row r */
+#define AVX2_ROW(r)                                                             \
+    a = _mm256_broadcast_ss(A + (r) * ld + k);                                  \
+    c##r##0 = _mm256_fmadd_ps(a, b0, c##r##0);                                  \
+    c##r##1 = _mm256_fmadd_ps(a, b1, c##r##1)
+
+#define AVX2_STORE(r)                                                           \
+    _mm256_storeu_ps(C + (r) * ld, c##r##0);                                    \
+    _mm256_storeu_ps(C + (r) * ld + 8, c##r##1)
+
+/**
+ * @brief 4×16 block of C over the full depth ld (inlined with ld constant)
+ */
+MM_INLINE_AVX2
+void block_4x16(const float* A, const float* B, float* C, const int ld) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+
+    for (int k = 0; k < ld; k++) {
+        const __m256 b0 = _mm256_loadu_ps(B + k * ld);
+        const __m256 b1 = _mm256_loadu_ps(B + k * ld + 8);
+        __m256 a;
+        AVX2_ROW(0); AVX2_ROW(1); AVX2_ROW(2); AVX2_ROW(3);
+    }
+
+    AVX2_STORE(0); AVX2_STORE(1); AVX2_STORE(2); AVX2_STORE(3);
+}
+
+/**
+ * @brief Define batch_N_avx2() for N a multiple of 16: 4×16 blocks of C
+ */
+#define DEFINE_FIXED_AVX2(N)                                                    \
+MM_TARGET_AVX2                                                                  \
+static void batch_##N##_avx2(const float* A, const float* B, float* C, int n) { \
+    (void)n;                                                                    \
+    for (int i = 0; i < N; i += 4)                                              \
+        for (int j = 0; j < N; j += 16)                                         \
+            block_4x16(A + i * N, B + j, C + i * N + j, N);                     \
+}
+
+DEFINE_FIXED_AVX2(16)
+DEFINE_FIXED_AVX2(32)
+DEFINE_FIXED_AVX2(48)
+DEFINE_FIXED_AVX2(64)
+
+#define AVX2_ROW8(r)                                                            \
+    a = _mm256_broadcast_ss(A + (r) * 8 + k);                                   \
+    c##r = _mm256_fmadd_ps(a, b, c##r)
+
+/**
+ * @brief 8×8: all of C in 8 ymm accumulators, one load of B per k
+ */
+MM_TARGET_AVX2
+static void batch_8_avx2(const float* A, const float* B, float* C, int n) {
+    __m256 c0 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps();
+    __m256 c2 = _mm256_setzero_ps(), c3 = _mm256_setzero_ps();
+    __m256 c4 = _mm256_setzero_ps(), c5 = _mm256_setzero_ps();
+    __m256 c6 = _mm256_setzero_ps(), c7 = _mm256_setzero_ps();
+    (void)n;
+
+    for (int k = 0; k < 8; k++) {
+        const __m256 b = _mm256_loadu_ps(B + k * 8);
+        __m256 a;
+        AVX2_ROW8(0); AVX2_ROW8(1); AVX2_ROW8(2); AVX2_ROW8(3);
+        AVX2_ROW8(4); AVX2_ROW8(5); AVX2_ROW8(6); AVX2_ROW8(7);
+    }
+
+    _mm256_storeu_ps(C + 0 * 8, c0); _mm256_storeu_ps(C + 1 * 8, c1);
+    _mm256_storeu_ps(C + 2 * 8, c2); _mm256_storeu_ps(C + 3 * 8, c3);
+    _mm256_storeu_ps(C + 4 * 8, c4); _mm256_storeu_ps(C + 5 * 8, c5);
+    _mm256_storeu_ps(C + 6 * 8, c6); _mm256_storeu_ps(C + 7 * 8, c7);
+}
+#endif
+
+/* ==================== Dispatch ==================== */
+
+/**
+ * @brief Any size: clear C, then one SIMD block product over the whole matrix
+ */
+static void batch_generic(const float* A, const float* B, float* C, int n) {
+    const size_t ld = (size_t)n;
+    memset(C, 0, ld * ld * sizeof(float));
+    matrix_mult_simd_block(n, n, n, A, ld, B, ld, C, ld);
+}
+
+typedef struct {
+    int n;
+    batch_kernel portable;
+    batch_kernel avx2;      /* NULL where only the portable kernel exists */
+} fixed_kernel;
+
+#if defined(MM_X86_64)
+#define AVX2_KERNEL(f) f
+#else
+#define AVX2_KERNEL(f) NULL
+#endif
+
+static const fixed_kernel FIXED[] = {
+    { 8,  batch_8_portable,  AVX2_KERNEL(batch_8_avx2) },
+    { 16, batch_16_portable, AVX2_KERNEL(batch_16_avx2) },
+    { 32, batch_32_portable, AVX2_KERNEL(batch_32_avx2) },
+    { 48, batch_48_portable, AVX2_KERNEL(batch_48_avx2) },
+    { 64, batch_64_portable, AVX2_KERNEL(batch_64_avx2) },
+};
+
+/**
+ * @brief Kernel for size n on this CPU
+ * @param fixed Receives non-zero if it is a compile-time specialisation (may be NULL)
+ */
+static batch_kernel batch_kernel_for(int n, int* fixed) {
+    const int avx2 = strcmp(matrix_mult_simd_isa(), "avx2") == 0;
+    for (size_t i = 0; i < sizeof(FIXED) / sizeof(FIXED[0]); i++) {
+        if (FIXED[i].n != n) continue;
+        if (fixed) *fixed = 1;
+        return avx2 && FIXED[i].avx2 ? FIXED[i].avx2 : FIXED[i].portable;
+    }
+    if (fixed) *fixed = 0;
+    return batch_generic;
+}
+
+int matrix_mult_batched_fixed(int n) {
+    int fixed;
+    batch_kernel_for(n, &fixed);
+    return fixed;
+}
+
+/* ==================== Entry points ==================== */
+
+void matrix_multiplication_batched(const float* A, size_t stride_a,
+                                   const float* B, size_t stride_b,
+                                   float* C, size_t stride_c,
+                                   int n, size_t batch, int threads) {
+    const batch_kernel kernel = batch_kernel_for(n, NULL);
+    const long long count = (long long)batch;
+    if (threads <= 0) threads = matrix_mult_max_threads();
+    (void)threads;
+
+    /* Matrices are independent: a static split gives each thread a contiguous range */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads) if (count > 1)
+#endif
+    for (long long b = 0; b < count; b++) {
+        kernel(A + (size_t)b * stride_a, B + (size_t)b * stride_b, C + (size_t)b * stride_c, n);
+    }
+}
+
+void matrix_multiplication_batched_ptr(const float* const* A, const float* const* B,
+                                       float* const* C, int n, size_t batch, int threads) {
+    const batch_kernel kernel = batch_kernel_for(n, NULL);
+    const long long count = (long long)batch;
+    if (threads <= 0) threads = matrix_mult_max_threads();
+    (void)threads;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads) if (count > 1)
+#endif
+    for (long long b = 0; b < count; b++) {
+        kernel(A[b], B[b], C[b], n);
+    }
+}
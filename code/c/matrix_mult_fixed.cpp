@@ -0,0 +1,21 @@
+/**
+ * @file matrix_mult_fixed.cpp
+ * @brief Instantiates matrix_mult.hpp's specialised kernels behind matrix_mult_fixed.h
+ *
+ * Uses no C++ runtime library features, so the object links into the C
+ * harness without libstdc++.
+ *
+ * Build: g++ -O2 -c matrix_mult_fixed.cpp
+ *        cl /O2 /c matrix_mult_fixed.cpp
+ */
+
+#include "matrix_mult.hpp"
+#include "matrix_mult_fixed.h"
+
+extern "C" void matrix_multiplication_fixed(const float* A, const float* B, float* C, int n) {
+    matrix_mult::matmul(A, B, C, n);
+}
+
+extern "C" int matrix_mult_fixed_size(int n) {
+    return matrix_mult::matmul_specialised(n) ? 1 : 0;
+}
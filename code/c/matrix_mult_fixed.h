@@ -0,0 +1,43 @@
+/**
+ * @file matrix_mult_fixed.h
+ * @brief C entry points to the compile-time specialised C++ kernels
+ *
+ * matrix_mult.hpp is header-only C++; this header exposes its runtime
+ * dispatcher matrix_mult::matmul(A, B, C, n) to C code, such as the
+ * benchmark harness, through one C++ translation unit
+ * (matrix_mult_fixed.cpp).
+ *
+ * Kept out of matrix_mult.h so the C kernels build without a C++
+ * compiler; the registry exposes the "fixed" kernel only when compiled
+ * with -DMATRIX_MULT_FIXED.
+ *
+ * Build: g++ -O2 -c matrix_mult_fixed.cpp (see benchmark.c for the link line)
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief C = A × B through matmul<n>() for n = 16, 32, 64 and 128
+ *
+ * Other sizes run matrix_multiplication_simd() with the default tile.
+ *
+ * @param A Pointer to first input matrix (n×n elements in row-major order)
+ * @param B Pointer to second input matrix (n×n elements in row-major order)
+ * @param C Pointer to output matrix (n×n elements, will be overwritten)
+ * @param n Dimension of the square matrices
+ */
+void matrix_multiplication_fixed(const float* A, const float* B, float* C, int n);
+
+/**
+ * @brief Whether matrix_multiplication_fixed() has a compile-time specialisation for n
+ * @return Non-zero for 16, 32, 64 and 128
+ */
+int matrix_mult_fixed_size(int n);
+
+#ifdef __cplusplus
+}
+#endif
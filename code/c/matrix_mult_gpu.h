@@ -0,0 +1,89 @@
+/**
+ * @file matrix_mult_gpu.h
+ * @brief GPU offload of square matrix multiplication (CUDA or HIP)
+ *
+ * One call copies A and B to the device, multiplies there and copies C
+ * back, and reports the three phases separately, so the benchmark can tell
+ * at which n the device kernel's speed pays for the PCIe transfers.
+ *
+ * Two device kernels:
+ * - Tiled: 32×32 tiles of A and B staged in shared memory, each thread
+ *   accumulating a 4×1 strip of C in registers (matrix_mult_gpu.cu)
+ * - BLAS: cublasSgemm() / rocblas_sgemm(), when the library was built in
+ *   with -DMATRIX_MULT_GPU_BLAS
+ *
+ * Host operands are ordinary (pageable) memory, so transfers include the
+ * driver's staging copy, as they would for an application that offloads
+ * its existing buffers.
+ *
+ * Kept out of matrix_mult.h so the CPU kernels build without a GPU
+ * toolkit; the registry exposes these kernels only when compiled with
+ * -DMATRIX_MULT_GPU.
+ *
+ * Build: nvcc -O2 -c matrix_mult_gpu.cu [-DMATRIX_MULT_GPU_BLAS]
+ *        hipcc -O2 -x hip -c matrix_mult_gpu.cu [-DMATRIX_MULT_GPU_BLAS]
+ *        (see benchmark.c for the link line)
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** matrix_mult_gpu_create() flag: multiply with cuBLAS/rocBLAS instead of the tiled kernel */
+#define MATRIX_MULT_GPU_BLAS_KERNEL 0x1
+
+/**
+ * @brief Phase times of the last matrix_multiplication_gpu() call
+ *
+ * Measured with device events, so each phase is the device-side duration
+ * of the copies or the kernel, without host-side launch gaps.
+ */
+typedef struct gpu_times {
+    double h2d_sec;     /* Copies of A and B to the device */
+    double kernel_sec;  /* Device multiply */
+    double d2h_sec;     /* Copy of C back to the host */
+} gpu_times;
+
+/** Opaque device buffers, events and BLAS handle */
+typedef struct matrix_mult_gpu matrix_mult_gpu;
+
+/**
+ * @brief Allocate device buffers for n×n multiplications on the current device
+ * @param n Largest matrix dimension the state will serve
+ * @param flags MATRIX_MULT_GPU_BLAS_KERNEL, or 0 for the tiled kernel
+ * @return New state, or NULL if there is no device, allocation fails, or
+ *         the BLAS kernel was requested but not built in
+ */
+matrix_mult_gpu* matrix_mult_gpu_create(int n, int flags);
+
+/**
+ * @brief Free the device buffers (NULL is ignored)
+ */
+void matrix_mult_gpu_destroy(matrix_mult_gpu* g);
+
+/**
+ * @brief C = A × B on the device, including both transfers
+ * @param A Pointer to first input matrix (n×n elements in row-major order)
+ * @param B Pointer to second input matrix (n×n elements in row-major order)
+ * @param C Pointer to output matrix (n×n elements, will be overwritten)
+ * @param n Dimension of the square matrices; at most the state's n
+ * @param g State from matrix_mult_gpu_create()
+ * @param times Receives the phase times (may be NULL)
+ * @return 0 on success, -1 if a device call failed (C is then undefined)
+ *
+ * Returns once C is back on the host.
+ */
+int matrix_multiplication_gpu(const float* A, const float* B, float* C, int n,
+                              matrix_mult_gpu* g, gpu_times* times);
+
+/**
+ * @brief Name of the current device and runtime, e.g. "NVIDIA A100 (CUDA 12.2)"
+ * @return Static string; "none" when no device is visible
+ */
+const char* matrix_mult_gpu_device(void);
+
+#ifdef __cplusplus
+}
+#endif
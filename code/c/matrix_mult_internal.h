@@ -0,0 +1,103 @@
+/**
+ * @file matrix_mult_internal.h
+ * @brief Declarations shared between the optimised kernel translation units
+ * 
+ * Not part of the public API in matrix_mult.h; only the kernel sources
+ * include this header.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "matrix_mult.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Alignment of kernel scratch buffers (one cache line, one AVX-512 vector) */
+#define MATRIX_MULT_ALIGN 64
+
+/**
+ * @brief Allocate a MATRIX_MULT_ALIGN-aligned buffer
+ * @param bytes Requested size (rounded up to a whole number of cache lines)
+ * @return Buffer to release with matrix_mult_aligned_free(), or NULL
+ */
+void* matrix_mult_aligned_alloc(size_t bytes);
+
+/**
+ * @brief Release a buffer from matrix_mult_aligned_alloc() (NULL is ignored)
+ */
+void matrix_mult_aligned_free(void* p);
+
+/**
+ * @brief Monotonic time in seconds, for intervals inside the kernels
+ * 
+ * clock_gettime(CLOCK_MONOTONIC) on POSIX and QueryPerformanceCounter on
+ * Windows, like now_sec() in platform.c; never stepped by NTP.
+ */
+double matrix_mult_now(void);
+
+/**
+ * @brief Allocate kernel scratch from an arena, falling back to the heap
+ * @param arena Arena to carve from, or NULL for the heap
+ * @param bytes Requested size
+ * @return MATRIX_MULT_ALIGN-aligned block, or NULL if both sources fail
+ */
+void* matrix_mult_scratch_alloc(matrix_mult_arena* arena, size_t bytes);
+
+/**
+ * @brief Release a block from matrix_mult_scratch_alloc() with the same arena
+ * 
+ * Heap blocks are freed; arena blocks are left for matrix_mult_arena_release().
+ */
+void matrix_mult_scratch_free(const matrix_mult_arena* arena, void* p);
+
+/**
+ * @brief Micro-kernel signature: C[0..MR, 0..NR] += A[0..MR, 0..kc] * B[0..kc, 0..NR]
+ * 
+ * Element A[r, k] is read at A[r*rs_a + k*cs_a], so the same micro-kernel
+ * runs on a row-major block (rs_a = lda, cs_a = 1) or on a packed
+ * k-major sliver (rs_a = 1, cs_a = MR). B and C are row-major with row
+ * strides ldb and ldc.
+ */
+typedef void (*ukernel_fn)(int kc, const float* A, size_t rs_a, size_t cs_a,
+                           const float* B, size_t ldb, float* C, size_t ldc);
+
+/**
+ * @brief Description of one micro-kernel implementation
+ */
+typedef struct {
+    const char* name;   /* ISA name reported by matrix_mult_simd_isa() */
+    int mr;             /* Rows of C held in registers */
+    int nr;             /* Columns of C held in registers */
+    ukernel_fn run;     /* Micro-kernel entry point */
+} ukernel_desc;
+
+/**
+ * @brief Micro-kernel selected for this CPU (detected once, on first call)
+ * @return Pointer to a static descriptor, never NULL
+ */
+const ukernel_desc* matrix_mult_ukernel(void);
+
+/**
+ * @brief Round a square tile edge up to whole micro-kernel blocks
+ * @param tile Requested tile edge (<= 0 selects MATRIX_MULT_DEFAULT_TILE)
+ * @param tile_m Receives the row extent, a multiple of MR
+ * @param tile_n Receives the column extent, a multiple of NR
+ */
+void matrix_mult_simd_tile(int tile, int* tile_m, int* tile_n);
+
+/**
+ * @brief Accumulate one unpacked block product with the selected micro-kernel
+ * 
+ * Computes C[0..m, 0..n] += A[0..m, 0..kc] * B[0..kc, 0..n] for row-major
+ * blocks with row strides lda, ldb and ldc. Full MR×NR blocks use the
+ * micro-kernel; ragged edges use a bounds-checked scalar loop.
+ */
+void matrix_mult_simd_block(int m, int n, int kc, const float* A, size_t lda,
+                            const float* B, size_t ldb, float* C, size_t ldc);
+
+#ifdef __cplusplus
+}
+#endif
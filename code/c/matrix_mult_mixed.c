@@ -0,0 +1,967 @@
+/**
+ * @file matrix_mult_mixed.c
+ * @brief Mixed-precision and integer matrix multiplication kernels
+ *
+ * Square C = A × B for element types other than fp32:
+ * - fp16 and bf16 inputs with fp32 accumulation and output
+ * - fp64 inputs, accumulation and output
+ * - int8 inputs with int32 accumulation and output
+ *
+ * Every type has a portable i-k-j kernel generated from one macro
+ * (MIXED_IKJ), so the loop nest is shared and only the element, accumulator
+ * and load conversion differ. Where the CPU has instructions for the type, a
+ * register-blocked kernel replaces it:
+ * - bf16: AVX-512 BF16 vdpbf16ps (x86-64), BFDOT (AArch64 with
+ *         __ARM_FEATURE_BF16_VECTOR_ARITHMETIC); 2-element dot products
+ *         into fp32
+ * - int8: AVX-512 VNNI vpdpbusd (x86-64), SDOT (AArch64 with
+ *         __ARM_FEATURE_DOTPROD); 4-element dot products into int32
+ * - fp16: F16C conversions + FMA (x86-64), vcvt + NEON FMA (AArch64);
+ *         AVX512-FP16 and FEAT_FP16 arithmetic are not used because they
+ *         accumulate in fp16
+ * - fp64: AVX2 + FMA 4×8 block (x86-64)
+ *
+ * The dot-product instructions consume pairs (bf16) or quads (int8) of
+ * consecutive k, so B is first interleaved into column strips in which the
+ * k-group of each column is contiguous; A needs no copy because a k-group
+ * of one row is already contiguous and is broadcast as one 32-bit word.
+ * vpdpbusd multiplies unsigned by signed bytes: A is offset by +128 (an XOR
+ * of the sign bit) and 128·Σ_k B[k,j] is subtracted from each column again.
+ *
+ * Paths are selected once per type from cpuid/xgetbv (x86) or getauxval
+ * (Linux/AArch64); MATRIX_MULT_ISA=scalar forces the portable kernels, as it
+ * does for matrix_multiplication_simd().
+ *
+ * matrix_multiplication_mixed() wraps the typed kernels for fp32 callers:
+ * it converts A and B (int8: symmetric per-matrix scale max|x|/127), runs
+ * the typed kernel and converts the result back, timing the conversions
+ * and the kernel separately.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_mult.h"
+#include "matrix_mult_internal.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MM_X86_64 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define MM_AARCH64 1
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+/* GCC and Clang need the ISA enabled per function; MSVC accepts intrinsics anywhere */
+#if defined(MM_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define MM_TARGET_F16C __attribute__((target("avx,fma,f16c")))
+#define MM_TARGET_FMA __attribute__((target("avx,fma")))
+#define MM_TARGET_BF16 __attribute__((target("avx512f,avx512bf16")))
+#define MM_TARGET_VNNI __attribute__((target("avx512f,avx512vnni")))
+#else
+#define MM_TARGET_F16C
+#define MM_TARGET_FMA
+#define MM_TARGET_BF16
+#define MM_TARGET_VNNI
+#endif
+
+/* The dot-product kernels need these compile-time features on AArch64 */
+#if defined(MM_AARCH64) && defined(__ARM_FEATURE_BF16_VECTOR_ARITHMETIC)
+#define MM_NEON_BF16 1
+#endif
+#if defined(MM_AARCH64) && defined(__ARM_FEATURE_DOTPROD)
+#define MM_NEON_DOT 1
+#endif
+
+/* Columns per interleaved strip of B: two zmm (x86) or four q registers (AArch64) of int32/fp32 */
+#if defined(MM_X86_64)
+#define MIXED_STRIP 32
+#else
+#define MIXED_STRIP 16
+#endif
+
+struct matrix_mult_mixed {
+    matrix_mult_dtype dtype;
+    int n;                      /* Largest dimension served */
+    matrix_mult_arena* arena;   /* Source of the buffers below */
+    void* a;                    /* A converted to dtype */
+    void* b;                    /* B converted to dtype */
+    void* c;                    /* fp64 or int32 product before conversion, or NULL */
+    void* b_pack;               /* Interleaved B (+ column sums for int8), or NULL */
+    double convert_sec;         /* Conversions of the last matrix_multiplication_mixed() */
+    double compute_sec;         /* Typed kernel of the last matrix_multiplication_mixed() */
+};
+
+/* ==================== Helpers ==================== */
+
+/* Unaligned 32-bit load of a k-group (aliasing-safe) */
+static uint32_t load_u32(const void* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/* Last int8 quad of a row with fewer than four k left, zero padded */
+static uint32_t tail_quad(const int8_t* a, int left) {
+    uint32_t v = 0;
+    for (int t = 0; t < left; t++) v |= (uint32_t)(uint8_t)a[t] << (8 * t);
+    return v;
+}
+
+/**
+ * @brief Interleaved B plus column sums for n×n inputs of a dot-product type
+ *
+ * Strips are MIXED_STRIP columns wide and k is rounded up to whole quads,
+ * which also covers bf16 pairs. The int8 column sums follow, line aligned.
+ */
+static size_t pack_bytes(int n, matrix_mult_dtype dtype) {
+    const size_t rows = ((size_t)n + 3) / 4 * 4;
+    const size_t cols = ((size_t)n + MIXED_STRIP - 1) / MIXED_STRIP * MIXED_STRIP;
+    size_t bytes = rows * cols * matrix_mult_dtype_size(dtype);
+    bytes = (bytes + MATRIX_MULT_ALIGN - 1) / MATRIX_MULT_ALIGN * MATRIX_MULT_ALIGN;
+    if (dtype == MATRIX_MULT_INT8) bytes += cols * sizeof(int32_t);
+    return bytes;
+}
+
+/**
+ * @brief Interleave buffer of ws, or a temporary one for this call
+ * @param owned Receives the temporary buffer to free afterwards, or NULL
+ */
+static void* pack_buffer(matrix_mult_mixed* ws, int n, matrix_mult_dtype dtype, void** owned) {
+    *owned = NULL;
+    if (ws && ws->b_pack && ws->dtype == dtype && n <= ws->n) return ws->b_pack;
+    *owned = matrix_mult_aligned_alloc(pack_bytes(n, dtype));
+    return *owned;
+}
+
+/**
+ * @brief Copy B into column strips with each column's k-group contiguous
+ *
+ * Element (k, j) of B lands at strip[(g·width + jj)·GROUP + t] with
+ * k = g·GROUP + t and j = j0 + jj, in strip j0 / width. Positions past n in
+ * either dimension are zero, so the kernels never need a k or j tail on B.
+ */
+#define DEFINE_INTERLEAVE(NAME, T, GROUP)                                       \
+static void NAME(const T* B, int n, int width, T* bp) {                         \
+    const int kg = (n + GROUP - 1) / GROUP;                                     \
+    for (int j0 = 0; j0 < n; j0 += width) {                                     \
+        T* strip = bp + (size_t)(j0 / width) * kg * width * GROUP;              \
+        for (int g = 0; g < kg; g++) {                                          \
+            for (int jj = 0; jj < width; jj++) {                                \
+                for (int t = 0; t < GROUP; t++) {                               \
+                    const int k = g * GROUP + t, j = j0 + jj;                   \
+                    strip[((size_t)g * width + jj) * GROUP + t] =               \
+                        (k < n && j < n) ? B[(size_t)k * n + j] : 0;            \
+                }                                                               \
+            }                                                                   \
+        }                                                                       \
+    }                                                                           \
+}
+
+DEFINE_INTERLEAVE(interleave_pairs, uint16_t, 2)
+DEFINE_INTERLEAVE(interleave_quads, int8_t, 4)
+
+/* ==================== Conversions ==================== */
+
+const char* matrix_mult_dtype_name(matrix_mult_dtype dtype) {
+    switch (dtype) {
+    case MATRIX_MULT_FP16: return "fp16";
+    case MATRIX_MULT_BF16: return "bf16";
+    case MATRIX_MULT_FP64: return "fp64";
+    case MATRIX_MULT_INT8: return "int8";
+    default:               return "fp32";
+    }
+}
+
+size_t matrix_mult_dtype_size(matrix_mult_dtype dtype) {
+    switch (dtype) {
+    case MATRIX_MULT_FP16:
+    case MATRIX_MULT_BF16: return sizeof(uint16_t);
+    case MATRIX_MULT_FP64: return sizeof(double);
+    case MATRIX_MULT_INT8: return sizeof(int8_t);
+    default:               return sizeof(float);
+    }
+}
+
+static uint32_t f32_bits(float x) {
+    uint32_t u;
+    memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+static float f32_from_bits(uint32_t u) {
+    float x;
+    memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+uint16_t matrix_mult_to_bf16(float x) {
+    uint32_t u = f32_bits(x);
+    if ((u & 0x7fffffffu) > 0x7f800000u) return (uint16_t)((u >> 16) | 0x0040u);  /* Quiet NaN */
+    u += 0x7fffu + ((u >> 16) & 1u);        /* Round to nearest, ties to even */
+    return (uint16_t)(u >> 16);
+}
+
+float matrix_mult_from_bf16(uint16_t h) {
+    return f32_from_bits((uint32_t)h << 16);
+}
+
+uint16_t matrix_mult_to_fp16(float x) {
+    const uint32_t u = f32_bits(x);
+    const uint16_t sign = (uint16_t)((u >> 16) & 0x8000u);
+    uint32_t a = u & 0x7fffffffu;
+
+    if (a > 0x7f800000u) return sign | 0x7e00u;         /* NaN */
+    if (a >= 0x47800000u) return sign | 0x7c00u;        /* >= 65536 and Inf */
+    if (a >= 0x38800000u) {                             /* Normal half (>= 2^-14) */
+        a += 0x0fffu + ((a >> 13) & 1u);                /* Round to 10 mantissa bits, ties to even */
+        return sign | (uint16_t)((a - 0x38000000u) >> 13);  /* Rebias 127 -> 15; may carry into Inf */
+    }
+    /* Subnormal half: the value in units of 2^-24, rounded in the default mode */
+    return sign | (uint16_t)nearbyintf(f32_from_bits(a) * 16777216.0f);
+}
+
+float matrix_mult_from_fp16(uint16_t h) {
+    const uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+    const uint32_t e = (h >> 10) & 0x1fu;
+    const uint32_t m = h & 0x3ffu;
+
+    if (e == 0) {
+        const float x = (float)m * 5.9604644775390625e-8f;     /* m · 2^-24 */
+        return sign ? -x : x;
+    }
+    if (e == 31) return f32_from_bits(sign | 0x7f800000u | (m << 13));
+    return f32_from_bits(sign | ((e + 112u) << 23) | (m << 13));
+}
+
+float matrix_mult_quantize_int8(const float* x, int8_t* q, size_t len) {
+    float amax = 0.0f;
+    for (size_t i = 0; i < len; i++) {
+        const float a = fabsf(x[i]);
+        if (a > amax) amax = a;
+    }
+
+    const float scale = amax > 0.0f ? amax / 127.0f : 1.0f;
+    const float inv = 1.0f / scale;
+    for (size_t i = 0; i < len; i++) {
+        float v = x[i] * inv;
+        if (v > 127.0f) v = 127.0f;
+        if (v < -127.0f) v = -127.0f;
+        q[i] = (int8_t)(int)(v + (v >= 0.0f ? 0.5f : -0.5f));   /* Nearest, ties away from zero */
+    }
+    return scale;
+}
+
+/* ==================== Portable kernels ==================== */
+
+/**
+ * @brief i-k-j kernel over columns [j0, n) for one element/accumulator pair
+ *
+ * C has the accumulator type, so the product is accumulated in place. The
+ * SIMD kernels call these with j0 > 0 for the columns their strips leave.
+ */
+#define MIXED_IKJ(NAME, TIN, TACC, LOAD)                                        \
+static void NAME(const TIN* A, const TIN* B, TACC* C, int n, int j0) {          \
+    for (int i = 0; i < n; i++) {                                               \
+        TACC* c = C + (size_t)i * n;                                            \
+        for (int j = j0; j < n; j++) c[j] = 0;                                  \
+        for (int k = 0; k < n; k++) {                                           \
+            const TACC a = LOAD(A[(size_t)i * n + k]);                          \
+            const TIN* b = B + (size_t)k * n;                                   \
+            for (int j = j0; j < n; j++) c[j] += a * LOAD(b[j]);                \
+        }                                                                       \
+    }                                                                           \
+}
+
+#define LOAD_SAME(x) (x)
+#define LOAD_INT8(x) ((int32_t)(x))
+
+MIXED_IKJ(ikj_fp16, uint16_t, float, matrix_mult_from_fp16)
+MIXED_IKJ(ikj_bf16, uint16_t, float, matrix_mult_from_bf16)
+MIXED_IKJ(ikj_fp64, double, double, LOAD_SAME)
+MIXED_IKJ(ikj_int8, int8_t, int32_t, LOAD_INT8)
+
+/* ==================== x86-64 kernels ==================== */
+
+#if defined(MM_X86_64)
+/* Rows i..i+3 of A, clamped to the last row; results of clamped rows are not stored */
+#define ROW_POINTERS(T, A, i, n)                                                \
+    const T* a0 = A + (size_t)((i) + 0 < (n) ? (i) + 0 : (n) - 1) * (n);        \
+    const T* a1 = A + (size_t)((i) + 1 < (n) ? (i) + 1 : (n) - 1) * (n);        \
+    const T* a2 = A + (size_t)((i) + 2 < (n) ? (i) + 2 : (n) - 1) * (n);        \
+    const T* a3 = A + (size_t)((i) + 3 < (n) ? (i) + 3 : (n) - 1) * (n)
+
+/* Broadcast one fp16 of row r and update both ymm accumulators */
+#define F16C_ROW(r)                                                             \
+    a = _mm256_set1_ps(_cvtsh_ss(a##r[k]));                                     \
+    c##r##0 = _mm256_fmadd_ps(a, b0, c##r##0);                                  \
+    c##r##1 = _mm256_fmadd_ps(a, b1, c##r##1)
+
+#define F16C_STORE(r)                                                           \
+    if (i + (r) < n) {                                                          \
+        _mm256_storeu_ps(C + (size_t)(i + (r)) * n + j0, c##r##0);              \
+        _mm256_storeu_ps(C + (size_t)(i + (r)) * n + j0 + 8, c##r##1);          \
+    }
+
+/**
+ * @brief fp16 × fp16 -> fp32 with F16C conversions and FMA, 4×16 blocks
+ *
+ * Each k step converts 16 halves of B to two ymm of fp32 and issues 8 FMAs.
+ * B is read in place: a 16-column strip of it stays in L2 while all row
+ * blocks pass over it.
+ */
+MM_TARGET_F16C
+static void fp16_f16c(const uint16_t* A, const uint16_t* B, float* C, int n) {
+    const int nv = n / 16 * 16;
+
+    for (int j0 = 0; j0 < nv; j0 += 16) {
+        for (int i = 0; i < n; i += 4) {
+            ROW_POINTERS(uint16_t, A, i, n);
+            __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+            __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+            __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+            __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+
+            for (int k = 0; k < n; k++) {
+                const uint16_t* b = B + (size_t)k * n + j0;
+                const __m256 b0 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)b));
+                const __m256 b1 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(b + 8)));
+                __m256 a;
+                F16C_ROW(0); F16C_ROW(1); F16C_ROW(2); F16C_ROW(3);
+            }
+
+            F16C_STORE(0) F16C_STORE(1) F16C_STORE(2) F16C_STORE(3)
+        }
+    }
+    if (nv < n) ikj_fp16(A, B, C, n, nv);
+}
+
+#define FMA64_ROW(r)                                                            \
+    a = _mm256_broadcast_sd(a##r + k);                                          \
+    c##r##0 = _mm256_fmadd_pd(a, b0, c##r##0);                                  \
+    c##r##1 = _mm256_fmadd_pd(a, b1, c##r##1)
+
+#define FMA64_STORE(r)                                                          \
+    if (i + (r) < n) {                                                          \
+        _mm256_storeu_pd(C + (size_t)(i + (r)) * n + j0, c##r##0);              \
+        _mm256_storeu_pd(C + (size_t)(i + (r)) * n + j0 + 4, c##r##1);          \
+    }
+
+/**
+ * @brief fp64 with AVX2-width FMA, 4×8 blocks over B read in place
+ */
+MM_TARGET_FMA
+static void fp64_fma(const double* A, const double* B, double* C, int n) {
+    const int nv = n / 8 * 8;
+
+    for (int j0 = 0; j0 < nv; j0 += 8) {
+        for (int i = 0; i < n; i += 4) {
+            ROW_POINTERS(double, A, i, n);
+            __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+            __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+            __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+            __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+
+            for (int k = 0; k < n; k++) {
+                const double* b = B + (size_t)k * n + j0;
+                const __m256d b0 = _mm256_loadu_pd(b);
+                const __m256d b1 = _mm256_loadu_pd(b + 4);
+                __m256d a;
+                FMA64_ROW(0); FMA64_ROW(1); FMA64_ROW(2); FMA64_ROW(3);
+            }
+
+            FMA64_STORE(0) FMA64_STORE(1) FMA64_STORE(2) FMA64_STORE(3)
+        }
+    }
+    if (nv < n) ikj_fp64(A, B, C, n, nv);
+}
+
+/* Column masks of a 32-wide strip with cols valid columns */
+#define STRIP_MASKS(cols)                                                       \
+    const __mmask16 m0 = (cols) >= 16 ? (__mmask16)0xffff                      \
+                                      : (__mmask16)((1u << (cols)) - 1u);       \
+    const __mmask16 m1 = (cols) <= 16 ? (__mmask16)0                           \
+                       : (cols) >= 32 ? (__mmask16)0xffff                      \
+                                      : (__mmask16)((1u << ((cols) - 16)) - 1u)
+
+/* Broadcast one bf16 pair of row r and update both zmm accumulators */
+#define BF16_ROW(r, pair)                                                       \
+    av = (__m512bh)_mm512_set1_epi32((int)(pair));                              \
+    c##r##0 = _mm512_dpbf16_ps(c##r##0, av, b0);                                \
+    c##r##1 = _mm512_dpbf16_ps(c##r##1, av, b1)
+
+#define BF16_LOAD_B(p)                                                          \
+    const __m512bh b0 = (__m512bh)_mm512_loadu_si512(bs + (size_t)(p) * 64);    \
+    const __m512bh b1 = (__m512bh)_mm512_loadu_si512(bs + (size_t)(p) * 64 + 32); \
+    __m512bh av
+
+#define ZMM_STORE_PS(r)                                                         \
+    if (i + (r) < n) {                                                          \
+        float* c = C + (size_t)(i + (r)) * n + j0;                              \
+        _mm512_mask_storeu_ps(c, m0, c##r##0);                                  \
+        if (m1) _mm512_mask_storeu_ps(c + 16, m1, c##r##1);                     \
+    }
+
+/**
+ * @brief bf16 × bf16 -> fp32 with AVX-512 BF16, 4×32 blocks
+ *
+ * vdpbf16ps adds the products of one k pair to each fp32 lane, so every k
+ * pair costs 2 loads of interleaved B, 4 broadcasts and 8 instructions for
+ * 4·32·2 multiply-adds.
+ */
+MM_TARGET_BF16
+static void bf16_avx512(const uint16_t* A, const uint16_t* B, float* C, int n, uint16_t* bp) {
+    const int kp = (n + 1) / 2;
+    const int kfull = n / 2;
+
+    interleave_pairs(B, n, MIXED_STRIP, bp);
+
+    for (int j0 = 0; j0 < n; j0 += MIXED_STRIP) {
+        const uint16_t* bs = bp + (size_t)(j0 / MIXED_STRIP) * kp * 2 * MIXED_STRIP;
+        const int cols = n - j0 < MIXED_STRIP ? n - j0 : MIXED_STRIP;
+        STRIP_MASKS(cols);
+
+        for (int i = 0; i < n; i += 4) {
+            ROW_POINTERS(uint16_t, A, i, n);
+            __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+            __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+            __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+            __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+
+            int p = 0;
+            for (; p < kfull; p++) {
+                BF16_LOAD_B(p);
+                BF16_ROW(0, load_u32(a0 + 2 * p)); BF16_ROW(1, load_u32(a1 + 2 * p));
+                BF16_ROW(2, load_u32(a2 + 2 * p)); BF16_ROW(3, load_u32(a3 + 2 * p));
+            }
+            if (p < kp) {   /* Odd n: the last pair holds one k */
+                BF16_LOAD_B(p);
+                BF16_ROW(0, a0[2 * p]); BF16_ROW(1, a1[2 * p]);
+                BF16_ROW(2, a2[2 * p]); BF16_ROW(3, a3[2 * p]);
+            }
+
+            ZMM_STORE_PS(0) ZMM_STORE_PS(1) ZMM_STORE_PS(2) ZMM_STORE_PS(3)
+        }
+    }
+}
+
+/* Broadcast one int8 quad of row r, offset to unsigned, into both accumulators */
+#define VNNI_ROW(r, quad)                                                       \
+    av = _mm512_set1_epi32((int)((quad) ^ 0x80808080u));                        \
+    c##r##0 = _mm512_dpbusd_epi32(c##r##0, av, b0);                             \
+    c##r##1 = _mm512_dpbusd_epi32(c##r##1, av, b1)
+
+#define VNNI_LOAD_B(q)                                                          \
+    const __m512i b0 = _mm512_loadu_si512(bs + (size_t)(q) * 128);              \
+    const __m512i b1 = _mm512_loadu_si512(bs + (size_t)(q) * 128 + 64);         \
+    __m512i av
+
+#define ZMM_STORE_EPI32(r)                                                      \
+    if (i + (r) < n) {                                                          \
+        int32_t* c = C + (size_t)(i + (r)) * n + j0;                            \
+        _mm512_mask_storeu_epi32(c, m0, _mm512_sub_epi32(c##r##0, s0));         \
+        if (m1) _mm512_mask_storeu_epi32(c + 16, m1, _mm512_sub_epi32(c##r##1, s1)); \
+    }
+
+/**
+ * @brief int8 × int8 -> int32 with AVX-512 VNNI, 4×32 blocks
+ * @param col_sum Scratch for 128·Σ_k B[k,j], MIXED_STRIP-padded
+ *
+ * vpdpbusd adds four u8·s8 products to each int32 lane without saturation.
+ * A is biased to unsigned (a + 128) on broadcast, and the bias is removed
+ * with the column sums before the store.
+ */
+MM_TARGET_VNNI
+static void int8_avx512_vnni(const int8_t* A, const int8_t* B, int32_t* C, int n,
+                             int8_t* bp, int32_t* col_sum) {
+    const int kq = (n + 3) / 4;
+    const int kfull = n / 4;
+    const int ncols = (n + MIXED_STRIP - 1) / MIXED_STRIP * MIXED_STRIP;
+
+    interleave_quads(B, n, MIXED_STRIP, bp);
+    for (int j = 0; j < ncols; j++) col_sum[j] = 0;
+    for (int k = 0; k < n; k++) {
+        const int8_t* b = B + (size_t)k * n;
+        for (int j = 0; j < n; j++) col_sum[j] += 128 * b[j];
+    }
+
+    for (int j0 = 0; j0 < n; j0 += MIXED_STRIP) {
+        const int8_t* bs = bp + (size_t)(j0 / MIXED_STRIP) * kq * 4 * MIXED_STRIP;
+        const int cols = n - j0 < MIXED_STRIP ? n - j0 : MIXED_STRIP;
+        const __m512i s0 = _mm512_loadu_si512(col_sum + j0);
+        const __m512i s1 = _mm512_loadu_si512(col_sum + j0 + 16);
+        STRIP_MASKS(cols);
+
+        for (int i = 0; i < n; i += 4) {
+            ROW_POINTERS(int8_t, A, i, n);
+            __m512i c00 = _mm512_setzero_si512(), c01 = _mm512_setzero_si512();
+            __m512i c10 = _mm512_setzero_si512(), c11 = _mm512_setzero_si512();
+            __m512i c20 = _mm512_setzero_si512(), c21 = _mm512_setzero_si512();
+            __m512i c30 = _mm512_setzero_si512(), c31 = _mm512_setzero_si512();
+
+            int q = 0;
+            for (; q < kfull; q++) {
+                VNNI_LOAD_B(q);
+                VNNI_ROW(0, load_u32(a0 + 4 * q)); VNNI_ROW(1, load_u32(a1 + 4 * q));
+                VNNI_ROW(2, load_u32(a2 + 4 * q)); VNNI_ROW(3, load_u32(a3 + 4 * q));
+            }
+            if (q < kq) {   /* n not a multiple of 4: B is zero past k = n */
+                const int left = n - 4 * q;
+                VNNI_LOAD_B(q);
+                VNNI_ROW(0, tail_quad(a0 + 4 * q, left)); VNNI_ROW(1, tail_quad(a1 + 4 * q, left));
+                VNNI_ROW(2, tail_quad(a2 + 4 * q, left)); VNNI_ROW(3, tail_quad(a3 + 4 * q, left));
+            }
+
+            ZMM_STORE_EPI32(0) ZMM_STORE_EPI32(1) ZMM_STORE_EPI32(2) ZMM_STORE_EPI32(3)
+        }
+    }
+}
+#endif
+
+/* ==================== AArch64 kernels ==================== */
+
+#if defined(MM_AARCH64)
+/* Rows i..i+3 of A, clamped to the last row; results of clamped rows are not stored */
+static void row_pointers(const void* A, size_t elem, int i, int n, const void* a[4]) {
+    for (int r = 0; r < 4; r++) {
+        const int row = i + r < n ? i + r : n - 1;
+        a[r] = (const char*)A + (size_t)row * n * elem;
+    }
+}
+
+/**
+ * @brief fp16 × fp16 -> fp32 with NEON conversions and FMA, 4×16 blocks
+ */
+static void fp16_neon(const uint16_t* A, const uint16_t* B, float* C, int n) {
+    const int nv = n / 16 * 16;
+
+    for (int j0 = 0; j0 < nv; j0 += 16) {
+        for (int i = 0; i < n; i += 4) {
+            const void* a[4];
+            float32x4_t acc[4][4];
+            row_pointers(A, sizeof(uint16_t), i, n, a);
+            for (int r = 0; r < 4; r++)
+                for (int v = 0; v < 4; v++) acc[r][v] = vdupq_n_f32(0.0f);
+
+            for (int k = 0; k < n; k++) {
+                const uint16_t* b = B + (size_t)k * n + j0;
+                float32x4_t bv[4];
+                for (int v = 0; v < 4; v++) bv[v] = vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(b + 4 * v)));
+                for (int r = 0; r < 4; r++) {
+                    const float32x4_t av = vdupq_n_f32(matrix_mult_from_fp16(((const uint16_t*)a[r])[k]));
+                    for (int v = 0; v < 4; v++) acc[r][v] = vfmaq_f32(acc[r][v], av, bv[v]);
+                }
+            }
+
+            for (int r = 0; r < 4 && i + r < n; r++)
+                for (int v = 0; v < 4; v++) vst1q_f32(C + (size_t)(i + r) * n + j0 + 4 * v, acc[r][v]);
+        }
+    }
+    if (nv < n) ikj_fp16(A, B, C, n, nv);
+}
+#endif
+
+#if defined(MM_NEON_BF16)
+/**
+ * @brief bf16 × bf16 -> fp32 with BFDOT, 4×16 blocks
+ *
+ * Each q register of interleaved B holds one k pair of four columns.
+ */
+static void bf16_neon(const uint16_t* A, const uint16_t* B, float* C, int n, uint16_t* bp) {
+    const int kp = (n + 1) / 2;
+    const int kfull = n / 2;
+
+    interleave_pairs(B, n, MIXED_STRIP, bp);
+
+    for (int j0 = 0; j0 < n; j0 += MIXED_STRIP) {
+        const uint16_t* bs = bp + (size_t)(j0 / MIXED_STRIP) * kp * 2 * MIXED_STRIP;
+        const int cols = n - j0 < MIXED_STRIP ? n - j0 : MIXED_STRIP;
+
+        for (int i = 0; i < n; i += 4) {
+            const void* a[4];
+            float32x4_t acc[4][4];
+            row_pointers(A, sizeof(uint16_t), i, n, a);
+            for (int r = 0; r < 4; r++)
+                for (int v = 0; v < 4; v++) acc[r][v] = vdupq_n_f32(0.0f);
+
+            for (int p = 0; p < kp; p++) {
+                const uint16_t* bk = bs + (size_t)p * 2 * MIXED_STRIP;
+                bfloat16x8_t bv[4];
+                for (int v = 0; v < 4; v++) bv[v] = vreinterpretq_bf16_u16(vld1q_u16(bk + 8 * v));
+                for (int r = 0; r < 4; r++) {
+                    const uint16_t* ar = (const uint16_t*)a[r] + 2 * p;
+                    const uint32_t pair = p < kfull ? load_u32(ar) : ar[0];
+                    const bfloat16x8_t av = vreinterpretq_bf16_u32(vdupq_n_u32(pair));
+                    for (int v = 0; v < 4; v++) acc[r][v] = vbfdotq_f32(acc[r][v], av, bv[v]);
+                }
+            }
+
+            for (int r = 0; r < 4 && i + r < n; r++) {
+                float row[MIXED_STRIP];
+                for (int v = 0; v < 4; v++) vst1q_f32(row + 4 * v, acc[r][v]);
+                memcpy(C + (size_t)(i + r) * n + j0, row, (size_t)cols * sizeof(float));
+            }
+        }
+    }
+}
+#endif
+
+#if defined(MM_NEON_DOT)
+/**
+ * @brief int8 × int8 -> int32 with SDOT, 4×16 blocks
+ *
+ * SDOT multiplies signed by signed bytes, so no bias correction is needed.
+ */
+static void int8_neon_dot(const int8_t* A, const int8_t* B, int32_t* C, int n, int8_t* bp) {
+    const int kq = (n + 3) / 4;
+    const int kfull = n / 4;
+
+    interleave_quads(B, n, MIXED_STRIP, bp);
+
+    for (int j0 = 0; j0 < n; j0 += MIXED_STRIP) {
+        const int8_t* bs = bp + (size_t)(j0 / MIXED_STRIP) * kq * 4 * MIXED_STRIP;
+        const int cols = n - j0 < MIXED_STRIP ? n - j0 : MIXED_STRIP;
+
+        for (int i = 0; i < n; i += 4) {
+            const void* a[4];
+            int32x4_t acc[4][4];
+            row_pointers(A, sizeof(int8_t), i, n, a);
+            for (int r = 0; r < 4; r++)
+                for (int v = 0; v < 4; v++) acc[r][v] = vdupq_n_s32(0);
+
+            for (int q = 0; q < kq; q++) {
+                const int8_t* bk = bs + (size_t)q * 4 * MIXED_STRIP;
+                int8x16_t bv[4];
+                for (int v = 0; v < 4; v++) bv[v] = vld1q_s8(bk + 16 * v);
+                for (int r = 0; r < 4; r++) {
+                    const int8_t* ar = (const int8_t*)a[r] + 4 * q;
+                    const uint32_t quad = q < kfull ? load_u32(ar) : tail_quad(ar, n - 4 * q);
+                    const int8x16_t av = vreinterpretq_s8_u32(vdupq_n_u32(quad));
+                    for (int v = 0; v < 4; v++) acc[r][v] = vdotq_s32(acc[r][v], av, bv[v]);
+                }
+            }
+
+            for (int r = 0; r < 4 && i + r < n; r++) {
+                int32_t row[MIXED_STRIP];
+                for (int v = 0; v < 4; v++) vst1q_s32(row + 4 * v, acc[r][v]);
+                memcpy(C + (size_t)(i + r) * n + j0, row, (size_t)cols * sizeof(int32_t));
+            }
+        }
+    }
+}
+#endif
+
+/* ==================== Dispatch ==================== */
+
+#if defined(MM_X86_64)
+#define FEAT_FMA_F16C   0x1     /* AVX + FMA + F16C with ymm state enabled */
+#define FEAT_AVX512_BF16 0x2    /* AVX512F + AVX512_BF16 with zmm state enabled */
+#define FEAT_AVX512_VNNI 0x4    /* AVX512F + AVX512_VNNI with zmm state enabled */
+
+/**
+ * @brief Probe the x86 features the mixed-precision kernels use
+ * @return FEAT_* bits
+ */
+static unsigned cpu_mixed_features(void) {
+    unsigned int r1[4], r7[4], r71[4] = { 0, 0, 0, 0 };
+    unsigned long long xcr0;
+
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, 1, 0);
+    memcpy(r1, info, sizeof(r1));
+    __cpuidex(info, 0, 0);
+    if (info[0] < 7) return 0;
+    __cpuidex(info, 7, 0);
+    memcpy(r7, info, sizeof(r7));
+    if (r7[0] >= 1) {
+        __cpuidex(info, 7, 1);
+        memcpy(r71, info, sizeof(r71));
+    }
+#else
+    if (!__get_cpuid_count(1, 0, &r1[0], &r1[1], &r1[2], &r1[3])) return 0;
+    if (!__get_cpuid_count(7, 0, &r7[0], &r7[1], &r7[2], &r7[3])) return 0;
+    if (r7[0] >= 1) __get_cpuid_count(7, 1, &r71[0], &r71[1], &r71[2], &r71[3]);
+#endif
+
+    const int fma = (r1[2] >> 12) & 1;          /* CPUID.1:ECX.FMA */
+    const int osxsave = (r1[2] >> 27) & 1;      /* CPUID.1:ECX.OSXSAVE */
+    const int avx = (r1[2] >> 28) & 1;          /* CPUID.1:ECX.AVX */
+    const int f16c = (r1[2] >> 29) & 1;         /* CPUID.1:ECX.F16C */
+    const int avx512f = (r7[1] >> 16) & 1;      /* CPUID.7.0:EBX.AVX512F */
+    const int vnni = (r7[2] >> 11) & 1;         /* CPUID.7.0:ECX.AVX512_VNNI */
+    const int bf16 = (r71[0] >> 5) & 1;         /* CPUID.7.1:EAX.AVX512_BF16 */
+    if (!(osxsave && avx)) return 0;
+
+#if defined(_MSC_VER)
+    xcr0 = _xgetbv(0);
+#else
+    unsigned int lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    xcr0 = ((unsigned long long)hi << 32) | lo;
+#endif
+    const int ymm = (xcr0 & 0x6) == 0x6;        /* xmm + ymm state */
+    const int zmm = (xcr0 & 0xe6) == 0xe6;      /* + opmask and both zmm halves */
+
+    unsigned features = 0;
+    if (ymm && fma && f16c) features |= FEAT_FMA_F16C;
+    if (zmm && avx512f && bf16) features |= FEAT_AVX512_BF16;
+    if (zmm && avx512f && vnni) features |= FEAT_AVX512_VNNI;
+    return features;
+}
+#endif
+
+#if defined(MM_AARCH64)
+#define FEAT_NEON_BF16 0x1      /* BFDOT */
+#define FEAT_NEON_DOT  0x2      /* SDOT/UDOT */
+
+/**
+ * @brief Probe the AArch64 features the mixed-precision kernels use
+ * @return FEAT_* bits (only for kernels this build compiled in)
+ */
+static unsigned cpu_mixed_features(void) {
+    unsigned features = 0;
+#if defined(MM_NEON_BF16)
+#if defined(__linux__) && defined(HWCAP2_BF16)
+    if (getauxval(AT_HWCAP2) & HWCAP2_BF16) features |= FEAT_NEON_BF16;
+#else
+    features |= FEAT_NEON_BF16;   /* The build targets a CPU with BF16 */
+#endif
+#endif
+#if defined(MM_NEON_DOT)
+#if defined(__linux__) && defined(HWCAP_ASIMDDP)
+    if (getauxval(AT_HWCAP) & HWCAP_ASIMDDP) features |= FEAT_NEON_DOT;
+#else
+    features |= FEAT_NEON_DOT;
+#endif
+#endif
+    return features;
+}
+#endif
+
+/* ISA name per dtype as reported by matrix_mult_mixed_isa(); "scalar" = portable kernel */
+static const char* mixed_paths[MATRIX_MULT_INT8 + 1];
+
+/**
+ * @brief Pick the kernel of every dtype for this CPU (runs once)
+ *
+ * Concurrent first calls may both run the detection; they store the same
+ * names, so the race is benign.
+ */
+static void mixed_detect(void) {
+    static int detected = 0;
+    if (detected) return;
+
+    const char* force = getenv("MATRIX_MULT_ISA");
+    const int scalar = force && strcmp(force, "scalar") == 0;
+    for (int t = MATRIX_MULT_FP16; t <= MATRIX_MULT_INT8; t++) mixed_paths[t] = "scalar";
+
+    if (!scalar) {
+#if defined(MM_X86_64)
+        const unsigned f = cpu_mixed_features();
+        if (f & FEAT_FMA_F16C) {
+            mixed_paths[MATRIX_MULT_FP16] = "f16c";
+            mixed_paths[MATRIX_MULT_FP64] = "avx2";
+        }
+        if (f & FEAT_AVX512_BF16) mixed_paths[MATRIX_MULT_BF16] = "avx512-bf16";
+        if (f & FEAT_AVX512_VNNI) mixed_paths[MATRIX_MULT_INT8] = "avx512-vnni";
+#endif
+#if defined(MM_AARCH64)
+        const unsigned f = cpu_mixed_features();
+        mixed_paths[MATRIX_MULT_FP16] = "neon";
+        if (f & FEAT_NEON_BF16) mixed_paths[MATRIX_MULT_BF16] = "neon-bf16";
+        if (f & FEAT_NEON_DOT) mixed_paths[MATRIX_MULT_INT8] = "neon-dotprod";
+#endif
+    }
+    detected = 1;
+}
+
+/* Non-zero if dtype has a vector kernel on this CPU */
+static int mixed_vector(matrix_mult_dtype dtype) {
+    mixed_detect();
+    return strcmp(mixed_paths[dtype], "scalar") != 0;
+}
+
+const char* matrix_mult_mixed_isa(matrix_mult_dtype dtype) {
+    if (dtype < MATRIX_MULT_FP16 || dtype > MATRIX_MULT_INT8) return matrix_mult_simd_isa();
+    mixed_detect();
+    return mixed_paths[dtype];
+}
+
+/* ==================== Typed kernels ==================== */
+
+void matrix_multiplication_fp16(const uint16_t* A, const uint16_t* B, float* C, int n) {
+    if (!mixed_vector(MATRIX_MULT_FP16)) {
+        ikj_fp16(A, B, C, n, 0);
+        return;
+    }
+#if defined(MM_X86_64)
+    fp16_f16c(A, B, C, n);
+#elif defined(MM_AARCH64)
+    fp16_neon(A, B, C, n);
+#endif
+}
+
+void matrix_multiplication_bf16(const uint16_t* A, const uint16_t* B, float* C, int n,
+                                matrix_mult_mixed* ws) {
+    void* owned = NULL;
+    uint16_t* bp = mixed_vector(MATRIX_MULT_BF16)
+                 ? (uint16_t*)pack_buffer(ws, n, MATRIX_MULT_BF16, &owned) : NULL;
+    if (!bp) {
+        ikj_bf16(A, B, C, n, 0);
+        return;
+    }
+#if defined(MM_X86_64)
+    bf16_avx512(A, B, C, n, bp);
+#elif defined(MM_NEON_BF16)
+    bf16_neon(A, B, C, n, bp);
+#endif
+    matrix_mult_aligned_free(owned);
+}
+
+void matrix_multiplication_fp64(const double* A, const double* B, double* C, int n) {
+    if (!mixed_vector(MATRIX_MULT_FP64)) {
+        ikj_fp64(A, B, C, n, 0);
+        return;
+    }
+#if defined(MM_X86_64)
+    fp64_fma(A, B, C, n);
+#endif
+}
+
+void matrix_multiplication_int8(const int8_t* A, const int8_t* B, int32_t* C, int n,
+                                matrix_mult_mixed* ws) {
+    void* owned = NULL;
+    int8_t* bp = mixed_vector(MATRIX_MULT_INT8)
+               ? (int8_t*)pack_buffer(ws, n, MATRIX_MULT_INT8, &owned) : NULL;
+    if (!bp) {
+        ikj_int8(A, B, C, n, 0);
+        return;
+    }
+#if defined(MM_X86_64)
+    const size_t sums = pack_bytes(n, MATRIX_MULT_INT8)
+                      - ((size_t)n + MIXED_STRIP - 1) / MIXED_STRIP * MIXED_STRIP * sizeof(int32_t);
+    int8_avx512_vnni(A, B, C, n, bp, (int32_t*)((char*)bp + sums));
+#elif defined(MM_NEON_DOT)
+    int8_neon_dot(A, B, C, n, bp);
+#endif
+    matrix_mult_aligned_free(owned);
+}
+
+/* ==================== fp32 wrapper ==================== */
+
+matrix_mult_mixed* matrix_mult_mixed_create(int n, matrix_mult_dtype dtype, matrix_mult_arena* arena) {
+    if (n <= 0 || dtype < MATRIX_MULT_FP16 || dtype > MATRIX_MULT_INT8) return NULL;
+
+    matrix_mult_mixed* ws = (matrix_mult_mixed*)calloc(1, sizeof(*ws));
+    if (!ws) return NULL;
+    ws->dtype = dtype;
+    ws->n = n;
+    ws->arena = arena;
+
+    const size_t len = (size_t)n * n;
+    const size_t elem = matrix_mult_dtype_size(dtype);
+    ws->a = matrix_mult_scratch_alloc(arena, len * elem);
+    ws->b = matrix_mult_scratch_alloc(arena, len * elem);
+    int ok = ws->a && ws->b;
+    if (dtype == MATRIX_MULT_FP64 || dtype == MATRIX_MULT_INT8) {
+        ws->c = matrix_mult_scratch_alloc(arena, len * (dtype == MATRIX_MULT_FP64 ? sizeof(double)
+                                                                                   : sizeof(int32_t)));
+        ok = ok && ws->c;
+    }
+    if (dtype == MATRIX_MULT_BF16 || dtype == MATRIX_MULT_INT8) {
+        ws->b_pack = matrix_mult_scratch_alloc(arena, pack_bytes(n, dtype));
+        ok = ok && ws->b_pack;
+    }
+    if (!ok) {
+        matrix_mult_mixed_destroy(ws);
+        return NULL;
+    }
+    return ws;
+}
+
+void matrix_mult_mixed_destroy(matrix_mult_mixed* ws) {
+    if (!ws) return;
+    matrix_mult_scratch_free(ws->arena, ws->a);
+    matrix_mult_scratch_free(ws->arena, ws->b);
+    matrix_mult_scratch_free(ws->arena, ws->c);
+    matrix_mult_scratch_free(ws->arena, ws->b_pack);
+    free(ws);
+}
+
+matrix_mult_dtype matrix_mult_mixed_dtype(const matrix_mult_mixed* ws) {
+    return ws->dtype;
+}
+
+void matrix_mult_mixed_times(const matrix_mult_mixed* ws, double* convert_sec, double* compute_sec) {
+    if (convert_sec) *convert_sec = ws->convert_sec;
+    if (compute_sec) *compute_sec = ws->compute_sec;
+}
+
+void matrix_multiplication_mixed(const float* A, const float* B, float* C, int n,
+                                 matrix_mult_mixed* ws) {
+    const size_t len = (size_t)n * n;
+    const double t0 = matrix_mult_now();
+    double t1, t2;
+
+    switch (ws->dtype) {
+    case MATRIX_MULT_FP16: {
+        uint16_t* a = (uint16_t*)ws->a;
+        uint16_t* b = (uint16_t*)ws->b;
+        for (size_t i = 0; i < len; i++) a[i] = matrix_mult_to_fp16(A[i]);
+        for (size_t i = 0; i < len; i++) b[i] = matrix_mult_to_fp16(B[i]);
+        t1 = matrix_mult_now();
+        matrix_multiplication_fp16(a, b, C, n);
+        t2 = matrix_mult_now();
+        break;
+    }
+    case MATRIX_MULT_BF16: {
+        uint16_t* a = (uint16_t*)ws->a;
+        uint16_t* b = (uint16_t*)ws->b;
+        for (size_t i = 0; i < len; i++) a[i] = matrix_mult_to_bf16(A[i]);
+        for (size_t i = 0; i < len; i++) b[i] = matrix_mult_to_bf16(B[i]);
+        t1 = matrix_mult_now();
+        matrix_multiplication_bf16(a, b, C, n, ws);
+        t2 = matrix_mult_now();
+        break;
+    }
+    case MATRIX_MULT_FP64: {
+        double* a = (double*)ws->a;
+        double* b = (double*)ws->b;
+        double* c = (double*)ws->c;
+        for (size_t i = 0; i < len; i++) a[i] = A[i];
+        for (size_t i = 0; i < len; i++) b[i] = B[i];
+        t1 = matrix_mult_now();
+        matrix_multiplication_fp64(a, b, c, n);
+        t2 = matrix_mult_now();
+        for (size_t i = 0; i < len; i++) C[i] = (float)c[i];
+        break;
+    }
+    default: {  /* MATRIX_MULT_INT8 */
+        int8_t* a = (int8_t*)ws->a;
+        int8_t* b = (int8_t*)ws->b;
+        int32_t* c = (int32_t*)ws->c;
+        const float scale = matrix_mult_quantize_int8(A, a, len) * matrix_mult_quantize_int8(B, b, len);
+        t1 = matrix_mult_now();
+        matrix_multiplication_int8(a, b, c, n, ws);
+        t2 = matrix_mult_now();
+        for (size_t i = 0; i < len; i++) C[i] = (float)c[i] * scale;
+        break;
+    }
+    }
+
+    ws->compute_sec = t2 - t1;
+    ws->convert_sec = (t1 - t0) + (matrix_mult_now() - t2);
+}
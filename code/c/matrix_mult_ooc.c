@@ -0,0 +1,202 @@
+/**
+ * @file matrix_mult_ooc.c
+ * @brief Out-of-core gemm streaming tiles through a fixed memory budget
+ *
+ * The operands may be far larger than memory (typically read-only file
+ * mappings, see matrix_file.h in the harness). The kernel keeps three
+ * buffers inside the budget and moves every byte through them explicitly:
+ * - a band of tm rows of C (tm × n), accumulated in memory
+ * - a panel of tk rows of B (tk × n), copied from B
+ * - the matching tm × tk block of A, copied from A
+ * For each band of C all panels of B stream past, then the band is written
+ * back once. Whole rows are copied, so every read and write is contiguous
+ * and touches each page of a mapping once per pass. B is read ceil(m/tm)
+ * times, so the planner makes tm as large as the budget allows for the
+ * panel depth (MATRIX_MULT_OOC_PANEL rows, fewer for very wide B).
+ *
+ * With MATRIX_MULT_OOC_MAPPED the operands' pages are handed back to the
+ * OS (madvise(MADV_DONTNEED)) right after they are copied or written, so
+ * the process's resident set stays at the budget instead of growing to the
+ * whole mapping; the page cache itself is left to the OS. Windows keeps
+ * them mapped (no equivalent call for file views).
+ *
+ * The in-memory product of each panel runs on the packed gemm driver
+ * (gemm_with_pack()); its packing buffers count against the budget.
+ */
+
+/* madvise() is not ISO C; expose it under -std=c11 too */
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
+#include <stdint.h>
+#include <string.h>
+#include "matrix_mult.h"
+#include "matrix_mult_internal.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define OOC_MADVISE 1
+#endif
+
+struct matrix_mult_ooc {
+    matrix_mult_arena* arena;   /* Arena the buffers came from, or NULL */
+    matrix_mult_pack* pack;     /* Packing buffers of the in-memory product */
+    float* buf;                 /* C band, B panel and A block, carved per call */
+    size_t capacity;            /* Floats in buf */
+    int flags;                  /* MATRIX_MULT_OOC_* */
+    size_t tm, tk;              /* Band rows and panel depth of the last call */
+    double bytes_read;          /* Operand bytes copied in by the last call */
+    double bytes_written;       /* Result bytes copied out by the last call */
+};
+
+/* ==================== Helpers ==================== */
+
+/**
+ * @brief Floats the three buffers need for bands of tm rows and panels of tk
+ */
+static size_t ooc_need(size_t tm, size_t tk, size_t n) {
+    return tm * n + tk * n + tm * tk;
+}
+
+/**
+ * @brief Largest band for an m×n×k problem within capacity floats
+ * @param tk Receives the panel depth
+ * @return Band rows, or 0 if not even one row of C fits
+ *
+ * The panel depth starts at MATRIX_MULT_OOC_PANEL and halves until a band
+ * of at least one row fits next to it.
+ */
+static size_t ooc_plan(size_t m, size_t n, size_t k, size_t capacity, size_t* tk) {
+    size_t depth = k < (size_t)MATRIX_MULT_OOC_PANEL ? k : (size_t)MATRIX_MULT_OOC_PANEL;
+    if (depth == 0) depth = 1;  /* k == 0 still clears C */
+    for (; depth >= 1; depth /= 2) {
+        if (ooc_need(1, depth, n) > capacity) continue;
+        size_t tm = (capacity - depth * n) / (n + depth);
+        *tk = depth;
+        return tm < m ? tm : m;
+    }
+    return 0;
+}
+
+/**
+ * @brief Hand the whole pages inside [p, p + bytes) back to the OS
+ *
+ * Partial pages at either end are kept: they may hold rows the next copy
+ * still needs. Dirty pages of a shared file mapping are written back, not
+ * lost.
+ */
+static void ooc_drop(const void* p, size_t bytes) {
+#if defined(OOC_MADVISE) && defined(MADV_DONTNEED)
+    const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t lo = ((uintptr_t)p + page - 1) / page * page;
+    uintptr_t hi = ((uintptr_t)p + bytes) / page * page;
+    if (hi > lo) madvise((void*)lo, (size_t)(hi - lo), MADV_DONTNEED);
+#else
+    (void)p; (void)bytes;
+#endif
+}
+
+/* ==================== Public API ==================== */
+
+matrix_mult_ooc* matrix_mult_ooc_create(int n, size_t budget, int flags, matrix_mult_arena* arena) {
+    matrix_mult_ooc* ooc = (matrix_mult_ooc*)matrix_mult_scratch_alloc(arena, sizeof(*ooc));
+    if (!ooc) return NULL;
+    memset(ooc, 0, sizeof(*ooc));
+    ooc->arena = arena;
+    ooc->flags = flags;
+    if (budget == 0) budget = MATRIX_MULT_OOC_DEFAULT_BUDGET;
+    if (n < 1) n = 1;
+
+    /* Packing panels first, sized like gemm()'s for a problem this large */
+    ooc->pack = matrix_mult_pack_create(n, 0, 0, 0, arena);
+    if (!ooc->pack) {
+        matrix_mult_ooc_destroy(ooc);
+        return NULL;
+    }
+    const size_t mc = (size_t)(n < MATRIX_MULT_PACK_MC ? n : MATRIX_MULT_PACK_MC);
+    const size_t kc = (size_t)(n < MATRIX_MULT_PACK_KC ? n : MATRIX_MULT_PACK_KC);
+    const size_t nc = (size_t)(n < MATRIX_MULT_PACK_NC ? n : MATRIX_MULT_PACK_NC);
+    const size_t pack_bytes = ((mc + 16) * kc + kc * (nc + 16)) * sizeof(float);
+    if (budget <= pack_bytes) {
+        matrix_mult_ooc_destroy(ooc);
+        return NULL;
+    }
+
+    /* The rest of the budget, but never more than an n×n problem can use */
+    const size_t dim = (size_t)n;
+    const size_t panel = dim < (size_t)MATRIX_MULT_OOC_PANEL ? dim : (size_t)MATRIX_MULT_OOC_PANEL;
+    size_t capacity = (budget - pack_bytes) / sizeof(float);
+    if (capacity > ooc_need(dim, panel, dim)) capacity = ooc_need(dim, panel, dim);
+    ooc->buf = (float*)matrix_mult_scratch_alloc(arena, capacity * sizeof(float));
+    if (!ooc->buf) {
+        matrix_mult_ooc_destroy(ooc);
+        return NULL;
+    }
+    ooc->capacity = capacity;
+    return ooc;
+}
+
+void matrix_mult_ooc_destroy(matrix_mult_ooc* ooc) {
+    if (!ooc) return;
+    matrix_mult_pack_destroy(ooc->pack);
+    matrix_mult_scratch_free(ooc->arena, ooc->buf);
+    matrix_mult_scratch_free(ooc->arena, ooc);
+}
+
+int gemm_ooc(size_t m, size_t n, size_t k, const float* A, const float* B, float* C,
+             matrix_mult_ooc* ooc) {
+    size_t tk = 0;
+    const size_t tm = ooc_plan(m, n, k, ooc->capacity, &tk);
+    const int mapped = ooc->flags & MATRIX_MULT_OOC_MAPPED;
+    ooc->tm = tm;
+    ooc->tk = tk;
+    ooc->bytes_read = 0.0;
+    ooc->bytes_written = 0.0;
+    if (m == 0 || n == 0) return 0;
+    if (tm == 0) return -1;
+
+    float* c_band = ooc->buf;
+    float* b_panel = c_band + tm * n;
+    float* a_block = b_panel + tk * n;
+
+    for (size_t i0 = 0; i0 < m; i0 += tm) {
+        const size_t mb = m - i0 < tm ? m - i0 : tm;
+        memset(c_band, 0, mb * n * sizeof(float));
+
+        for (size_t p0 = 0; p0 < k; p0 += tk) {
+            const size_t kb = k - p0 < tk ? k - p0 : tk;
+
+            /* Rows p0.. of B are contiguous: one copy per panel */
+            memcpy(b_panel, B + p0 * n, kb * n * sizeof(float));
+            for (size_t i = 0; i < mb; i++) {
+                memcpy(a_block + i * kb, A + (i0 + i) * k + p0, kb * sizeof(float));
+            }
+            ooc->bytes_read += (double)(kb * n + mb * kb) * sizeof(float);
+            if (mapped) ooc_drop(B + p0 * n, kb * n * sizeof(float));
+
+            gemm_with_pack(mb, n, kb, 1.0f, a_block, kb, b_panel, n, 1.0f, c_band, n, ooc->pack);
+        }
+
+        /* The band of A is finished; C is written back once per band */
+        memcpy(C + i0 * n, c_band, mb * n * sizeof(float));
+        ooc->bytes_written += (double)(mb * n) * sizeof(float);
+        if (mapped) {
+            ooc_drop(A + i0 * k, mb * k * sizeof(float));
+            ooc_drop(C + i0 * n, mb * n * sizeof(float));
+        }
+    }
+    return 0;
+}
+
+void matrix_mult_ooc_traffic(const matrix_mult_ooc* ooc, double* bytes_read, double* bytes_written) {
+    if (bytes_read) *bytes_read = ooc->bytes_read;
+    if (bytes_written) *bytes_written = ooc->bytes_written;
+}
+
+void matrix_mult_ooc_tiles(const matrix_mult_ooc* ooc, size_t* tm, size_t* tk, size_t* buffer_bytes) {
+    if (tm) *tm = ooc->tm;
+    if (tk) *tk = ooc->tk;
+    if (buffer_bytes) *buffer_bytes = ooc->capacity * sizeof(float);
+}
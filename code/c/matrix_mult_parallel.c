@@ -0,0 +1,288 @@
+/**
+ * @file matrix_mult_parallel.c
+ * @brief Multithreaded matrix multiplication over the C tile grid (OpenMP)
+ *
+ * The output matrix is cut into the same MR/NR-aligned tiles as the SIMD
+ * kernel. Each tile is owned by exactly one thread, which clears it and
+ * accumulates all of its k-blocks, so no synchronisation is needed beyond
+ * handing out tiles. Two ways of handing out tiles are provided:
+ * - matrix_multiplication_parallel(): static split of the tile range
+ * - matrix_multiplication_stealing(): per-thread deques with work stealing,
+ *   for ragged tile grids and cores shared with other processes
+ *
+ * Build with OpenMP enabled (gcc/clang -fopenmp, MSVC /openmp). Without it
+ * the same loops run on the calling thread, so the kernels still work and
+ * the thread count is reported as 1.
+ */
+
+#include <string.h>
+#include "matrix_mult.h"
+#include "matrix_mult_internal.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Deque entries are padded to a cache line so owners and thieves on
+ * different cores do not invalidate each other's counters */
+#define DEQUE_PAD 64
+
+/**
+ * @brief Tile geometry shared by all threads of one multiply
+ */
+typedef struct {
+    const float* A;
+    const float* B;
+    float* C;
+    int n;
+    int tile;       /* k-block depth */
+    int tile_m;     /* Rows per tile (multiple of MR) */
+    int tile_n;     /* Columns per tile (multiple of NR) */
+    int tiles_n;    /* Tiles per row of the grid */
+    int ntiles;     /* Total number of tiles */
+} tile_grid;
+
+/**
+ * @brief Range of tile indices [lo, hi) owned by one thread
+ *
+ * The owner takes tiles from hi (most recently split, still warm in its
+ * cache); thieves take from lo.
+ */
+typedef struct {
+    int lo;
+    int hi;
+#ifdef _OPENMP
+    omp_lock_t lock;
+#endif
+    char pad[DEQUE_PAD];
+} tile_deque;
+
+int matrix_mult_max_threads(void) {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+static void grid_init(tile_grid* g, const float* A, const float* B, float* C, int n, int tile) {
+    g->A = A;
+    g->B = B;
+    g->C = C;
+    g->n = n;
+    matrix_mult_simd_tile(tile, &g->tile_m, &g->tile_n);
+    g->tile = tile > 0 ? tile : MATRIX_MULT_DEFAULT_TILE;
+    g->tiles_n = (n + g->tile_n - 1) / g->tile_n;
+    g->ntiles = ((n + g->tile_m - 1) / g->tile_m) * g->tiles_n;
+}
+
+/**
+ * @brief Compute one tile of C: clear it, then accumulate every k-block
+ * @param g Tile geometry
+ * @param t Tile index, row-major over the (ii, jj) grid
+ */
+static void compute_tile(const tile_grid* g, int t) {
+    const int n = g->n;
+    const size_t ld = (size_t)n;
+    int ii = (t / g->tiles_n) * g->tile_m;
+    int jj = (t % g->tiles_n) * g->tile_n;
+    int mb = ii + g->tile_m < n ? g->tile_m : n - ii;
+    int nb = jj + g->tile_n < n ? g->tile_n : n - jj;
+    float* c = g->C + (size_t)ii * ld + jj;
+
+    for (int i = 0; i < mb; i++) memset(c + (size_t)i * ld, 0, (size_t)nb * sizeof(float));
+
+    for (int kk = 0; kk < n; kk += g->tile) {
+        int kc = kk + g->tile < n ? g->tile : n - kk;
+        matrix_mult_simd_block(mb, nb, kc,
+                               g->A + (size_t)ii * ld + kk, ld,
+                               g->B + (size_t)kk * ld + jj, ld,
+                               c, ld);
+    }
+}
+
+/**
+ * @brief Multiply two square matrices with the tile grid split across threads
+ *
+ * Implementation details:
+ * - Tiles are numbered row-major over the (ii, jj) grid; a flat loop index
+ *   keeps the schedule expressible in OpenMP 2.0 (MSVC) without collapse
+ * - The micro-kernel is selected before the parallel region, so all
+ *   threads use the same implementation
+ *
+ * @param A Pointer to first input matrix (n×n floats, row-major)
+ * @param B Pointer to second input matrix (n×n floats, row-major)
+ * @param C Pointer to output matrix (n×n floats, row-major, will be overwritten)
+ * @param n Dimension of the square matrices
+ * @param tile Tile edge in elements (<= 0 selects MATRIX_MULT_DEFAULT_TILE)
+ * @param threads Number of threads (<= 0 uses matrix_mult_max_threads())
+ */
+void matrix_multiplication_parallel(const float* A, const float* B, float* C, int n,
+                                    int tile, int threads) {
+    tile_grid g;
+    int t;
+
+    matrix_mult_ukernel();
+    grid_init(&g, A, B, C, n, tile);
+    if (threads <= 0) threads = matrix_mult_max_threads();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads)
+#else
+    (void)threads;
+#endif
+    for (t = 0; t < g.ntiles; t++) {
+        compute_tile(&g, t);
+    }
+}
+
+/**
+ * @brief Take the next tile from the calling thread's own deque
+ * @return Tile index, or -1 if the deque is empty
+ */
+static int deque_pop(tile_deque* d) {
+    int t = -1;
+#ifdef _OPENMP
+    omp_set_lock(&d->lock);
+#endif
+    if (d->hi > d->lo) t = --d->hi;
+#ifdef _OPENMP
+    omp_unset_lock(&d->lock);
+#endif
+    return t;
+}
+
+/**
+ * @brief Steal the older half of a victim's remaining tiles
+ * @param victim Deque to steal from
+ * @param lo Receives the first stolen tile index
+ * @param hi Receives one past the last stolen tile index
+ * @return Non-zero if at least one tile was stolen
+ */
+static int deque_steal_half(tile_deque* victim, int* lo, int* hi) {
+    int ok = 0;
+#ifdef _OPENMP
+    omp_set_lock(&victim->lock);
+#endif
+    int left = victim->hi - victim->lo;
+    if (left > 0) {
+        int take = (left + 1) / 2;
+        *lo = victim->lo;
+        *hi = victim->lo + take;
+        victim->lo += take;
+        ok = 1;
+    }
+#ifdef _OPENMP
+    omp_unset_lock(&victim->lock);
+#endif
+    return ok;
+}
+
+/**
+ * @brief Multiply two square matrices with a work-stealing tile scheduler
+ *
+ * Implementation details:
+ * - Thread t starts with the contiguous tile range a static split over
+ *   the team would give it, held in its own lock-protected deque; the
+ *   split is made inside the parallel region, so a team smaller than
+ *   requested (OMP_DYNAMIC, thread limits) still covers every tile
+ * - A thread pops tiles from the top of its own deque; when it runs dry it
+ *   scans the other deques round-robin and steals the bottom half of the
+ *   first non-empty one, which becomes its new range
+ * - No tiles are created after the start, so once a full scan finds every
+ *   deque empty the thread can exit
+ * - Busy time covers compute_tile() only; scanning and lock waits count as
+ *   idle, which is what load imbalance is made of
+ *
+ * @param A Pointer to first input matrix (n×n floats, row-major)
+ * @param B Pointer to second input matrix (n×n floats, row-major)
+ * @param C Pointer to output matrix (n×n floats, row-major, will be overwritten)
+ * @param n Dimension of the square matrices
+ * @param tile Tile edge in elements (<= 0 selects MATRIX_MULT_DEFAULT_TILE)
+ * @param threads Number of threads (<= 0 uses matrix_mult_max_threads())
+ * @param stats Receives per-thread busy time, tile and steal counts (may be NULL)
+ */
+void matrix_multiplication_stealing(const float* A, const float* B, float* C, int n,
+                                    int tile, int threads, matrix_mult_sched_stats* stats) {
+    tile_grid g;
+    tile_deque deques[MATRIX_MULT_MAX_THREADS];
+
+    matrix_mult_ukernel();
+    grid_init(&g, A, B, C, n, tile);
+    if (threads <= 0) threads = matrix_mult_max_threads();
+    if (threads > MATRIX_MULT_MAX_THREADS) threads = MATRIX_MULT_MAX_THREADS;
+#ifndef _OPENMP
+    threads = 1;
+#endif
+
+#ifdef _OPENMP
+    for (int t = 0; t < threads; t++) omp_init_lock(&deques[t].lock);
+#endif
+    if (stats) memset(stats, 0, sizeof(*stats));
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads)
+#endif
+    {
+#ifdef _OPENMP
+        const int self = omp_get_thread_num();
+        const int team = omp_get_num_threads();
+#else
+        const int self = 0;
+        const int team = 1;
+#endif
+        double busy = 0.0;
+        int done = 0, steals = 0;
+
+        /* Split by the team OpenMP delivered; the barrier at the end of single publishes it */
+#ifdef _OPENMP
+#pragma omp single
+#endif
+        {
+            for (int t = 0; t < team; t++) {
+                deques[t].lo = (int)((long long)g.ntiles * t / team);
+                deques[t].hi = (int)((long long)g.ntiles * (t + 1) / team);
+            }
+            if (stats) stats->threads = team;
+        }
+
+        for (;;) {
+            int t = deque_pop(&deques[self]);
+
+            if (t < 0) {
+                /* Own deque is empty: look for a victim */
+                int lo, hi, found = 0;
+                for (int v = 1; v < team && !found; v++) {
+                    found = deque_steal_half(&deques[(self + v) % team], &lo, &hi);
+                }
+                if (!found) break;   /* Every deque is empty: all tiles handed out */
+
+                ++steals;
+#ifdef _OPENMP
+                omp_set_lock(&deques[self].lock);
+#endif
+                deques[self].lo = lo;
+                deques[self].hi = hi;
+#ifdef _OPENMP
+                omp_unset_lock(&deques[self].lock);
+#endif
+                continue;
+            }
+
+            double t0 = matrix_mult_now();
+            compute_tile(&g, t);
+            busy += matrix_mult_now() - t0;
+            ++done;
+        }
+
+        if (stats) {
+            stats->busy_sec[self] = busy;
+            stats->tiles[self] = done;
+            stats->steals[self] = steals;
+        }
+    }
+
+#ifdef _OPENMP
+    for (int t = 0; t < threads; t++) omp_destroy_lock(&deques[t].lock);
+#endif
+}
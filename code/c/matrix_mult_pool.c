@@ -0,0 +1,369 @@
+/**
+ * @file matrix_mult_pool.c
+ * @brief Persistent thread pool with an asynchronous gemm_submit()/gemm_wait() API
+ *
+ * The OpenMP kernels fork a team for every call: idle OpenMP threads spin
+ * for a while and then sleep, so a multiply issued after a pause pays for
+ * waking them, and a stream of independent small multiplies cannot overlap
+ * because each call joins its team before returning. Here the workers are
+ * started once and stay parked on a condition variable; gemm_submit()
+ * appends a request to a ring of MATRIX_MULT_POOL_QUEUE slots and returns
+ * at once, and the caller collects results with gemm_wait() whenever it
+ * needs them, so independent requests pipeline through the workers.
+ *
+ * Every request is cut into row bands of C, at most one per active worker
+ * (matrix_mult_pool_set_active() parks the others). Workers claim bands in
+ * submission order under the pool lock (bands are large, so the lock is
+ * taken twice per band of real work) and compute them with gemm_with_pack()
+ * on their own packing buffers. The last band of a request stamps its
+ * completion time and wakes the waiters.
+ *
+ * Threads inherit their creator's affinity, so a pool created from a
+ * pinned thread would put every worker on that one CPU. Workers given a
+ * CPU by matrix_mult_pool_create() therefore pin themselves to it before
+ * taking any request (Linux and Windows; elsewhere they run unpinned).
+ *
+ * Build: POSIX threads (gcc/clang -pthread) or the Win32 thread API; no
+ * OpenMP needed.
+ */
+
+/* pthreads are not ISO C; sched_setaffinity() is a GNU extension */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#elif !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include "matrix_mult.h"
+#include "matrix_mult_internal.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#endif
+
+/* Slot states */
+enum {
+    JOB_FREE,       /* Never used */
+    JOB_QUEUED,     /* Submitted; some bands not finished yet */
+    JOB_DONE        /* Finished; latency still readable */
+};
+
+/**
+ * @brief One submitted request
+ */
+typedef struct pool_job {
+    long long ticket;
+    int state;
+    size_t m, n, k;
+    float alpha, beta;
+    const float* A;
+    const float* B;
+    float* C;
+    size_t lda, ldb, ldc;
+    size_t band_rows;   /* Rows of C per band */
+    size_t bands;       /* Bands in total */
+    size_t next_band;   /* First band not yet claimed */
+    size_t done_bands;  /* Bands finished */
+    double submitted;   /* matrix_mult_now() at gemm_submit() */
+    double finished;    /* matrix_mult_now() when the last band finished */
+} pool_job;
+
+#if defined(_WIN32)
+typedef CRITICAL_SECTION pool_mutex;
+typedef CONDITION_VARIABLE pool_cond;
+typedef HANDLE pool_thread;
+#else
+typedef pthread_mutex_t pool_mutex;
+typedef pthread_cond_t pool_cond;
+typedef pthread_t pool_thread;
+#endif
+
+/**
+ * @brief One worker: its thread and packing buffers
+ */
+typedef struct pool_worker {
+    matrix_mult_pool* pool;
+    matrix_mult_pack* pack;
+    pool_thread thread;
+    int index;
+    int cpu;            /* CPU to pin to, or -1 to keep the inherited affinity */
+    int started;
+} pool_worker;
+
+struct matrix_mult_pool {
+    pool_mutex lock;
+    pool_cond work;     /* Signalled when a request is queued or the pool stops */
+    pool_cond done;     /* Signalled when a request finishes */
+    pool_job jobs[MATRIX_MULT_POOL_QUEUE];
+    long long tail;     /* Ticket of the next submission */
+    long long claim;    /* Oldest ticket with bands left to claim */
+    int stop;
+    int threads;
+    int active;         /* Workers below this index take requests */
+    pool_worker* workers;
+};
+
+/* ==================== Platform primitives ==================== */
+
+#if defined(_WIN32)
+
+static int sync_init(matrix_mult_pool* pool) {
+    InitializeCriticalSection(&pool->lock);
+    InitializeConditionVariable(&pool->work);
+    InitializeConditionVariable(&pool->done);
+    return 0;
+}
+
+/* Win32 condition variables hold no resources to free */
+static void sync_destroy(matrix_mult_pool* pool) {
+    DeleteCriticalSection(&pool->lock);
+}
+
+static void pool_lock(pool_mutex* m) { EnterCriticalSection(m); }
+static void pool_unlock(pool_mutex* m) { LeaveCriticalSection(m); }
+static void pool_wait(pool_cond* c, pool_mutex* m) { SleepConditionVariableCS(c, m, INFINITE); }
+static void pool_wake_all(pool_cond* c) { WakeAllConditionVariable(c); }
+
+static DWORD WINAPI worker_entry(LPVOID arg);
+
+static int thread_start(pool_worker* w) {
+    w->thread = CreateThread(NULL, 0, worker_entry, w, 0, NULL);
+    return w->thread ? 0 : -1;
+}
+
+static void thread_join(pool_worker* w) {
+    WaitForSingleObject(w->thread, INFINITE);
+    CloseHandle(w->thread);
+}
+
+/* Processor group 0 only, like placement.c */
+static void thread_pin_self(int cpu) {
+    if (cpu >= 0 && cpu < 64) SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu);
+}
+
+#else /* POSIX */
+
+static int sync_init(matrix_mult_pool* pool) {
+    if (pthread_mutex_init(&pool->lock, NULL) != 0) return -1;
+    if (pthread_cond_init(&pool->work, NULL) != 0) {
+        pthread_mutex_destroy(&pool->lock);
+        return -1;
+    }
+    if (pthread_cond_init(&pool->done, NULL) != 0) {
+        pthread_cond_destroy(&pool->work);
+        pthread_mutex_destroy(&pool->lock);
+        return -1;
+    }
+    return 0;
+}
+
+static void sync_destroy(matrix_mult_pool* pool) {
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+static void pool_lock(pool_mutex* m) { pthread_mutex_lock(m); }
+static void pool_unlock(pool_mutex* m) { pthread_mutex_unlock(m); }
+static void pool_wait(pool_cond* c, pool_mutex* m) { pthread_cond_wait(c, m); }
+static void pool_wake_all(pool_cond* c) { pthread_cond_broadcast(c); }
+
+static void* worker_entry(void* arg);
+
+static int thread_start(pool_worker* w) {
+    return pthread_create(&w->thread, NULL, worker_entry, w) == 0 ? 0 : -1;
+}
+
+static void thread_join(pool_worker* w) {
+    pthread_join(w->thread, NULL);
+}
+
+static void thread_pin_self(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return;
+    cpu_set_t one;
+    CPU_ZERO(&one);
+    CPU_SET(cpu, &one);
+    sched_setaffinity(0, sizeof(one), &one);
+#else
+    (void)cpu;
+#endif
+}
+
+#endif
+
+/* ==================== Workers ==================== */
+
+/**
+ * @brief Claim and compute bands until the pool stops and the queue is empty
+ */
+static void worker_loop(pool_worker* w) {
+    matrix_mult_pool* pool = w->pool;
+    thread_pin_self(w->cpu);    /* Best effort: a refused pin leaves the inherited mask */
+    pool_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stop && (pool->claim == pool->tail || w->index >= pool->active)) {
+            pool_wait(&pool->work, &pool->lock);
+        }
+        if (pool->claim == pool->tail) break;   /* Stopped and drained */
+
+        pool_job* job = &pool->jobs[pool->claim % MATRIX_MULT_POOL_QUEUE];
+        const size_t band = job->next_band++;
+        if (job->next_band == job->bands) pool->claim++;
+        pool_unlock(&pool->lock);
+
+        const size_t i0 = band * job->band_rows;
+        const size_t rows = job->m - i0 < job->band_rows ? job->m - i0 : job->band_rows;
+        gemm_with_pack(rows, job->n, job->k, job->alpha, job->A + i0 * job->lda, job->lda,
+                       job->B, job->ldb, job->beta, job->C + i0 * job->ldc, job->ldc, w->pack);
+
+        pool_lock(&pool->lock);
+        if (++job->done_bands == job->bands) {
+            job->finished = matrix_mult_now();
+            job->state = JOB_DONE;
+            pool_wake_all(&pool->done);
+        }
+    }
+    pool_unlock(&pool->lock);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI worker_entry(LPVOID arg) {
+    worker_loop((pool_worker*)arg);
+    return 0;
+}
+#else
+static void* worker_entry(void* arg) {
+    worker_loop((pool_worker*)arg);
+    return NULL;
+}
+#endif
+
+/* ==================== Entry points ==================== */
+
+matrix_mult_pool* matrix_mult_pool_create(int threads, int n, matrix_mult_arena* arena,
+                                          const int* cpus, int ncpus) {
+    if (threads <= 0) threads = matrix_mult_max_threads();
+
+    matrix_mult_pool* pool = (matrix_mult_pool*)calloc(1, sizeof(*pool));
+    if (!pool) return NULL;
+    pool->threads = threads;
+    pool->active = threads;
+    pool->workers = (pool_worker*)calloc((size_t)threads, sizeof(pool_worker));
+    if (!pool->workers || sync_init(pool) != 0) {
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+
+    /* Buffers first: creating them also resolves the micro-kernel before any worker runs */
+    for (int t = 0; t < threads; t++) {
+        pool->workers[t].pool = pool;
+        pool->workers[t].index = t;
+        pool->workers[t].cpu = cpus && t < ncpus ? cpus[t] : -1;
+        pool->workers[t].pack = matrix_mult_pack_create(n, 0, 0, 0, arena);
+        if (!pool->workers[t].pack) {
+            matrix_mult_pool_destroy(pool);
+            return NULL;
+        }
+    }
+    for (int t = 0; t < threads; t++) {
+        if (thread_start(&pool->workers[t]) != 0) {
+            matrix_mult_pool_destroy(pool);
+            return NULL;
+        }
+        pool->workers[t].started = 1;
+    }
+    return pool;
+}
+
+void matrix_mult_pool_destroy(matrix_mult_pool* pool) {
+    if (!pool) return;
+    pool_lock(&pool->lock);
+    pool->stop = 1;
+    pool_wake_all(&pool->work);
+    pool_unlock(&pool->lock);
+    for (int t = 0; t < pool->threads; t++) {
+        if (pool->workers[t].started) thread_join(&pool->workers[t]);
+        matrix_mult_pack_destroy(pool->workers[t].pack);
+    }
+    sync_destroy(pool);
+    free(pool->workers);
+    free(pool);
+}
+
+int matrix_mult_pool_threads(const matrix_mult_pool* pool) {
+    return pool->threads;
+}
+
+int matrix_mult_pool_set_active(matrix_mult_pool* pool, int threads) {
+    if (threads < 1) threads = 1;
+    if (threads > pool->threads) threads = pool->threads;
+    pool_lock(&pool->lock);
+    pool->active = threads;
+    pool_wake_all(&pool->work);
+    pool_unlock(&pool->lock);
+    return threads;
+}
+
+long long gemm_submit(matrix_mult_pool* pool, size_t m, size_t n, size_t k, float alpha,
+                      const float* A, size_t lda, const float* B, size_t ldb,
+                      float beta, float* C, size_t ldc) {
+    if (!pool) return -1;
+
+    pool_lock(&pool->lock);
+
+    /* At most one band per active worker, none thinner than MATRIX_MULT_POOL_MIN_ROWS */
+    size_t bands = (m + MATRIX_MULT_POOL_MIN_ROWS - 1) / MATRIX_MULT_POOL_MIN_ROWS;
+    if (bands > (size_t)pool->active) bands = (size_t)pool->active;
+    if (bands == 0) bands = 1;
+    const size_t band_rows = m > 0 ? (m + bands - 1) / bands : 1;
+
+    pool_job* job = &pool->jobs[pool->tail % MATRIX_MULT_POOL_QUEUE];
+    while (job->state == JOB_QUEUED) pool_wait(&pool->done, &pool->lock);
+    job->ticket = pool->tail;
+    job->state = JOB_QUEUED;
+    job->m = m;
+    job->n = n;
+    job->k = k;
+    job->alpha = alpha;
+    job->beta = beta;
+    job->A = A;
+    job->B = B;
+    job->C = C;
+    job->lda = lda;
+    job->ldb = ldb;
+    job->ldc = ldc;
+    job->band_rows = band_rows;
+    job->bands = m > 0 ? (m + band_rows - 1) / band_rows : 1;
+    job->next_band = 0;
+    job->done_bands = 0;
+    job->submitted = matrix_mult_now();
+    job->finished = 0.0;
+    const long long ticket = pool->tail++;
+    pool_wake_all(&pool->work);
+    pool_unlock(&pool->lock);
+    return ticket;
+}
+
+int gemm_wait(matrix_mult_pool* pool, long long ticket, double* latency_sec) {
+    if (!pool) return -1;
+    pool_lock(&pool->lock);
+    if (ticket < 0 || ticket >= pool->tail) {
+        pool_unlock(&pool->lock);
+        return -1;
+    }
+    const pool_job* job = &pool->jobs[ticket % MATRIX_MULT_POOL_QUEUE];
+    while (job->ticket == ticket && job->state == JOB_QUEUED) pool_wait(&pool->done, &pool->lock);
+
+    /* A slot that holds a later ticket means this request finished long ago */
+    if (latency_sec) *latency_sec = job->ticket == ticket ? job->finished - job->submitted : -1.0;
+    pool_unlock(&pool->lock);
+    return 0;
+}
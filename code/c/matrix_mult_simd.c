@@ -0,0 +1,356 @@
+/**
+ * @file matrix_mult_simd.c
+ * @brief Register-blocked SIMD matrix multiplication with runtime dispatch
+ *
+ * The kernel reuses the i/j/k blocking of matrix_multiplication_tiled() and
+ * replaces the inner block product with a register-blocked micro-kernel that
+ * keeps an MR×NR block of C in vector registers for the whole k-block:
+ * - AVX2 + FMA (x86-64): 6×16 block, 12 ymm accumulators
+ * - NEON (AArch64):      8×8 block, 16 q accumulators
+ * - Scalar fallback:     4×8 block in plain C
+ *
+ * The micro-kernel is chosen once, on first use, from what the CPU reports
+ * (cpuid/xgetbv on x86, getauxval on Linux/AArch64). Setting the environment
+ * variable MATRIX_MULT_ISA to "scalar" forces the fallback, which is useful
+ * to measure what the vector units contribute.
+ *
+ * Edge blocks that do not fill a whole MR×NR block use a bounds-checked
+ * scalar loop, so any n is accepted.
+ *
+ * The micro-kernels address A through a row and a column stride, so the
+ * packed driver in matrix_mult_packed.c runs them unchanged on packed panels.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_mult.h"
+#include "matrix_mult_internal.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MM_X86_64 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define MM_AARCH64 1
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+/* GCC and Clang need the ISA enabled per function; MSVC accepts intrinsics anywhere */
+#if defined(MM_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define MM_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define MM_TARGET_AVX2
+#endif
+
+/* ==================== Micro-kernels ==================== */
+
+/**
+ * @brief Portable 4×8 micro-kernel
+ *
+ * The accumulator array has constant bounds, so optimising compilers keep
+ * it in registers and may vectorise the j loop on their own.
+ */
+static void ukernel_scalar_4x8(int kc, const float* A, size_t rs_a, size_t cs_a,
+                               const float* B, size_t ldb, float* C, size_t ldc) {
+    float acc[4][8];
+
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 8; j++) acc[i][j] = C[i * ldc + j];
+
+    for (int k = 0; k < kc; k++) {
+        const float* b = B + (size_t)k * ldb;
+        const float* ak = A + (size_t)k * cs_a;
+        for (int i = 0; i < 4; i++) {
+            float a = ak[i * rs_a];
+            for (int j = 0; j < 8; j++) acc[i][j] += a * b[j];
+        }
+    }
+
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 8; j++) C[i * ldc + j] = acc[i][j];
+}
+
+#if defined(MM_X86_64)
+/* Broadcast A[r, k] and update both ymm accumulators of row r */
+#define AVX2_ROW(r)                                                    \
+    a = _mm256_broadcast_ss(ak + (r) * rs_a);                          \
+    c##r##0 = _mm256_fmadd_ps(a, b0, c##r##0);                         \
+    c##r##1 = _mm256_fmadd_ps(a, b1, c##r##1)
+
+/**
+ * @brief AVX2/FMA 6×16 micro-kernel
+ *
+ * 12 accumulators + 2 B vectors + 1 broadcast use 15 of the 16 ymm
+ * registers; each k step issues 12 FMAs for 2 loads of B and 6 broadcasts.
+ */
+MM_TARGET_AVX2
+static void ukernel_avx2_6x16(int kc, const float* A, size_t rs_a, size_t cs_a,
+                              const float* B, size_t ldb, float* C, size_t ldc) {
+    __m256 c00 = _mm256_loadu_ps(C + 0 * ldc), c01 = _mm256_loadu_ps(C + 0 * ldc + 8);
+    __m256 c10 = _mm256_loadu_ps(C + 1 * ldc), c11 = _mm256_loadu_ps(C + 1 * ldc + 8);
+    __m256 c20 = _mm256_loadu_ps(C + 2 * ldc), c21 = _mm256_loadu_ps(C + 2 * ldc + 8);
+    __m256 c30 = _mm256_loadu_ps(C + 3 * ldc), c31 = _mm256_loadu_ps(C + 3 * ldc + 8);
+    __m256 c40 = _mm256_loadu_ps(C + 4 * ldc), c41 = _mm256_loadu_ps(C + 4 * ldc + 8);
+    __m256 c50 = _mm256_loadu_ps(C + 5 * ldc), c51 = _mm256_loadu_ps(C + 5 * ldc + 8);
+
+    for (int k = 0; k < kc; k++) {
+        const float* b = B + (size_t)k * ldb;
+        const float* ak = A + (size_t)k * cs_a;
+        __m256 b0 = _mm256_loadu_ps(b);
+        __m256 b1 = _mm256_loadu_ps(b + 8);
+        __m256 a;
+
+        AVX2_ROW(0); AVX2_ROW(1); AVX2_ROW(2);
+        AVX2_ROW(3); AVX2_ROW(4); AVX2_ROW(5);
+    }
+
+    _mm256_storeu_ps(C + 0 * ldc, c00); _mm256_storeu_ps(C + 0 * ldc + 8, c01);
+    _mm256_storeu_ps(C + 1 * ldc, c10); _mm256_storeu_ps(C + 1 * ldc + 8, c11);
+    _mm256_storeu_ps(C + 2 * ldc, c20); _mm256_storeu_ps(C + 2 * ldc + 8, c21);
+    _mm256_storeu_ps(C + 3 * ldc, c30); _mm256_storeu_ps(C + 3 * ldc + 8, c31);
+    _mm256_storeu_ps(C + 4 * ldc, c40); _mm256_storeu_ps(C + 4 * ldc + 8, c41);
+    _mm256_storeu_ps(C + 5 * ldc, c50); _mm256_storeu_ps(C + 5 * ldc + 8, c51);
+}
+#undef AVX2_ROW
+#endif /* MM_X86_64 */
+
+#if defined(MM_AARCH64)
+/* Broadcast A[r, k] and update both q accumulators of row r */
+#define NEON_ROW(r)                                                    \
+    a = vdupq_n_f32(ak[(r) * rs_a]);                                   \
+    c##r##0 = vfmaq_f32(c##r##0, a, b0);                               \
+    c##r##1 = vfmaq_f32(c##r##1, a, b1)
+
+#define NEON_LOAD(r)                                                   \
+    float32x4_t c##r##0 = vld1q_f32(C + (r) * ldc);                    \
+    float32x4_t c##r##1 = vld1q_f32(C + (r) * ldc + 4)
+
+#define NEON_STORE(r)                                                  \
+    vst1q_f32(C + (r) * ldc, c##r##0);                                 \
+    vst1q_f32(C + (r) * ldc + 4, c##r##1)
+
+/**
+ * @brief NEON 8×8 micro-kernel
+ *
+ * 16 accumulators + 2 B vectors + 1 broadcast fit comfortably in the 32
+ * AArch64 vector registers; each k step issues 16 FMAs.
+ */
+static void ukernel_neon_8x8(int kc, const float* A, size_t rs_a, size_t cs_a,
+                             const float* B, size_t ldb, float* C, size_t ldc) {
+    NEON_LOAD(0); NEON_LOAD(1); NEON_LOAD(2); NEON_LOAD(3);
+    NEON_LOAD(4); NEON_LOAD(5); NEON_LOAD(6); NEON_LOAD(7);
+
+    for (int k = 0; k < kc; k++) {
+        const float* b = B + (size_t)k * ldb;
+        const float* ak = A + (size_t)k * cs_a;
+        float32x4_t b0 = vld1q_f32(b);
+        float32x4_t b1 = vld1q_f32(b + 4);
+        float32x4_t a;
+
+        NEON_ROW(0); NEON_ROW(1); NEON_ROW(2); NEON_ROW(3);
+        NEON_ROW(4); NEON_ROW(5); NEON_ROW(6); NEON_ROW(7);
+    }
+
+    NEON_STORE(0); NEON_STORE(1); NEON_STORE(2); NEON_STORE(3);
+    NEON_STORE(4); NEON_STORE(5); NEON_STORE(6); NEON_STORE(7);
+}
+#undef NEON_ROW
+#undef NEON_LOAD
+#undef NEON_STORE
+#endif /* MM_AARCH64 */
+
+/**
+ * @brief Bounds-checked block product for partial MR×NR edge blocks
+ */
+static void edge_kernel(int mr, int nr, int kc, const float* A, size_t lda,
+                        const float* B, size_t ldb, float* C, size_t ldc) {
+    for (int i = 0; i < mr; i++) {
+        float* c = C + i * ldc;
+        for (int k = 0; k < kc; k++) {
+            float a = A[i * lda + k];
+            const float* b = B + (size_t)k * ldb;
+            for (int j = 0; j < nr; j++) c[j] += a * b[j];
+        }
+    }
+}
+
+/* ==================== Runtime dispatch ==================== */
+
+static const ukernel_desc UKERNEL_SCALAR = {"scalar", 4, 8, ukernel_scalar_4x8};
+#if defined(MM_X86_64)
+static const ukernel_desc UKERNEL_AVX2 = {"avx2", 6, 16, ukernel_avx2_6x16};
+#endif
+#if defined(MM_AARCH64)
+static const ukernel_desc UKERNEL_NEON = {"neon", 8, 8, ukernel_neon_8x8};
+#endif
+
+#if defined(MM_X86_64)
+/**
+ * @brief Check for AVX2 + FMA support, including OS support for ymm state
+ * @return Non-zero if the AVX2 micro-kernel can run
+ */
+static int cpu_has_avx2_fma(void) {
+    unsigned int r1[4], r7[4];
+    unsigned long long xcr0;
+
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, 1, 0);
+    memcpy(r1, info, sizeof(r1));
+    __cpuidex(info, 0, 0);
+    if (info[0] < 7) return 0;
+    __cpuidex(info, 7, 0);
+    memcpy(r7, info, sizeof(r7));
+#else
+    if (!__get_cpuid_count(1, 0, &r1[0], &r1[1], &r1[2], &r1[3])) return 0;
+    if (!__get_cpuid_count(7, 0, &r7[0], &r7[1], &r7[2], &r7[3])) return 0;
+#endif
+
+    const int fma = (r1[2] >> 12) & 1;      /* CPUID.1:ECX.FMA */
+    const int osxsave = (r1[2] >> 27) & 1;  /* CPUID.1:ECX.OSXSAVE */
+    const int avx = (r1[2] >> 28) & 1;      /* CPUID.1:ECX.AVX */
+    const int avx2 = (r7[1] >> 5) & 1;      /* CPUID.7.0:EBX.AVX2 */
+    if (!(fma && osxsave && avx && avx2)) return 0;
+
+    /* The OS must save xmm and ymm state across context switches */
+#if defined(_MSC_VER)
+    xcr0 = _xgetbv(0);
+#else
+    unsigned int lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    xcr0 = ((unsigned long long)hi << 32) | lo;
+#endif
+    return (xcr0 & 0x6) == 0x6;
+}
+#endif
+
+#if defined(MM_AARCH64)
+/**
+ * @brief Check for Advanced SIMD (NEON) support
+ * @return Non-zero if the NEON micro-kernel can run
+ */
+static int cpu_has_neon(void) {
+#if defined(__linux__) && defined(HWCAP_ASIMD)
+    return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#else
+    return 1; /* Advanced SIMD is mandatory on AArch64 */
+#endif
+}
+#endif
+
+/**
+ * @brief Pick the best micro-kernel for this CPU (runs once)
+ *
+ * Concurrent first calls may both run the detection; they store the same
+ * pointer, so the race is benign.
+ */
+const ukernel_desc* matrix_mult_ukernel(void) {
+    static const ukernel_desc* selected = NULL;
+    if (selected) return selected;
+
+    const ukernel_desc* best = &UKERNEL_SCALAR;
+    const char* force = getenv("MATRIX_MULT_ISA");
+
+    if (!force || strcmp(force, "scalar") != 0) {
+#if defined(MM_X86_64)
+        if (cpu_has_avx2_fma()) best = &UKERNEL_AVX2;
+#endif
+#if defined(MM_AARCH64)
+        if (cpu_has_neon()) best = &UKERNEL_NEON;
+#endif
+    }
+
+    selected = best;
+    return selected;
+}
+
+const char* matrix_mult_simd_isa(void) {
+    return matrix_mult_ukernel()->name;
+}
+
+void matrix_mult_simd_tile(int tile, int* tile_m, int* tile_n) {
+    const ukernel_desc* uk = matrix_mult_ukernel();
+    if (tile <= 0) tile = MATRIX_MULT_DEFAULT_TILE;
+    *tile_m = (tile + uk->mr - 1) / uk->mr * uk->mr;   /* Whole micro-blocks per tile */
+    *tile_n = (tile + uk->nr - 1) / uk->nr * uk->nr;
+}
+
+/* ==================== Blocked driver ==================== */
+
+void matrix_mult_simd_block(int m, int n, int kc, const float* A, size_t lda,
+                            const float* B, size_t ldb, float* C, size_t ldc) {
+    const ukernel_desc* uk = matrix_mult_ukernel();
+    const int mr = uk->mr;
+    const int nr = uk->nr;
+
+    for (int i = 0; i < m; i += mr) {
+        int mb = m - i < mr ? m - i : mr;
+        const float* a = A + (size_t)i * lda;
+
+        for (int j = 0; j < n; j += nr) {
+            int nb = n - j < nr ? n - j : nr;
+            const float* b = B + j;
+            float* c = C + (size_t)i * ldc + j;
+
+            if (mb == mr && nb == nr) {
+                uk->run(kc, a, lda, 1, b, ldb, c, ldc);
+            } else {
+                edge_kernel(mb, nb, kc, a, lda, b, ldb, c, ldc);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Multiply two square matrices with a register-blocked SIMD micro-kernel
+ *
+ * Implementation details:
+ * - Same ii/kk/jj tile loop as matrix_multiplication_tiled(); the kk block
+ *   is the micro-kernel's k extent, so each C block is loaded and stored
+ *   once per k-block
+ * - The i and j tile edges are rounded up to multiples of MR and NR, so
+ *   only the ragged right and bottom edges of C go to edge_kernel()
+ *
+ * @param A Pointer to first input matrix (n×n floats, row-major)
+ * @param B Pointer to second input matrix (n×n floats, row-major)
+ * @param C Pointer to output matrix (n×n floats, row-major, will be overwritten)
+ * @param n Dimension of the square matrices
+ * @param tile Tile edge in elements (<= 0 selects MATRIX_MULT_DEFAULT_TILE)
+ */
+void matrix_multiplication_simd(const float* A, const float* B, float* C, int n, int tile) {
+    const size_t ld = (size_t)n;
+    int tile_m, tile_n;
+
+    matrix_mult_simd_tile(tile, &tile_m, &tile_n);
+    if (tile <= 0) tile = MATRIX_MULT_DEFAULT_TILE;
+
+    /* Partial products are accumulated across k-blocks, so start from zero */
+    memset(C, 0, ld * ld * sizeof(float));
+
+    for (int ii = 0; ii < n; ii += tile_m) {        /* Block row of A and C */
+        int mb = ii + tile_m < n ? tile_m : n - ii;
+
+        for (int kk = 0; kk < n; kk += tile) {      /* Block of the common dimension */
+            int kc = kk + tile < n ? tile : n - kk;
+
+            for (int jj = 0; jj < n; jj += tile_n) {  /* Block column of B and C */
+                int nb = jj + tile_n < n ? tile_n : n - jj;
+
+                matrix_mult_simd_block(mb, nb, kc,
+                                       A + (size_t)ii * ld + kk, ld,
+                                       B + (size_t)kk * ld + jj, ld,
+                                       C + (size_t)ii * ld + jj, ld);
+            }
+        }
+    }
+}
@@ -0,0 +1,350 @@
+/**
+ * @file matrix_mult_summa.c
+ * @brief SUMMA distributed multiplication on top of gemm_with_pack()
+ *
+ * Block partition: grid row i owns global rows [n*i/pr, n*(i+1)/pr), grid
+ * column j owns global columns [n*j/pc, n*(j+1)/pc), so block extents
+ * differ by at most one when n is not a multiple of the grid.
+ *
+ * Step over the common dimension k: columns k.. of A belong to one grid
+ * column and rows k.. of B to one grid row, so a panel is cut short at the
+ * next boundary of either partition and each step has exactly one root per
+ * row and per column broadcast. The A panel is strided in the owner's block
+ * and is copied to a contiguous rows×kb buffer before the row broadcast;
+ * the B panel is a contiguous slab of kb whole block rows and is broadcast
+ * in place from the owner.
+ *
+ * Communication and compute are timed separately: comm_sec covers the copy
+ * and both MPI_Bcast() calls, which include waiting for slower ranks, and
+ * compute_sec the local gemm_with_pack() call.
+ *
+ * With MATRIX_MULT_SUMMA_OVERLAP the panels are double buffered: while step
+ * s multiplies the panels in buffer s % 2, the MPI_Ibcast() of step s + 1 is
+ * already in flight into the other buffer. Most MPI libraries only progress
+ * non-blocking collectives inside MPI calls, so the product of each step is
+ * split into SUMMA_PROGRESS_CHUNKS row blocks with an MPI_Testall() between
+ * them. comm_sec is then the communication left exposed: packing A, posting
+ * the broadcasts and MPI_Waitall() until the panels of a step have arrived.
+ */
+
+#include <limits.h>
+#include <string.h>
+#include "matrix_mult_summa.h"
+#include "matrix_mult_internal.h"
+#include "platform.h"
+
+/* Row blocks per overlapped product, each followed by an MPI progress call */
+#define SUMMA_PROGRESS_CHUNKS 4
+
+/**
+ * @brief Grid state of one rank
+ */
+struct matrix_mult_summa {
+    MPI_Comm comm;          /* Duplicate of the caller's communicator */
+    MPI_Comm row_comm;      /* Ranks of this grid row, ranked by grid column */
+    MPI_Comm col_comm;      /* Ranks of this grid column, ranked by grid row */
+    int prows, pcols;       /* Grid dimensions */
+    int my_row, my_col;     /* Position of this rank */
+    size_t n;               /* Global dimension */
+    size_t row0, rows;      /* Block rows of this rank */
+    size_t col0, cols;      /* Block columns of this rank */
+    int panel;              /* Maximum panel depth */
+    int flags;              /* MATRIX_MULT_SUMMA_* */
+    float* a_panel[2];      /* rows×panel, row-major (second only when overlapping) */
+    float* b_panel[2];      /* panel×cols, row-major (second only when overlapping) */
+    matrix_mult_pack* pack; /* Buffers for the local products */
+    matrix_mult_arena* arena;
+};
+
+/* ==================== Partition helpers ==================== */
+
+/**
+ * @brief First index owned by part i of a p-way split of n
+ */
+static size_t part_start(size_t n, int p, int i) {
+    return n * (size_t)i / (size_t)p;
+}
+
+/**
+ * @brief Part of a p-way split of n that owns index k
+ */
+static int part_owner(size_t n, int p, size_t k) {
+    int i = (int)(k * (size_t)p / n);
+    while (i + 1 < p && part_start(n, p, i + 1) <= k) i++;
+    while (i > 0 && part_start(n, p, i) > k) i--;
+    return i;
+}
+
+static size_t min_size(size_t a, size_t b) {
+    return a < b ? a : b;
+}
+
+/**
+ * @brief Geometry of the SUMMA step that starts at global index k
+ */
+typedef struct summa_step {
+    size_t k, kb;           /* First index and depth of the panels */
+    int a_root;             /* Grid column owning A[:, k..k+kb) (root in row_comm) */
+    int b_root;             /* Grid row owning B[k..k+kb, :] (root in col_comm) */
+} summa_step;
+
+/**
+ * @brief Step at k: the panel is cut at the next boundary of either partition
+ */
+static summa_step step_at(const matrix_mult_summa* s, size_t k) {
+    summa_step st;
+    st.k = k;
+    st.a_root = part_owner(s->n, s->pcols, k);
+    st.b_root = part_owner(s->n, s->prows, k);
+    size_t a_end = part_start(s->n, s->pcols, st.a_root + 1);
+    size_t b_end = part_start(s->n, s->prows, st.b_root + 1);
+    st.kb = min_size((size_t)s->panel, min_size(a_end, b_end) - k);
+    return st;
+}
+
+/**
+ * @brief Copy this rank's A columns of a step into a contiguous panel (owners only)
+ */
+static void pack_a_panel(const matrix_mult_summa* s, const summa_step* st, const float* A,
+                         float* panel) {
+    if (s->my_col != st->a_root) return;
+    const float* src = A + (st->k - s->col0);
+    for (size_t i = 0; i < s->rows; i++)
+        memcpy(panel + i * st->kb, src + i * s->cols, st->kb * sizeof(float));
+}
+
+/**
+ * @brief B panel of a step: in place on the owning grid row, else the receive buffer
+ */
+static float* b_panel_for(const matrix_mult_summa* s, const summa_step* st, const float* B,
+                          float* recv) {
+    if (s->my_row != st->b_root) return recv;
+    return (float*)B + (st->k - s->row0) * s->cols;
+}
+
+/**
+ * @brief Free the buffers and the state itself (not the communicators)
+ */
+static void release(matrix_mult_summa* s) {
+    matrix_mult_pack_destroy(s->pack);
+    for (int b = 0; b < 2; b++) {
+        matrix_mult_scratch_free(s->arena, s->a_panel[b]);
+        matrix_mult_scratch_free(s->arena, s->b_panel[b]);
+    }
+    matrix_mult_scratch_free(s->arena, s);
+}
+
+/* ==================== Step loops ==================== */
+
+/**
+ * @brief Record one step's times, if the caller asked for them
+ */
+static void record_step(summa_times* times, int step, double comm, double compute) {
+    if (!times) return;
+    times->comm_sec += comm;
+    times->compute_sec += compute;
+    if (times->step_comm_sec) times->step_comm_sec[step] = comm;
+    if (times->step_compute_sec) times->step_compute_sec[step] = compute;
+}
+
+/**
+ * @brief Blocking SUMMA: broadcast a step's panels, then multiply them
+ */
+static int run_blocking(matrix_mult_summa* s, const float* A, const float* B, float* C,
+                        summa_times* times, int* steps) {
+    const size_t rows = s->rows, cols = s->cols;
+    int rc = MPI_SUCCESS;
+
+    for (size_t k = 0; k < s->n && rc == MPI_SUCCESS; (*steps)++) {
+        const summa_step st = step_at(s, k);
+
+        double t0 = now_sec();
+        pack_a_panel(s, &st, A, s->a_panel[0]);
+        rc = MPI_Bcast(s->a_panel[0], (int)(rows * st.kb), MPI_FLOAT, st.a_root, s->row_comm);
+        float* b_panel = b_panel_for(s, &st, B, s->b_panel[0]);
+        if (rc == MPI_SUCCESS)
+            rc = MPI_Bcast(b_panel, (int)(st.kb * cols), MPI_FLOAT, st.b_root, s->col_comm);
+
+        double t1 = now_sec();
+        if (rows > 0 && cols > 0)
+            gemm_with_pack(rows, cols, st.kb, 1.0f, s->a_panel[0], st.kb, b_panel, cols,
+                           1.0f, C, cols, s->pack);
+        double t2 = now_sec();
+
+        record_step(times, *steps, t1 - t0, t2 - t1);
+        k += st.kb;
+    }
+    return rc;
+}
+
+/**
+ * @brief Pack and post the non-blocking broadcasts of one step into buffer `buf`
+ */
+static int post_step(matrix_mult_summa* s, const summa_step* st, const float* A, const float* B,
+                     int buf, float** b_panel, MPI_Request req[2]) {
+    pack_a_panel(s, st, A, s->a_panel[buf]);
+    int rc = MPI_Ibcast(s->a_panel[buf], (int)(s->rows * st->kb), MPI_FLOAT, st->a_root,
+                        s->row_comm, &req[0]);
+    *b_panel = b_panel_for(s, st, B, s->b_panel[buf]);
+    if (rc == MPI_SUCCESS)
+        rc = MPI_Ibcast(*b_panel, (int)(st->kb * s->cols), MPI_FLOAT, st->b_root,
+                        s->col_comm, &req[1]);
+    return rc;
+}
+
+/**
+ * @brief Overlapped SUMMA: the next step's broadcasts run during this step's product
+ */
+static int run_overlapped(matrix_mult_summa* s, const float* A, const float* B, float* C,
+                          summa_times* times, int* steps) {
+    const size_t rows = s->rows, cols = s->cols;
+    size_t chunk = (rows + SUMMA_PROGRESS_CHUNKS - 1) / SUMMA_PROGRESS_CHUNKS;
+    if (chunk < MATRIX_MULT_PACK_MC) chunk = MATRIX_MULT_PACK_MC;
+
+    MPI_Request req[2][2] = { { MPI_REQUEST_NULL, MPI_REQUEST_NULL },
+                              { MPI_REQUEST_NULL, MPI_REQUEST_NULL } };
+    float* b_panel[2] = { NULL, NULL };
+    if (s->n == 0) return MPI_SUCCESS;
+
+    summa_step cur = step_at(s, 0);
+    double t0 = now_sec();
+    int rc = post_step(s, &cur, A, B, 0, &b_panel[0], req[0]);
+    double posted = now_sec() - t0;   /* Exposed time of posting the first step */
+
+    for (int buf = 0; rc == MPI_SUCCESS; buf ^= 1) {
+        t0 = now_sec();
+        rc = MPI_Waitall(2, req[buf], MPI_STATUSES_IGNORE);
+
+        /* Start the next step into the other buffer, whose product is done */
+        const int more = cur.k + cur.kb < s->n;
+        summa_step next = cur;
+        if (more && rc == MPI_SUCCESS) {
+            next = step_at(s, cur.k + cur.kb);
+            rc = post_step(s, &next, A, B, buf ^ 1, &b_panel[buf ^ 1], req[buf ^ 1]);
+        }
+        double t1 = now_sec();
+
+        for (size_t i = 0; i < rows && cols > 0 && rc == MPI_SUCCESS; i += chunk) {
+            size_t mb = min_size(chunk, rows - i);
+            gemm_with_pack(mb, cols, cur.kb, 1.0f, s->a_panel[buf] + i * cur.kb, cur.kb,
+                           b_panel[buf], cols, 1.0f, C + i * cols, cols, s->pack);
+            if (more) {
+                int done;
+                MPI_Testall(2, req[buf ^ 1], &done, MPI_STATUSES_IGNORE);
+            }
+        }
+        double t2 = now_sec();
+
+        record_step(times, (*steps)++, posted + t1 - t0, t2 - t1);
+        posted = 0.0;
+        if (!more) break;
+        cur = next;
+    }
+    return rc;
+}
+
+/* ==================== Public API ==================== */
+
+matrix_mult_summa* matrix_mult_summa_create(MPI_Comm comm, size_t n, int panel, int flags,
+                                            matrix_mult_arena* arena) {
+    int size, rank;
+    MPI_Comm_size(comm, &size);
+    MPI_Comm_rank(comm, &rank);
+
+    int dims[2] = { 0, 0 };
+    MPI_Dims_create(size, 2, dims);
+
+    matrix_mult_summa* s = (matrix_mult_summa*)matrix_mult_scratch_alloc(arena, sizeof(*s));
+    int ok = s != NULL;
+    if (s) {
+        memset(s, 0, sizeof(*s));
+        s->arena = arena;
+        s->n = n;
+        s->prows = dims[0];
+        s->pcols = dims[1];
+        s->my_row = rank / s->pcols;
+        s->my_col = rank % s->pcols;
+        s->row0 = part_start(n, s->prows, s->my_row);
+        s->rows = part_start(n, s->prows, s->my_row + 1) - s->row0;
+        s->col0 = part_start(n, s->pcols, s->my_col);
+        s->cols = part_start(n, s->pcols, s->my_col + 1) - s->col0;
+
+        if (panel <= 0) panel = MATRIX_MULT_SUMMA_PANEL;
+        if ((size_t)panel > n) panel = n > 0 ? (int)n : 1;
+        s->panel = panel;
+        s->flags = flags;
+
+        /* Broadcast counts are int */
+        size_t widest = s->rows > s->cols ? s->rows : s->cols;
+        ok = widest * (size_t)panel <= (size_t)INT_MAX;
+
+        const int buffers = (flags & MATRIX_MULT_SUMMA_OVERLAP) ? 2 : 1;
+        for (int b = 0; b < buffers && ok; b++) {
+            s->a_panel[b] = (float*)matrix_mult_scratch_alloc(arena, s->rows * (size_t)panel * sizeof(float));
+            s->b_panel[b] = (float*)matrix_mult_scratch_alloc(arena, (size_t)panel * s->cols * sizeof(float));
+            ok = s->a_panel[b] && s->b_panel[b];
+        }
+        if (ok) {
+            int edge = (int)(widest > (size_t)panel ? widest : (size_t)panel);
+            s->pack = matrix_mult_pack_create(edge, 0, 0, 0, arena);
+            ok = s->pack != NULL;
+        }
+    }
+
+    /* Fail on every rank together so no rank waits in a later collective */
+    int all_ok = 0;
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, comm);
+    if (!all_ok) {
+        if (s) release(s);
+        return NULL;
+    }
+
+    MPI_Comm_dup(comm, &s->comm);
+    MPI_Comm_split(comm, s->my_row, s->my_col, &s->row_comm);
+    MPI_Comm_split(comm, s->my_col, s->my_row, &s->col_comm);
+    return s;
+}
+
+void matrix_mult_summa_destroy(matrix_mult_summa* s) {
+    if (!s) return;
+    MPI_Comm_free(&s->row_comm);
+    MPI_Comm_free(&s->col_comm);
+    MPI_Comm_free(&s->comm);
+    release(s);
+}
+
+void matrix_mult_summa_block(const matrix_mult_summa* s, size_t* row0, size_t* rows,
+                             size_t* col0, size_t* cols) {
+    if (row0) *row0 = s->row0;
+    if (rows) *rows = s->rows;
+    if (col0) *col0 = s->col0;
+    if (cols) *cols = s->cols;
+}
+
+void matrix_mult_summa_grid(const matrix_mult_summa* s, int* prows, int* pcols) {
+    if (prows) *prows = s->prows;
+    if (pcols) *pcols = s->pcols;
+}
+
+int matrix_mult_summa_steps(const matrix_mult_summa* s) {
+    int steps = 0;
+    for (size_t k = 0; k < s->n; steps++) k += step_at(s, k).kb;
+    return steps;
+}
+
+int matrix_mult_summa_run(matrix_mult_summa* s, const float* A, const float* B, float* C,
+                          summa_times* times) {
+    int steps = 0;
+    double start = now_sec();
+    if (times) times->comm_sec = times->compute_sec = 0.0;
+    memset(C, 0, s->rows * s->cols * sizeof(float));
+
+    int rc = (s->flags & MATRIX_MULT_SUMMA_OVERLAP) ? run_overlapped(s, A, B, C, times, &steps)
+                                                     : run_blocking(s, A, B, C, times, &steps);
+
+    if (times) {
+        times->total_sec = now_sec() - start;
+        times->steps = steps;
+    }
+    return rc == MPI_SUCCESS ? 0 : -1;
+}
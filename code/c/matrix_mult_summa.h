@@ -0,0 +1,123 @@
+/**
+ * @file matrix_mult_summa.h
+ * @brief Distributed matrix multiplication (SUMMA) over MPI
+ *
+ * The n×n matrices A, B and C are split into a pr×pc grid of blocks, one
+ * per rank, with the same row and column partition for all three. SUMMA
+ * (van de Geijn and Watts, 1997) then walks the common dimension in
+ * panels: the ranks owning columns k..k+kb of A broadcast them along their
+ * grid row, the ranks owning rows k..k+kb of B broadcast them along their
+ * grid column, and every rank adds the product of the two panels to its C
+ * block with the single-node packed kernel (gemm_with_pack()).
+ *
+ * With MATRIX_MULT_SUMMA_OVERLAP the broadcasts of the next panel are
+ * posted as non-blocking collectives (MPI_Ibcast(), MPI-3) into a second
+ * panel buffer while the current panel is multiplied, which hides part of
+ * the communication time behind the local product.
+ *
+ * Kept out of matrix_mult.h so the single-node kernels build without MPI.
+ *
+ * Build: mpicc -O2 ... matrix_mult_summa.c ... (see benchmark_mpi.c)
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <mpi.h>
+#include "matrix_mult.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Default panel depth: one packed KC slice per SUMMA step */
+#define MATRIX_MULT_SUMMA_PANEL MATRIX_MULT_PACK_KC
+
+/** matrix_mult_summa_create() flag: overlap the next panel's broadcasts with the product */
+#define MATRIX_MULT_SUMMA_OVERLAP 0x1
+
+/**
+ * @brief Per-rank phase times of one matrix_mult_summa_run() call
+ *
+ * With MATRIX_MULT_SUMMA_OVERLAP, comm_sec counts only the exposed part:
+ * packing and posting the broadcasts and waiting for them to complete.
+ */
+typedef struct summa_times {
+    double compute_sec;     /* Local gemm_with_pack() calls */
+    double comm_sec;        /* Panel copies and broadcasts, including waits for other ranks */
+    double total_sec;       /* Wall time of the whole call */
+    int steps;              /* Panels broadcast */
+    double* step_comm_sec;  /* If not NULL: comm_sec of every step (matrix_mult_summa_steps() entries) */
+    double* step_compute_sec;   /* If not NULL: compute_sec of every step */
+} summa_times;
+
+/** Opaque process grid, communicators and panel buffers */
+typedef struct matrix_mult_summa matrix_mult_summa;
+
+/**
+ * @brief Set up a process grid for n×n multiplications (collective over comm)
+ * @param comm Communicator whose ranks take part (duplicated internally)
+ * @param n Global matrix dimension
+ * @param panel Panel depth per step (<= 0 selects MATRIX_MULT_SUMMA_PANEL)
+ * @param flags MATRIX_MULT_SUMMA_OVERLAP, or 0 for blocking broadcasts
+ * @param arena Arena for panel and packing buffers (heap if NULL or full);
+ *              overlapping needs two A and two B panels instead of one each
+ * @return Grid state, or NULL on every rank if any rank could not allocate
+ *         its buffers
+ *
+ * The grid is the most square factorisation pr×pc of the communicator size
+ * (MPI_Dims_create()); rank r sits at grid row r / pc, column r % pc.
+ */
+matrix_mult_summa* matrix_mult_summa_create(MPI_Comm comm, size_t n, int panel, int flags,
+                                            matrix_mult_arena* arena);
+
+/**
+ * @brief Free the grid and its communicators (collective; NULL is ignored)
+ */
+void matrix_mult_summa_destroy(matrix_mult_summa* s);
+
+/**
+ * @brief Global position and extent of this rank's block of A, B and C
+ * @param s Grid from matrix_mult_summa_create()
+ * @param row0 Receives the first global row (may be NULL)
+ * @param rows Receives the row count (may be NULL)
+ * @param col0 Receives the first global column (may be NULL)
+ * @param cols Receives the column count (may be NULL)
+ *
+ * Blocks are stored row-major with leading dimension cols.
+ */
+void matrix_mult_summa_block(const matrix_mult_summa* s, size_t* row0, size_t* rows,
+                             size_t* col0, size_t* cols);
+
+/**
+ * @brief Dimensions of the process grid
+ * @param s Grid from matrix_mult_summa_create()
+ * @param prows Receives the grid rows (may be NULL)
+ * @param pcols Receives the grid columns (may be NULL)
+ */
+void matrix_mult_summa_grid(const matrix_mult_summa* s, int* prows, int* pcols);
+
+/**
+ * @brief Number of SUMMA steps of one multiplication (the same on every rank)
+ *
+ * Panels end at panel-depth multiples and at block boundaries, so this can
+ * exceed ceil(n / panel) when n is not a multiple of the grid.
+ */
+int matrix_mult_summa_steps(const matrix_mult_summa* s);
+
+/**
+ * @brief C = A * B on the distributed blocks (collective)
+ * @param s Grid from matrix_mult_summa_create()
+ * @param A This rank's block of A (see matrix_mult_summa_block())
+ * @param B This rank's block of B
+ * @param C This rank's block of C, overwritten
+ * @param times Receives this rank's phase times (may be NULL); set its step
+ *              arrays, or NULL them, before the call
+ * @return 0 on success, -1 if an MPI call failed
+ */
+int matrix_mult_summa_run(matrix_mult_summa* s, const float* A, const float* B, float* C,
+                          summa_times* times);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,320 @@
+/**
+ * @file placement.c
+ * @brief Linux and Windows implementations of placement.h
+ *
+ * Build: compiled together with benchmark.c with OpenMP enabled; no NUMA
+ * library is needed (page nodes are queried with the move_pages system
+ * call directly). Windows sees processor group 0 only (up to 64 CPUs).
+ */
+
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* sched_setaffinity(), CPU_SET, syscall() */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "placement.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#define PLACEMENT_LINUX 1
+#endif
+#endif
+
+/* Pages whose node is queried per move_pages() call */
+#define PLACEMENT_QUERY_PAGES 1024
+
+/* ==================== Shared helpers ==================== */
+
+/**
+ * @brief Make the whole affinity list one node (hosts without NUMA information)
+ */
+static void single_node(placement_topology* t) {
+    t->nodes = 1;
+    t->node_id[0] = 0;
+    t->node_first[0] = 0;
+    t->node_cpus[0] = t->ncpus;
+    for (int i = 0; i < t->ncpus; i++) t->node_of[i] = 0;
+}
+
+/**
+ * @brief Append a usable CPU to the node currently being filled
+ */
+static void add_cpu(placement_topology* t, int cpu, int node) {
+    if (t->ncpus >= PLACEMENT_MAX_CPUS) return;
+    t->cpu[t->ncpus] = cpu;
+    t->node_of[t->ncpus] = node;
+    t->ncpus++;
+    t->node_cpus[node]++;
+}
+
+/**
+ * @brief First row of thread i's band: the same split for touching and counting
+ */
+static size_t band_start(size_t rows, int threads, int i) {
+    return (size_t)((unsigned long long)rows * (unsigned long long)i / (unsigned long long)threads);
+}
+
+int placement_parse(const char* s) {
+    if (strcmp(s, "serial") == 0) return PLACEMENT_SERIAL;
+    if (strcmp(s, "first-touch") == 0) return PLACEMENT_FIRST_TOUCH;
+    return -1;
+}
+
+const char* placement_name(int policy) {
+    return policy == PLACEMENT_FIRST_TOUCH ? "first-touch" : "serial";
+}
+
+int placement_bind_parse(const char* s) {
+    if (strcmp(s, "none") == 0) return PLACEMENT_BIND_NONE;
+    if (strcmp(s, "compact") == 0) return PLACEMENT_BIND_COMPACT;
+    if (strcmp(s, "scatter") == 0) return PLACEMENT_BIND_SCATTER;
+    return -1;
+}
+
+const char* placement_bind_name(int bind) {
+    switch (bind) {
+    case PLACEMENT_BIND_COMPACT: return "compact";
+    case PLACEMENT_BIND_SCATTER: return "scatter";
+    default:                     return "none";
+    }
+}
+
+int placement_cpu_for(const placement_topology* t, int bind, int thread) {
+    if (bind == PLACEMENT_BIND_NONE || t->ncpus <= 0) return -1;
+    if (bind == PLACEMENT_BIND_COMPACT) return t->cpu[thread % t->ncpus];
+
+    /* Scatter: node thread % nodes, then that node's CPUs in turn */
+    int node = thread % t->nodes;
+    int slot = (thread / t->nodes) % t->node_cpus[node];
+    return t->cpu[t->node_first[node] + slot];
+}
+
+void placement_first_touch(void* p, size_t rows, size_t row_bytes, int threads) {
+    unsigned char* base = (unsigned char*)p;
+    if (!p || rows == 0) return;
+    if (threads < 1) threads = 1;
+    if ((size_t)threads > rows) threads = (int)rows;
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads)
+#endif
+    {
+#ifdef _OPENMP
+        const int i = omp_get_thread_num();
+        const int team = omp_get_num_threads();
+#else
+        const int i = 0;
+        const int team = 1;
+#endif
+        const size_t lo = band_start(rows, team, i);
+        const size_t hi = band_start(rows, team, i + 1);
+        memset(base + lo * row_bytes, 0, (hi - lo) * row_bytes);
+    }
+}
+
+#if defined(_WIN32)
+
+/* ==================== Windows ==================== */
+
+void placement_topology_init(placement_topology* t) {
+    DWORD_PTR process_mask = 0, system_mask = 0;
+    ULONG highest = 0;
+
+    memset(t, 0, sizeof(*t));
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) process_mask = 1;
+    if (!GetNumaHighestNodeNumber(&highest)) highest = 0;
+
+    for (ULONG node = 0; node <= highest && t->nodes < PLACEMENT_MAX_NODES; node++) {
+        ULONGLONG node_mask = 0;
+        if (!GetNumaNodeProcessorMask((UCHAR)node, &node_mask)) continue;
+        node_mask &= (ULONGLONG)process_mask;
+        if (!node_mask) continue;
+        t->node_id[t->nodes] = (int)node;
+        t->node_first[t->nodes] = t->ncpus;
+        for (int cpu = 0; cpu < 64; cpu++) {
+            if (node_mask & (1ULL << cpu)) add_cpu(t, cpu, t->nodes);
+        }
+        t->nodes++;
+    }
+    if (t->nodes == 0) {
+        for (int cpu = 0; cpu < 64; cpu++) {
+            if ((ULONGLONG)process_mask & (1ULL << cpu)) add_cpu(t, cpu, 0);
+        }
+        single_node(t);
+    }
+}
+
+int placement_bind_threads(const placement_topology* t, int bind, int threads) {
+    int failed = 0;
+    if (bind == PLACEMENT_BIND_NONE) return 0;
+    if (threads < 1) threads = 1;
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads) reduction(+:failed)
+#endif
+    {
+#ifdef _OPENMP
+        const int cpu = placement_cpu_for(t, bind, omp_get_thread_num());
+#else
+        const int cpu = placement_cpu_for(t, bind, 0);
+#endif
+        if (!SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu)) failed++;
+    }
+    return failed ? -1 : 0;
+}
+
+int placement_count_pages(const placement_topology* t, int bind, const void* p, size_t rows,
+                          size_t row_bytes, int threads, placement_pages* acc) {
+    (void)t; (void)bind; (void)p; (void)rows; (void)row_bytes; (void)threads; (void)acc;
+    return -1;
+}
+
+#else /* Linux / POSIX */
+
+/* ==================== Linux / POSIX ==================== */
+
+#if defined(PLACEMENT_LINUX)
+/**
+ * @brief Parse a sysfs CPU list ("0-3,8-11") and add the CPUs also in mask
+ */
+static void add_cpulist(placement_topology* t, const char* list, const cpu_set_t* mask, int node) {
+    const char* s = list;
+    while (*s) {
+        char* end;
+        long lo = strtol(s, &end, 10);
+        long hi = lo;
+        if (end == s) break;
+        if (*end == '-') hi = strtol(end + 1, &end, 10);
+        for (long c = lo; c <= hi; c++) {
+            if (c < CPU_SETSIZE && CPU_ISSET((int)c, mask)) add_cpu(t, (int)c, node);
+        }
+        s = *end == ',' ? end + 1 : end;
+        if (*s == '\n') break;
+    }
+}
+#endif
+
+void placement_topology_init(placement_topology* t) {
+    memset(t, 0, sizeof(*t));
+#if defined(PLACEMENT_LINUX)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+        for (int c = 0; c < CPU_SETSIZE && c < PLACEMENT_MAX_CPUS; c++) CPU_SET(c, &mask);
+    }
+
+    /* Node directories may be sparse (e.g. node0 and node2 only) */
+    for (int node = 0; node < PLACEMENT_MAX_NODES * 4 && t->nodes < PLACEMENT_MAX_NODES; node++) {
+        char path[96], list[4096];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE* f = fopen(path, "r");
+        if (!f) continue;
+        int ok = fgets(list, sizeof(list), f) != NULL;
+        fclose(f);
+        if (!ok) continue;
+        t->node_id[t->nodes] = node;
+        t->node_first[t->nodes] = t->ncpus;
+        add_cpulist(t, list, &mask, t->nodes);
+        if (t->node_cpus[t->nodes] > 0) t->nodes++;
+    }
+    if (t->nodes > 0 && t->ncpus > 0) return;
+
+    /* No sysfs node information: one node holding the affinity mask */
+    t->ncpus = 0;
+    for (int c = 0; c < CPU_SETSIZE && t->ncpus < PLACEMENT_MAX_CPUS; c++) {
+        if (CPU_ISSET(c, &mask)) {
+            t->cpu[t->ncpus++] = c;
+        }
+    }
+#else
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    t->ncpus = online > 0 ? (int)(online < PLACEMENT_MAX_CPUS ? online : PLACEMENT_MAX_CPUS) : 1;
+    for (int c = 0; c < t->ncpus; c++) t->cpu[c] = c;
+#endif
+    single_node(t);
+}
+
+int placement_bind_threads(const placement_topology* t, int bind, int threads) {
+    if (bind == PLACEMENT_BIND_NONE) return 0;
+#if defined(PLACEMENT_LINUX)
+    int failed = 0;
+    if (threads < 1) threads = 1;
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads) reduction(+:failed)
+#endif
+    {
+#ifdef _OPENMP
+        const int cpu = placement_cpu_for(t, bind, omp_get_thread_num());
+#else
+        const int cpu = placement_cpu_for(t, bind, 0);
+#endif
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(cpu, &one);
+        if (sched_setaffinity(0, sizeof(one), &one) != 0) failed++;
+    }
+    return failed ? -1 : 0;
+#else
+    (void)t; (void)threads;
+    return -1;
+#endif
+}
+
+int placement_count_pages(const placement_topology* t, int bind, const void* p, size_t rows,
+                          size_t row_bytes, int threads, placement_pages* acc) {
+#if defined(PLACEMENT_LINUX) && defined(SYS_move_pages)
+    if (bind == PLACEMENT_BIND_NONE || !p || rows == 0) return -1;
+    if (threads < 1) threads = 1;
+    if ((size_t)threads > rows) threads = (int)rows;
+
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    const unsigned char* base = (const unsigned char*)p;
+    const size_t bytes = rows * row_bytes;
+    void* pages[PLACEMENT_QUERY_PAGES];
+    int expect[PLACEMENT_QUERY_PAGES];
+    int status[PLACEMENT_QUERY_PAGES];
+
+    /* Each page belongs to the band of its first byte inside the matrix */
+    size_t off = 0;
+    int band = 0;
+    while (off < bytes) {
+        int count = 0;
+        for (; count < PLACEMENT_QUERY_PAGES && off < bytes; count++) {
+            const size_t row = off / row_bytes;
+            while (band + 1 < threads && band_start(rows, threads, band + 1) <= row) band++;
+            int cpu = placement_cpu_for(t, bind, band);
+            int idx = 0;
+            while (idx < t->ncpus - 1 && t->cpu[idx] != cpu) idx++;
+            expect[count] = t->node_of[idx];
+            pages[count] = (void*)((size_t)(base + off) / page * page);
+            off = ((size_t)(base + off) / page + 1) * page - (size_t)base;
+        }
+
+        /* With a NULL node list, move_pages only reports where each page is */
+        if (syscall(SYS_move_pages, 0, (unsigned long)count, pages, NULL, status, 0) != 0) return -1;
+        for (int i = 0; i < count; i++) {
+            if (status[i] < 0) continue;            /* Not resident (or not queryable) */
+            if (status[i] == t->node_id[expect[i]]) acc->local++;
+            else acc->remote++;
+        }
+    }
+    return 0;
+#else
+    (void)t; (void)bind; (void)p; (void)rows; (void)row_bytes; (void)threads; (void)acc;
+    return -1;
+#endif
+}
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * @file placement.h
+ * @brief NUMA first-touch placement of the operands and thread pinning
+ *
+ * On a multi-socket host a page lands on the NUMA node of the thread that
+ * first writes it. If one thread initialises every matrix, all of them
+ * live on that thread's socket and the other sockets' threads read them
+ * remotely, at a fraction of the local bandwidth. The benchmark therefore
+ * can first-touch each operand in parallel, every thread writing the row
+ * band it later computes (the same contiguous split the static OpenMP
+ * schedules of the parallel kernels use), and pin its threads so that the
+ * band stays next to the thread:
+ * - compact: thread i on the i-th usable CPU, filling node 0 before node 1
+ * - scatter: threads dealt round-robin over the nodes, so every node gets
+ *   a share of the threads (and of the memory bandwidth) from the start
+ *
+ * | Function                 | Linux                                  | Windows                  |
+ * |--------------------------|----------------------------------------|--------------------------|
+ * | placement_topology_init  | /sys/devices/system/node, affinity mask| GetNumaNodeProcessorMask |
+ * | placement_bind_threads   | sched_setaffinity per OpenMP thread    | SetThreadAffinityMask    |
+ * | placement_count_pages    | move_pages (query only)                | not available (-1)       |
+ *
+ * Pinning is applied from inside an OpenMP parallel region of the same
+ * size as the kernel's; OpenMP runtimes keep their pool threads in the
+ * same order between regions, so the pins hold for the kernel's region.
+ * Elsewhere every host is reported as one node and pinning is a no-op.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest number of CPUs the topology records */
+#define PLACEMENT_MAX_CPUS 1024
+
+/** Largest number of NUMA nodes the topology records */
+#define PLACEMENT_MAX_NODES 64
+
+/** Operand placement policies (--placement) */
+enum {
+    PLACEMENT_SERIAL,       /* One thread initialises everything (pages on its node) */
+    PLACEMENT_FIRST_TOUCH   /* Every thread first-touches its own row band */
+};
+
+/** Thread pinning policies (--bind) */
+enum {
+    PLACEMENT_BIND_NONE,    /* Leave threads to the OS scheduler */
+    PLACEMENT_BIND_COMPACT, /* Fill the CPUs of one node before the next */
+    PLACEMENT_BIND_SCATTER  /* Deal threads round-robin over the nodes */
+};
+
+/**
+ * @brief Usable CPUs of the process, grouped by NUMA node
+ */
+typedef struct placement_topology {
+    int nodes;                          /**< Nodes with at least one usable CPU (1 if unknown) */
+    int ncpus;                          /**< CPUs in the affinity mask at initialisation */
+    int cpu[PLACEMENT_MAX_CPUS];        /**< CPU ids, node by node, ascending within a node */
+    int node_of[PLACEMENT_MAX_CPUS];    /**< Index (below nodes) of the node of cpu[i] */
+    int node_id[PLACEMENT_MAX_NODES];   /**< OS node number of each node */
+    int node_first[PLACEMENT_MAX_NODES];/**< Index in cpu[] of each node's first CPU */
+    int node_cpus[PLACEMENT_MAX_NODES]; /**< Usable CPUs of each node */
+} placement_topology;
+
+/**
+ * @brief Resident operand pages on and off the node of the thread that computes them
+ */
+typedef struct placement_pages {
+    size_t local;
+    size_t remote;
+} placement_pages;
+
+/**
+ * @brief Read the NUMA layout of the CPUs this process may run on
+ *
+ * Call before the first placement_bind_threads(): pinning narrows the
+ * affinity mask the layout is read from.
+ */
+void placement_topology_init(placement_topology* t);
+
+/**
+ * @brief Parse a --placement value ("serial" or "first-touch")
+ * @return PLACEMENT_* value, or -1 if the name is unknown
+ */
+int placement_parse(const char* s);
+
+/**
+ * @brief Name of a placement policy as written to the CSV
+ */
+const char* placement_name(int policy);
+
+/**
+ * @brief Parse a --bind value ("none", "compact" or "scatter")
+ * @return PLACEMENT_BIND_* value, or -1 if the name is unknown
+ */
+int placement_bind_parse(const char* s);
+
+/**
+ * @brief Name of a pinning policy as written to the CSV
+ */
+const char* placement_bind_name(int bind);
+
+/**
+ * @brief CPU that thread i of a team runs on under a pinning policy
+ * @return CPU id, or -1 for PLACEMENT_BIND_NONE
+ */
+int placement_cpu_for(const placement_topology* t, int bind, int thread);
+
+/**
+ * @brief Pin the threads of the next OpenMP regions with `threads` threads
+ * @param t Topology from placement_topology_init()
+ * @param bind Pinning policy (PLACEMENT_BIND_NONE does nothing)
+ * @param threads Team size the kernel will use
+ * @return 0 on success, -1 if the OS refused or does not support pinning
+ */
+int placement_bind_threads(const placement_topology* t, int bind, int threads);
+
+/**
+ * @brief Zero a matrix with each thread writing its own contiguous row band
+ * @param p Start of the matrix
+ * @param rows Number of rows
+ * @param row_bytes Bytes per row
+ * @param threads Team size; thread i writes rows [i*rows/threads, (i+1)*rows/threads)
+ *
+ * Only places pages that have not been touched yet; see
+ * matrix_mult_arena_discard() for handing arena pages back first.
+ */
+void placement_first_touch(void* p, size_t rows, size_t row_bytes, int threads);
+
+/**
+ * @brief Count a matrix's pages on and off the node of the row band's thread
+ * @param t Topology from placement_topology_init()
+ * @param bind Pinning policy of the run (threads must be pinned to know their node)
+ * @param p Start of the matrix
+ * @param rows Number of rows
+ * @param row_bytes Bytes per row
+ * @param threads Team size, split as in placement_first_touch()
+ * @param acc Counts are added here
+ * @return 0 on success, -1 if threads are not pinned or page nodes cannot be queried
+ */
+int placement_count_pages(const placement_topology* t, int bind, const void* p, size_t rows,
+                          size_t row_bytes, int threads, placement_pages* acc);
+
+#ifdef __cplusplus
+}
+#endif
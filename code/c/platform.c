@@ -0,0 +1,453 @@
+/**
+ * @file platform.c
+ * @brief Windows and POSIX/Linux implementations of platform.h
+ *
+ * Build: compiled together with benchmark.c; no extra libraries on POSIX
+ * (MSVC links psapi, bcrypt, powrprof and advapi32 through the #pragmas below;
+ * MinGW needs -lpsapi -lbcrypt -lpowrprof).
+ */
+
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* sched_getaffinity(), CPU_COUNT, CLOCK_MONOTONIC_RAW */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "platform.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PLATFORM_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+/* ==================== Shared helpers ==================== */
+
+/**
+ * @brief Read the 48-character processor brand string from cpuid (x86 only)
+ * @return Non-zero if buf was filled
+ */
+static int cpuid_brand(char* buf, size_t n) {
+#if defined(PLATFORM_X86)
+    unsigned int regs[12];
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0x80000000);
+    if ((unsigned int)info[0] < 0x80000004u) return 0;
+    for (int i = 0; i < 3; i++) {
+        __cpuid(info, 0x80000002 + i);
+        memcpy(&regs[4 * i], info, sizeof(info));
+    }
+#else
+    if (__get_cpuid_max(0x80000000u, NULL) < 0x80000004u) return 0;
+    for (unsigned int i = 0; i < 3; i++) {
+        __get_cpuid(0x80000002u + i, &regs[4 * i], &regs[4 * i + 1], &regs[4 * i + 2], &regs[4 * i + 3]);
+    }
+#endif
+    char brand[49];
+    memcpy(brand, regs, 48);
+    brand[48] = '\0';
+
+    /* Vendors pad the string with leading and trailing blanks */
+    const char* start = brand;
+    while (*start == ' ') start++;
+    size_t len = strlen(start);
+    while (len > 0 && start[len - 1] == ' ') len--;
+    if (len == 0) return 0;
+    snprintf(buf, n, "%.*s", (int)len, start);
+    return 1;
+#else
+    (void)buf;
+    (void)n;
+    return 0;
+#endif
+}
+
+/**
+ * @brief Format 16 random bytes as a version 4, variant 1 UUID
+ */
+static void format_uuid(unsigned char b[16], char* buf, size_t n) {
+    b[6] = (unsigned char)((b[6] & 0x0f) | 0x40);
+    b[8] = (unsigned char)((b[8] & 0x3f) | 0x80);
+    snprintf(buf, n, "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+             b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7],
+             b[8], b[9], b[10], b[11], b[12], b[13], b[14], b[15]);
+}
+
+/**
+ * @brief Weak fallback entropy: time, clock and a stack address
+ */
+static void fallback_random(unsigned char b[16]) {
+    unsigned long long x = (unsigned long long)time(NULL) ^ ((unsigned long long)clock() << 20) ^
+                           (unsigned long long)(size_t)&b;
+    for (int i = 0; i < 16; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        b[i] = (unsigned char)(x >> 24);
+    }
+}
+
+#if defined(_WIN32)
+
+#include <windows.h>
+#include <psapi.h>
+#include <bcrypt.h>
+#include <powrprof.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#pragma comment(lib, "bcrypt.lib")
+#pragma comment(lib, "powrprof.lib")
+#pragma comment(lib, "advapi32.lib")
+#endif
+
+double now_sec(void) {
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+double proc_cpu_seconds(void) {
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time,
+                    &kernel_time, &user_time);
+
+    /* Convert FILETIME to 64-bit integer (100-nanosecond intervals) */
+    ULONGLONG kernel_ticks = ((ULONGLONG)kernel_time.dwLowDateTime) |
+                             ((ULONGLONG)kernel_time.dwHighDateTime << 32);
+    ULONGLONG user_ticks = ((ULONGLONG)user_time.dwLowDateTime) |
+                           ((ULONGLONG)user_time.dwHighDateTime << 32);
+
+    /* Convert to seconds (1e7 = 100ns per second) */
+    return (kernel_ticks + user_ticks) / 1e7;
+}
+
+double current_mem_mib(void) {
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return pmc.WorkingSetSize / (1024.0 * 1024.0);
+    }
+    return 0.0;
+}
+
+double peak_mem_mib(void) {
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return pmc.PeakWorkingSetSize / (1024.0 * 1024.0);
+    }
+    return 0.0;
+}
+
+int logical_cpus(void) {
+    /* Count the CPUs this process may use, like sched_getaffinity() on Linux */
+    DWORD_PTR process_mask, system_mask;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask) && process_mask) {
+        int count = 0;
+        for (; process_mask; process_mask &= process_mask - 1) count++;
+        return count;
+    }
+
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    return system_info.dwNumberOfProcessors > 0 ?
+           (int)system_info.dwNumberOfProcessors : 1;
+}
+
+size_t llc_bytes(void) {
+    DWORD len = 0;
+    GetLogicalProcessorInformation(NULL, &len);
+    if (len == 0) return 0;
+
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION* info =
+        (SYSTEM_LOGICAL_PROCESSOR_INFORMATION*)malloc(len);
+    if (!info) return 0;
+
+    size_t best = 0;
+    int best_level = 0;
+    if (GetLogicalProcessorInformation(info, &len)) {
+        DWORD count = len / sizeof(*info);
+        for (DWORD i = 0; i < count; i++) {
+            if (info[i].Relationship != RelationCache) continue;
+            const CACHE_DESCRIPTOR* c = &info[i].Cache;
+            if (c->Type == CacheInstruction) continue;
+            if (c->Level > best_level || (c->Level == best_level && c->Size > best)) {
+                best_level = c->Level;
+                best = c->Size;
+            }
+        }
+    }
+    free(info);
+    return best;
+}
+
+void cpu_model_str(char* buf, size_t n) {
+    if (cpuid_brand(buf, n)) return;
+
+    char name[128];
+    DWORD len = sizeof(name);
+    if (RegGetValueA(HKEY_LOCAL_MACHINE, "HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0",
+                     "ProcessorNameString", RRF_RT_REG_SZ, NULL, name, &len) == ERROR_SUCCESS) {
+        snprintf(buf, n, "%s", name);
+        return;
+    }
+    snprintf(buf, n, "unknown");
+}
+
+void cpu_governor_str(char* buf, size_t n) {
+    /* Report the built-in schemes by name, anything else by GUID */
+    static const struct { unsigned long data1; const char* name; } schemes[] = {
+        { 0x8c5e7fdaUL, "high-performance" },
+        { 0x381b4222UL, "balanced" },
+        { 0xa1841308UL, "power-saver" },
+        { 0xe9a42b02UL, "ultimate-performance" },
+    };
+    GUID* scheme = NULL;
+    buf[0] = '\0';
+    if (PowerGetActiveScheme(NULL, &scheme) != ERROR_SUCCESS || !scheme) return;
+    for (size_t i = 0; i < sizeof(schemes) / sizeof(schemes[0]); i++) {
+        if (scheme->Data1 == schemes[i].data1) {
+            snprintf(buf, n, "%s", schemes[i].name);
+            LocalFree(scheme);
+            return;
+        }
+    }
+    snprintf(buf, n, "scheme-%08lx", (unsigned long)scheme->Data1);
+    LocalFree(scheme);
+}
+
+void os_kernel_str(char* buf, size_t n) {
+    /* GetVersionEx reports the manifest-compatible version; RtlGetVersion the real one */
+    typedef LONG (WINAPI *rtl_get_version_fn)(OSVERSIONINFOW*);
+    rtl_get_version_fn get_version =
+        (rtl_get_version_fn)(void*)GetProcAddress(GetModuleHandleA("ntdll.dll"), "RtlGetVersion");
+    OSVERSIONINFOW info;
+    memset(&info, 0, sizeof(info));
+    info.dwOSVersionInfoSize = sizeof(info);
+    if (get_version && get_version(&info) == 0) {
+        snprintf(buf, n, "Windows %lu.%lu.%lu", info.dwMajorVersion, info.dwMinorVersion,
+                 info.dwBuildNumber);
+    } else {
+        snprintf(buf, n, "Windows");
+    }
+}
+
+void random_uuid_str(char* buf, size_t n) {
+    unsigned char b[16];
+    if (BCryptGenRandom(NULL, b, sizeof(b), BCRYPT_USE_SYSTEM_PREFERRED_RNG) != 0) {
+        fallback_random(b);
+    }
+    format_uuid(b, buf, n);
+}
+
+void run_id_str(char* buf, size_t n) {
+    SYSTEMTIME st;
+    GetLocalTime(&st);
+    _snprintf_s(buf, n, _TRUNCATE, "%02d/%02d/%02d/%02d",
+                st.wDay, st.wMonth, st.wHour, st.wMinute);
+}
+
+#else /* POSIX */
+
+#include <sys/resource.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+/**
+ * @brief Read a "Key:  value kB" field from /proc/self/status
+ * @param key Field name including the colon (e.g. "VmRSS:")
+ * @return Value in KiB, or -1 if the file or field is unavailable
+ */
+static long proc_status_kib(const char* key) {
+    FILE* f = fopen("/proc/self/status", "r");
+    if (!f) return -1;
+
+    char line[256];
+    long kib = -1;
+    size_t len = strlen(key);
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, key, len) == 0) {
+            if (sscanf(line + len, "%ld", &kib) != 1) kib = -1;
+            break;
+        }
+    }
+    fclose(f);
+    return kib;
+}
+
+/**
+ * @brief Peak resident set size from getrusage() in MiB (fallback without /proc)
+ */
+static double rusage_peak_mib(void) {
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0.0;
+#if defined(__APPLE__)
+    return ru.ru_maxrss / (1024.0 * 1024.0); /* bytes on macOS */
+#else
+    return ru.ru_maxrss / 1024.0;            /* KiB elsewhere */
+#endif
+}
+
+double now_sec(void) {
+    struct timespec ts;
+#if defined(CLOCK_MONOTONIC_RAW)
+    /* Not slewed by NTP, like QueryPerformanceCounter */
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+double proc_cpu_seconds(void) {
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0.0;
+
+    /* User + system time of all threads, as GetProcessTimes reports */
+    return (double)ru.ru_utime.tv_sec + ru.ru_utime.tv_usec * 1e-6 +
+           (double)ru.ru_stime.tv_sec + ru.ru_stime.tv_usec * 1e-6;
+}
+
+double current_mem_mib(void) {
+    long kib = proc_status_kib("VmRSS:");
+    return kib >= 0 ? kib / 1024.0 : rusage_peak_mib();
+}
+
+double peak_mem_mib(void) {
+    long kib = proc_status_kib("VmHWM:");
+    return kib >= 0 ? kib / 1024.0 : rusage_peak_mib();
+}
+
+int logical_cpus(void) {
+#if defined(__linux__) && defined(CPU_COUNT)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        int count = CPU_COUNT(&set);
+        if (count > 0) return count;
+    }
+#endif
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    return online > 0 ? (int)online : 1;
+}
+
+size_t llc_bytes(void) {
+    /* Highest-level data or unified cache of CPU 0 in sysfs */
+    size_t best = 0;
+    int best_level = 0;
+    for (int index = 0; index < 16; index++) {
+        char path[96], text[32];
+        int level = 0;
+        unsigned long kib = 0;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/type", index);
+        FILE* f = fopen(path, "r");
+        if (!f) break;
+        int data = fgets(text, sizeof(text), f) && strncmp(text, "Instruction", 11) != 0;
+        fclose(f);
+        if (!data) continue;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/level", index);
+        if ((f = fopen(path, "r")) != NULL) {
+            if (fscanf(f, "%d", &level) != 1) level = 0;
+            fclose(f);
+        }
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", index);
+        if ((f = fopen(path, "r")) != NULL) {
+            if (fscanf(f, "%luK", &kib) != 1) kib = 0;
+            fclose(f);
+        }
+        if (level > best_level && kib > 0) {
+            best_level = level;
+            best = (size_t)kib * 1024;
+        }
+    }
+    if (best > 0) return best;
+
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+    long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (l3 > 0) return (size_t)l3;
+#endif
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+    long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (l2 > 0) return (size_t)l2;
+#endif
+    return 0;
+}
+
+/**
+ * @brief Read the first line of a small text file without its newline
+ * @return Non-zero if something was read
+ */
+static int read_first_line(const char* path, char* buf, size_t n) {
+    FILE* f = fopen(path, "r");
+    if (!f) return 0;
+    int ok = fgets(buf, (int)n, f) != NULL;
+    fclose(f);
+    if (ok) buf[strcspn(buf, "\r\n")] = '\0';
+    return ok && buf[0];
+}
+
+void cpu_model_str(char* buf, size_t n) {
+    if (cpuid_brand(buf, n)) return;
+
+    /* "model name" on x86, "Model"/"Hardware"/"cpu" on ARM and POWER */
+    static const char* const keys[] = { "model name", "Model", "Hardware", "cpu" };
+    FILE* f = fopen("/proc/cpuinfo", "r");
+    if (f) {
+        char line[256];
+        while (fgets(line, sizeof(line), f)) {
+            for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+                size_t len = strlen(keys[i]);
+                const char* colon = strchr(line, ':');
+                if (strncmp(line, keys[i], len) == 0 && colon && colon[1]) {
+                    const char* v = colon + 1;
+                    while (*v == ' ' || *v == '\t') v++;
+                    snprintf(buf, n, "%.*s", (int)strcspn(v, "\r\n"), v);
+                    fclose(f);
+                    return;
+                }
+            }
+        }
+        fclose(f);
+    }
+    snprintf(buf, n, "unknown");
+}
+
+void cpu_governor_str(char* buf, size_t n) {
+    if (!read_first_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor", buf, n)) {
+        buf[0] = '\0';
+    }
+}
+
+void os_kernel_str(char* buf, size_t n) {
+    struct utsname u;
+    if (uname(&u) == 0) snprintf(buf, n, "%s %s", u.sysname, u.release);
+    else snprintf(buf, n, "unknown");
+}
+
+void random_uuid_str(char* buf, size_t n) {
+    unsigned char b[16];
+    FILE* f = fopen("/dev/urandom", "rb");
+    if (!f || fread(b, 1, sizeof(b), f) != sizeof(b)) fallback_random(b);
+    if (f) fclose(f);
+    format_uuid(b, buf, n);
+}
+
+void run_id_str(char* buf, size_t n) {
+    time_t now = time(NULL);
+    struct tm lt;
+    localtime_r(&now, &lt);
+    snprintf(buf, n, "%02d/%02d/%02d/%02d",
+             lt.tm_mday, lt.tm_mon + 1, lt.tm_hour, lt.tm_min);
+}
+
+#endif
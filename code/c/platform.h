@@ -0,0 +1,112 @@
+/**
+ * @file platform.h
+ * @brief Timing, CPU, memory and system queries used by the benchmark harness
+ *
+ * One interface with a Windows implementation and a POSIX/Linux one, so
+ * benchmark.c builds unchanged with MSVC and GCC/Clang. Each function
+ * measures the same quantity on both platforms, so CSV rows from Windows
+ * and Linux machines can be compared directly:
+ *
+ * | Function           | Windows                     | Linux / POSIX                       |
+ * |--------------------|-----------------------------|-------------------------------------|
+ * | now_sec            | QueryPerformanceCounter     | clock_gettime(CLOCK_MONOTONIC_RAW)  |
+ * | proc_cpu_seconds   | GetProcessTimes user+kernel | getrusage(RUSAGE_SELF) user+system  |
+ * | current_mem_mib    | WorkingSetSize              | VmRSS in /proc/self/status          |
+ * | peak_mem_mib       | PeakWorkingSetSize          | VmHWM in /proc/self/status          |
+ * | logical_cpus       | process affinity mask       | sched_getaffinity                   |
+ * | llc_bytes          | GetLogicalProcessorInfo     | /sys/.../cpu0/cache, sysconf        |
+ * | cpu_model_str      | cpuid brand string, registry| cpuid brand string, /proc/cpuinfo   |
+ * | cpu_governor_str   | active power scheme         | cpufreq scaling_governor of cpu0    |
+ * | os_kernel_str      | RtlGetVersion               | uname                               |
+ * | random_uuid_str    | BCryptGenRandom             | /dev/urandom                        |
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get current time in seconds with high precision
+ * @return Monotonic time in seconds (arbitrary origin, not adjusted by NTP)
+ */
+double now_sec(void);
+
+/**
+ * @brief Get total CPU time consumed by the current process
+ * @return CPU time in seconds, summed over all threads (user + kernel time)
+ */
+double proc_cpu_seconds(void);
+
+/**
+ * @brief Get current process memory usage in MiB
+ * @return Resident set / working set size in mebibytes (MiB), or 0.0 on error
+ */
+double current_mem_mib(void);
+
+/**
+ * @brief Get the largest memory usage of the process so far in MiB
+ * @return Peak resident set / working set size in MiB, or 0.0 on error
+ */
+double peak_mem_mib(void);
+
+/**
+ * @brief Get number of logical CPU cores this process may run on
+ * @return Number of logical processors in the affinity mask, or 1 if
+ *         detection fails
+ */
+int logical_cpus(void);
+
+/**
+ * @brief Get the size of the largest (last-level) CPU cache
+ * @return Cache size in bytes as seen by CPU 0, or 0 if it cannot be detected
+ */
+size_t llc_bytes(void);
+
+/**
+ * @brief Get the CPU model name (e.g. "AMD EPYC 7763 64-Core Processor")
+ * @param buf Buffer to store the name ("unknown" if it cannot be detected)
+ * @param n Size of the buffer
+ */
+void cpu_model_str(char* buf, size_t n);
+
+/**
+ * @brief Get the CPU frequency policy in effect
+ * @param buf Buffer to store the cpufreq governor (Linux, e.g. "performance")
+ *            or power scheme (Windows, e.g. "high-performance"); "" if unknown
+ * @param n Size of the buffer
+ */
+void cpu_governor_str(char* buf, size_t n);
+
+/**
+ * @brief Get the operating system kernel name and release
+ * @param buf Buffer to store e.g. "Linux 6.8.0-45-generic" or "Windows 10.0.22631"
+ * @param n Size of the buffer
+ */
+void os_kernel_str(char* buf, size_t n);
+
+/**
+ * @brief Generate a random (version 4) UUID
+ * @param buf Buffer of at least 37 bytes for the 36-character text form
+ * @param n Size of the buffer
+ *
+ * Uses the OS random source; falls back to time and address entropy if
+ * it is unavailable, which is still unique enough to tell runs apart.
+ */
+void random_uuid_str(char* buf, size_t n);
+
+/**
+ * @brief Generate a run identifier string from current local time
+ * @param buf Buffer to store the run ID string
+ * @param n Size of the buffer
+ *
+ * Format: DD/MM/HH/MM (day/month/hour/minute)
+ */
+void run_id_str(char* buf, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,397 @@
+/**
+ * @file result_sink.c
+ * @brief Column table and writers behind result_sink.h
+ *
+ * One table (COLUMNS) lists every column in CSV order with its type, its
+ * place in result_row and its text format; the CSV header, the CSV, JSON
+ * and binary writers are all driven by it, so a new column is one entry
+ * here plus the header strings of the Java and Python harnesses.
+ *
+ * Binary layout (host byte order; readers check the order marker):
+ *   char     magic[8]       "MMBENCH1"
+ *   uint32   order          0x01020304
+ *   uint32   ncols          number of columns
+ *   uint32   record_bytes   size of one record
+ *   uint32   header_bytes   length of the column list that follows
+ *   char     header[]       the CSV header without the newline
+ *   records                 ncols fields each: strings as char[64]
+ *                           (NUL padded), every number as float64 (NaN
+ *                           when not measured)
+ * An existing binary file is appended to only if its header is identical.
+ * Longer strings (long cflags) are truncated in binary records only.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "result_sink.h"
+
+/* Rows buffered before the first growth of the buffer */
+#define SINK_INITIAL_ROWS 256
+
+/* Width of a string field in a binary record */
+#define SINK_STR_BYTES 64
+
+/* Longest CSV header accepted when checking an existing file */
+#define SINK_HEADER_MAX 2048
+
+static const char SINK_MAGIC[8] = { 'M', 'M', 'B', 'E', 'N', 'C', 'H', '1' };
+static const uint32_t SINK_ORDER = 0x01020304u;
+
+/* ==================== Column table ==================== */
+
+/* Kinds of columns */
+enum {
+    COL_STR,        /* const char* */
+    COL_INT,        /* int */
+    COL_SIZE,       /* size_t */
+    COL_REAL,       /* double, always measured */
+    COL_OPT         /* double, negative when not measured */
+};
+
+typedef struct column {
+    const char* name;
+    int kind;
+    size_t offset;      /* Offset of the field in result_row */
+    const char* fmt;    /* printf format for COL_REAL and COL_OPT */
+} column;
+
+#define ROW_FIELD(f) offsetof(result_row, f)
+#define ROW_COUNTER(i) (offsetof(result_row, counters) + (i) * sizeof(double))
+
+/* CSV column order (keep in sync with the Java and Python harnesses) */
+static const column COLUMNS[] = {
+    { "run_id",        COL_STR,  ROW_FIELD(run_id),        NULL },
+    { "language",      COL_STR,  ROW_FIELD(language),      NULL },
+    { "size",          COL_INT,  ROW_FIELD(size),          NULL },
+    { "run_idx",       COL_INT,  ROW_FIELD(run_idx),       NULL },
+    { "time_ms",       COL_REAL, ROW_FIELD(time_ms),       "%.3f" },
+    { "cpu_pct",       COL_REAL, ROW_FIELD(cpu_pct),       "%.1f" },
+    { "peak_mib",      COL_REAL, ROW_FIELD(peak_mib),      "%.2f" },
+    { "kernel",        COL_STR,  ROW_FIELD(kernel),        NULL },
+    { "pack_ms",       COL_OPT,  ROW_FIELD(pack_ms),       "%.3f" },
+    { "compute_ms",    COL_OPT,  ROW_FIELD(compute_ms),    "%.3f" },
+    { "threads",       COL_INT,  ROW_FIELD(threads),       NULL },
+    { "imbalance",     COL_OPT,  ROW_FIELD(imbalance),     "%.3f" },
+    { "steals",        COL_OPT,  ROW_FIELD(steals),        "%.0f" },
+    { "m",             COL_SIZE, ROW_FIELD(dims.m),        NULL },
+    { "n",             COL_SIZE, ROW_FIELD(dims.n),        NULL },
+    { "k",             COL_SIZE, ROW_FIELD(dims.k),        NULL },
+    { "max_err",       COL_OPT,  ROW_FIELD(max_err),       "%.3e" },
+    { "cycles",        COL_OPT,  ROW_COUNTER(HW_CYCLES),       "%.0f" },
+    { "instructions",  COL_OPT,  ROW_COUNTER(HW_INSTRUCTIONS), "%.0f" },
+    { "l1d_misses",    COL_OPT,  ROW_COUNTER(HW_L1D_MISSES),   "%.0f" },
+    { "llc_misses",    COL_OPT,  ROW_COUNTER(HW_LLC_MISSES),   "%.0f" },
+    { "dtlb_misses",   COL_OPT,  ROW_COUNTER(HW_DTLB_MISSES),  "%.0f" },
+    { "fp_ops",        COL_OPT,  ROW_COUNTER(HW_FP_OPS),       "%.0f" },
+    { "reps",          COL_INT,  ROW_FIELD(reps),          NULL },
+    { "gflops",        COL_REAL, ROW_FIELD(gflops),        "%.3f" },
+    { "intensity",     COL_REAL, ROW_FIELD(intensity),     "%.3f" },
+    { "pct_peak",      COL_OPT,  ROW_FIELD(pct_peak),      "%.1f" },
+    { "peak_gflops",   COL_OPT,  ROW_FIELD(peak_gflops),   "%.2f" },
+    { "bandwidth_gbs", COL_OPT,  ROW_FIELD(bandwidth_gbs), "%.2f" },
+    { "fingerprint",   COL_STR,  ROW_FIELD(fingerprint),   NULL },
+    { "cpu_model",     COL_STR,  ROW_FIELD(cpu_model),     NULL },
+    { "cores",         COL_INT,  ROW_FIELD(cores),         NULL },
+    { "governor",      COL_STR,  ROW_FIELD(governor),      NULL },
+    { "compiler",      COL_STR,  ROW_FIELD(compiler),      NULL },
+    { "cflags",        COL_STR,  ROW_FIELD(cflags),        NULL },
+    { "os_kernel",     COL_STR,  ROW_FIELD(os_kernel),     NULL },
+    { "run_uuid",      COL_STR,  ROW_FIELD(run_uuid),      NULL },
+    { "comm_ms",       COL_OPT,  ROW_FIELD(comm_ms),       "%.3f" },
+    { "ranks",         COL_INT,  ROW_FIELD(ranks),         NULL },
+    { "rank",          COL_INT,  ROW_FIELD(rank),          NULL },
+    { "dtype",         COL_STR,  ROW_FIELD(dtype),         NULL },
+    { "err_fp64",      COL_OPT,  ROW_FIELD(err_fp64),      "%.3e" },
+    { "batch",         COL_SIZE, ROW_FIELD(batch),         NULL },
+    { "h2d_ms",        COL_OPT,  ROW_FIELD(h2d_ms),        "%.3f" },
+    { "d2h_ms",        COL_OPT,  ROW_FIELD(d2h_ms),        "%.3f" },
+    { "placement",     COL_STR,  ROW_FIELD(placement),     NULL },
+    { "bind",          COL_STR,  ROW_FIELD(bind),          NULL },
+    { "remote_pct",    COL_OPT,  ROW_FIELD(remote_pct),    "%.1f" },
+    { "bytes_read",    COL_OPT,  ROW_FIELD(bytes_read),    "%.0f" },
+    { "bytes_written", COL_OPT,  ROW_FIELD(bytes_written), "%.0f" },
+    { "verified",      COL_STR,  ROW_FIELD(verified),      NULL },
+    { "verify_err",    COL_OPT,  ROW_FIELD(verify_err),    "%.3e" },
+    { "density",       COL_REAL, ROW_FIELD(density),       "%g" },
+    { "queue",         COL_SIZE, ROW_FIELD(queue),         NULL },
+    { "lat_p50_ms",    COL_OPT,  ROW_FIELD(lat_p50_ms),    "%.4f" },
+    { "lat_p99_ms",    COL_OPT,  ROW_FIELD(lat_p99_ms),    "%.4f" },
+};
+
+#define NCOLUMNS ((int)(sizeof(COLUMNS) / sizeof(COLUMNS[0])))
+
+static const char* col_str(const result_row* row, const column* c) {
+    const char* s = *(const char* const*)((const char*)row + c->offset);
+    return s ? s : "";
+}
+
+static double col_num(const result_row* row, const column* c) {
+    const char* p = (const char*)row + c->offset;
+    switch (c->kind) {
+    case COL_INT:  return (double)*(const int*)p;
+    case COL_SIZE: return (double)*(const size_t*)p;
+    default:       return *(const double*)p;
+    }
+}
+
+/* ==================== Sink ==================== */
+
+struct result_sink {
+    const char* csv_path;
+    const char* jsonl_path;     /* NULL if not requested */
+    const char* binary_path;    /* NULL if not requested */
+    result_row* rows;
+    size_t count;
+    size_t capacity;
+};
+
+const char* result_sink_csv_header(void) {
+    static char header[SINK_HEADER_MAX];
+    if (!header[0]) {
+        size_t len = 0;
+        for (int i = 0; i < NCOLUMNS; i++) {
+            len += (size_t)snprintf(header + len, sizeof(header) - len, "%s%c",
+                                    COLUMNS[i].name, i + 1 < NCOLUMNS ? ';' : '\n');
+        }
+    }
+    return header;
+}
+
+static size_t record_bytes(void) {
+    size_t bytes = 0;
+    for (int i = 0; i < NCOLUMNS; i++) {
+        bytes += COLUMNS[i].kind == COL_STR ? SINK_STR_BYTES : sizeof(double);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Create the CSV with its header, or check the header of an existing one
+ *
+ * Appending rows to a file written with an older schema would misalign
+ * every column, so an existing file must start with exactly this header.
+ */
+static int prepare_csv(const char* path) {
+    const char* header = result_sink_csv_header();
+    FILE* f = fopen(path, "r");
+    if (f) {
+        char line[SINK_HEADER_MAX];
+        int ok = fgets(line, sizeof(line), f) && strcmp(line, header) == 0;
+        fclose(f);
+        if (!ok) {
+            fprintf(stderr, "%s has a different CSV header; expected:\n%s"
+                            "Use a new output file for this schema.\n", path, header);
+            return -1;
+        }
+        return 0;
+    }
+
+    f = fopen(path, "a");
+    if (!f) {
+        fprintf(stderr, "Cannot open %s for writing\n", path);
+        return -1;
+    }
+    fputs(header, f);
+    fclose(f);
+    return 0;
+}
+
+/**
+ * @brief Create the binary file with its header, or check an existing one
+ */
+static int prepare_binary(const char* path) {
+    const char* header = result_sink_csv_header();
+    const uint32_t ncols = (uint32_t)NCOLUMNS;
+    const uint32_t rec = (uint32_t)record_bytes();
+    const uint32_t hlen = (uint32_t)strlen(header) - 1; /* Without the newline */
+
+    FILE* f = fopen(path, "rb");
+    if (f) {
+        char magic[8], text[SINK_HEADER_MAX];
+        uint32_t fields[4];
+        int ok = fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+                 memcmp(magic, SINK_MAGIC, sizeof(magic)) == 0 &&
+                 fread(fields, sizeof(uint32_t), 4, f) == 4 &&
+                 fields[0] == SINK_ORDER && fields[1] == ncols && fields[2] == rec &&
+                 fields[3] == hlen && hlen < sizeof(text) &&
+                 fread(text, 1, hlen, f) == hlen && memcmp(text, header, hlen) == 0;
+        fclose(f);
+        if (!ok) {
+            fprintf(stderr, "%s is not a result file with this schema; "
+                            "use a new binary output file.\n", path);
+            return -1;
+        }
+        return 0;
+    }
+
+    f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "Cannot open %s for writing\n", path);
+        return -1;
+    }
+    const uint32_t fields[4] = { SINK_ORDER, ncols, rec, hlen };
+    fwrite(SINK_MAGIC, 1, sizeof(SINK_MAGIC), f);
+    fwrite(fields, sizeof(uint32_t), 4, f);
+    fwrite(header, 1, hlen, f);
+    fclose(f);
+    return 0;
+}
+
+/* ==================== Writers ==================== */
+
+static void write_csv_row(FILE* f, const result_row* row) {
+    for (int i = 0; i < NCOLUMNS; i++) {
+        const column* c = &COLUMNS[i];
+        switch (c->kind) {
+        case COL_STR:  fputs(col_str(row, c), f); break;
+        case COL_INT:  fprintf(f, "%d", *(const int*)((const char*)row + c->offset)); break;
+        case COL_SIZE: fprintf(f, "%zu", *(const size_t*)((const char*)row + c->offset)); break;
+        case COL_REAL: fprintf(f, c->fmt, col_num(row, c)); break;
+        default: {
+            /* Negative values mean "not measured" and are left empty */
+            double v = col_num(row, c);
+            if (v >= 0.0) fprintf(f, c->fmt, v);
+            break;
+        }
+        }
+        fputc(i + 1 < NCOLUMNS ? ';' : '\n', f);
+    }
+}
+
+/**
+ * @brief Write a string as a JSON string literal
+ */
+static void put_json_string(FILE* f, const char* s) {
+    fputc('"', f);
+    for (; *s; s++) {
+        unsigned char ch = (unsigned char)*s;
+        if (ch == '"' || ch == '\\') fprintf(f, "\\%c", ch);
+        else if (ch < 0x20) fprintf(f, "\\u%04x", ch);
+        else fputc(ch, f);
+    }
+    fputc('"', f);
+}
+
+static void write_json_row(FILE* f, const result_row* row) {
+    fputc('{', f);
+    for (int i = 0; i < NCOLUMNS; i++) {
+        const column* c = &COLUMNS[i];
+        fprintf(f, "%s\"%s\":", i ? "," : "", c->name);
+        if (c->kind == COL_STR) {
+            put_json_string(f, col_str(row, c));
+        } else if (c->kind == COL_INT || c->kind == COL_SIZE) {
+            fprintf(f, "%.0f", col_num(row, c));
+        } else {
+            double v = col_num(row, c);
+            /* JSON has no NaN/Inf; unmeasured and non-finite values become null */
+            if ((c->kind == COL_OPT && v < 0.0) || !isfinite(v)) fputs("null", f);
+            else fprintf(f, c->fmt, v);
+        }
+    }
+    fputs("}\n", f);
+}
+
+static void write_binary_row(FILE* f, const result_row* row) {
+    for (int i = 0; i < NCOLUMNS; i++) {
+        const column* c = &COLUMNS[i];
+        if (c->kind == COL_STR) {
+            char text[SINK_STR_BYTES];
+            memset(text, 0, sizeof(text));
+            strncpy(text, col_str(row, c), sizeof(text) - 1);
+            fwrite(text, 1, sizeof(text), f);
+        } else {
+            double v = col_num(row, c);
+            if (c->kind == COL_OPT && v < 0.0) v = NAN;
+            fwrite(&v, sizeof(v), 1, f);
+        }
+    }
+}
+
+/**
+ * @brief Append rows to one output with a row writer
+ */
+static int append_rows(const char* path, const char* mode, const result_row* rows, size_t count,
+                       void (*write)(FILE*, const result_row*)) {
+    FILE* f = fopen(path, mode);
+    if (!f) {
+        fprintf(stderr, "Cannot open %s for appending\n", path);
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) write(f, &rows[i]);
+    int ok = fclose(f) == 0;
+    return ok ? 0 : -1;
+}
+
+static int write_rows(const result_sink* sink, const result_row* rows, size_t count) {
+    int status = 0;
+    if (count == 0) return 0;
+    if (append_rows(sink->csv_path, "a", rows, count, write_csv_row) != 0) status = -1;
+    if (sink->jsonl_path && append_rows(sink->jsonl_path, "a", rows, count, write_json_row) != 0) {
+        status = -1;
+    }
+    if (sink->binary_path && append_rows(sink->binary_path, "ab", rows, count, write_binary_row) != 0) {
+        status = -1;
+    }
+    return status;
+}
+
+/* ==================== Public API ==================== */
+
+result_sink* result_sink_open(const char* csv_path, const char* jsonl_path,
+                              const char* binary_path) {
+    if (!csv_path || prepare_csv(csv_path) != 0) return NULL;
+    if (binary_path && prepare_binary(binary_path) != 0) return NULL;
+    if (jsonl_path) {
+        FILE* f = fopen(jsonl_path, "a");
+        if (!f) {
+            fprintf(stderr, "Cannot open %s for writing\n", jsonl_path);
+            return NULL;
+        }
+        fclose(f);
+    }
+
+    result_sink* sink = (result_sink*)calloc(1, sizeof(*sink));
+    if (!sink) return NULL;
+    sink->csv_path = csv_path;
+    sink->jsonl_path = jsonl_path;
+    sink->binary_path = binary_path;
+    sink->rows = (result_row*)malloc(SINK_INITIAL_ROWS * sizeof(result_row));
+    sink->capacity = sink->rows ? SINK_INITIAL_ROWS : 0;
+    return sink;
+}
+
+int result_sink_add(result_sink* sink, const result_row* row) {
+    if (sink->count == sink->capacity) {
+        size_t capacity = sink->capacity ? 2 * sink->capacity : SINK_INITIAL_ROWS;
+        result_row* rows = (result_row*)realloc(sink->rows, capacity * sizeof(result_row));
+        if (!rows) {
+            /* Out of memory: write through rather than lose the row */
+            result_sink_flush(sink);
+            write_rows(sink, row, 1);
+            return -1;
+        }
+        sink->rows = rows;
+        sink->capacity = capacity;
+    }
+    sink->rows[sink->count++] = *row;
+    return 0;
+}
+
+int result_sink_flush(result_sink* sink) {
+    if (!sink) return 0;
+    int status = write_rows(sink, sink->rows, sink->count);
+    sink->count = 0;
+    return status;
+}
+
+int result_sink_close(result_sink* sink) {
+    if (!sink) return 0;
+    int status = result_sink_flush(sink);
+    free(sink->rows);
+    free(sink);
+    return status;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file result_sink.h
+ * @brief Buffered writer for benchmark result rows (CSV, JSON lines, binary)
+ *
+ * Rows are collected in memory while kernels run and written out by
+ * result_sink_flush(), which the harness calls once per size and at exit,
+ * so no file is opened, written or closed next to a timed region.
+ *
+ * Every row always goes to the semicolon CSV (the schema shared with the
+ * Java and Python harnesses). Two optional outputs carry the same columns
+ * for sweeps too large to re-parse as text:
+ * - JSON lines: one object per row; unmeasured metrics are null
+ * - Binary: a self-describing header followed by fixed-size records, see
+ *   result_sink.c for the layout; unmeasured metrics are NaN
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "hw_counters.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Problem shape: A is m×k, B is k×n, C is m×n
+ */
+typedef struct shape {
+    size_t m, n, k;
+} shape;
+
+/**
+ * @brief One CSV row: the measurements of a single timed run
+ *
+ * String fields must stay valid until the row has been flushed.
+ */
+typedef struct result_row {
+    const char* run_id;
+    const char* language;
+    int size;
+    int run_idx;
+    double time_ms;
+    double cpu_pct;
+    double peak_mib;
+    const char* kernel;
+    double pack_ms;     /* Negative when the kernel does not report it */
+    double compute_ms;  /* Negative when the kernel does not report it */
+    int threads;
+    double imbalance;   /* Negative when the kernel does not report it */
+    double steals;      /* Negative when the kernel does not report it */
+    shape dims;
+    double max_err;     /* Negative when no reference result was computed */
+    double counters[HW_COUNTER_COUNT];  /* Negative when not measured */
+    int reps;           /* Kernel calls averaged into this row */
+    double gflops;
+    double intensity;   /* FLOPs per byte of compulsory memory traffic */
+    double pct_peak;    /* Negative when the roofline was not measured */
+    double peak_gflops; /* Negative when the roofline was not measured */
+    double bandwidth_gbs;  /* Negative when the roofline was not measured */
+    const char* fingerprint;    /* Host and build hash (fingerprint.h) */
+    const char* cpu_model;
+    int cores;
+    const char* governor;
+    const char* compiler;
+    const char* cflags;
+    const char* os_kernel;
+    const char* run_uuid;
+    double comm_ms;     /* Negative when the kernel does not communicate */
+    int ranks;          /* MPI ranks in the run (1 for single-process harnesses) */
+    int rank;           /* Rank that measured this row */
+    const char* dtype;  /* Element type the kernel computes in ("fp32", "bf16", ...) */
+    double err_fp64;    /* Max |C - fp64 reference|; negative when not computed */
+    size_t batch;       /* Matrices multiplied per call (1 for non-batched kernels) */
+    double h2d_ms;      /* Negative when the kernel does not offload */
+    double d2h_ms;      /* Negative when the kernel does not offload */
+    const char* placement;  /* Operand placement policy ("serial", "first-touch") */
+    const char* bind;       /* Thread pinning policy ("none", "compact", "scatter") */
+    double remote_pct;  /* A and C pages off their thread's node; negative when not measured */
+    double bytes_read;  /* Operand bytes an out-of-core kernel streamed in; negative otherwise */
+    double bytes_written; /* Result bytes it streamed out; negative otherwise */
+    const char* verified;   /* "pass" or "fail" against verify.h's tolerance; NULL when not checked */
+    double verify_err;  /* Componentwise relative error (verify.h); negative when not checked */
+    double density;     /* Fraction of A's elements generated nonzero (1 = dense) */
+    size_t queue;       /* Requests in flight per call (1 unless the kernel queues several) */
+    double lat_p50_ms;  /* Median request latency of a queueing kernel; negative otherwise */
+    double lat_p99_ms;  /* 99th percentile request latency; negative otherwise */
+} result_row;
+
+/** Opaque buffered writer */
+typedef struct result_sink result_sink;
+
+/**
+ * @brief Open the outputs and check that existing files use this schema
+ * @param csv_path Semicolon CSV path (required)
+ * @param jsonl_path JSON-lines path, or NULL
+ * @param binary_path Binary record file path, or NULL
+ * @return Sink, or NULL if a file cannot be written or an existing file has
+ *         a different header (a message is printed to stderr)
+ *
+ * Existing files are appended to; new files get their header here.
+ */
+result_sink* result_sink_open(const char* csv_path, const char* jsonl_path,
+                              const char* binary_path);
+
+/**
+ * @brief Buffer one row (copied; pointers inside it are kept)
+ * @return 0 on success, -1 if the buffer cannot grow (the row is then
+ *         flushed directly)
+ */
+int result_sink_add(result_sink* sink, const result_row* row);
+
+/**
+ * @brief Append every buffered row to the outputs and empty the buffer
+ * @return 0 on success, -1 if a file could not be written
+ */
+int result_sink_flush(result_sink* sink);
+
+/**
+ * @brief Flush and release the sink (NULL is ignored)
+ * @return Result of the final flush
+ */
+int result_sink_close(result_sink* sink);
+
+/**
+ * @brief Semicolon-separated CSV header line, including the newline
+ */
+const char* result_sink_csv_header(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,151 @@
+/**
+ * @file rng.c
+ * @brief Scalar and AVX2 implementations of rng.h
+ *
+ * AVX2 has no 64-bit multiply, so the two splitmix64 multiplications are
+ * built from three 32×32→64 products each; eight elements per iteration
+ * (two vectors of four) keep the dependent multiply chains overlapped.
+ * Both paths compute the same integers, so they agree bit for bit.
+ *
+ * Build with OpenMP enabled (gcc/clang -fopenmp, MSVC /openmp); without it
+ * the fill runs on the calling thread.
+ */
+
+#include <string.h>
+#include "rng.h"
+#include "matrix_mult.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define RNG_X86_64 1
+#include <immintrin.h>
+#endif
+
+/* GCC and Clang need the ISA enabled per function; MSVC accepts intrinsics anywhere */
+#if defined(RNG_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define RNG_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define RNG_TARGET_AVX2
+#endif
+
+/* splitmix64 constants: golden-ratio increment and the two finaliser multipliers */
+#define RNG_SEED_MUL  0x9E3779B97F4A7C15ull
+#define RNG_WHICH_MUL 0xD1B54A32D192ED03ull
+#define RNG_MIX1      0xBF58476D1CE4E5B9ull
+#define RNG_MIX2      0x94D049BB133111EBull
+
+/* Elements in [0, 1) keep the top 24 bits, exactly representable as float */
+#define RNG_SCALE (1.0f / 16777216.0f)
+
+/**
+ * @brief Counter of element 0 of a matrix; element i is at base + i
+ */
+static uint64_t rng_base(uint64_t seed, uint64_t which) {
+    return seed * RNG_SEED_MUL + which * RNG_WHICH_MUL;
+}
+
+static float mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * RNG_MIX1;
+    z = (z ^ (z >> 27)) * RNG_MIX2;
+    z ^= z >> 31;
+    return (float)(z >> 40) * RNG_SCALE;
+}
+
+float rng_element(uint64_t seed, uint64_t which, uint64_t index) {
+    return mix(rng_base(seed, which) + index);
+}
+
+static void fill_scalar(float* dst, size_t count, uint64_t z) {
+    for (size_t i = 0; i < count; i++) dst[i] = mix(z + i);
+}
+
+#if defined(RNG_X86_64)
+/**
+ * @brief x * c modulo 2^64 per lane; chi holds the high half of c in each low dword
+ */
+RNG_TARGET_AVX2
+static __m256i mul64(__m256i x, __m256i clo, __m256i chi) {
+    const __m256i lo = _mm256_mul_epu32(x, clo);
+    const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), clo),
+                                           _mm256_mul_epu32(x, chi));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+
+RNG_TARGET_AVX2
+static __m256i mix_avx2(__m256i z, __m256i m1lo, __m256i m1hi, __m256i m2lo, __m256i m2hi) {
+    z = mul64(_mm256_xor_si256(z, _mm256_srli_epi64(z, 30)), m1lo, m1hi);
+    z = mul64(_mm256_xor_si256(z, _mm256_srli_epi64(z, 27)), m2lo, m2hi);
+    z = _mm256_xor_si256(z, _mm256_srli_epi64(z, 31));
+    return _mm256_srli_epi64(z, 40);
+}
+
+RNG_TARGET_AVX2
+static void fill_avx2(float* dst, size_t count, uint64_t z) {
+    const __m256i m1lo = _mm256_set1_epi64x((long long)(RNG_MIX1 & 0xFFFFFFFFu));
+    const __m256i m1hi = _mm256_set1_epi64x((long long)(RNG_MIX1 >> 32));
+    const __m256i m2lo = _mm256_set1_epi64x((long long)(RNG_MIX2 & 0xFFFFFFFFu));
+    const __m256i m2hi = _mm256_set1_epi64x((long long)(RNG_MIX2 >> 32));
+    const __m256i step = _mm256_set1_epi64x(8);
+    /* Gathers the low dword of each 64-bit lane of two vectors into one */
+    const __m256i pack = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m256 scale = _mm256_set1_ps(RNG_SCALE);
+
+    __m256i z0 = _mm256_add_epi64(_mm256_set1_epi64x((long long)z), _mm256_setr_epi64x(0, 1, 2, 3));
+    __m256i z1 = _mm256_add_epi64(z0, _mm256_set1_epi64x(4));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i r0 = _mm256_permutevar8x32_epi32(mix_avx2(z0, m1lo, m1hi, m2lo, m2hi), pack);
+        const __m256i r1 = _mm256_permutevar8x32_epi32(mix_avx2(z1, m1lo, m1hi, m2lo, m2hi), pack);
+        const __m256i r = _mm256_permute2x128_si256(r0, r1, 0x20);
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(r), scale));
+        z0 = _mm256_add_epi64(z0, step);
+        z1 = _mm256_add_epi64(z1, step);
+    }
+    fill_scalar(dst + i, count - i, z + i);
+}
+#endif
+
+void rng_fill(float* dst, size_t count, uint64_t seed, uint64_t which, uint64_t first, int threads) {
+    const uint64_t z = rng_base(seed, which) + first;
+    void (*fill)(float*, size_t, uint64_t) = fill_scalar;
+#if defined(RNG_X86_64)
+    if (strcmp(matrix_mult_simd_isa(), "avx2") == 0) fill = fill_avx2;
+#endif
+
+    /* Every element depends only on its index, so any split gives the same matrix */
+#ifdef _OPENMP
+    if (threads <= 0) threads = omp_get_max_threads();
+#pragma omp parallel num_threads(threads) if (count >= 65536)
+#else
+    (void)threads;
+#endif
+    {
+#ifdef _OPENMP
+        const size_t t = (size_t)omp_get_thread_num(), team = (size_t)omp_get_num_threads();
+#else
+        const size_t t = 0, team = 1;
+#endif
+        const size_t lo = (size_t)((unsigned long long)count * t / team);
+        const size_t hi = (size_t)((unsigned long long)count * (t + 1) / team);
+        fill(dst + lo, hi - lo, z + lo);
+    }
+}
+
+void rng_sparsify(float* dst, size_t count, uint64_t seed, uint64_t which, uint64_t first,
+                  double density, int threads) {
+    const uint64_t z = rng_base(seed, which) + first;
+    const long long len = (long long)count;
+    if (density >= 1.0) return;
+#ifdef _OPENMP
+    if (threads <= 0) threads = omp_get_max_threads();
+#pragma omp parallel for schedule(static) num_threads(threads) if (count >= 65536)
+#else
+    (void)threads;
+#endif
+    for (long long i = 0; i < len; i++) {
+        if ((double)mix(z + (uint64_t)i) >= density) dst[i] = 0.0f;
+    }
+}
@@ -0,0 +1,73 @@
+/**
+ * @file rng.h
+ * @brief Counter-based generator for the benchmark's input matrices
+ *
+ * Element `index` of matrix `which` is a pure function of (seed, which,
+ * index): the splitmix64 finaliser over a linear combination of the three,
+ * keeping the top 24 bits as a float in [0, 1). There is no generator
+ * state, so
+ * - any thread (or MPI rank) can fill any range of elements on its own,
+ *   and a matrix comes out bit-identical for every thread count
+ * - the result only uses 64-bit integer arithmetic and an exact int-to-float
+ *   conversion, so every compiler, OS and ISA produces the same matrices
+ *   for the same seed (unlike rand(), whose range and sequence differ
+ *   between C libraries)
+ * - a matrix does not depend on which sizes ran before it
+ *
+ * benchmark.c and benchmark_mpi.c both use matrix 0 for A and 1 for B with
+ * row-major element indices, so the same seed gives both harnesses the
+ * same n×n operands.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Matrix numbers of the operands (the "which" argument) */
+#define RNG_MATRIX_A 0
+#define RNG_MATRIX_B 1
+
+/** Stream of the Freivalds weights of verify.c */
+#define RNG_MATRIX_VERIFY 2
+
+/** Stream deciding which elements of A --density keeps */
+#define RNG_MATRIX_SPARSITY 3
+
+/**
+ * @brief Element `index` of matrix `which`, in [0, 1)
+ */
+float rng_element(uint64_t seed, uint64_t which, uint64_t index);
+
+/**
+ * @brief Fill dst[i] = rng_element(seed, which, first + i) for i < count
+ * @param dst Output elements
+ * @param count Number of elements
+ * @param seed Run seed
+ * @param which Matrix number (RNG_MATRIX_A, RNG_MATRIX_B, ...)
+ * @param first Index of dst[0] within the matrix
+ * @param threads OpenMP threads splitting the range (<= 0 uses all); the
+ *                result does not depend on it
+ *
+ * Uses AVX2 for 4 elements at a time when the CPU has it.
+ */
+void rng_fill(float* dst, size_t count, uint64_t seed, uint64_t which, uint64_t first, int threads);
+
+/**
+ * @brief Zero dst[i] unless rng_element(seed, which, first + i) < density
+ * @param density Expected fraction of elements kept (>= 1 keeps all)
+ *
+ * Which elements survive depends only on (seed, which, index), like the
+ * values themselves, so a sparse matrix is reproducible on every host and
+ * thread count; use a stream (which) of its own, e.g. RNG_MATRIX_SPARSITY.
+ */
+void rng_sparsify(float* dst, size_t count, uint64_t seed, uint64_t which, uint64_t first,
+                  double density, int threads);
+
+#ifdef __cplusplus
+}
+#endif
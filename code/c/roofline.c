@@ -0,0 +1,291 @@
+/**
+ * @file roofline.c
+ * @brief FMA peak and STREAM triad probes behind roofline.h
+ *
+ * The FMA loops keep 12 vector accumulators live (AVX2: 2 FMA ports × 4-5
+ * cycles latency needs at least 10) and update them as acc = acc * x + y
+ * with x < 1, so values converge instead of overflowing or going denormal.
+ * Each probe is repeated and the fastest trial is kept, as STREAM does.
+ *
+ * The triad arrays are carved from the caller's arena when one is given
+ * (the harness sizes its arena to hold them), so the probe adds nothing to
+ * the process footprint beyond the arena. They are capped at
+ * RF_TRIAD_MAX_BYTES each: on hosts whose LLC is larger than the capped
+ * working set, the triad partly runs from cache and overstates DRAM
+ * bandwidth.
+ *
+ * Build with OpenMP (-fopenmp, /openmp) for the all-thread figures; without
+ * it both measurements run on the calling thread.
+ */
+
+#include <string.h>
+#include "matrix_mult.h"
+#include "matrix_mult_internal.h"
+#include "platform.h"
+#include "roofline.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define RF_X86_64 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define RF_AARCH64 1
+#include <arm_neon.h>
+#endif
+
+/* Same per-function ISA enabling as matrix_mult_simd.c */
+#if defined(RF_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define RF_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define RF_TARGET_AVX2
+#endif
+
+/* Independent accumulators per FMA loop */
+#define RF_ACCS 12
+
+/* Trials per probe; the fastest one is reported */
+#define RF_TRIALS 5
+
+/* Minimum wall time of one peak trial */
+#define RF_MIN_SECONDS 0.02
+
+/* Triad arrays: 4x the LLC over all three, within these bounds per array */
+#define RF_TRIAD_MIN_BYTES ((size_t)8 << 20)
+#define RF_TRIAD_MAX_BYTES ((size_t)32 << 20)
+
+/* ==================== FMA loops ==================== */
+
+/* Each returns a sum of its accumulators so the loop cannot be removed */
+
+/**
+ * @brief Portable loop: RF_ACCS independent 8-wide chains in plain C
+ * @return FLOPs per iteration via *flops, accumulator sum as result
+ */
+static float fma_loop_scalar(long iters, double* flops) {
+    float acc[RF_ACCS][8];
+    const float x = 0.999999f, y = 1e-6f;
+    for (int a = 0; a < RF_ACCS; a++)
+        for (int j = 0; j < 8; j++) acc[a][j] = (float)(a + j) * 1e-3f;
+
+    for (long it = 0; it < iters; it++)
+        for (int a = 0; a < RF_ACCS; a++)
+            for (int j = 0; j < 8; j++) acc[a][j] = acc[a][j] * x + y;
+
+    float sum = 0.0f;
+    for (int a = 0; a < RF_ACCS; a++)
+        for (int j = 0; j < 8; j++) sum += acc[a][j];
+    *flops = 2.0 * RF_ACCS * 8;
+    return sum;
+}
+
+#if defined(RF_X86_64)
+RF_TARGET_AVX2
+static float fma_loop_avx2(long iters, double* flops) {
+    const __m256 x = _mm256_set1_ps(0.999999f), y = _mm256_set1_ps(1e-6f);
+    __m256 c0 = _mm256_set1_ps(0.0f), c1 = _mm256_set1_ps(0.1f), c2 = _mm256_set1_ps(0.2f);
+    __m256 c3 = _mm256_set1_ps(0.3f), c4 = _mm256_set1_ps(0.4f), c5 = _mm256_set1_ps(0.5f);
+    __m256 c6 = _mm256_set1_ps(0.6f), c7 = _mm256_set1_ps(0.7f), c8 = _mm256_set1_ps(0.8f);
+    __m256 c9 = _mm256_set1_ps(0.9f), c10 = _mm256_set1_ps(1.0f), c11 = _mm256_set1_ps(1.1f);
+
+    for (long it = 0; it < iters; it++) {
+        c0 = _mm256_fmadd_ps(c0, x, y);   c1 = _mm256_fmadd_ps(c1, x, y);
+        c2 = _mm256_fmadd_ps(c2, x, y);   c3 = _mm256_fmadd_ps(c3, x, y);
+        c4 = _mm256_fmadd_ps(c4, x, y);   c5 = _mm256_fmadd_ps(c5, x, y);
+        c6 = _mm256_fmadd_ps(c6, x, y);   c7 = _mm256_fmadd_ps(c7, x, y);
+        c8 = _mm256_fmadd_ps(c8, x, y);   c9 = _mm256_fmadd_ps(c9, x, y);
+        c10 = _mm256_fmadd_ps(c10, x, y); c11 = _mm256_fmadd_ps(c11, x, y);
+    }
+
+    __m256 s = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(c0, c1), _mm256_add_ps(c2, c3)),
+                             _mm256_add_ps(_mm256_add_ps(c4, c5), _mm256_add_ps(c6, c7)));
+    s = _mm256_add_ps(s, _mm256_add_ps(_mm256_add_ps(c8, c9), _mm256_add_ps(c10, c11)));
+    float lanes[8];
+    _mm256_storeu_ps(lanes, s);
+    *flops = 2.0 * RF_ACCS * 8;
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+}
+#endif
+
+#if defined(RF_AARCH64)
+static float fma_loop_neon(long iters, double* flops) {
+    const float32x4_t x = vdupq_n_f32(0.999999f), y = vdupq_n_f32(1e-6f);
+    float32x4_t acc[RF_ACCS];
+    for (int a = 0; a < RF_ACCS; a++) acc[a] = vdupq_n_f32((float)a * 0.1f);
+
+    for (long it = 0; it < iters; it++)
+        for (int a = 0; a < RF_ACCS; a++) acc[a] = vfmaq_f32(y, acc[a], x);
+
+    float32x4_t s = acc[0];
+    for (int a = 1; a < RF_ACCS; a++) s = vaddq_f32(s, acc[a]);
+    *flops = 2.0 * RF_ACCS * 4;
+    return vaddvq_f32(s);
+}
+#endif
+
+typedef float (*fma_loop_fn)(long iters, double* flops);
+
+/**
+ * @brief FMA loop matching the micro-kernel that matrix_mult_simd.c selected
+ */
+static fma_loop_fn select_loop(const char* isa) {
+#if defined(RF_X86_64)
+    if (strcmp(isa, "avx2") == 0) return fma_loop_avx2;
+#endif
+#if defined(RF_AARCH64)
+    if (strcmp(isa, "neon") == 0) return fma_loop_neon;
+#endif
+    (void)isa;
+    return fma_loop_scalar;
+}
+
+/* ==================== Probes ==================== */
+
+static volatile float rf_sink;
+
+/**
+ * @brief Best FMA throughput of `threads` threads running the loop concurrently
+ * @return GFLOP/s summed over the threads
+ */
+static double measure_peak(fma_loop_fn loop, int threads) {
+    double per_iter = 0.0;
+    long iters = 1 << 14;
+
+    /* Grow the trip count until one trial takes RF_MIN_SECONDS on one thread */
+    for (;;) {
+        double t0 = now_sec();
+        rf_sink = loop(iters, &per_iter);
+        if (now_sec() - t0 >= RF_MIN_SECONDS || iters > (1L << 30)) break;
+        iters *= 2;
+    }
+
+    double best = 0.0;
+    for (int trial = 0; trial < RF_TRIALS; trial++) {
+        double t0 = 0.0, t1 = 0.0;
+        int team = 1;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads)
+        {
+            /* The clock starts at the end of single's barrier, before any thread loops */
+#pragma omp single
+            {
+                team = omp_get_num_threads();
+                t0 = now_sec();
+            }
+            double f;
+            float s = loop(iters, &f);
+#pragma omp atomic
+            rf_sink += s;
+#pragma omp barrier
+#pragma omp master
+            t1 = now_sec();
+        }
+#else
+        (void)threads;
+        t0 = now_sec();
+        rf_sink = loop(iters, &per_iter);
+        t1 = now_sec();
+#endif
+        /* Scaled by the team OpenMP delivered, which may be smaller than requested */
+        double gflops = per_iter * (double)iters * team / (t1 - t0) * 1e-9;
+        if (gflops > best) best = gflops;
+    }
+    return best;
+}
+
+/**
+ * @brief Bytes of one triad array
+ */
+static size_t triad_array_bytes(void) {
+    size_t bytes = 4 * llc_bytes() / 3;
+    if (bytes < RF_TRIAD_MIN_BYTES) bytes = RF_TRIAD_MIN_BYTES;
+    if (bytes > RF_TRIAD_MAX_BYTES) bytes = RF_TRIAD_MAX_BYTES;
+    return bytes;
+}
+
+/**
+ * @brief Best STREAM triad bandwidth over RF_TRIALS trials on len-element arrays
+ * @return GB/s (10^9 bytes per second)
+ */
+static double run_triad(float* a, float* b, float* c, long len, int threads) {
+    const double bytes = (double)len * sizeof(float);
+
+    /* First touch with the same static split as the triad */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads)
+#endif
+    for (long i = 0; i < len; i++) {
+        a[i] = 0.0f;
+        b[i] = 1.0f;
+        c[i] = 2.0f;
+    }
+
+    const float s = 3.0f;
+    double best = 0.0;
+    for (int trial = 0; trial < RF_TRIALS; trial++) {
+        double t0 = now_sec();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads)
+#endif
+        for (long i = 0; i < len; i++) a[i] = b[i] + s * c[i];
+        double t1 = now_sec();
+
+        double gbs = 3.0 * bytes / (t1 - t0) * 1e-9;
+        if (gbs > best) best = gbs;
+    }
+    rf_sink = a[len / 2];
+    (void)threads;
+    return best;
+}
+
+/**
+ * @brief Triad bandwidth on arrays from the arena (or the heap when they do not fit)
+ * @return GB/s (10^9 bytes per second), or -1 if allocation fails
+ */
+static double measure_triad(int threads, matrix_mult_arena* arena) {
+    const size_t bytes = triad_array_bytes();
+    const size_t mark = matrix_mult_arena_mark(arena);
+    float* a = (float*)matrix_mult_scratch_alloc(arena, bytes);
+    float* b = (float*)matrix_mult_scratch_alloc(arena, bytes);
+    float* c = (float*)matrix_mult_scratch_alloc(arena, bytes);
+
+    const double best = a && b && c ? run_triad(a, b, c, (long)(bytes / sizeof(float)), threads) : -1.0;
+
+    matrix_mult_scratch_free(arena, a);
+    matrix_mult_scratch_free(arena, b);
+    matrix_mult_scratch_free(arena, c);
+    if (arena) matrix_mult_arena_release(arena, mark);
+    return best;
+}
+
+/* ==================== Public API ==================== */
+
+size_t roofline_triad_bytes(void) {
+    return 3 * (triad_array_bytes() + MATRIX_MULT_ALIGN);
+}
+
+int roofline_measure(roofline* rf, int threads, matrix_mult_arena* arena) {
+    if (threads <= 0) threads = logical_cpus();
+
+    rf->isa = matrix_mult_simd_isa();
+    rf->threads = threads;
+
+    fma_loop_fn loop = select_loop(rf->isa);
+    rf->peak_gflops_1 = measure_peak(loop, 1);
+    rf->peak_gflops = threads > 1 ? measure_peak(loop, threads) : rf->peak_gflops_1;
+    if (rf->peak_gflops < rf->peak_gflops_1) rf->peak_gflops = rf->peak_gflops_1;
+
+    rf->bandwidth_gbs = measure_triad(threads, arena);
+    return rf->bandwidth_gbs > 0.0 ? 0 : -1;
+}
+
+double roofline_peak_for(const roofline* rf, int threads) {
+    if (!rf) return -1.0;
+    if (threads < 1) threads = 1;
+    double linear = rf->peak_gflops_1 * threads;
+    return linear < rf->peak_gflops ? linear : rf->peak_gflops;
+}
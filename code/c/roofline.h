@@ -0,0 +1,66 @@
+/**
+ * @file roofline.h
+ * @brief Machine peak FLOP/s and memory bandwidth probes for roofline reporting
+ *
+ * Measured once at startup by the benchmark harness:
+ * - Peak: a register-only FMA loop with enough independent accumulators to
+ *   hide FMA latency, using the same ISA as the SIMD micro-kernel
+ *   (matrix_mult_simd_isa()), so percent of peak is relative to what the
+ *   kernels in this library can issue.
+ * - Bandwidth: a STREAM triad a[i] = b[i] + s * c[i] over arrays that
+ *   together hold four times the last-level cache (8 to 32 MiB each),
+ *   counting 12 bytes per element as STREAM does (no write-allocate
+ *   traffic).
+ *
+ * Both are run on one thread and on all requested threads (OpenMP); runs
+ * with t threads are compared against min(t * one-thread peak, all-thread
+ * peak).
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "matrix_mult.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Measured machine limits
+ */
+typedef struct roofline {
+    const char* isa;            /**< ISA of the FMA loop (as matrix_mult_simd_isa()) */
+    int threads;                /**< Thread count of the all-thread measurements */
+    double peak_gflops_1;       /**< FMA peak of one thread, GFLOP/s */
+    double peak_gflops;         /**< FMA peak of all threads, GFLOP/s */
+    double bandwidth_gbs;       /**< STREAM triad bandwidth of all threads, GB/s */
+} roofline;
+
+/**
+ * @brief Bytes roofline_measure() takes from its arena for the triad arrays
+ */
+size_t roofline_triad_bytes(void);
+
+/**
+ * @brief Run the peak FLOP/s and bandwidth probes
+ * @param rf Receives the results
+ * @param threads Threads for the all-thread measurements (<= 0: all logical CPUs)
+ * @param arena Arena for the triad arrays, or NULL; they come from the heap
+ *              when they do not fit
+ * @return 0 on success, -1 if the triad arrays could not be allocated
+ *         (the peak is still filled in; bandwidth_gbs is then -1)
+ *
+ * Takes roughly a second; the triad arrays are released before returning.
+ */
+int roofline_measure(roofline* rf, int threads, matrix_mult_arena* arena);
+
+/**
+ * @brief Attainable peak for a run with the given thread count
+ * @return GFLOP/s, or -1 if rf is NULL
+ */
+double roofline_peak_for(const roofline* rf, int threads);
+
+#ifdef __cplusplus
+}
+#endif
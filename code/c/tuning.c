@@ -0,0 +1,375 @@
+/**
+ * @file tuning.c
+ * @brief Tuning table, tuning file I/O and the parameter search behind tuning.h
+ *
+ * The search calls kernels through the registry, exactly as the harness
+ * does, so a tuned parameter set is the one that was fastest under the
+ * same prepare/run/release sequence the benchmark times.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tuning.h"
+#include "platform.h"
+
+/* Header line of a tuning file (without the newline) */
+#define TUNING_HEADER "fingerprint;kernel;size_class;tile;threads;cutoff;mc;kc;nc;time_ms;gflops"
+
+/* Longest line tuning_load() and tuning_save() handle */
+#define TUNING_LINE_MAX 256
+
+/* Shortest timed sample when measuring a candidate: short calls are repeated to reach it */
+#define TUNING_SAMPLE_SEC 1e-3
+
+/* ==================== Table ==================== */
+
+int tuning_size_class(int n) {
+    int c = 1;
+    while (c < n && c < (1 << 30)) c <<= 1;
+    return c;
+}
+
+void tuning_default_path(const char* fingerprint, char* buf, size_t len) {
+    snprintf(buf, len, "tuning_%s.csv", fingerprint);
+}
+
+void tuning_init(tuning_table* t, const char* fingerprint) {
+    memset(t, 0, sizeof(*t));
+    snprintf(t->fingerprint, sizeof(t->fingerprint), "%s", fingerprint);
+}
+
+int tuning_set(tuning_table* t, const tuning_entry* e) {
+    for (int i = 0; i < t->count; i++) {
+        tuning_entry* cur = &t->entries[i];
+        if (cur->size_class == e->size_class && strcmp(cur->kernel, e->kernel) == 0) {
+            *cur = *e;
+            return 0;
+        }
+    }
+    if (t->count >= TUNING_MAX_ENTRIES) return -1;
+    t->entries[t->count++] = *e;
+    return 0;
+}
+
+/* Integer log2 of a size class (a power of two) */
+static int class_log2(int c) {
+    int l = 0;
+    while (c > 1) {
+        c >>= 1;
+        l++;
+    }
+    return l;
+}
+
+const tuning_entry* tuning_lookup(const tuning_table* t, const char* kernel, int n) {
+    const int want = class_log2(tuning_size_class(n));
+    const tuning_entry* best = NULL;
+    int best_dist = 0;
+
+    for (int i = 0; i < t->count; i++) {
+        const tuning_entry* e = &t->entries[i];
+        if (strcmp(e->kernel, kernel) != 0) continue;
+        int dist = abs(class_log2(e->size_class) - want);
+        /* Equal distance: prefer the larger class, whose blocking also fits smaller problems */
+        if (!best || dist < best_dist || (dist == best_dist && e->size_class > best->size_class)) {
+            best = e;
+            best_dist = dist;
+        }
+    }
+    return best;
+}
+
+const tuning_entry* tuning_apply(const tuning_table* t, const kernel_entry* kernel, int n,
+                                 kernel_opts* opts, int keep) {
+    const tuning_entry* e = t ? tuning_lookup(t, kernel->name, n) : NULL;
+    if (!e) return NULL;
+
+    if ((kernel->tunable & KERNEL_TUNE_TILE) && !(keep & TUNING_KEEP_TILE) && e->tile > 0) {
+        opts->tile = e->tile;
+    }
+    if ((kernel->tunable & KERNEL_TUNE_THREADS) && !(keep & TUNING_KEEP_THREADS) && e->threads > 0) {
+        opts->threads = e->threads;
+    }
+    if ((kernel->tunable & KERNEL_TUNE_CUTOFF) && !(keep & TUNING_KEEP_CUTOFF) && e->cutoff > 0) {
+        opts->cutoff = e->cutoff;
+    }
+    if ((kernel->tunable & KERNEL_TUNE_BLOCKS) && !(keep & TUNING_KEEP_BLOCKS)) {
+        if (e->mc > 0) opts->mc = e->mc;
+        if (e->kc > 0) opts->kc = e->kc;
+        if (e->nc > 0) opts->nc = e->nc;
+    }
+    return e;
+}
+
+/* ==================== File ==================== */
+
+/* Strip a trailing newline (and CR of files edited on Windows) */
+static void chomp(char* line) {
+    size_t len = strlen(line);
+    while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+}
+
+/* Parse one data row; returns 0 and fills e and fp on success */
+static int parse_row(const char* line, char fp[17], tuning_entry* e) {
+    memset(e, 0, sizeof(*e));
+    return sscanf(line, "%16[^;];%31[^;];%d;%d;%d;%d;%d;%d;%d;%lf;%lf", fp, e->kernel,
+                  &e->size_class, &e->tile, &e->threads, &e->cutoff, &e->mc, &e->kc, &e->nc,
+                  &e->time_ms, &e->gflops) == 11 ? 0 : -1;
+}
+
+int tuning_load(tuning_table* t, const char* path) {
+    char line[TUNING_LINE_MAX];
+    int loaded = 0;
+    FILE* f = fopen(path, "r");
+    if (!f) return -1;
+
+    if (!fgets(line, sizeof(line), f)) {
+        fclose(f);
+        return -1;
+    }
+    chomp(line);
+    if (strcmp(line, TUNING_HEADER) != 0) {
+        fprintf(stderr, "%s is not a tuning file (header differs)\n", path);
+        fclose(f);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), f)) {
+        char fp[17];
+        tuning_entry e;
+        chomp(line);
+        if (parse_row(line, fp, &e) != 0 || strcmp(fp, t->fingerprint) != 0) continue;
+        if (tuning_set(t, &e) == 0) loaded++;
+    }
+    fclose(f);
+    return loaded;
+}
+
+int tuning_save(const tuning_table* t, const char* path) {
+    char line[TUNING_LINE_MAX];
+    char* others = NULL;
+    size_t others_len = 0;
+
+    /* Keep the rows of other hosts */
+    FILE* f = fopen(path, "r");
+    if (f) {
+        int first = 1;
+        while (fgets(line, sizeof(line), f)) {
+            char fp[17];
+            tuning_entry e;
+            chomp(line);
+            if (first) {
+                first = 0;
+                if (strcmp(line, TUNING_HEADER) == 0) continue;
+            }
+            if (parse_row(line, fp, &e) != 0 || strcmp(fp, t->fingerprint) == 0) continue;
+            size_t len = strlen(line);
+            char* grown = (char*)realloc(others, others_len + len + 2);
+            if (!grown) break;
+            others = grown;
+            memcpy(others + others_len, line, len);
+            others[others_len + len] = '\n';
+            others_len += len + 1;
+        }
+        fclose(f);
+    }
+
+    f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "Cannot open %s for writing\n", path);
+        free(others);
+        return -1;
+    }
+    fputs(TUNING_HEADER "\n", f);
+    if (others) fwrite(others, 1, others_len, f);
+    for (int i = 0; i < t->count; i++) {
+        const tuning_entry* e = &t->entries[i];
+        fprintf(f, "%s;%s;%d;%d;%d;%d;%d;%d;%d;%.4f;%.3f\n", t->fingerprint, e->kernel,
+                e->size_class, e->tile, e->threads, e->cutoff, e->mc, e->kc, e->nc,
+                e->time_ms, e->gflops);
+    }
+    free(others);
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+/* ==================== Search ==================== */
+
+/**
+ * @brief Best time per call of the kernel with one parameter set
+ * @return Seconds per call, or HUGE_VAL if prepare() failed
+ *
+ * Calls shorter than TUNING_SAMPLE_SEC are repeated inside each sample so
+ * the timer resolution does not decide the winner; the best sample over
+ * the budget is kept, as the least disturbed by other activity.
+ */
+static double measure(const kernel_entry* kernel, const float* A, const float* B, float* C,
+                      int n, const kernel_opts* opts, double budget_sec) {
+    const size_t mark = matrix_mult_arena_mark(opts->arena);
+    kernel_ctx ctx;
+    double best, start, t0, t;
+    int inner = 1;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.opts = opts;
+    ctx.m = ctx.n = ctx.k = (size_t)n;
+    if (kernel->prepare) {
+        ctx.state = kernel->prepare(n, opts);
+        if (!ctx.state) {
+            matrix_mult_arena_release(opts->arena, mark);
+            return HUGE_VAL;
+        }
+    }
+
+    kernel->run(A, B, C, n, &ctx);     /* Warm-up: caches, OpenMP threads */
+
+    /* Calibrate the calls per sample */
+    for (;;) {
+        t0 = now_sec();
+        for (int i = 0; i < inner; i++) kernel->run(A, B, C, n, &ctx);
+        t = now_sec() - t0;
+        if (t >= TUNING_SAMPLE_SEC || inner >= (1 << 20)) break;
+        inner *= 2;
+    }
+    best = t / inner;
+
+    start = now_sec();
+    while (now_sec() - start < budget_sec) {
+        t0 = now_sec();
+        for (int i = 0; i < inner; i++) kernel->run(A, B, C, n, &ctx);
+        t = (now_sec() - t0) / inner;
+        if (t < best) best = t;
+    }
+
+    if (kernel->release) kernel->release(ctx.state);
+    matrix_mult_arena_release(opts->arena, mark);
+    return best;
+}
+
+/* Maximum candidates per parameter */
+#define MAX_CANDIDATES 16
+
+/**
+ * @brief One searched parameter: its field in kernel_opts and its candidates
+ */
+typedef struct axis {
+    const char* name;
+    size_t offset;              /* offsetof(kernel_opts, field) */
+    int values[MAX_CANDIDATES];
+    int count;
+} axis;
+
+/* Add the values of list that are <= limit (always at least the first) */
+static void add_candidates(axis* a, const int* list, int len, int limit) {
+    for (int i = 0; i < len && a->count < MAX_CANDIDATES; i++) {
+        if (list[i] <= limit || a->count == 0) a->values[a->count++] = list[i];
+    }
+}
+
+static int* field(kernel_opts* o, const axis* a) {
+    return (int*)((char*)o + a->offset);
+}
+
+int tuning_search(const kernel_entry* kernel, const float* A, const float* B, float* C, int n,
+                  const kernel_opts* base, int max_threads, double budget_ms, tuning_entry* out) {
+    static const int tiles[] = { 16, 24, 32, 48, 64, 96, 128, 192, 256 };
+    static const int cutoffs[] = { 64, 128, 256, 512, 1024 };
+    static const int mcs[] = { 24, 48, 72, 96, 144, 192, 288 };
+    static const int kcs[] = { 64, 128, 192, 256, 384, 512 };
+    static const int ncs[] = { 256, 512, 1024, 2048, 4096 };
+    const double budget = budget_ms > 0.0 ? budget_ms * 1e-3 : 0.0;
+    axis axes[6];
+    int naxes = 0, measured = 0;
+    kernel_opts cur = *base;
+    double best;
+
+    memset(axes, 0, sizeof(axes));
+    if (max_threads < 1) max_threads = 1;
+
+    /* Start from the defaults, spelled out so every candidate differs visibly */
+    if (cur.tile <= 0) cur.tile = MATRIX_MULT_DEFAULT_TILE;
+    if (cur.threads <= 0) cur.threads = (kernel->tunable & KERNEL_TUNE_THREADS) ? max_threads : 1;
+    if (cur.cutoff <= 0) cur.cutoff = MATRIX_MULT_STRASSEN_CUTOFF;
+    if (cur.mc <= 0) cur.mc = MATRIX_MULT_PACK_MC;
+    if (cur.kc <= 0) cur.kc = MATRIX_MULT_PACK_KC;
+    if (cur.nc <= 0) cur.nc = MATRIX_MULT_PACK_NC;
+
+    /* Threads first: the best tile depends on how the work is split */
+    if (kernel->tunable & KERNEL_TUNE_THREADS) {
+        axis* a = &axes[naxes++];
+        a->name = "threads";
+        a->offset = offsetof(kernel_opts, threads);
+        for (int p = 1; p < max_threads && a->count < MAX_CANDIDATES - 1; p *= 2) {
+            a->values[a->count++] = p;
+        }
+        a->values[a->count++] = max_threads;
+    }
+    if (kernel->tunable & KERNEL_TUNE_TILE) {
+        axis* a = &axes[naxes++];
+        a->name = "tile";
+        a->offset = offsetof(kernel_opts, tile);
+        add_candidates(a, tiles, (int)(sizeof(tiles) / sizeof(tiles[0])), n);
+    }
+    if (kernel->tunable & KERNEL_TUNE_CUTOFF) {
+        axis* a = &axes[naxes++];
+        a->name = "cutoff";
+        a->offset = offsetof(kernel_opts, cutoff);
+        add_candidates(a, cutoffs, (int)(sizeof(cutoffs) / sizeof(cutoffs[0])), n);
+    }
+    if (kernel->tunable & KERNEL_TUNE_BLOCKS) {
+        axis* a = &axes[naxes++];
+        a->name = "kc";
+        a->offset = offsetof(kernel_opts, kc);
+        add_candidates(a, kcs, (int)(sizeof(kcs) / sizeof(kcs[0])), n);
+        a = &axes[naxes++];
+        a->name = "mc";
+        a->offset = offsetof(kernel_opts, mc);
+        add_candidates(a, mcs, (int)(sizeof(mcs) / sizeof(mcs[0])), n);
+        a = &axes[naxes++];
+        a->name = "nc";
+        a->offset = offsetof(kernel_opts, nc);
+        add_candidates(a, ncs, (int)(sizeof(ncs) / sizeof(ncs[0])), n);
+    }
+
+    best = measure(kernel, A, B, C, n, &cur, budget);
+    measured++;
+
+    /* Coordinate descent, two sweeps */
+    for (int pass = 0; pass < 2; pass++) {
+        int improved = 0;
+        for (int ai = 0; ai < naxes; ai++) {
+            const axis* a = &axes[ai];
+            const int current = *field(&cur, a);
+            for (int ci = 0; ci < a->count; ci++) {
+                if (a->values[ci] == current) continue;
+                kernel_opts trial = cur;
+                *field(&trial, a) = a->values[ci];
+                double t = measure(kernel, A, B, C, n, &trial, budget);
+                measured++;
+                if (t < best) {
+                    best = t;
+                    cur = trial;
+                    improved = 1;
+                }
+            }
+        }
+        if (!improved) break;
+    }
+    if (best == HUGE_VAL) return -1;
+
+    memset(out, 0, sizeof(*out));
+    snprintf(out->kernel, sizeof(out->kernel), "%s", kernel->name);
+    out->size_class = tuning_size_class(n);
+    if (kernel->tunable & KERNEL_TUNE_TILE) out->tile = cur.tile;
+    if (kernel->tunable & KERNEL_TUNE_THREADS) out->threads = cur.threads;
+    if (kernel->tunable & KERNEL_TUNE_CUTOFF) out->cutoff = cur.cutoff;
+    if (kernel->tunable & KERNEL_TUNE_BLOCKS) {
+        out->mc = cur.mc;
+        out->kc = cur.kc;
+        out->nc = cur.nc;
+    }
+    out->time_ms = best * 1000.0;
+    out->gflops = 2.0 * (double)n * (double)n * (double)n / best * 1e-9;
+    return measured;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file tuning.h
+ * @brief Per-host autotuning of kernel parameters, cached in a tuning file
+ *
+ * The best tile edge, thread count, Strassen cutoff and packing block
+ * sizes depend on the caches and core count of the machine. tuning_search()
+ * measures a registered kernel over a small candidate grid for one size;
+ * the winners of all kernels and sizes live in a tuning table that is
+ * saved to a per-host file and loaded again at startup, so later runs get
+ * tuned parameters without repeating the search.
+ *
+ * Entries are kept per kernel and size class: the smallest power of two
+ * >= n, so one search at n = 1000 serves every n in 513..1024.
+ *
+ * File format: semicolon-separated text with a header line,
+ *   fingerprint;kernel;size_class;tile;threads;cutoff;mc;kc;nc;time_ms;gflops
+ * one row per kernel and size class; 0 in a parameter column means the
+ * kernel's default. Rows whose fingerprint differs from the loading host's
+ * are ignored, so one file can be shared but never applies another
+ * machine's winners. The default path is tuning_<fingerprint>.csv.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "kernel_registry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of (kernel, size class) entries in one table */
+#define TUNING_MAX_ENTRIES 256
+
+/** tuning_apply() mask bits: parameters fixed on the command line, not to be overridden */
+#define TUNING_KEEP_TILE    0x1
+#define TUNING_KEEP_THREADS 0x2
+#define TUNING_KEEP_CUTOFF  0x4
+#define TUNING_KEEP_BLOCKS  0x8
+
+/**
+ * @brief Tuned parameters of one kernel for one size class
+ */
+typedef struct tuning_entry {
+    char kernel[32];        /**< Kernel name from the registry */
+    int size_class;         /**< Power of two covering the tuned sizes */
+    int tile;               /**< 0 where the kernel has no tile */
+    int threads;            /**< 0 for serial kernels */
+    int cutoff;             /**< 0 unless the kernel recurses */
+    int mc, kc, nc;         /**< 0 unless the kernel packs */
+    double time_ms;         /**< Time per call of the winner at the tuned size */
+    double gflops;          /**< Its throughput */
+} tuning_entry;
+
+/**
+ * @brief All tuned entries of one host
+ */
+typedef struct tuning_table {
+    char fingerprint[17];   /**< Host the entries belong to (machine_fingerprint::hash) */
+    int count;
+    tuning_entry entries[TUNING_MAX_ENTRIES];
+} tuning_table;
+
+/**
+ * @brief Size class of n: the smallest power of two >= n
+ */
+int tuning_size_class(int n);
+
+/**
+ * @brief Default tuning file name for a host
+ * @param fingerprint Host hash (machine_fingerprint::hash)
+ * @param buf Receives "tuning_<fingerprint>.csv"
+ * @param len Capacity of buf
+ */
+void tuning_default_path(const char* fingerprint, char* buf, size_t len);
+
+/**
+ * @brief Start an empty table for a host
+ */
+void tuning_init(tuning_table* t, const char* fingerprint);
+
+/**
+ * @brief Add the entries of a tuning file that belong to the table's host
+ * @param t Table from tuning_init()
+ * @param path Tuning file
+ * @return Number of entries loaded, or -1 if the file cannot be read or
+ *         has an unexpected header
+ */
+int tuning_load(tuning_table* t, const char* path);
+
+/**
+ * @brief Write the table to a tuning file, replacing it
+ *
+ * Rows of other hosts already in the file are kept, so hosts sharing a
+ * directory can share one file.
+ *
+ * @return 0 on success, -1 if the file cannot be written
+ */
+int tuning_save(const tuning_table* t, const char* path);
+
+/**
+ * @brief Entry for a kernel at size n
+ * @return The entry of n's size class, else the nearest size class tuned
+ *         for that kernel, or NULL if the kernel was never tuned
+ */
+const tuning_entry* tuning_lookup(const tuning_table* t, const char* kernel, int n);
+
+/**
+ * @brief Insert or replace the entry for (e->kernel, e->size_class)
+ * @return 0 on success, -1 if the table is full
+ */
+int tuning_set(tuning_table* t, const tuning_entry* e);
+
+/**
+ * @brief Copy a kernel's tuned parameters for size n into its options
+ * @param t Table to look up (NULL applies nothing)
+ * @param kernel Kernel about to run
+ * @param n Matrix size
+ * @param opts Options to update; only the kernel's tunable fields change
+ * @param keep TUNING_KEEP_* bits of fields the caller set explicitly
+ * @return The entry applied, or NULL if there is none
+ */
+const tuning_entry* tuning_apply(const tuning_table* t, const kernel_entry* kernel, int n,
+                                 kernel_opts* opts, int keep);
+
+/**
+ * @brief Search the kernel's tunable parameters for n×n operands
+ * @param kernel Kernel with a non-zero tunable mask
+ * @param A Pointer to first input matrix (n×n, row-major)
+ * @param B Pointer to second input matrix (n×n, row-major)
+ * @param C Output matrix (n×n, overwritten by every candidate)
+ * @param n Matrix size
+ * @param base Starting options (arena, batch, ...) and the first candidate
+ * @param max_threads Largest thread count to try
+ * @param budget_ms Measuring time per candidate (repeated calls, best-of)
+ * @param out Receives the winner for n's size class
+ * @return Number of candidates measured, or -1 if no candidate could be set up
+ *
+ * Coordinate descent: each parameter in turn sweeps its candidate list with
+ * the others fixed at their best so far, and the sweep repeats once more
+ * from the improved point. Candidates are a few powers of two and their
+ * midpoints that fit n. Scratch comes from base->arena and is rewound
+ * after each candidate.
+ */
+int tuning_search(const kernel_entry* kernel, const float* A, const float* B, float* C, int n,
+                  const kernel_opts* base, int max_threads, double budget_ms, tuning_entry* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,198 @@
+/**
+ * @file verify.c
+ * @brief Full and Freivalds implementations of verify.h
+ *
+ * All sums are in fp64, so the reference's own rounding (about k * 2^-53
+ * relative) is negligible against the fp32 tolerances.
+ *
+ * Build with OpenMP enabled (gcc/clang -fopenmp, MSVC /openmp); without it
+ * the Freivalds products run on the calling thread.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include "verify.h"
+#include "rng.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Unit roundoff of each input type (int8: half a step of a full-scale [0, 1) operand) */
+#define VERIFY_U_FP32 (FLT_EPSILON / 2.0)
+#define VERIFY_U_FP16 (1.0 / 2048.0)
+#define VERIFY_U_BF16 (1.0 / 256.0)
+#define VERIFY_U_INT8 (1.0 / 254.0)
+
+/* Safety factor on the first-order bounds */
+#define VERIFY_SLACK 2.0
+
+/* Extra growth allowed to the fp32 inexact kernels' (Strassen's) error */
+#define VERIFY_INEXACT_GROWTH 16.0
+
+/**
+ * @brief Allocate doubles from the arena, zeroed
+ */
+static double* alloc_doubles(matrix_mult_arena* arena, size_t count) {
+    double* p = (double*)matrix_mult_arena_alloc(arena, count * sizeof(double));
+    if (p) memset(p, 0, count * sizeof(double));
+    return p;
+}
+
+/**
+ * @brief A·B and |A||B| in fp64, i-k-j order
+ */
+static void full_reference(verify_ref* v, const float* A, const float* B) {
+    const size_t m = v->m, n = v->n, k = v->k;
+    for (size_t i = 0; i < m; i++) {
+        double* r = v->ref + i * n;
+        double* b = v->bound + i * n;
+        for (size_t p = 0; p < k; p++) {
+            const double a = A[i * k + p];
+            const double aa = fabs(a);
+            const float* brow = B + p * n;
+            for (size_t j = 0; j < n; j++) {
+                r[j] += a * brow[j];
+                b[j] += aa * fabs((double)brow[j]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief A(Bx) and |A|(|B|x) for the weights in v->x
+ * @param y Scratch of k doubles for Bx
+ * @param yb Scratch of k doubles for |B|x
+ */
+static void freivalds_reference(verify_ref* v, const float* A, const float* B,
+                                double* y, double* yb, int threads) {
+    const long long m = (long long)v->m, k = (long long)v->k;
+    const size_t n = v->n;
+    (void)threads;
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+    for (long long p = 0; p < k; p++) {
+        const float* brow = B + (size_t)p * n;
+        double s = 0.0, sb = 0.0;
+        for (size_t j = 0; j < n; j++) {
+            s += brow[j] * v->x[j];
+            sb += fabs((double)brow[j]) * v->x[j];
+        }
+        y[p] = s;
+        yb[p] = sb;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+    for (long long i = 0; i < m; i++) {
+        const float* arow = A + (size_t)i * (size_t)k;
+        double s = 0.0, sb = 0.0;
+        for (long long p = 0; p < k; p++) {
+            s += arow[p] * y[p];
+            sb += fabs((double)arow[p]) * yb[p];
+        }
+        v->ref[i] = s;
+        v->bound[i] = sb;
+    }
+}
+
+/**
+ * @brief |got - want| / bound, with 0/0 = 0 and NaN mapped to infinity
+ */
+static double rel_error(double got, double want, double bound) {
+    const double d = fabs(got - want);
+    if (d != d || d == HUGE_VAL) return HUGE_VAL;
+    if (d == 0.0) return 0.0;
+    return bound > 0.0 ? d / bound : HUGE_VAL;
+}
+
+int verify_prepare(verify_ref* v, const float* A, const float* B, size_t m, size_t n, size_t k,
+                   uint64_t seed, int full_max, matrix_mult_arena* arena, int threads) {
+    memset(v, 0, sizeof(*v));
+    v->m = m;
+    v->n = n;
+    v->k = k;
+    if (full_max <= 0) full_max = VERIFY_FULL_MAX;
+#ifdef _OPENMP
+    if (threads <= 0) threads = omp_get_max_threads();
+#endif
+
+    const double cube = (double)full_max * full_max * full_max;
+    if ((double)m * (double)n * (double)k <= cube) {
+        v->ref = alloc_doubles(arena, m * n);
+        v->bound = alloc_doubles(arena, m * n);
+        if (!v->ref || !v->bound) return VERIFY_NONE;
+        full_reference(v, A, B);
+        v->method = VERIFY_FULL;
+        return v->method;
+    }
+
+    /* Weights in [1, 2) from their own generator stream, independent of A and B */
+    v->x = alloc_doubles(arena, n);
+    v->ref = alloc_doubles(arena, m);
+    v->bound = alloc_doubles(arena, m);
+    double* y = alloc_doubles(arena, k);
+    double* yb = alloc_doubles(arena, k);
+    if (!v->x || !v->ref || !v->bound || !y || !yb) return VERIFY_NONE;
+    for (size_t j = 0; j < n; j++) v->x[j] = 1.0 + rng_element(seed, RNG_MATRIX_VERIFY, j);
+    freivalds_reference(v, A, B, y, yb, threads);
+    v->method = VERIFY_FREIVALDS;
+    return v->method;
+}
+
+double verify_error(const verify_ref* v, const float* C, int threads) {
+    double err = 0.0;
+    (void)threads;
+    if (v->method == VERIFY_NONE) return -1.0;
+
+    if (v->method == VERIFY_FULL) {
+        const size_t len = v->m * v->n;
+        for (size_t i = 0; i < len; i++) {
+            const double e = rel_error(C[i], v->ref[i], v->bound[i]);
+            if (e > err) err = e;
+        }
+        return err;
+    }
+
+    const long long m = (long long)v->m;
+    const size_t n = v->n;
+#ifdef _OPENMP
+    if (threads <= 0) threads = omp_get_max_threads();
+#pragma omp parallel for num_threads(threads) schedule(static) reduction(max:err)
+#endif
+    for (long long i = 0; i < m; i++) {
+        const float* crow = C + (size_t)i * n;
+        double w = 0.0;
+        for (size_t j = 0; j < n; j++) w += crow[j] * v->x[j];
+        const double e = rel_error(w, v->ref[i], v->bound[i]);
+        if (e > err) err = e;
+    }
+    return err;
+}
+
+double verify_tolerance(matrix_mult_dtype dtype, int inexact, size_t k) {
+    /* Accumulation in fp32 (any order) plus the rounding of both inputs to the kernel's type */
+    const double accumulate = (double)k * VERIFY_U_FP32;
+    double inputs = 0.0;
+    switch (dtype) {
+    case MATRIX_MULT_FP16: inputs = 2.0 * VERIFY_U_FP16; break;
+    case MATRIX_MULT_BF16: inputs = 2.0 * VERIFY_U_BF16; break;
+    case MATRIX_MULT_INT8: inputs = 2.0 * VERIFY_U_INT8; break;
+    default: break;
+    }
+    double tol = VERIFY_SLACK * (accumulate + inputs + VERIFY_U_FP32);
+    if (inexact && dtype == MATRIX_MULT_FP32) tol *= VERIFY_INEXACT_GROWTH;
+    return tol;
+}
+
+const char* verify_method_name(int method) {
+    switch (method) {
+    case VERIFY_FULL:      return "full";
+    case VERIFY_FREIVALDS: return "freivalds";
+    default:               return "none";
+    }
+}
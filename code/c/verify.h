@@ -0,0 +1,94 @@
+/**
+ * @file verify.h
+ * @brief Correctness check of every kernel's C: full comparison or Freivalds
+ *
+ * Both methods measure the componentwise relative error
+ *
+ *     err = max_i |C x - A B x|_i / (|A| |B| x)_i
+ *
+ * where x is every unit vector (full: each element (i, j) of C against an
+ * fp64 reference, scaled by (|A||B|)_ij) or one random vector with
+ * entries in [1, 2) (Freivalds). (|A||B|)_ij is the scale of the rounding
+ * error any summation order makes in element (i, j): an fp32 dot product
+ * of length k is within about k*u of it (u = 2^-24), so one tolerance per
+ * element type holds for every correct kernel and shape, with either
+ * method, and a wrong element, tile or edge shows up far above it.
+ *
+ * The full comparison costs two fp64 products of A and B, so it is used
+ * for shapes up to m*n*k = full_max^3 only (default VERIFY_FULL_MAX^3).
+ * Freivalds' check costs O(m*k + k*n) once per shape plus O(m*n) per
+ * result, so verification never costs more than the multiply it checks.
+ * Its random weights average each row of C, so it reliably flags errors
+ * that span a good part of a row (wrong tiles, edges, races) but can miss
+ * a single element that is off by less than about n times the tolerance.
+ *
+ * Build with OpenMP enabled for the row-parallel Freivalds products.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "matrix_mult.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest cube edge verified by the full comparison by default */
+#define VERIFY_FULL_MAX 256
+
+/** Verification methods */
+enum {
+    VERIFY_NONE,        /* Not prepared (no memory, or verification off) */
+    VERIFY_FULL,        /* Every element against an fp64 reference */
+    VERIFY_FREIVALDS    /* One random projection, O(n^2) */
+};
+
+/**
+ * @brief Reference data of one shape, shared by every kernel that runs it
+ */
+typedef struct verify_ref {
+    int method;         /**< VERIFY_* */
+    size_t m, n, k;     /**< Shape: A is m×k, B is k×n */
+    double* ref;        /**< Full: A·B (m×n); Freivalds: A(Bx) (m) */
+    double* bound;      /**< Full: |A||B| (m×n); Freivalds: |A|(|B|x) (m) */
+    double* x;          /**< Freivalds weights (n), NULL for the full method */
+} verify_ref;
+
+/**
+ * @brief Compute the reference of one shape from the arena
+ * @param v Receives the reference (method VERIFY_NONE if it does not fit)
+ * @param A m×k row-major operand
+ * @param B k×n row-major operand
+ * @param seed Seed of the Freivalds weights
+ * @param full_max Largest cube edge for the full comparison (<= 0: VERIFY_FULL_MAX)
+ * @param arena Arena the reference is carved from (released with the operands)
+ * @param threads OpenMP threads for the Freivalds products (<= 0 uses all)
+ * @return The method chosen
+ */
+int verify_prepare(verify_ref* v, const float* A, const float* B, size_t m, size_t n, size_t k,
+                   uint64_t seed, int full_max, matrix_mult_arena* arena, int threads);
+
+/**
+ * @brief Componentwise relative error of a result (see the file comment)
+ * @return Error (infinite if C contains NaN or Inf), or -1 if v was not prepared
+ */
+double verify_error(const verify_ref* v, const float* C, int threads);
+
+/**
+ * @brief Largest error a correct kernel of this element type may make
+ * @param dtype Element type the kernel computes in
+ * @param inexact Non-zero for kernels that trade accuracy for speed in fp32 (Strassen)
+ * @param k Inner dimension
+ */
+double verify_tolerance(matrix_mult_dtype dtype, int inexact, size_t k);
+
+/**
+ * @brief Name of a method for the console ("full", "freivalds" or "none")
+ */
+const char* verify_method_name(int method);
+
+#ifdef __cplusplus
+}
+#endif
@@ -2,11 +2,22 @@ package code.java;
 
 import java.io.*;
 import java.lang.management.ManagementFactory;
+import java.nio.ByteOrder;
+import java.nio.MappedByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.nio.file.StandardOpenOption;
+import java.util.ArrayList;
+import java.util.List;
 import java.time.LocalDateTime;
 import java.time.format.DateTimeFormatter;
 import java.util.Arrays;
 import java.util.Locale;
 import java.util.Random;
+import java.util.UUID;
 
 /**
  * Benchmark harness for the Java matrix multiplication implementation.
@@ -19,16 +30,150 @@ import java.util.Random;
  *   args[1]  runs per size (default: 3)
  *   args[2]  output CSV path (default: results_raw.csv)
  *   args[3]  random seed (default: 27)
+ *   --matrix-dir DIR  read A and B from the C benchmark's matrix files
+ *                     DIR/A_<n>x<n>_s<seed>.mat and DIR/B_<n>x<n>_s<seed>.mat
+ *                     (see code/c/matrix_file.h) instead of generating them
  *
  * Example:
  *   java Benchmark "64,128,256" 5 output.csv 42
+ *   java Benchmark "64,128,256" 5 output.csv 27 --matrix-dir /data/mats
  *
  * CSV schema (semicolon-separated):
- *   run_id;language;size;run_idx;time_ms;cpu_pct;peak_mib
+ *   run_id;language;size;run_idx;time_ms;cpu_pct;peak_mib;kernel;pack_ms;compute_ms;threads;
+ *   imbalance;steals;m;n;k;max_err;
+ *   cycles;instructions;l1d_misses;llc_misses;dtlb_misses;fp_ops;reps;
+ *   gflops;intensity;pct_peak;peak_gflops;bandwidth_gbs;
+ *   fingerprint;cpu_model;cores;governor;compiler;cflags;os_kernel;run_uuid;
+ *   comm_ms;ranks;rank;dtype;err_fp64;batch;h2d_ms;d2h_ms;placement;bind;remote_pct;
+ *   bytes_read;bytes_written;verified;verify_err;density;queue;lat_p50_ms;lat_p99_ms
+ *
+ * The columns between kernel and fingerprint are only measured by the C harness
+ * and are left empty. The fingerprint columns describe this host and JVM. Runs
+ * are single-process: comm_ms is empty, ranks is 1 and rank is 0. The kernel
+ * computes in double precision, so dtype is fp64; err_fp64 is not measured. Every call multiplies one matrix,
+ * so batch is 1, and nothing is offloaded, so h2d_ms and d2h_ms are empty.
+ * The JVM places and schedules its own memory and threads: placement is serial,
+ * bind is none and remote_pct is empty. Nothing is streamed out of core, so
+ * bytes_read and bytes_written are empty. Results are not verified (the
+ * C harness's verify.c), so verified and verify_err are empty too. The
+ * operands are dense, so density is 1. Every call is a single request, so
+ * queue is 1 and the latency percentiles are empty.
+ *
+ * With --matrix-dir every size multiplies the exact fp32 inputs the C harness
+ * generated for the seed (widened to double), so the three languages can be
+ * compared on identical operands; the files must exist (run the C benchmark
+ * with --matrix-dir first).
  */
 public class Benchmark {
-    /** CSV header written once when creating the file. */
-    static final String HEADER = "run_id;language;size;run_idx;time_ms;cpu_pct;peak_mib\n";
+    /** CSV header written once when creating the file (keep in sync with the C and Python harnesses). */
+    static final String HEADER = "run_id;language;size;run_idx;time_ms;cpu_pct;peak_mib;kernel;"
+            + "pack_ms;compute_ms;threads;imbalance;steals;m;n;k;max_err;"
+            + "cycles;instructions;l1d_misses;llc_misses;dtlb_misses;fp_ops;reps;"
+            + "gflops;intensity;pct_peak;peak_gflops;bandwidth_gbs;"
+            + "fingerprint;cpu_model;cores;governor;compiler;cflags;os_kernel;run_uuid;"
+            + "comm_ms;ranks;rank;dtype;err_fp64;batch;h2d_ms;d2h_ms;placement;bind;remote_pct;"
+            + "bytes_read;bytes_written;verified;verify_err;density;queue;lat_p50_ms;lat_p99_ms\n";
+
+    /** Name written to the kernel column; this harness only has the baseline kernel. */
+    static final String KERNEL = "naive";
+
+    /** Empty fields for the C-only columns between the kernel and fingerprint columns. */
+    static final String PAD = ";".repeat(
+            (int) HEADER.substring(0, HEADER.indexOf("fingerprint")).chars().filter(c -> c == ';').count() - 8);
+
+    /**
+     * Fields after run_uuid: no communication time, one rank (rank 0), double elements, batch of one,
+     * no transfers, serial placement without pinning, no out-of-core traffic, no verification,
+     * dense operands.
+     */
+    static final String TAIL = ";;1;0;fp64;;1;;;serial;none;;;;;;1;1;;";
+
+    /** Magic at the start of a matrix file (code/c/matrix_file.h). */
+    static final byte[] MATRIX_MAGIC = "MMATRIX1".getBytes(StandardCharsets.US_ASCII);
+
+    /** Bytes before element 0 of a matrix file. */
+    static final int MATRIX_HEADER_BYTES = 64;
+
+    /** Largest element region mapped at once; a MappedByteBuffer is limited to 2 GiB. */
+    static final long MATRIX_MAP_BYTES = 1L << 30;
+
+    /** FNV-1a 64-bit offset basis of the fingerprint hash (same as code/c/fingerprint.c). */
+    static final long FNV_OFFSET = 0xcbf29ce484222325L;
+
+    /** FNV-1a 64-bit prime. */
+    static final long FNV_PRIME = 0x100000001b3L;
+
+    /**
+     * Reads the first line of a small text file.
+     *
+     * @param path file path
+     * @return trimmed first line, or "" if the file is unavailable
+     */
+    static String firstLine(String path) {
+        try (BufferedReader br = Files.newBufferedReader(Paths.get(path), StandardCharsets.UTF_8)) {
+            String line = br.readLine();
+            return line == null ? "" : line.trim();
+        } catch (IOException | SecurityException e) {
+            return "";
+        }
+    }
+
+    /**
+     * Returns the CPU model from /proc/cpuinfo, PROCESSOR_IDENTIFIER or os.arch.
+     *
+     * @return CPU model name
+     */
+    static String cpuModel() {
+        try (BufferedReader br = Files.newBufferedReader(Paths.get("/proc/cpuinfo"), StandardCharsets.UTF_8)) {
+            String line;
+            while ((line = br.readLine()) != null) {
+                int colon = line.indexOf(':');
+                if (colon < 0) continue;
+                String key = line.substring(0, colon).trim();
+                String value = line.substring(colon + 1).trim();
+                if (!value.isEmpty() && (key.equals("model name") || key.equals("Model")
+                        || key.equals("Hardware") || key.equals("cpu"))) {
+                    return value;
+                }
+            }
+        } catch (IOException | SecurityException e) {
+            // Not Linux: fall through
+        }
+        String id = System.getenv("PROCESSOR_IDENTIFIER");
+        return id != null && !id.isEmpty() ? id : System.getProperty("os.arch", "unknown");
+    }
+
+    /**
+     * Builds the fingerprint columns of this host and JVM.
+     *
+     * Mirrors code/c/fingerprint.c: the hash is FNV-1a 64 over
+     * "cpu_model;cores;governor;compiler;cflags;os_kernel" as written to the CSV.
+     * The compiler column holds the JVM name and version, cflags the JVM arguments.
+     *
+     * @param ncpu logical processors available to the JVM
+     * @return semicolon-joined fingerprint, cpu_model, cores, governor, compiler,
+     *         cflags, os_kernel and run_uuid fields
+     */
+    static String machineFingerprint(int ncpu) {
+        String[] fields = {
+            cpuModel(),
+            Integer.toString(ncpu),
+            firstLine("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor"),
+            System.getProperty("java.vm.name") + " " + System.getProperty("java.version"),
+            String.join(" ", ManagementFactory.getRuntimeMXBean().getInputArguments()),
+            System.getProperty("os.name") + " " + System.getProperty("os.version"),
+        };
+        for (int i = 0; i < fields.length; i++) {
+            fields[i] = fields[i].replace(';', ',').replace('\n', ' ');
+        }
+
+        String joined = String.join(";", fields);
+        long h = FNV_OFFSET;
+        for (byte b : joined.getBytes(StandardCharsets.UTF_8)) {
+            h = (h ^ (b & 0xff)) * FNV_PRIME;
+        }
+        return String.format("%016x", h) + ";" + joined + ";" + UUID.randomUUID();
+    }
 
     /**
      * Generates an n×n matrix with entries in [0,1).
@@ -47,6 +192,56 @@ public class Benchmark {
         return M;
     }
 
+    /**
+     * Reads an n×n fp32 matrix file written by the C benchmark.
+     *
+     * The header and elements are in the writer's byte order; the byte-order
+     * mark tells whether that is this host's native order. Elements are
+     * mapped a band of rows at a time (at most MATRIX_MAP_BYTES), so files
+     * beyond the 2 GiB limit of one mapping are read as well.
+     *
+     * @param path matrix file
+     * @param n    expected dimension
+     * @return n×n matrix of doubles (exact widening of the stored floats)
+     * @throws IOException if the file is missing, of another shape or not a matrix file
+     */
+    static double[][] readMatrixFile(Path path, int n) throws IOException {
+        try (FileChannel ch = FileChannel.open(path, StandardOpenOption.READ)) {
+            if (ch.size() < MATRIX_HEADER_BYTES) throw new IOException(path + ": not a matrix file");
+            MappedByteBuffer buf = ch.map(FileChannel.MapMode.READ_ONLY, 0, MATRIX_HEADER_BYTES);
+            buf.order(ByteOrder.nativeOrder());
+            byte[] magic = new byte[MATRIX_MAGIC.length];
+            buf.get(magic);
+            if (!Arrays.equals(magic, MATRIX_MAGIC) || buf.getInt(8) != 0x01020304 || buf.getInt(12) != 0
+                    || buf.getLong(32) != MATRIX_HEADER_BYTES) {
+                throw new IOException(path + ": not an fp32 matrix file in this host's byte order");
+            }
+            if (buf.getLong(16) != n || buf.getLong(24) != n
+                    || ch.size() < MATRIX_HEADER_BYTES + 4L * n * n) {
+                throw new IOException(path + ": shape is not " + n + "x" + n);
+            }
+            final long rowBytes = 4L * n;
+            if (rowBytes > MATRIX_MAP_BYTES) {
+                throw new IOException(path + ": rows of " + n + " elements exceed one mapping");
+            }
+            final int bandRows = (int) Math.min(n, MATRIX_MAP_BYTES / rowBytes);
+            double[][] M = new double[n][n];
+            for (int i0 = 0; i0 < n; i0 += bandRows) {
+                int rows = Math.min(bandRows, n - i0);
+                MappedByteBuffer band = ch.map(FileChannel.MapMode.READ_ONLY,
+                        MATRIX_HEADER_BYTES + i0 * rowBytes, rows * rowBytes);
+                band.order(ByteOrder.nativeOrder());
+                for (int i = 0; i < rows; i++) {
+                    int row = (int) (i * rowBytes);
+                    for (int j = 0; j < n; j++) {
+                        M[i0 + i][j] = band.getFloat(row + 4 * j);
+                    }
+                }
+            }
+            return M;
+        }
+    }
+
     /**
      * Ensures the CSV header exists for the given path.
      *
@@ -120,6 +315,15 @@ public class Benchmark {
     public static void main(String[] args) throws Exception {
         Locale.setDefault(Locale.US);
 
+        /* --matrix-dir may appear anywhere; the rest are positional */
+        String matrixDir = null;
+        List<String> pos = new ArrayList<>();
+        for (int i = 0; i < args.length; i++) {
+            if (args[i].equals("--matrix-dir") && i + 1 < args.length) matrixDir = args[++i];
+            else pos.add(args[i]);
+        }
+        args = pos.toArray(new String[0]);
+
         if (!checkCorrectness()) {
             throw new RuntimeException("Verification failed");
         }
@@ -140,11 +344,18 @@ public class Benchmark {
         var osBean = (com.sun.management.OperatingSystemMXBean)
                 ManagementFactory.getOperatingSystemMXBean();
         int ncpu = osBean.getAvailableProcessors();
+        String fingerprint = machineFingerprint(ncpu);
         Random rnd = new Random(seed);
 
         for (int n : sizes) {
-            double[][] A = gen(n, rnd);
-            double[][] B = gen(n, rnd);
+            double[][] A, B;
+            if (matrixDir != null) {
+                A = readMatrixFile(Paths.get(matrixDir, "A_" + n + "x" + n + "_s" + seed + ".mat"), n);
+                B = readMatrixFile(Paths.get(matrixDir, "B_" + n + "x" + n + "_s" + seed + ".mat"), n);
+            } else {
+                A = gen(n, rnd);
+                B = gen(n, rnd);
+            }
 
             for (int r = 1; r <= runs; r++) {
                 System.gc();
@@ -168,8 +379,8 @@ public class Benchmark {
 
                 try (FileWriter fw = new FileWriter(out, true)) {
                     fw.write(String.format(Locale.US,
-                            "%s;%s;%d;%d;%.3f;%.1f;%.2f%n",
-                            runId, language, n, r, timeMs, cpu, peakMiB));
+                            "%s;%s;%d;%d;%.3f;%.1f;%.2f;%s%s;%s%s%n",
+                            runId, language, n, r, timeMs, cpu, peakMiB, KERNEL, PAD, fingerprint, TAIL));
                 }
             }
         }
@@ -11,14 +11,21 @@ Command-line arguments:
     --out: Output CSV file path (default: "results_raw.csv")
     --seed: Random seed (default: 27)
     --check_n: Matrix size for correctness check (default: 5)
+    --matrix-dir: Read A and B from the C benchmark's matrix files
+                  DIR/A_<n>x<n>_s<seed>.mat and DIR/B_<n>x<n>_s<seed>.mat
+                  (see code/c/matrix_file.h) instead of generating them
 
 Example:
     python benchmark.py --sizes 64 128 256 --runs 5 --out output.csv --seed 42
+    python benchmark.py --sizes 256 512 --matrix-dir /data/mats --seed 27
 """
 
 import argparse
 import os
+import platform
+import struct
 import time
+import uuid
 from typing import Tuple
 
 import numpy as np
@@ -26,8 +33,126 @@ import psutil
 
 from matrix_mult import matrixMultiplication
 
-# CSV header format
-HEADER = "run_id;language;size;run_idx;time_ms;cpu_pct;peak_mib\n"
+# CSV header format (keep in sync with the C and Java harnesses)
+HEADER = ("run_id;language;size;run_idx;time_ms;cpu_pct;peak_mib;kernel;"
+          "pack_ms;compute_ms;threads;imbalance;steals;m;n;k;max_err;"
+          "cycles;instructions;l1d_misses;llc_misses;dtlb_misses;fp_ops;reps;"
+          "gflops;intensity;pct_peak;peak_gflops;bandwidth_gbs;"
+          "fingerprint;cpu_model;cores;governor;compiler;cflags;os_kernel;run_uuid;"
+          "comm_ms;ranks;rank;dtype;err_fp64;batch;h2d_ms;d2h_ms;placement;bind;remote_pct;"
+          "bytes_read;bytes_written;verified;verify_err;density;queue;lat_p50_ms;lat_p99_ms\n")
+
+# Name written to the kernel column; this harness only has the baseline kernel
+KERNEL = "naive"
+
+# Empty fields for the C-only columns between the kernel and fingerprint columns
+PAD = ";" * (HEADER[:HEADER.index("fingerprint")].count(";") - 8)
+
+# Fields after run_uuid: no communication time, one rank (rank 0), float32 operands, batch of one,
+# no device transfers, serial placement without pinning, no out-of-core traffic, no verification,
+# dense operands
+TAIL = ";;1;0;fp32;;1;;;serial;none;;;;;;1;1;;"
+
+# Matrix file header (code/c/matrix_file.h): magic, byte-order mark, dtype, rows, cols, offset
+MATRIX_HEADER = struct.Struct("=8sIIQQQ")
+MATRIX_MAGIC = b"MMATRIX1"
+MATRIX_HEADER_BYTES = 64
+
+# FNV-1a 64-bit parameters of the fingerprint hash (same as code/c/fingerprint.c)
+FNV_OFFSET = 0xcbf29ce484222325
+FNV_PRIME = 0x100000001b3
+
+
+def _first_line(path: str) -> str:
+    """
+    Read the first line of a small text file, or "" if it is unavailable.
+    """
+    try:
+        with open(path, encoding="utf-8") as f:
+            return f.readline().strip()
+    except OSError:
+        return ""
+
+
+def _cpu_model() -> str:
+    """
+    CPU model name from /proc/cpuinfo, falling back to platform.processor().
+    """
+    try:
+        with open("/proc/cpuinfo", encoding="utf-8") as f:
+            for line in f:
+                key, _, value = line.partition(":")
+                if key.strip() in ("model name", "Model", "Hardware", "cpu") and value.strip():
+                    return value.strip()
+    except OSError:
+        pass
+    return platform.processor() or "unknown"
+
+
+def machine_fingerprint() -> str:
+    """
+    Build the fingerprint columns of this host and interpreter.
+    
+    Mirrors code/c/fingerprint.c: the hash is FNV-1a 64 over
+    "cpu_model;cores;governor;compiler;cflags;os_kernel" as written to the
+    CSV. The compiler column holds the Python implementation and version,
+    and cflags is empty.
+    
+    Returns:
+        Semicolon-joined fingerprint, cpu_model, cores, governor, compiler,
+        cflags, os_kernel and run_uuid fields
+    """
+    cores = len(os.sched_getaffinity(0)) if hasattr(os, "sched_getaffinity") else (os.cpu_count() or 1)
+    if platform.system() == "Windows":
+        os_kernel = f"Windows {platform.version()}"
+    else:
+        os_kernel = f"{platform.system()} {platform.release()}"
+    fields = [
+        _cpu_model(),
+        str(cores),
+        _first_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor"),
+        f"{platform.python_implementation()} {platform.python_version()}",
+        "",
+        os_kernel,
+    ]
+    fields = [f.replace(";", ",").replace("\n", " ") for f in fields]
+    
+    h = FNV_OFFSET
+    for byte in ";".join(fields).encode("utf-8"):
+        h = ((h ^ byte) * FNV_PRIME) & 0xFFFFFFFFFFFFFFFF
+    return ";".join([f"{h:016x}"] + fields + [str(uuid.uuid4())])
+
+
+def load_matrix_file(path: str, n: int) -> np.ndarray:
+    """
+    Map an n×n fp32 matrix file written by the C benchmark, read-only.
+
+    The header and elements are in the writer's byte order; a byte-order
+    mark other than 0x01020304 in native order means another host wrote it.
+
+    Args:
+        path: Matrix file path
+        n: Expected dimension
+
+    Returns:
+        Read-only n×n float32 array backed by the file
+
+    Raises:
+        SystemExit: If the file is missing, of another shape or not a matrix file
+    """
+    try:
+        with open(path, "rb") as f:
+            head = f.read(MATRIX_HEADER_BYTES)
+    except OSError as e:
+        raise SystemExit(f"{path}: {e.strerror}; run the C benchmark with --matrix-dir first")
+    if len(head) < MATRIX_HEADER_BYTES:
+        raise SystemExit(f"{path}: not a matrix file")
+    magic, order, dtype, rows, cols, offset = MATRIX_HEADER.unpack_from(head)
+    if magic != MATRIX_MAGIC or order != 0x01020304 or dtype != 0 or offset != MATRIX_HEADER_BYTES:
+        raise SystemExit(f"{path}: not an fp32 matrix file in this host's byte order")
+    if (rows, cols) != (n, n):
+        raise SystemExit(f"{path}: shape is {rows}x{cols}, not {n}x{n}")
+    return np.memmap(path, dtype=np.float32, mode="r", offset=offset, shape=(n, n))
 
 
 def check_correctness(n: int, seed: int = 27, atol: float = 1e-8) -> bool:
@@ -124,6 +249,8 @@ def main() -> None:
                    help="Random seed for reproducibility")
     p.add_argument("--check_n", type=int, default=5,
                    help="Matrix size for correctness verification")
+    p.add_argument("--matrix-dir", type=str, default=None,
+                   help="Directory of the C benchmark's matrix files to read A and B from")
     args = p.parse_args()
 
     # Verify implementation correctness before benchmarking
@@ -136,15 +263,20 @@ def main() -> None:
     ncpu = psutil.cpu_count(logical=True) or 1
     language = "Python"
     run_id = time.strftime("%d/%m/%H/%M", time.localtime())
+    fingerprint = machine_fingerprint()
 
     # Prepare output file
     write_header_if_needed(args.out)
 
     # Main benchmarking loop: iterate over all matrix sizes
     for n in args.sizes:
-        # Generate random matrices for this size
-        A = rng.random((n, n), dtype=np.float32)
-        B = rng.random((n, n), dtype=np.float32)
+        # Generate random matrices for this size, or use the C harness's exact inputs
+        if args.matrix_dir:
+            A = load_matrix_file(os.path.join(args.matrix_dir, f"A_{n}x{n}_s{args.seed}.mat"), n)
+            B = load_matrix_file(os.path.join(args.matrix_dir, f"B_{n}x{n}_s{args.seed}.mat"), n)
+        else:
+            A = rng.random((n, n), dtype=np.float32)
+            B = rng.random((n, n), dtype=np.float32)
         
         # Perform multiple runs for statistical stability
         for r in range(1, args.runs + 1):
@@ -156,7 +288,7 @@ def main() -> None:
             
             # Append results to CSV file
             with open(args.out, "a", encoding="utf-8") as f:
-                f.write(f"{run_id};{language};{n};{r};{t_ms:.3f};{cpu_pct:.1f};{peak_mib:.2f}\n")
+                f.write(f"{run_id};{language};{n};{r};{t_ms:.3f};{cpu_pct:.1f};{peak_mib:.2f};{KERNEL}{PAD};{fingerprint}{TAIL}\n")
 
 
 if __name__ == "__main__":
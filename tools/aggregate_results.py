@@ -2,26 +2,215 @@
 Aggregate per-run benchmark results into summary statistics.
 
 This script reads raw benchmark results from a CSV file, computes summary
-statistics (mean, min, max) per language and matrix size, and writes the
-aggregated results to a new CSV file with Excel-friendly decimal formatting
-(comma as decimal separator).
+statistics (mean, min, max, and median, standard deviation and a 95%
+confidence interval after outlier rejection) per run, machine fingerprint,
+language, kernel, element type, thread count, batch size, queue depth,
+operand density, placement and pinning policy, MPI rank count and matrix
+shape, and writes the aggregated results to a new CSV file with
+Excel-friendly decimal formatting (comma as decimal separator).
 
 Input CSV format (semicolon-separated):
-    run_id;language;size;run_idx;time_ms;cpu_pct;peak_mib
+    run_id;language;size;run_idx;time_ms;cpu_pct;peak_mib;kernel;pack_ms;compute_ms;
+    threads;imbalance;steals;m;n;k;max_err;cycles;instructions;l1d_misses;llc_misses;
+    dtlb_misses;fp_ops;reps;gflops;intensity;pct_peak;peak_gflops;bandwidth_gbs;
+    fingerprint;cpu_model;cores;governor;compiler;cflags;os_kernel;run_uuid;comm_ms;
+    ranks;rank;dtype;err_fp64;batch;h2d_ms;d2h_ms;placement;bind;remote_pct;bytes_read;
+    bytes_written;verified;verify_err;density;queue;lat_p50_ms;lat_p99_ms
 
 Output CSV format (semicolon-separated):
-    run_id;language;size;runs;avg_time_ms;min_time_ms;max_time_ms;cpu_pct_avg;peak_mib
+    run_id;language;kernel;dtype;threads;batch;queue;density;placement;bind;ranks;size;
+    m;n;k;runs;avg_time_ms;min_time_ms;max_time_ms;outliers;median_time_ms;std_time_ms;
+    ci95_lo_ms;ci95_hi_ms;cpu_pct_avg;peak_mib;bytes_read_avg;bytes_written_avg;
+    pack_ms_avg;compute_ms_avg;comm_ms_avg;h2d_ms_avg;d2h_ms_avg;lat_p50_ms_avg;
+    lat_p99_ms_avg;remote_pct_avg;imbalance_avg;steals_avg;max_err;err_fp64;verified;
+    verify_err;cycles_avg;instructions_avg;l1d_misses_avg;llc_misses_avg;dtlb_misses_avg;
+    fp_ops_avg;reps_avg;gflops_avg;intensity;pct_peak_avg;peak_gflops;bandwidth_gbs;
+    fingerprint;cpu_model;cores;governor;compiler;cflags;os_kernel;run_uuid
+
+Outliers: within every group, a run whose time_ms lies more than
+--outlier-z (default 3.5) robust standard deviations from the group
+median is rejected; the robust deviation is the median absolute deviation
+scaled to a normal sigma (the mean absolute deviation when more than half
+the runs tie). Groups of fewer than 3 runs keep every run. outliers counts
+the rejected runs, and median_time_ms, std_time_ms (sample standard
+deviation) and ci95_lo_ms/ci95_hi_ms (Student-t interval of the mean)
+describe the runs that are left; avg_time_ms, min_time_ms and max_time_ms
+still cover every run. The interval is empty for groups with fewer than 2
+runs left. --outlier-z 0 keeps every run.
+
+Compare mode (--compare BASELINE CANDIDATE) reads two raw files instead
+and matches their groups by kernel configuration and shape (every
+grouping key except run_id, with runs of the same configuration in one
+file pooled). For every match it rejects outliers as above and tests the
+candidate's mean time_ms against the baseline's with Welch's t-test at 95%
+confidence; a change is reported as slower (or faster) when it is
+significant and the means differ by more than --threshold percent
+(default 5), so noise-level differences from many runs do not fail a
+gate. Every comparison is printed, --report writes them to a CSV, and the
+exit status is 1 when any group is slower, so a CI job can block a change
+that slows a kernel down. Groups present in only one file, or with fewer
+than 2 runs on either side, are listed but never fail. A note is printed
+when the two files come from different machine fingerprints.
+
+Rows are grouped by fingerprint (a hash of CPU model, cores, frequency
+governor, compiler, flags and OS kernel) and run_uuid (one per benchmark
+process) as well as run_id, so results from different machines or from
+processes started in the same minute are never averaged together. Rows
+written before these columns existed share an empty fingerprint and run_uuid.
+
+pack_ms and compute_ms are only reported by kernels that time their phases
+separately, and imbalance and steals only by the work-stealing kernel; the
+averages are left empty for all other kernels. max_err (the worst error
+against the naive kernel over all runs) is only present when the C harness
+computed a reference result. The hardware counter averages are only present
+for C runs made with --counters on a machine whose counters could be opened.
+time_ms is always the time of one kernel call; C runs made with --min-time-ms
+average it over reps calls (reps_avg), rows without reps count as 1 call.
+gflops and intensity are derived from time_ms and the shape for rows that
+lack them (Java, Python, older files); pct_peak, peak_gflops and
+bandwidth_gbs come from the C harness's startup roofline probes only.
+
+dtype is the element type a kernel computes in: fp32 for the C kernels
+except the mixed-precision ones (fp16, bf16, fp64, int8) and for the
+Python harness, fp64 for the Java harness. err_fp64 (the worst error
+against an fp64 reference over all runs) is present when the C harness
+computed that reference. Files without dtype get fp64 for Java rows and
+fp32 otherwise.
+
+batch is the number of matrices one call of a batched C kernel (batch,
+batch_ptr, batch_loop) multiplies; time_ms is per call and gflops counts
+every matrix of the batch. Rows without batch (other kernels, older files)
+count as a batch of 1.
+
+h2d_ms and d2h_ms are the host-to-device and device-to-host copy times of
+the GPU kernels (gpu, gpu_blas), whose compute_ms is the device kernel and
+time_ms the whole offloaded call; the averages are empty for other kernels.
+
+placement is how the C harness initialised the operands (serial: one
+thread, first-touch: every thread its own row band) and bind how it pinned
+the threads (none, compact, scatter); runs with different policies are
+summarised separately. remote_pct is the share of A and C pages found on
+another NUMA node than the pinned thread computing them, and is empty for
+unpinned runs. Rows without these columns count as serial and none.
+
+bytes_read and bytes_written are the operand bytes the out-of-core C kernel
+(ooc) streamed into its memory budget and the result bytes it wrote back
+per call; their averages sit next to peak_mib and are empty for every
+other kernel.
+
+verified is "pass" or "fail" from the C harness's correctness check of
+every result (verify.c) and verify_err its componentwise relative error;
+a group is "fail" if any of its runs failed, with the worst verify_err.
+Both are empty for rows that were not checked (Java, Python, MPI, older
+files).
+
+density is the fraction of A's elements the C harness left nonzero
+(--density); runs at different densities are summarised separately, so
+the sparse (csr) and dense kernels can be compared at each one. Rows
+without it are dense (1).
+
+queue is the number of requests one call of the C thread-pool kernel
+(pool) keeps in flight; time_ms is the whole queue, so gflops is the
+sustained throughput, and lat_p50_ms and lat_p99_ms are the median and
+99th percentile submit-to-completion latency of its requests. Runs at
+different queue depths are summarised separately; lat_p50_ms_avg and
+lat_p99_ms_avg average the percentiles over the runs and are empty for
+other kernels. Rows without queue (other kernels, older files) count as 1.
+
+The MPI harness (benchmark_mpi.c) writes one row per rank for every run.
+Those rows are first collapsed to one row per run: time_ms, compute_ms and
+comm_ms are the slowest rank's (the distributed multiply finishes with it),
+cpu_pct is the mean over ranks, peak_mib, max_err, err_fp64 and pct_peak the worst
+rank's, and gflops follows from the collapsed time. The host columns are
+rank 0's. comm_ms_avg is therefore the average over runs of the largest
+per-rank communication time. Rows without ranks (single-process harnesses,
+older files) count as 1 rank.
+
+Files written before the kernel column existed are accepted; their rows are
+treated as the "naive" baseline kernel. Rows without a thread count (older
+files, and the single-threaded Java and Python harnesses) count as 1 thread.
+Rows without an m/n/k shape are square runs with m = n = k = size; for
+rectangular shapes size is the equivalent cube size round(cbrt(m*n*k)).
+
+The input may also be a JSON-lines (.jsonl) or binary (.bin) file written by
+the C harness with --jsonl / --binary; they carry the same columns and are
+read without text parsing of every number (binary) or CSV quirks (JSON).
 
 Usage:
     python aggregate_results.py --inp results_raw.csv --out results_summary.csv
+    python aggregate_results.py --inp sweep.bin --out sweep_summary.csv
+    python aggregate_results.py --compare baseline_raw.csv results_raw.csv --report compare.csv
 """
 
 import argparse
+import math
+import struct
+import sys
+import numpy as np
 import pandas as pd
 
 # CSV delimiter used in input and output files
 SEP = ";"
 
+# Kernel name assumed for rows that predate the kernel column
+DEFAULT_KERNEL = "naive"
+
+# Thread count assumed for rows without one
+DEFAULT_THREADS = 1
+
+# Roofline columns written by the C harness
+ROOFLINE_COLS = ["gflops", "intensity", "pct_peak", "peak_gflops", "bandwidth_gbs"]
+
+# Bytes per matrix element (float32) for the compulsory-traffic intensity
+ELEM_BYTES = 4
+
+# Binary result file: magic, then order marker, ncols, record bytes, header bytes
+BINARY_MAGIC = b"MMBENCH1"
+BINARY_ORDER = 0x01020304
+
+# Binary string fields are fixed-width and NUL padded
+BINARY_STR_BYTES = 64
+
+# Columns stored as strings in the binary format
+BINARY_STR_COLS = {"run_id", "language", "kernel", "fingerprint", "cpu_model", "governor",
+                   "compiler", "cflags", "os_kernel", "run_uuid", "dtype", "placement", "bind",
+                   "verified"}
+
+# Host and build description columns; the first and last are grouping keys
+FINGERPRINT_COLS = ["fingerprint", "cpu_model", "cores", "governor", "compiler", "cflags",
+                    "os_kernel", "run_uuid"]
+
+# Summary grouping keys, in output order
+GROUP_KEYS = ["run_id", "language", "kernel", "dtype", "threads", "batch", "queue", "density",
+              "placement", "bind", "ranks", "size", "m", "n", "k"]
+
+# Hardware counter columns written by the C harness with --counters
+COUNTER_COLS = ["cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "fp_ops"]
+
+# Compare-mode matching keys: a configuration and shape, whichever run it came from
+COMPARE_KEYS = [c for c in GROUP_KEYS if c != "run_id"]
+
+# Default modified z-score beyond which a run is an outlier (Iglewicz and Hoaglin)
+OUTLIER_Z = 3.5
+
+# Groups smaller than this keep every run
+MIN_OUTLIER_RUNS = 3
+
+# Normal-consistency factors: sigma = MAD / 0.6745 = 1.2533 * mean absolute deviation
+MAD_SCALE = 0.6745
+MEAN_AD_SCALE = 1.253314
+
+# Default smallest slowdown, in percent of the baseline mean, that compare mode reports
+SLOWDOWN_PCT = 5.0
+
+# Two-sided 95% Student-t critical values by degrees of freedom; between
+# entries the next lower one is used, which errs towards "not significant"
+T95 = [(1, 12.706), (2, 4.303), (3, 3.182), (4, 2.776), (5, 2.571), (6, 2.447), (7, 2.365),
+       (8, 2.306), (9, 2.262), (10, 2.228), (11, 2.201), (12, 2.179), (13, 2.160), (14, 2.145),
+       (15, 2.131), (16, 2.120), (17, 2.110), (18, 2.101), (19, 2.093), (20, 2.086), (21, 2.080),
+       (22, 2.074), (23, 2.069), (24, 2.064), (25, 2.060), (26, 2.056), (27, 2.052), (28, 2.048),
+       (29, 2.045), (30, 2.042), (40, 2.021), (60, 2.000), (120, 1.980), (math.inf, 1.960)]
+
 
 def fmt(x: float, nd: int) -> str:
     """
@@ -46,34 +235,166 @@ def fmt(x: float, nd: int) -> str:
     return f"{float(x):.{nd}f}".replace(".", ",")
 
 
-def main():
+def fmt_optional(x: float, nd: int) -> str:
     """
-    Main entry point for the aggregation script.
+    Format an optional metric like fmt(), leaving missing values empty.
     
-    Parses command-line arguments, reads raw benchmark data, computes summary
-    statistics grouped by run_id, language, and size, and writes the results
-    to a CSV file with Excel-friendly formatting.
+    Args:
+        x: Number to format, or NaN if the metric was not measured
+        nd: Number of decimal places
+    
+    Returns:
+        Formatted string, or "" for NaN
     """
-    # Parse command-line arguments
-    ap = argparse.ArgumentParser(
-        description="Aggregate per-run results with Excel-friendly decimals."
-    )
-    ap.add_argument(
-        "--inp", 
-        type=str, 
-        default="results_raw.csv",
-        help="Input CSV file with raw benchmark results"
-    )
-    ap.add_argument(
-        "--out", 
-        type=str, 
-        default="results_summary.csv",
-        help="Output CSV file for aggregated summary statistics"
-    )
-    args = ap.parse_args()
+    return "" if pd.isna(x) else fmt(x, nd)
+
+
+def read_binary(path: str) -> pd.DataFrame:
+    """
+    Read a binary result file written by the C harness with --binary.
+    
+    The header lists the column names; string columns are char[64] and
+    every other column is a float64 with NaN for unmeasured values (see
+    code/c/result_sink.c for the layout).
+    
+    Args:
+        path: Path to the .bin file
+    
+    Returns:
+        DataFrame with the same columns as the CSV
+    """
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != BINARY_MAGIC:
+        raise ValueError(f"{path}: not a benchmark result file")
+    
+    # The order marker tells which byte order the writer used
+    endian = "<" if struct.unpack("<I", data[8:12])[0] == BINARY_ORDER else ">"
+    _, ncols, rec_bytes, hdr_bytes = struct.unpack(endian + "4I", data[8:24])
+    names = data[24:24 + hdr_bytes].decode("ascii").split(SEP)
+    if len(names) != ncols:
+        raise ValueError(f"{path}: header lists {len(names)} columns, expected {ncols}")
+    
+    dtype = np.dtype([(c, f"S{BINARY_STR_BYTES}") if c in BINARY_STR_COLS else (c, endian + "f8")
+                      for c in names])
+    if dtype.itemsize != rec_bytes:
+        raise ValueError(f"{path}: record size {rec_bytes} does not match its columns")
+    records = np.frombuffer(data, dtype=dtype, offset=24 + hdr_bytes)
+    
+    df = pd.DataFrame({c: records[c] for c in names})
+    for c in BINARY_STR_COLS & set(names):
+        df[c] = df[c].str.decode("utf-8").str.rstrip("\x00")
+    return df
+
+
+def collapse_ranks(df: pd.DataFrame) -> pd.DataFrame:
+    """
+    Reduce the per-rank rows of every multi-rank run to one row.
+    
+    Args:
+        df: Raw rows with numeric ranks, rank and shape columns
+    
+    Returns:
+        DataFrame with single-rank rows unchanged and one row per MPI run,
+        timed by its slowest rank
+    """
+    multi = df[df["ranks"] > 1]
+    if multi.empty:
+        return df
+    keys = GROUP_KEYS + ["run_uuid", "run_idx"]
+    how = {c: (c, "first") for c in df.columns if c not in keys}   # rank 0 after the sort
+    how.update(time_ms=("time_ms", "max"), compute_ms=("compute_ms", "max"),
+               comm_ms=("comm_ms", "max"), cpu_pct=("cpu_pct", "mean"),
+               peak_mib=("peak_mib", "max"), max_err=("max_err", "max"),
+               err_fp64=("err_fp64", "max"), verify_failed=("verify_failed", "max"),
+               verify_err=("verify_err", "max"), pct_peak=("pct_peak", "min"))
+    runs = multi.sort_values("rank").groupby(keys, as_index=False).agg(**how)
+    runs["gflops"] = float("nan")
+    return pd.concat([df[df["ranks"] <= 1], runs[df.columns]], ignore_index=True)
+
+
+def read_raw(path: str) -> pd.DataFrame:
+    """
+    Read raw results from a semicolon CSV, JSON-lines or binary file.
     
-    # Read raw benchmark data
-    df = pd.read_csv(args.inp, sep=SEP)
+    Args:
+        path: Input path; the format is chosen by extension (.jsonl, .bin,
+              anything else is CSV)
+    
+    Returns:
+        DataFrame with one row per timed run
+    """
+    if path.endswith(".jsonl"):
+        return pd.read_json(path, lines=True, dtype={"run_id": str}, convert_dates=False)
+    if path.endswith(".bin"):
+        return read_binary(path)
+    return pd.read_csv(path, sep=SEP)
+
+
+def t95(dof: float) -> float:
+    """
+    Two-sided 95% Student-t critical value.
+    
+    Args:
+        dof: Degrees of freedom (need not be an integer, as for Welch's test)
+    
+    Returns:
+        Critical value from T95 for the largest tabulated dof not above
+        dof, or NaN for dof < 1
+    """
+    crit = float("nan")
+    if not dof >= 1:   # Also catches NaN
+        return crit
+    for d, t in T95:
+        if d > dof:
+            break
+        crit = t
+    return crit
+
+
+def mark_outliers(df: pd.DataFrame, keys: list, z: float) -> pd.Series:
+    """
+    Flag runs whose time_ms is an outlier within their group.
+    
+    A run is an outlier when its modified z-score, the distance from the
+    group median over the normal-scaled median absolute deviation, exceeds
+    z. When more than half the runs tie, the MAD is 0 and the scaled mean
+    absolute deviation is used instead.
+    
+    Args:
+        df: Normalised raw rows (see load_runs())
+        keys: Columns identifying a group of repeated runs
+        z: Modified z-score threshold; 0 or less flags nothing
+    
+    Returns:
+        Boolean Series aligned with df, True for rejected runs
+    """
+    if z <= 0:
+        return pd.Series(False, index=df.index)
+    g = df.groupby(keys)["time_ms"]
+    dev = (df["time_ms"] - g.transform("median")).abs()
+    dg = dev.groupby([df[k] for k in keys])
+    mad, mean_ad = dg.transform("median"), dg.transform("mean")
+    scale = (mad / MAD_SCALE).where(mad > 0, mean_ad * MEAN_AD_SCALE)
+    score = (dev / scale).where(scale > 0, 0.0)
+    return (g.transform("count") >= MIN_OUTLIER_RUNS) & (score > z)
+
+
+def load_runs(path: str) -> pd.DataFrame:
+    """
+    Read a raw result file and normalise it to one row per timed run.
+    
+    Converts the numeric columns, fills the columns older files or other
+    harnesses lack with their defaults, collapses the per-rank rows of MPI
+    runs and derives gflops and intensity where they are missing.
+    
+    Args:
+        path: Raw result file (.csv, .jsonl or .bin)
+    
+    Returns:
+        DataFrame with every GROUP_KEYS column and verify_failed
+    """
+    df = read_raw(path)
     
     # Convert columns to appropriate numeric types
     # Integer columns: size and run index
@@ -84,8 +405,106 @@ def main():
     for col in ["time_ms", "cpu_pct", "peak_mib"]:
         df[col] = pd.to_numeric(df[col], errors="coerce")
     
-    # Group by run_id, language, and size to compute statistics
-    g = df.groupby(["run_id", "language", "size"], as_index=False)
+    # Optional kernel statistics (absent in older files, empty for most kernels)
+    for col in (["pack_ms", "compute_ms", "comm_ms", "h2d_ms", "d2h_ms", "remote_pct", "imbalance",
+                 "steals", "max_err", "err_fp64", "bytes_read", "bytes_written", "verify_err",
+                 "lat_p50_ms", "lat_p99_ms"]
+                + COUNTER_COLS + ROOFLINE_COLS):
+        df[col] = pd.to_numeric(df[col], errors="coerce") if col in df.columns else float("nan")
+    
+    # Verification outcome as a number so a group can take the worst: 1 = fail, 0 = pass
+    if "verified" in df.columns:
+        verified = df["verified"].astype(str)
+    else:
+        verified = pd.Series("", index=df.index)
+    df["verify_failed"] = verified.map({"fail": 1.0, "pass": 0.0})
+    
+    # Older files have no kernel column: every row is the baseline kernel
+    if "kernel" not in df.columns:
+        df["kernel"] = DEFAULT_KERNEL
+    df["kernel"] = df["kernel"].fillna(DEFAULT_KERNEL)
+    
+    # Missing thread counts mean a single-threaded run
+    if "threads" not in df.columns:
+        df["threads"] = DEFAULT_THREADS
+    df["threads"] = (pd.to_numeric(df["threads"], errors="coerce")
+                     .fillna(DEFAULT_THREADS).astype("Int64"))
+    
+    # Older files have no dtype: Java computes in double, C and Python in float
+    if "dtype" not in df.columns:
+        df["dtype"] = pd.NA
+    df["dtype"] = df["dtype"].fillna(df["language"].map({"Java": "fp64"})).fillna("fp32")
+    
+    # Older files were initialised by one thread without pinning
+    for col, default in [("placement", "serial"), ("bind", "none")]:
+        if col not in df.columns:
+            df[col] = default
+        df[col] = df[col].fillna(default).astype(str)
+    
+    # Missing rank counts mean a single-process run, missing batch one matrix per call
+    # and missing queue one request per call
+    for col, default in [("ranks", 1), ("rank", 0), ("batch", 1), ("queue", 1)]:
+        if col not in df.columns:
+            df[col] = default
+        df[col] = pd.to_numeric(df[col], errors="coerce").fillna(default).astype("Int64")
+    
+    # Older files only have dense operands
+    if "density" not in df.columns:
+        df["density"] = 1.0
+    df["density"] = pd.to_numeric(df["density"], errors="coerce").fillna(1.0)
+    
+    # Missing repetition counts mean one kernel call per timed run
+    if "reps" not in df.columns:
+        df["reps"] = 1
+    df["reps"] = pd.to_numeric(df["reps"], errors="coerce").fillna(1)
+    
+    # Missing shapes mean a square run of the given size
+    for col in ["m", "n", "k"]:
+        if col not in df.columns:
+            df[col] = pd.NA
+        df[col] = pd.to_numeric(df[col], errors="coerce").fillna(df["size"]).astype("Int64")
+    
+    # Older rows have no fingerprint; empty strings keep them in the groupby
+    for col in FINGERPRINT_COLS:
+        if col not in df.columns:
+            df[col] = ""
+        if col == "cores":
+            df[col] = pd.to_numeric(df[col], errors="coerce")
+        else:
+            df[col] = df[col].fillna("").astype(str)
+    
+    # One row per MPI run, timed by its slowest rank
+    df = collapse_ranks(df)
+    
+    # Throughput and arithmetic intensity follow from time and shape when absent
+    flops = 2.0 * df["m"].astype(float) * df["n"].astype(float) * df["k"].astype(float)
+    min_bytes = ELEM_BYTES * (df["m"].astype(float) * df["k"].astype(float)
+                              + df["k"].astype(float) * df["n"].astype(float)
+                              + df["m"].astype(float) * df["n"].astype(float))
+    df["gflops"] = df["gflops"].fillna(flops * df["batch"].astype(float) * df["queue"].astype(float)
+                                       / (df["time_ms"] * 1e6))
+    df["intensity"] = df["intensity"].fillna(flops / min_bytes)
+    
+    return df
+
+
+def summarise(df: pd.DataFrame, z: float) -> pd.DataFrame:
+    """
+    Compute the formatted summary of every group of repeated runs.
+    
+    Args:
+        df: Normalised raw rows (see load_runs())
+        z: Outlier threshold for mark_outliers()
+    
+    Returns:
+        Summary DataFrame with the output columns, formatted for Excel
+    """
+    # Statistics of the runs that survive outlier rejection; rejected runs become NaN
+    df = df.assign(outlier=mark_outliers(df, GROUP_KEYS + ["fingerprint", "run_uuid"], z))
+    df["time_kept"] = df["time_ms"].where(~df["outlier"])
+    
+    # Group by run, machine, language, kernel, threads, and shape to compute statistics
+    g = df.groupby(GROUP_KEYS + ["fingerprint", "run_uuid"], as_index=False)
     
     # Aggregate statistics for each group
     summary = g.agg(
@@ -93,17 +512,254 @@ def main():
         avg_time_ms=("time_ms", "mean"),      # Average execution time
         min_time_ms=("time_ms", "min"),       # Minimum execution time
         max_time_ms=("time_ms", "max"),       # Maximum execution time
+        outliers=("outlier", "sum"),          # Runs rejected as outliers
+        median_time_ms=("time_kept", "median"),  # Median time of the kept runs
+        std_time_ms=("time_kept", "std"),     # Sample standard deviation of the kept runs
+        kept_mean=("time_kept", "mean"),      # Mean and count of the kept runs, for the interval
+        kept_runs=("time_kept", "count"),
         cpu_pct_avg=("cpu_pct", "mean"),      # Average CPU usage
         peak_mib=("peak_mib", "max"),         # Peak memory consumption
-    ).sort_values(["language", "size", "run_id"])
+        bytes_read_avg=("bytes_read", "mean"),  # Average bytes streamed in (out-of-core)
+        bytes_written_avg=("bytes_written", "mean"),  # Average bytes streamed out (out-of-core)
+        pack_ms_avg=("pack_ms", "mean"),      # Average packing time (if reported)
+        compute_ms_avg=("compute_ms", "mean"),  # Average compute time (if reported)
+        comm_ms_avg=("comm_ms", "mean"),      # Average communication time (MPI runs)
+        h2d_ms_avg=("h2d_ms", "mean"),        # Average host-to-device copy time (GPU kernels)
+        d2h_ms_avg=("d2h_ms", "mean"),        # Average device-to-host copy time (GPU kernels)
+        lat_p50_ms_avg=("lat_p50_ms", "mean"),  # Average median request latency (pool kernel)
+        lat_p99_ms_avg=("lat_p99_ms", "mean"),  # Average 99th percentile latency (pool kernel)
+        remote_pct_avg=("remote_pct", "mean"),  # Average share of remote pages (pinned runs)
+        imbalance_avg=("imbalance", "mean"),  # Average max/mean busy time (if reported)
+        steals_avg=("steals", "mean"),        # Average steal count (if reported)
+        max_err=("max_err", "max"),           # Worst error vs naive (if measured)
+        err_fp64=("err_fp64", "max"),         # Worst error vs the fp64 reference (if measured)
+        verified=("verify_failed", "max"),    # Any failed verification (if checked)
+        verify_err=("verify_err", "max"),     # Worst verification error (if checked)
+        **{f"{c}_avg": (c, "mean") for c in COUNTER_COLS},  # Hardware counters (if measured)
+        reps_avg=("reps", "mean"),            # Average kernel calls per timed run
+        gflops_avg=("gflops", "mean"),        # Average throughput
+        intensity=("intensity", "first"),     # FLOPs per compulsory byte (per shape)
+        pct_peak_avg=("pct_peak", "mean"),    # Average percent of attainable peak (if measured)
+        peak_gflops=("peak_gflops", "max"),   # Machine FMA peak for this thread count (if measured)
+        bandwidth_gbs=("bandwidth_gbs", "max"),  # Machine triad bandwidth (if measured)
+        **{c: (c, "first") for c in FINGERPRINT_COLS[1:-1]},  # Same within a fingerprint
+    ).sort_values(COMPARE_KEYS + ["fingerprint", "run_id"])
+    
+    # Student-t interval of the kept runs' mean; one kept run gives none
+    kept = summary["kept_runs"]
+    half = kept.map(lambda n: t95(n - 1)) * summary["std_time_ms"] / np.sqrt(kept)
+    summary.insert(summary.columns.get_loc("std_time_ms") + 1, "ci95_lo_ms",
+                   summary["kept_mean"] - half)
+    summary.insert(summary.columns.get_loc("ci95_lo_ms") + 1, "ci95_hi_ms",
+                   summary["kept_mean"] + half)
+    summary = summary.drop(columns=["kept_mean", "kept_runs"])
+    
+    # Fingerprint columns go last, in raw-file order
+    summary = summary[[c for c in summary.columns if c not in FINGERPRINT_COLS] + FINGERPRINT_COLS]
     
     # Round and format numeric columns with comma decimal separator for Excel
     # This ensures compatibility with European Excel locale settings
+    summary["density"] = summary["density"].map(lambda v: fmt(v, 4))
     summary["avg_time_ms"] = summary["avg_time_ms"].round(3).map(lambda v: fmt(v, 3))
     summary["min_time_ms"] = summary["min_time_ms"].round(3).map(lambda v: fmt(v, 3))
     summary["max_time_ms"] = summary["max_time_ms"].round(3).map(lambda v: fmt(v, 3))
+    for c in ["median_time_ms", "std_time_ms", "ci95_lo_ms", "ci95_hi_ms"]:
+        summary[c] = summary[c].round(3).map(lambda v: fmt_optional(v, 3))
     summary["cpu_pct_avg"] = summary["cpu_pct_avg"].round(1).map(lambda v: fmt(v, 1))
     summary["peak_mib"] = summary["peak_mib"].round(2).map(lambda v: fmt(v, 2))
+    summary["bytes_read_avg"] = summary["bytes_read_avg"].map(lambda v: fmt_optional(v, 0))
+    summary["bytes_written_avg"] = summary["bytes_written_avg"].map(lambda v: fmt_optional(v, 0))
+    summary["pack_ms_avg"] = summary["pack_ms_avg"].round(3).map(lambda v: fmt_optional(v, 3))
+    summary["compute_ms_avg"] = summary["compute_ms_avg"].round(3).map(lambda v: fmt_optional(v, 3))
+    summary["comm_ms_avg"] = summary["comm_ms_avg"].round(3).map(lambda v: fmt_optional(v, 3))
+    summary["h2d_ms_avg"] = summary["h2d_ms_avg"].round(3).map(lambda v: fmt_optional(v, 3))
+    summary["d2h_ms_avg"] = summary["d2h_ms_avg"].round(3).map(lambda v: fmt_optional(v, 3))
+    summary["lat_p50_ms_avg"] = summary["lat_p50_ms_avg"].round(4).map(lambda v: fmt_optional(v, 4))
+    summary["lat_p99_ms_avg"] = summary["lat_p99_ms_avg"].round(4).map(lambda v: fmt_optional(v, 4))
+    summary["remote_pct_avg"] = summary["remote_pct_avg"].round(1).map(lambda v: fmt_optional(v, 1))
+    summary["imbalance_avg"] = summary["imbalance_avg"].round(3).map(lambda v: fmt_optional(v, 3))
+    summary["steals_avg"] = summary["steals_avg"].round(1).map(lambda v: fmt_optional(v, 1))
+    for c in ["max_err", "err_fp64", "verify_err"]:
+        summary[c] = summary[c].map(lambda v: "" if pd.isna(v) else f"{v:.3e}".replace(".", ","))
+    summary["verified"] = summary["verified"].map(
+        lambda v: "" if pd.isna(v) else ("fail" if v > 0 else "pass"))
+    for c in COUNTER_COLS:
+        summary[f"{c}_avg"] = summary[f"{c}_avg"].map(lambda v: fmt_optional(v, 0))
+    summary["reps_avg"] = summary["reps_avg"].round(1).map(lambda v: fmt(v, 1))
+    summary["gflops_avg"] = summary["gflops_avg"].round(3).map(lambda v: fmt_optional(v, 3))
+    summary["intensity"] = summary["intensity"].round(3).map(lambda v: fmt_optional(v, 3))
+    summary["pct_peak_avg"] = summary["pct_peak_avg"].round(1).map(lambda v: fmt_optional(v, 1))
+    summary["peak_gflops"] = summary["peak_gflops"].round(2).map(lambda v: fmt_optional(v, 2))
+    summary["bandwidth_gbs"] = summary["bandwidth_gbs"].round(2).map(lambda v: fmt_optional(v, 2))
+    summary["cores"] = summary["cores"].map(lambda v: fmt_optional(v, 0))
+    
+    return summary
+
+
+def group_stats(df: pd.DataFrame, z: float) -> pd.DataFrame:
+    """
+    Per-configuration time_ms statistics of one file for compare mode.
+    
+    Args:
+        df: Normalised raw rows (see load_runs())
+        z: Outlier threshold for mark_outliers()
+    
+    Returns:
+        DataFrame indexed by COMPARE_KEYS with runs, mean and std of the
+        kept runs
+    """
+    kept = df[~mark_outliers(df, COMPARE_KEYS, z)]
+    return kept.groupby(COMPARE_KEYS).agg(
+        runs=("time_ms", "count"),
+        mean=("time_ms", "mean"),
+        std=("time_ms", "std"),
+    )
+
+
+def compare_runs(base: pd.DataFrame, cand: pd.DataFrame, z: float,
+                 threshold: float) -> pd.DataFrame:
+    """
+    Test every configuration of the candidate against the baseline.
+    
+    Args:
+        base: Normalised baseline rows
+        cand: Normalised candidate rows
+        z: Outlier threshold for mark_outliers()
+        threshold: Smallest change of the mean, in percent, that counts
+    
+    Returns:
+        One row per configuration in either file: both sides' runs, mean
+        and std, delta_pct, Welch's t and degrees of freedom, and status
+        (slower, faster, same, n/a for too few runs, or missing)
+    """
+    res = group_stats(base, z).join(group_stats(cand, z), how="outer",
+                                    lsuffix="_base", rsuffix="_cand")
+    
+    vb = res["std_base"] ** 2 / res["runs_base"]
+    vc = res["std_cand"] ** 2 / res["runs_cand"]
+    se = np.sqrt(vb + vc)
+    diff = res["mean_cand"] - res["mean_base"]
+    res["delta_pct"] = 100.0 * diff / res["mean_base"]
+    
+    # Zero variance on both sides: any difference at all is significant
+    res["t"] = (diff / se).where(se > 0, np.sign(diff) * np.inf)
+    welch = (vb + vc) ** 2 / (vb ** 2 / (res["runs_base"] - 1) + vc ** 2 / (res["runs_cand"] - 1))
+    res["dof"] = welch.where(se > 0, res["runs_base"] + res["runs_cand"] - 2)
+    crit = res["dof"].map(t95)
+    
+    res["status"] = "same"
+    res.loc[(res["t"] > crit) & (res["delta_pct"] > threshold), "status"] = "slower"
+    res.loc[(res["t"] < -crit) & (res["delta_pct"] < -threshold), "status"] = "faster"
+    res.loc[(res["runs_base"] < 2) | (res["runs_cand"] < 2), "status"] = "n/a"
+    res.loc[res["runs_base"].isna() | res["runs_cand"].isna(), "status"] = "missing"
+    return res.reset_index()
+
+
+def compare_main(args) -> int:
+    """
+    Compare mode: print and optionally write the comparison, return the exit status.
+    
+    Args:
+        args: Parsed command-line arguments with compare, outlier_z,
+              threshold and report
+    
+    Returns:
+        1 if any configuration got significantly slower, else 0
+    """
+    base, cand = load_runs(args.compare[0]), load_runs(args.compare[1])
+    res = compare_runs(base, cand, args.outlier_z, args.threshold)
+    
+    if set(base["fingerprint"]) != set(cand["fingerprint"]):
+        print("note: baseline and candidate come from different machine fingerprints")
+    
+    for _, r in res.iterrows():
+        shape = f"{r['size']}" if r["m"] == r["n"] == r["k"] else f"{r['m']}x{r['n']}x{r['k']}"
+        what = (f"{r['language']} {r['kernel']} {r['dtype']} n={shape} threads={r['threads']}"
+                f" batch={r['batch']} queue={r['queue']} density={r['density']:g}"
+                f" {r['placement']}/{r['bind']} ranks={r['ranks']}")
+        if r["status"] == "missing":
+            side = "candidate" if pd.isna(r["runs_cand"]) else "baseline"
+            print(f"{'missing':8s}{what}: not in the {side}")
+            continue
+        print(f"{r['status']:8s}{what}: {r['mean_base']:.4f} -> {r['mean_cand']:.4f} ms"
+              f" ({r['delta_pct']:+.1f}%, t={r['t']:.2f},"
+              f" runs {r['runs_base']:.0f}/{r['runs_cand']:.0f})")
+    
+    counts = res["status"].value_counts()
+    statuses = ["slower", "faster", "same", "n/a", "missing"]
+    print(", ".join(f"{counts.get(s, 0)} {s}" for s in statuses))
+    
+    if args.report:
+        out = res.copy()
+        out["density"] = out["density"].map(lambda v: fmt(v, 4))
+        for c in ["runs_base", "runs_cand"]:
+            out[c] = out[c].map(lambda v: fmt_optional(v, 0))
+        for c in ["mean_base", "std_base", "mean_cand", "std_cand"]:
+            out[c] = out[c].round(4).map(lambda v: fmt_optional(v, 4))
+        for c in ["delta_pct", "t", "dof"]:
+            out[c] = out[c].map(lambda v: "" if pd.isna(v) or math.isinf(v) else fmt(v, 2))
+        out.to_csv(args.report, index=False, sep=SEP, encoding="utf-8-sig")
+        print(f"Comparison written to: {args.report}")
+    
+    return 1 if counts.get("slower", 0) > 0 else 0
+
+
+def main():
+    """
+    Main entry point for the aggregation script.
+    
+    Parses command-line arguments, reads raw benchmark data, computes summary
+    statistics grouped by run_id, language, kernel, dtype, threads, batch,
+    queue, density, placement, bind, ranks and shape, and writes the results
+    to a CSV file with Excel-friendly formatting. With --compare it compares
+    two raw files instead and exits with status 1 on a significant slowdown.
+    """
+    # Parse command-line arguments
+    ap = argparse.ArgumentParser(
+        description="Aggregate per-run results with Excel-friendly decimals."
+    )
+    ap.add_argument(
+        "--inp", 
+        type=str, 
+        default="results_raw.csv",
+        help="Input file with raw benchmark results (.csv, .jsonl or .bin)"
+    )
+    ap.add_argument(
+        "--out", 
+        type=str, 
+        default="results_summary.csv",
+        help="Output CSV file for aggregated summary statistics"
+    )
+    ap.add_argument(
+        "--outlier-z",
+        type=float,
+        default=OUTLIER_Z,
+        help="Modified z-score beyond which a run is rejected as an outlier (0 keeps every run)"
+    )
+    ap.add_argument(
+        "--compare",
+        nargs=2,
+        metavar=("BASELINE", "CANDIDATE"),
+        help="Compare two raw files instead of aggregating; exit 1 on a significant slowdown"
+    )
+    ap.add_argument(
+        "--threshold",
+        type=float,
+        default=SLOWDOWN_PCT,
+        help="Compare mode: smallest change of the mean time, in percent, to report"
+    )
+    ap.add_argument(
+        "--report",
+        type=str,
+        help="Compare mode: CSV file for the per-configuration comparison"
+    )
+    args = ap.parse_args()
+    
+    if args.compare:
+        sys.exit(compare_main(args))
+    
+    df = load_runs(args.inp)
+    summary = summarise(df, args.outlier_z)
     
     # Write summary to output CSV with UTF-8-BOM encoding for Excel compatibility
     summary.to_csv(args.out, index=False, sep=SEP, encoding="utf-8-sig")
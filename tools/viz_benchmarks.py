@@ -7,11 +7,24 @@ time, CPU usage, memory consumption, and computational throughput.
 
 Input Files
 -----------
-- results_summary.csv: Aggregated statistics per language and size
-  Columns: run_id;language;size;runs;avg_time_ms;min_time_ms;max_time_ms;cpu_pct_avg;peak_mib
+- results_summary.csv: Aggregated statistics per language, kernel and size
+  Columns: run_id;language;kernel;dtype;threads;batch;queue;density;placement;bind;ranks;size;m;n;k;runs;avg_time_ms;
+           min_time_ms;max_time_ms;outliers;median_time_ms;std_time_ms;ci95_lo_ms;ci95_hi_ms;cpu_pct_avg;peak_mib;bytes_read_avg;bytes_written_avg;pack_ms_avg;compute_ms_avg;comm_ms_avg;h2d_ms_avg;
+           d2h_ms_avg;lat_p50_ms_avg;lat_p99_ms_avg;remote_pct_avg;imbalance_avg;
+           steals_avg;max_err;err_fp64;verified;verify_err;cycles_avg;instructions_avg;l1d_misses_avg;llc_misses_avg;dtlb_misses_avg;fp_ops_avg;reps_avg;
+           gflops_avg;intensity;pct_peak_avg;peak_gflops;bandwidth_gbs;fingerprint;cpu_model;
+           cores;governor;compiler;cflags;os_kernel;run_uuid
 
 - results_raw.csv: Per-run raw measurements
-  Columns: run_id;language;size;run_idx;time_ms;cpu_pct;peak_mib
+  Columns: run_id;language;size;run_idx;time_ms;cpu_pct;peak_mib;kernel;pack_ms;compute_ms;threads;
+           imbalance;steals;m;n;k;max_err;cycles;instructions;l1d_misses;llc_misses;
+           dtlb_misses;fp_ops;reps;gflops;intensity;pct_peak;peak_gflops;bandwidth_gbs;
+           fingerprint;cpu_model;cores;governor;compiler;cflags;os_kernel;run_uuid;
+           comm_ms;ranks;rank;dtype;err_fp64;batch;h2d_ms;d2h_ms;placement;bind;remote_pct;
+           bytes_read;bytes_written;verified;verify_err;density;queue;lat_p50_ms;lat_p99_ms
+
+- results_steps.csv (optional): Per-step SUMMA times from benchmark_mpi --steps
+  Columns: run_id;run_uuid;kernel;size;ranks;rank;run_idx;step;comm_ms;compute_ms
 
 Output Files
 ------------
@@ -23,12 +36,52 @@ PNG figures saved to ./figs/ directory:
 - mem_vs_size.png: Peak memory consumption vs matrix size
 - boxplots_time_by_size.png: Per-run time distribution by size and language
 - efficiency_gflops.png: Computational throughput in GFLOP/s
+- kernels_gflops.png: GFLOP/s of every C kernel vs matrix size
+- thread_scaling.png: Strong-scaling speedup and parallel efficiency of the
+  multithreaded C kernels
+- accuracy_vs_speed.png: Time and max error vs the naive kernel for every C
+  kernel with a measured max_err (e.g. Strassen), to locate the crossover
+- counters_vs_size.png: IPC and L1D/LLC/dTLB misses per 1000 instructions vs
+  size for every C kernel run with --counters
+- roofline.png: GFLOP/s vs arithmetic intensity of every C kernel under the
+  measured FMA-peak and triad-bandwidth roofs
+- mpi_scaling.png: Strong-scaling speedup, weak-scaling GFLOP/s per rank and
+  communication share vs MPI rank count for the distributed (SUMMA) kernel
+- mixed_precision.png: GFLOP/s (GOP/s for int8) and max error vs an fp64
+  reference per element type (the fp16/bf16/fp64/int8 kernels next to the
+  fp32 kernels run in the same invocation)
+- gpu_offload.png: Offloaded time (with transfers) and device kernel time of
+  the GPU kernels against the fastest CPU kernel per size, with the size at
+  which offloading starts to pay, and the transfer share of the GPU time
+- batched_gflops.png: GFLOP/s of the batched small-matrix kernels vs batch
+  count, one panel per matrix size
+- numa_placement.png: GFLOP/s and remote operand pages vs size for every
+  operand placement (serial, first-touch) and thread pinning (none,
+  compact, scatter) a parallel C kernel was run with
+- ooc_traffic.png: Bytes the out-of-core kernel streamed per call relative
+  to the compulsory operand traffic, and its peak memory next to the
+  in-core C kernels', vs size
+- sparse_density.png: Time of the sparse (csr) and dense C kernels vs the
+  density of A, per size; where the csr curve crosses below a dense one is
+  the density at which sparse storage starts to pay
+- pool_stream.png: Median and 99th percentile request latency and sustained
+  GFLOP/s of the thread-pool kernel vs the number of requests in flight,
+  per size, next to the per-call time and GFLOP/s of the OpenMP kernel
+- verification.png: Componentwise relative error of every C kernel's
+  result (verify.c) vs size, with failed checks marked
+- summa_overlap.png: Exposed communication per SUMMA step and per rank for
+  blocking vs overlapped (non-blocking, double-buffered) broadcasts; drawn
+  only when results_steps.csv exists
 
 Notes
 -----
 - Handles semicolon-separated CSVs with comma decimal separators
 - Uses matplotlib for all visualizations (no seaborn dependency)
 - Language colors: Python=blue, Java=orange, C=purple
+- Cross-language charts use only the "naive" baseline kernel; optimised C
+  kernels are compared separately in kernels_gflops.png
+- Per-size kernel charts use batch = 1, queue = 1 rows only; larger batches
+  appear in batched_gflops.png, deeper queues in pool_stream.png
 """
 
 import os
@@ -42,6 +95,7 @@ import matplotlib.pyplot as plt
 # Input file paths
 SUMMARY_PATH = "results_summary.csv"
 RAW_PATH = "results_raw.csv"
+STEPS_PATH = "results_steps.csv"
 
 # Output directory for figures
 OUT_DIR = "figs"
@@ -56,6 +110,16 @@ COLORS = {
 # Consistent ordering of languages across all plots
 LANG_ORDER = ["Python", "Java", "C"]
 
+# Kernel implemented by every language; used for cross-language comparisons
+BASELINE_KERNEL = "naive"
+
+# Roofline columns in the summary (peak and bandwidth from the C harness only)
+ROOFLINE_COLS = ["gflops_avg", "intensity", "pct_peak_avg", "peak_gflops", "bandwidth_gbs"]
+
+# Hardware counter averages in the summary (C harness with --counters only)
+COUNTER_AVG_COLS = ["cycles_avg", "instructions_avg", "l1d_misses_avg",
+                    "llc_misses_avg", "dtlb_misses_avg", "fp_ops_avg"]
+
 # ==================== Utility Functions ====================
 
 
@@ -102,6 +166,62 @@ def _to_num(x):
         return np.nan
 
 
+def _with_kernel(df):
+    """
+    Ensure the DataFrame has kernel, threads, ranks and m/n/k shape columns.
+    
+    Files written before these columns existed contain only single-threaded,
+    single-process square runs of the baseline kernel, so missing values are
+    filled with BASELINE_KERNEL, 1 thread, 1 rank and m = n = k = size.
+    
+    Args:
+        df: DataFrame loaded from a results CSV
+    
+    Returns:
+        The same DataFrame with populated kernel, threads, ranks and shape columns
+    """
+    if "kernel" not in df.columns:
+        df["kernel"] = BASELINE_KERNEL
+    df["kernel"] = df["kernel"].fillna(BASELINE_KERNEL)
+    if "threads" not in df.columns:
+        df["threads"] = 1
+    df["threads"] = df["threads"].apply(_to_num).fillna(1).astype(int)
+    if "ranks" not in df.columns:
+        df["ranks"] = 1
+    df["ranks"] = df["ranks"].apply(_to_num).fillna(1).astype(int)
+    for col in ["m", "n", "k"]:
+        if col not in df.columns:
+            df[col] = np.nan
+        df[col] = df[col].apply(_to_num).fillna(df["size"].astype(float))
+    return df
+
+
+def square_only(df):
+    """
+    Select square (m = n = k) runs for plots with matrix size on the x axis.
+    
+    Args:
+        df: Summary or raw DataFrame with m, n and k columns
+    
+    Returns:
+        DataFrame without rectangular-shape rows
+    """
+    return df[(df["m"] == df["n"]) & (df["n"] == df["k"])]
+
+
+def baseline_only(df):
+    """
+    Select rows of the baseline kernel for cross-language comparisons.
+    
+    Args:
+        df: Summary or raw DataFrame with a kernel column
+    
+    Returns:
+        DataFrame restricted to BASELINE_KERNEL rows
+    """
+    return df[df["kernel"] == BASELINE_KERNEL]
+
+
 def load_summary(path=SUMMARY_PATH):
     """
     Load and sanitize the summary CSV file.
@@ -126,11 +246,30 @@ def load_summary(path=SUMMARY_PATH):
     for col in num_cols:
         df[col] = df[col].apply(_to_num)
     
+    # Optional columns (absent in older summaries)
+    df["max_err"] = df["max_err"].apply(_to_num) if "max_err" in df.columns else np.nan
+    for col in ["comm_ms_avg", "compute_ms_avg", "h2d_ms_avg", "d2h_ms_avg", "remote_pct_avg",
+                "bytes_read_avg", "bytes_written_avg", "verify_err", "lat_p50_ms_avg", "lat_p99_ms_avg"]:
+        df[col] = df[col].apply(_to_num) if col in df.columns else np.nan
+    df["err_fp64"] = df["err_fp64"].apply(_to_num) if "err_fp64" in df.columns else np.nan
+    if "dtype" not in df.columns:
+        df["dtype"] = "fp32"
+    df["verified"] = df["verified"].fillna("") if "verified" in df.columns else ""
+    df["batch"] = df["batch"].apply(_to_num).fillna(1).astype(int) if "batch" in df.columns else 1
+    df["density"] = df["density"].apply(_to_num).fillna(1.0) if "density" in df.columns else 1.0
+    df["queue"] = df["queue"].apply(_to_num).fillna(1).astype(int) if "queue" in df.columns else 1
+    for col, default in [("placement", "serial"), ("bind", "none")]:
+        df[col] = df[col].fillna(default) if col in df.columns else default
+    for col in COUNTER_AVG_COLS + ROOFLINE_COLS:
+        df[col] = df[col].apply(_to_num) if col in df.columns else np.nan
+    
+    df = _with_kernel(df)
+    
     # Filter to expected languages and create ordered categorical
     df = df[df["language"].isin(LANG_ORDER)].copy()
     df["language"] = pd.Categorical(df["language"], categories=LANG_ORDER, ordered=True)
     
-    return df.sort_values(["language", "size"])
+    return df.sort_values(["language", "kernel", "size"])
 
 
 def load_raw(path=RAW_PATH):
@@ -156,11 +295,34 @@ def load_raw(path=RAW_PATH):
     for col in ["time_ms", "cpu_pct", "peak_mib"]:
         df[col] = df[col].apply(_to_num)
     
+    df = _with_kernel(df)
+    
     # Filter to expected languages and create ordered categorical
     df = df[df["language"].isin(LANG_ORDER)].copy()
     df["language"] = pd.Categorical(df["language"], categories=LANG_ORDER, ordered=True)
     
-    return df.sort_values(["language", "size", "run_idx"])
+    return df.sort_values(["language", "kernel", "size", "run_idx"])
+
+
+def load_steps(path=STEPS_PATH):
+    """
+    Load the optional per-step SUMMA file written by benchmark_mpi --steps.
+    
+    Args:
+        path: Path to the semicolon-separated steps CSV
+    
+    Returns:
+        DataFrame with numeric size, ranks, rank, run_idx, step, comm_ms and
+        compute_ms columns, or None if the file does not exist
+    """
+    if not os.path.exists(path):
+        return None
+    df = pd.read_csv(path, sep=";", dtype={"run_id": str})
+    for col in ["size", "ranks", "rank", "run_idx", "step"]:
+        df[col] = pd.to_numeric(df[col], errors="coerce").astype("Int64")
+    for col in ["comm_ms", "compute_ms"]:
+        df[col] = pd.to_numeric(df[col], errors="coerce")
+    return df
 
 
 def ensure_outdir():
@@ -446,6 +608,709 @@ def plot_efficiency_gflops(df_sum):
     savefig("efficiency_gflops.png")
 
 
+def plot_kernels_gflops(df_sum):
+    """
+    Plot GFLOP/s of every C kernel vs matrix size.
+    
+    Compares the optimised C kernels against the naive baseline using the
+    same 2*n³ FLOP count as plot_efficiency_gflops().
+    
+    Args:
+        df_sum: Summary DataFrame with kernel and avg_time_ms columns
+    """
+    d_c = square_only(df_sum[df_sum["language"] == "C"])
+    series = sorted(d_c.groupby(["kernel", "threads", "ranks"]).groups.keys())
+    if not series:
+        return
+    
+    plt.figure(figsize=(7, 4.5))
+    
+    # One line per (kernel, thread count, ranks); counts shown when > 1
+    for kernel, threads, ranks in series:
+        d = d_c[(d_c["kernel"] == kernel) & (d_c["threads"] == threads)
+                & (d_c["ranks"] == ranks)].sort_values("size")
+        n = d["size"].astype(int).values
+        t_s = d["avg_time_ms"].values / 1000.0
+        gflops = (2.0 * (n.astype(float) ** 3)) / (t_s * 1e9)
+        label = kernel if threads == 1 else f"{kernel} ×{threads}"
+        if ranks > 1:
+            label += f" {ranks} ranks"
+        plt.plot(n, gflops, "o-", label=label)
+    
+    plt.title("C Kernels: Throughput (GFLOP/s) vs Matrix Size")
+    plt.xlabel("Matrix size (n)")
+    plt.ylabel("GFLOP/s")
+    plt.legend()
+    savefig("kernels_gflops.png")
+
+
+def plot_thread_scaling(df_sum):
+    """
+    Plot strong-scaling speedup and parallel efficiency vs thread count.
+    
+    For every C kernel that was run with more than one thread count, and
+    every matrix size, speedup is measured against the smallest thread
+    count p0 that was run:
+        speedup(p)    = p0 * time(p0) / time(p)
+        efficiency(p) = speedup(p) / p
+    so a perfectly scaling kernel follows speedup = p and efficiency = 1.
+    
+    Args:
+        df_sum: Summary DataFrame with kernel, threads and avg_time_ms columns
+    """
+    d_c = df_sum[df_sum["language"] == "C"]
+    swept = [k for k, d in d_c.groupby("kernel") if d["threads"].nunique() > 1]
+    if not swept:
+        return
+    
+    fig, (ax_s, ax_e) = plt.subplots(1, 2, figsize=(12, 4.5))
+    
+    for kernel in swept:
+        d_k = d_c[d_c["kernel"] == kernel]
+        for n, d in d_k.groupby("size"):
+            d = d.sort_values("threads")
+            p = d["threads"].astype(float).values
+            t = d["avg_time_ms"].values
+            speedup = p[0] * t[0] / t
+            label = f"{kernel} n={int(n)}"
+            ax_s.plot(p, speedup, "o-", label=label)
+            ax_e.plot(p, speedup / p, "o-", label=label)
+    
+    # Ideal scaling reference
+    p_max = d_c["threads"].max()
+    ax_s.plot([1, p_max], [1, p_max], "k--", linewidth=1, label="ideal")
+    ax_e.axhline(1.0, color="k", linestyle="--", linewidth=1)
+    
+    ax_s.set_title("Strong Scaling: Speedup vs Threads")
+    ax_s.set_xlabel("Threads")
+    ax_s.set_ylabel("Speedup")
+    ax_s.legend(fontsize=8)
+    ax_e.set_title("Parallel Efficiency vs Threads")
+    ax_e.set_xlabel("Threads")
+    ax_e.set_ylabel("Efficiency (speedup / threads)")
+    ax_e.set_ylim(0, 1.1)
+    savefig("thread_scaling.png")
+
+
+def plot_accuracy_vs_speed(df_sum):
+    """
+    Plot time and max error vs the naive kernel side by side.
+    
+    Shows every single-threaded C kernel for which the harness recorded
+    max_err. The size where a fast-but-inexact kernel (Strassen) drops below
+    the classical kernels in the left panel is the crossover; the right
+    panel shows the accuracy paid for it.
+    
+    Args:
+        df_sum: Summary DataFrame with kernel, avg_time_ms and max_err columns
+    """
+    d_c = square_only(df_sum[(df_sum["language"] == "C") & (df_sum["threads"] == 1)])
+    d_c = d_c[d_c["max_err"].notna()]
+    if d_c.empty:
+        return
+    
+    fig, (ax_t, ax_e) = plt.subplots(1, 2, figsize=(12, 4.5))
+    
+    for kernel, d in d_c.groupby("kernel"):
+        d = d.sort_values("size")
+        n = d["size"].astype(int).values
+        ax_t.plot(n, d["avg_time_ms"].values, "o-", label=kernel)
+        # Exact results (error 0) cannot be drawn on a log axis
+        err = d["max_err"].where(d["max_err"] > 0).values
+        ax_e.plot(n, err, "o-", label=kernel)
+    
+    ax_t.set_xscale("log", base=2)
+    ax_t.set_yscale("log")
+    ax_t.set_title("Time vs Matrix Size")
+    ax_t.set_xlabel("Matrix size (n)")
+    ax_t.set_ylabel("Average time (ms)")
+    ax_t.legend()
+    ax_e.set_xscale("log", base=2)
+    ax_e.set_yscale("log")
+    ax_e.set_title("Max Error vs Naive Kernel")
+    ax_e.set_xlabel("Matrix size (n)")
+    ax_e.set_ylabel("max |C - C_naive|")
+    ax_e.legend()
+    savefig("accuracy_vs_speed.png")
+
+
+def plot_mixed_precision(df_sum):
+    """
+    Plot throughput and error vs an fp64 reference per element type.
+    
+    Uses the single-threaded square C rows with a measured err_fp64, i.e.
+    the mixed-precision kernels and any fp32 kernel run alongside them. The
+    left panel shows what a narrower type buys in GFLOP/s (GOP/s for int8),
+    the right panel what it costs in accuracy.
+    
+    Args:
+        df_sum: Summary DataFrame with kernel, dtype, gflops_avg and err_fp64 columns
+    """
+    d_c = square_only(df_sum[(df_sum["language"] == "C") & (df_sum["threads"] == 1)
+                             & (df_sum["ranks"] == 1)])
+    d_c = d_c[d_c["err_fp64"].notna()]
+    if d_c.empty:
+        return
+    
+    fig, (ax_t, ax_e) = plt.subplots(1, 2, figsize=(12, 4.5))
+    
+    for (kernel, dtype), d in d_c.groupby(["kernel", "dtype"]):
+        d = d.sort_values("size")
+        n = d["size"].astype(int).values
+        label = kernel if kernel == dtype else f"{kernel} ({dtype})"
+        ax_t.plot(n, d["gflops_avg"].values, "o-", label=label)
+        ax_e.plot(n, d["err_fp64"].where(d["err_fp64"] > 0).values, "o-", label=label)
+    
+    ax_t.set_xscale("log", base=2)
+    ax_t.set_title("Throughput per Element Type")
+    ax_t.set_xlabel("Matrix size (n)")
+    ax_t.set_ylabel("GFLOP/s (int8: GOP/s)")
+    ax_t.legend()
+    ax_e.set_xscale("log", base=2)
+    ax_e.set_yscale("log")
+    ax_e.set_title("Max Error vs fp64 Reference")
+    ax_e.set_xlabel("Matrix size (n)")
+    ax_e.set_ylabel("max |C - C_fp64|")
+    ax_e.legend()
+    savefig("mixed_precision.png")
+
+
+def plot_batched_gflops(df_sum):
+    """
+    Plot GFLOP/s vs batch count for the batched small-matrix kernels.
+    
+    One panel per matrix size, one line per (kernel, thread count). The
+    batch_loop baseline shows the per-call overhead of looping over the
+    single-matrix simd kernel; the gap to batch and batch_ptr is what the
+    fixed-size kernels and resolving the kernel once per batch buy.
+    
+    Args:
+        df_sum: Summary DataFrame with kernel, threads, batch and gflops_avg columns
+    """
+    d_c = df_sum[(df_sum["language"] == "C") & df_sum["kernel"].str.startswith("batch")]
+    sizes = sorted(d_c["size"].dropna().astype(int).unique())
+    if not sizes:
+        return
+    
+    cols = min(len(sizes), 4)
+    rows = math.ceil(len(sizes) / cols)
+    fig, axes = plt.subplots(rows, cols, figsize=(4.5 * cols, 3.8 * rows), squeeze=False)
+    
+    for ax, n in zip(axes.flat, sizes):
+        d_n = d_c[d_c["size"] == n]
+        for (kernel, threads), d in d_n.groupby(["kernel", "threads"]):
+            d = d.groupby("batch", as_index=False)["gflops_avg"].mean().sort_values("batch")
+            label = kernel if threads == 1 else f"{kernel} ×{threads}"
+            ax.plot(d["batch"], d["gflops_avg"], "o-", label=label)
+        ax.set_xscale("log", base=2)
+        ax.set_title(f"n = {n}")
+        ax.set_xlabel("Matrices per call")
+        ax.set_ylabel("GFLOP/s")
+        ax.grid(True, alpha=0.3)
+        ax.legend(fontsize=7)
+    for ax in list(axes.flat)[len(sizes):]:
+        ax.set_visible(False)
+    
+    fig.suptitle("Batched Small-Matrix Kernels: Throughput vs Batch Count")
+    savefig("batched_gflops.png")
+
+
+def plot_gpu_offload(df_sum):
+    """
+    Plot where GPU offload pays off once transfers are counted.
+    
+    Left: time per multiply vs n for every GPU kernel, both the whole
+    offloaded call (avg_time_ms, transfers included) and the device kernel
+    alone (compute_ms_avg), against the fastest CPU kernel at each size
+    (any kernel and thread count). The first size from which the offloaded
+    call stays faster than the CPU is marked as the break-even point.
+    Right: share of the GPU time spent in host-to-device and device-to-host
+    copies, which shrinks as n grows (O(n²) bytes against O(n³) FLOPs).
+    
+    Args:
+        df_sum: Summary DataFrame with kernel, h2d_ms_avg, compute_ms_avg and
+                d2h_ms_avg columns
+    """
+    d_c = square_only(df_sum[(df_sum["language"] == "C") & (df_sum["ranks"] == 1)])
+    gpu = d_c[d_c["h2d_ms_avg"].notna()]
+    if gpu.empty:
+        return
+    
+    cpu = d_c[d_c["h2d_ms_avg"].isna()]
+    best_cpu = cpu.groupby("size")["avg_time_ms"].min()
+    
+    fig, (ax_t, ax_s) = plt.subplots(1, 2, figsize=(12, 4.5))
+    if not best_cpu.empty:
+        ax_t.plot(best_cpu.index.astype(int), best_cpu.values, "ko-", label="fastest CPU kernel")
+    
+    for i, (kernel, d) in enumerate(gpu.groupby("kernel")):
+        d = d.groupby("size", as_index=False)[["avg_time_ms", "compute_ms_avg", "h2d_ms_avg",
+                                               "d2h_ms_avg"]].mean().sort_values("size")
+        n = d["size"].astype(int).values
+        color = f"C{i}"
+        ax_t.plot(n, d["avg_time_ms"].values, "o-", color=color, label=f"{kernel} (with transfers)")
+        ax_t.plot(n, d["compute_ms_avg"].values, "o--", color=color, label=f"{kernel} (kernel only)")
+        
+        # Break-even: smallest n from which the offloaded call beats the CPU
+        cpu_t = best_cpu.reindex(d["size"]).values
+        wins = d["avg_time_ms"].values < cpu_t
+        for j in range(len(n)):
+            if wins[j:].all() and not np.isnan(cpu_t[j:]).any():
+                ax_t.axvline(n[j], color=color, linestyle=":", linewidth=1)
+                ax_t.annotate(f"{kernel} pays off from n={n[j]}", (n[j], d["avg_time_ms"].values[j]),
+                              textcoords="offset points", xytext=(5, -12), fontsize=8, color=color)
+                break
+        
+        transfers = d["h2d_ms_avg"] + d["d2h_ms_avg"]
+        total = transfers + d["compute_ms_avg"]
+        ax_s.plot(n, 100.0 * transfers / total, "o-", color=color, label=kernel)
+    
+    ax_t.set_xscale("log", base=2)
+    ax_t.set_yscale("log")
+    ax_t.set_title("GPU Offload vs Fastest CPU Kernel")
+    ax_t.set_xlabel("Matrix size (n)")
+    ax_t.set_ylabel("Time per multiply (ms)")
+    ax_t.legend(fontsize=8)
+    ax_s.set_xscale("log", base=2)
+    ax_s.set_ylim(0, 100)
+    ax_s.set_title("Transfer Share of GPU Time")
+    ax_s.set_xlabel("Matrix size (n)")
+    ax_s.set_ylabel("(h2d + d2h) / (h2d + kernel + d2h) (%)")
+    ax_s.legend(fontsize=8)
+    savefig("gpu_offload.png")
+
+
+def plot_numa_placement(df_sum):
+    """
+    Plot GFLOP/s and remote operand pages per placement and pinning policy.
+    
+    For every parallel C kernel run with more than one combination of
+    operand placement (serial, first-touch) and thread pinning (none,
+    compact, scatter), the left panel shows GFLOP/s vs n at the largest
+    thread count, one line per combination. On a multi-socket host serial
+    placement leaves every operand on one node, which shows up as a lower
+    curve for the pinned scatter runs. The right panel shows remote_pct,
+    the share of A and C pages on another node than the pinned thread that
+    computes them (unpinned runs do not measure it).
+    
+    Args:
+        df_sum: Summary DataFrame with kernel, threads, placement, bind,
+                gflops_avg and remote_pct_avg columns
+    """
+    d_c = square_only(df_sum[(df_sum["language"] == "C") & (df_sum["ranks"] == 1)])
+    d_c = d_c.assign(policy=d_c["placement"] + "/" + d_c["bind"])
+    compared = [k for k, d in d_c.groupby("kernel") if d["policy"].nunique() > 1]
+    if not compared:
+        return
+    
+    fig, (ax_g, ax_r) = plt.subplots(1, 2, figsize=(12, 4.5))
+    for kernel in compared:
+        d_k = d_c[d_c["kernel"] == kernel]
+        d_k = d_k[d_k["threads"] == d_k["threads"].max()]
+        for policy, d in d_k.groupby("policy"):
+            d = d.groupby("size", as_index=False)[["gflops_avg", "remote_pct_avg"]].mean().sort_values("size")
+            label = f"{kernel} {policy} ({int(d_k['threads'].max())} threads)"
+            ax_g.plot(d["size"].astype(int), d["gflops_avg"], "o-", label=label)
+            if d["remote_pct_avg"].notna().any():
+                ax_r.plot(d["size"].astype(int), d["remote_pct_avg"], "o-", label=label)
+    
+    ax_g.set_xscale("log", base=2)
+    ax_g.set_title("Throughput by Placement and Pinning")
+    ax_g.set_xlabel("Matrix size (n)")
+    ax_g.set_ylabel("GFLOP/s")
+    ax_g.legend(fontsize=8)
+    ax_r.set_xscale("log", base=2)
+    ax_r.set_ylim(0, 100)
+    ax_r.set_title("Remote Operand Pages (pinned runs)")
+    ax_r.set_xlabel("Matrix size (n)")
+    ax_r.set_ylabel("A and C pages off the thread's node (%)")
+    if ax_r.lines:
+        ax_r.legend(fontsize=8)
+    savefig("numa_placement.png")
+
+
+def plot_ooc_traffic(df_sum):
+    """
+    Plot the out-of-core kernel's streamed traffic and memory footprint.
+    
+    The left panel shows bytes_read + bytes_written per call divided by the
+    compulsory traffic 4*(m*k + k*n + m*n): 1 means every operand byte was
+    streamed once, and values above 1 are the repeated passes over B that a
+    small --ooc-mib budget forces. The right panel compares peak_mib of the
+    ooc kernel with the in-core C kernels at the same sizes.
+    
+    Args:
+        df_sum: Summary DataFrame with kernel, bytes_read_avg,
+                bytes_written_avg and peak_mib columns
+    """
+    d_c = square_only(df_sum[(df_sum["language"] == "C") & (df_sum["ranks"] == 1)])
+    ooc = d_c[d_c["bytes_read_avg"].notna()]
+    if ooc.empty:
+        return
+    
+    fig, (ax_t, ax_m) = plt.subplots(1, 2, figsize=(12, 4.5))
+    for kernel, d in ooc.groupby("kernel"):
+        d = d.groupby("size", as_index=False)[["bytes_read_avg", "bytes_written_avg", "peak_mib"]].mean()
+        d = d.sort_values("size")
+        n = d["size"].astype(float)
+        ratio = (d["bytes_read_avg"] + d["bytes_written_avg"]) / (12.0 * n * n)
+        ax_t.plot(d["size"].astype(int), ratio, "o-", label=kernel)
+        ax_m.plot(d["size"].astype(int), d["peak_mib"], "o-", label=kernel)
+    sizes = set(ooc["size"].dropna().astype(int))
+    for kernel, d in d_c[d_c["bytes_read_avg"].isna() & d_c["size"].isin(sizes)].groupby("kernel"):
+        d = d.groupby("size", as_index=False)["peak_mib"].max().sort_values("size")
+        ax_m.plot(d["size"].astype(int), d["peak_mib"], "s--", alpha=0.6, label=kernel)
+    
+    ax_t.set_xscale("log", base=2)
+    ax_t.axhline(1.0, color="gray", linestyle=":", linewidth=1)
+    ax_t.set_title("Out-of-Core Traffic")
+    ax_t.set_xlabel("Matrix size (n)")
+    ax_t.set_ylabel("Streamed bytes / compulsory bytes")
+    ax_t.legend(fontsize=8)
+    ax_m.set_xscale("log", base=2)
+    ax_m.set_title("Peak Memory (in-core kernels dashed)")
+    ax_m.set_xlabel("Matrix size (n)")
+    ax_m.set_ylabel("Peak memory (MiB)")
+    ax_m.legend(fontsize=8)
+    savefig("ooc_traffic.png")
+
+
+def plot_sparse_density(df_sum):
+    """
+    Plot the time of the sparse and dense C kernels vs the density of A.
+    
+    Drawn for every square size that was run at more than one density. The
+    dense kernels' time hardly moves with density while csr's falls with
+    the number of nonzeros, so the crossing of the curves is the density
+    below which CSR storage wins on this machine.
+    
+    Args:
+        df_sum: Summary DataFrame with kernel, threads, density, size and avg_time_ms columns
+    """
+    d_c = square_only(df_sum[(df_sum["language"] == "C") & (df_sum["ranks"] == 1)])
+    sizes = [n for n, d in d_c.groupby("size") if d["density"].nunique() > 1]
+    if not sizes:
+        return
+    
+    fig, axes = plt.subplots(1, len(sizes), figsize=(6 * len(sizes), 4.5), squeeze=False)
+    for ax, n in zip(axes[0], sizes):
+        d_n = d_c[d_c["size"] == n]
+        for (kernel, threads), d in d_n.groupby(["kernel", "threads"]):
+            if d["density"].nunique() < 2 and kernel != "csr":
+                continue
+            d = d.groupby("density", as_index=False)["avg_time_ms"].mean().sort_values("density")
+            style = "o-" if kernel == "csr" else "s--"
+            label = kernel if threads == 1 else f"{kernel} ({threads} thr)"
+            ax.plot(d["density"], d["avg_time_ms"], style, label=label)
+        ax.set_xscale("log")
+        ax.set_yscale("log")
+        ax.set_title(f"Sparse vs Dense, n={int(n)}")
+        ax.set_xlabel("Density of A (fraction nonzero)")
+        ax.set_ylabel("Time (ms)")
+        ax.legend(fontsize=8)
+    savefig("sparse_density.png")
+
+
+def plot_pool_stream(df_sum):
+    """
+    Plot request latency and sustained throughput of the thread-pool kernel.
+    
+    The left panel shows the median (solid) and 99th percentile (dotted)
+    submit-to-completion latency vs the number of requests in flight, the
+    right one the GFLOP/s of the whole queue. The OpenMP kernel's per-call
+    time and GFLOP/s at the same size and thread count are drawn as
+    horizontal lines: a queue of 1 against them is the cost or saving of
+    handing a call to parked workers instead of an OpenMP team, deeper
+    queues show how much independent requests overlap.
+    
+    Args:
+        df_sum: Summary DataFrame with kernel, threads, queue, size,
+                lat_p50_ms_avg, lat_p99_ms_avg, avg_time_ms and gflops_avg columns
+    """
+    d_c = square_only(df_sum[(df_sum["language"] == "C") & (df_sum["ranks"] == 1)])
+    d_pool = d_c[(d_c["kernel"] == "pool") & d_c["lat_p50_ms_avg"].notna()]
+    if d_pool.empty:
+        return
+    d_omp = d_c[(d_c["kernel"] == "openmp") & (d_c["queue"] == 1)]
+    
+    fig, (ax_l, ax_t) = plt.subplots(1, 2, figsize=(13, 4.5))
+    for (n, threads), d in d_pool.groupby(["size", "threads"]):
+        d = d.groupby("queue", as_index=False)[["lat_p50_ms_avg", "lat_p99_ms_avg", "gflops_avg"]].mean()
+        d = d.sort_values("queue")
+        label = f"n={int(n)}" if threads == 1 else f"n={int(n)} ({threads} thr)"
+        line = ax_l.plot(d["queue"], d["lat_p50_ms_avg"], "o-", label=f"{label} p50")[0]
+        ax_l.plot(d["queue"], d["lat_p99_ms_avg"], "o:", color=line.get_color(), label=f"{label} p99")
+        ax_t.plot(d["queue"], d["gflops_avg"], "o-", color=line.get_color(), label=label)
+        ref = d_omp[(d_omp["size"] == n) & (d_omp["threads"] == threads)]
+        if not ref.empty:
+            ax_l.axhline(ref["avg_time_ms"].mean(), color=line.get_color(), linestyle="--", linewidth=1)
+            ax_t.axhline(ref["gflops_avg"].mean(), color=line.get_color(), linestyle="--", linewidth=1)
+    
+    ax_l.set_xscale("log", base=2)
+    ax_l.set_yscale("log")
+    ax_l.set_title("Request Latency (dashed: openmp per call)")
+    ax_l.set_xlabel("Requests in flight")
+    ax_l.set_ylabel("Submit-to-completion latency (ms)")
+    ax_l.legend(fontsize=7, ncol=2)
+    ax_t.set_xscale("log", base=2)
+    ax_t.set_title("Sustained Throughput (dashed: openmp)")
+    ax_t.set_xlabel("Requests in flight")
+    ax_t.set_ylabel("GFLOP/s")
+    ax_t.legend(fontsize=8)
+    savefig("pool_stream.png")
+
+
+def plot_verification(df_sum):
+    """
+    Plot the verification error of every C kernel vs size.
+    
+    verify_err is the componentwise relative error |Cx - ABx| / (|A||B|x)
+    of the full comparison (small shapes) or Freivalds' check (large
+    shapes), so every kernel of one element type shares a scale: fp32
+    kernels sit near k * 2^-24, narrower types above. Groups with a failed
+    check are circled in red.
+    
+    Args:
+        df_sum: Summary DataFrame with kernel, dtype, verified and verify_err columns
+    """
+    d_c = df_sum[(df_sum["language"] == "C") & (df_sum["ranks"] == 1) & df_sum["verify_err"].notna()]
+    if d_c.empty:
+        return
+    
+    fig, ax = plt.subplots(figsize=(8, 5))
+    for (kernel, dtype), d in d_c.groupby(["kernel", "dtype"]):
+        d = d.groupby("size", as_index=False).agg(verify_err=("verify_err", "max"),
+                                                  failed=("verified", lambda v: (v == "fail").any()))
+        d = d.sort_values("size")
+        label = kernel if kernel == dtype or dtype == "fp32" else f"{kernel} ({dtype})"
+        err = d["verify_err"].where(d["verify_err"] > 0)
+        ax.plot(d["size"].astype(int), err, "o-", label=label)
+        bad = d[d["failed"]]
+        if not bad.empty:
+            ax.scatter(bad["size"].astype(int), bad["verify_err"].clip(upper=1.0), s=160,
+                       facecolors="none", edgecolors="red", linewidths=2)
+    
+    ax.set_xscale("log", base=2)
+    ax.set_yscale("log")
+    ax.set_title("Result Verification (failed checks circled)")
+    ax.set_xlabel("Matrix size (n)")
+    ax.set_ylabel("max |Cx - ABx| / (|A||B|x)")
+    ax.legend(fontsize=8, ncol=2)
+    savefig("verification.png")
+
+
+def plot_counters_vs_size(df_sum):
+    """
+    Plot IPC and cache/TLB miss rates vs matrix size for the C kernels.
+    
+    The left panel shows instructions per cycle, the right one misses per
+    1000 instructions (MPKI) for L1D, LLC and dTLB, one line style per
+    cache level and one color per kernel. Only runs made with --counters
+    carry these columns; the figure is skipped when none did.
+    
+    Args:
+        df_sum: Summary DataFrame from load_summary()
+    """
+    c = square_only(df_sum[df_sum["language"] == "C"])
+    c = c[c["instructions_avg"].notna() & (c["instructions_avg"] > 0)]
+    if c.empty:
+        return
+    
+    misses = [("l1d_misses_avg", "L1D", "-"),
+              ("llc_misses_avg", "LLC", "--"),
+              ("dtlb_misses_avg", "dTLB", ":")]
+    fig, (ax_ipc, ax_mpki) = plt.subplots(1, 2, figsize=(13, 5))
+    
+    for i, (kernel, d) in enumerate(c.groupby("kernel")):
+        # Average over thread counts and run ids of the same kernel and size
+        d = d.groupby("size", as_index=False)[COUNTER_AVG_COLS].mean().sort_values("size")
+        color = f"C{i}"
+        
+        ipc = d["instructions_avg"] / d["cycles_avg"]
+        if ipc.notna().any():
+            ax_ipc.plot(d["size"], ipc, marker="o", color=color, label=kernel)
+        
+        for col, level, style in misses:
+            mpki = 1000.0 * d[col] / d["instructions_avg"]
+            if mpki.notna().any():
+                ax_mpki.plot(d["size"], mpki, marker="o", linestyle=style, color=color,
+                             label=f"{kernel} {level}")
+    
+    ax_ipc.set_xlabel("Matrix size (n)")
+    ax_ipc.set_ylabel("Instructions per cycle")
+    ax_ipc.set_title("IPC vs size (C kernels)")
+    ax_ipc.grid(True, alpha=0.3)
+    if ax_ipc.lines:
+        ax_ipc.legend()
+    
+    ax_mpki.set_xlabel("Matrix size (n)")
+    ax_mpki.set_ylabel("Misses per 1000 instructions")
+    ax_mpki.set_yscale("log")
+    ax_mpki.set_title("Cache and TLB miss rate vs size (C kernels)")
+    ax_mpki.grid(True, alpha=0.3, which="both")
+    if ax_mpki.lines:
+        ax_mpki.legend(fontsize=7, ncol=2)
+    
+    savefig("counters_vs_size.png")
+
+
+def plot_roofline(df_sum):
+    """
+    Plot a roofline: attained GFLOP/s vs arithmetic intensity for the C kernels.
+    
+    Each roof is min(peak_gflops, bandwidth_gbs * intensity) for one thread
+    count measured by the harness; the ridge point, where the two meet, is
+    the intensity above which a kernel can be compute-bound. Points far
+    below the roof at high intensity are limited by the kernel (cache reuse,
+    vectorisation), not by the machine. Skipped when no run recorded the
+    machine peak.
+    
+    Args:
+        df_sum: Summary DataFrame from load_summary()
+    """
+    c = df_sum[(df_sum["language"] == "C") & df_sum["gflops_avg"].notna()
+               & df_sum["intensity"].notna()]
+    roofs = c[c["peak_gflops"].notna() & c["bandwidth_gbs"].notna()]
+    if roofs.empty:
+        return
+    
+    plt.figure(figsize=(8, 5.5))
+    x_lo = max(c["intensity"].min() / 4.0, 1e-2)
+    x_hi = c["intensity"].max() * 4.0
+    ai = np.logspace(np.log10(x_lo), np.log10(x_hi), 200)
+    
+    # One roof per thread count; the bandwidth roof is shared
+    for threads, r in roofs.groupby("threads"):
+        peak = r["peak_gflops"].max()
+        bw = r["bandwidth_gbs"].max()
+        plt.plot(ai, np.minimum(peak, bw * ai), "k-", alpha=0.7)
+        plt.text(x_hi, peak, f" {peak:.0f} GFLOP/s ({threads} thr)", va="center", fontsize=7)
+    
+    markers = ["o", "s", "^", "D", "v", "P", "X", "*"]
+    for i, (kernel, d) in enumerate(c.groupby("kernel")):
+        plt.scatter(d["intensity"], d["gflops_avg"], marker=markers[i % len(markers)],
+                    label=kernel, alpha=0.8)
+    
+    plt.xscale("log")
+    plt.yscale("log")
+    plt.title(f"Roofline (triad {roofs['bandwidth_gbs'].max():.1f} GB/s)")
+    plt.xlabel("Arithmetic intensity (FLOP/byte, compulsory traffic)")
+    plt.ylabel("GFLOP/s")
+    plt.grid(True, alpha=0.3, which="both")
+    plt.legend(fontsize=8)
+    savefig("roofline.png")
+
+
+def plot_mpi_scaling(df_sum):
+    """
+    Plot strong and weak scaling of the distributed kernels across MPI ranks.
+    
+    Times are those of the slowest rank (see aggregate_results.py).
+    - Strong scaling: for every size run on more than one rank count,
+      speedup against the smallest rank count p0, p0 * time(p0) / time(p),
+      with the ideal speedup = p line.
+    - Weak scaling: runs made with benchmark_mpi --weak keep the block edge
+      n / sqrt(p) per rank fixed while n grows; they are grouped by that edge
+      and shown as GFLOP/s per rank, which stays flat when scaling is ideal.
+    - Communication share: comm_ms_avg / avg_time_ms of every run, the part
+      of the slowest rank's time spent in panel broadcasts.
+    
+    Args:
+        df_sum: Summary DataFrame with kernel, ranks, size, avg_time_ms,
+                gflops_avg and comm_ms_avg columns
+    """
+    d_c = df_sum[(df_sum["language"] == "C") & df_sum["comm_ms_avg"].notna()]
+    if d_c["ranks"].nunique() < 2:
+        return
+    
+    fig, (ax_s, ax_w, ax_c) = plt.subplots(1, 3, figsize=(15, 4.5))
+    
+    for kernel, d_k in d_c.groupby("kernel"):
+        # Strong scaling: fixed n, growing rank count
+        for n, d in d_k.groupby("size"):
+            if d["ranks"].nunique() < 2:
+                continue
+            d = d.groupby("ranks", as_index=False)["avg_time_ms"].mean().sort_values("ranks")
+            p = d["ranks"].astype(float).values
+            t = d["avg_time_ms"].values
+            ax_s.plot(p, p[0] * t[0] / t, "o-", label=f"{kernel} n={int(n)}")
+        
+        # Weak scaling: fixed block edge per rank, n grows with sqrt(ranks)
+        edge = (d_k["size"].astype(float) / np.sqrt(d_k["ranks"].astype(float))).round().astype(int)
+        for b, d in d_k.groupby(edge):
+            if d["ranks"].nunique() < 2 or d["size"].nunique() < 2:
+                continue
+            d = d.groupby("ranks", as_index=False)["gflops_avg"].mean().sort_values("ranks")
+            ax_w.plot(d["ranks"], d["gflops_avg"] / d["ranks"], "o-", label=f"{kernel} block={b}")
+        
+        for n, d in d_k.groupby("size"):
+            d = d.sort_values("ranks")
+            ax_c.plot(d["ranks"], 100.0 * d["comm_ms_avg"] / d["avg_time_ms"], "o-",
+                      label=f"{kernel} n={int(n)}")
+    
+    p_max = d_c["ranks"].max()
+    ax_s.plot([1, p_max], [1, p_max], "k--", linewidth=1, label="ideal")
+    
+    ax_s.set_title("Strong Scaling: Speedup vs Ranks")
+    ax_s.set_xlabel("MPI ranks")
+    ax_s.set_ylabel("Speedup")
+    ax_s.legend(fontsize=8)
+    ax_w.set_title("Weak Scaling: GFLOP/s per Rank")
+    ax_w.set_xlabel("MPI ranks")
+    ax_w.set_ylabel("GFLOP/s per rank")
+    if ax_w.lines:
+        ax_w.legend(fontsize=8)
+    ax_c.set_title("Communication Share of Total Time")
+    ax_c.set_xlabel("MPI ranks")
+    ax_c.set_ylabel("comm / total (%)")
+    ax_c.set_ylim(0, 100)
+    ax_c.legend(fontsize=8)
+    savefig("mpi_scaling.png")
+
+
+def plot_summa_overlap(df_steps):
+    """
+    Compare exposed communication of blocking and overlapped SUMMA.
+    
+    Uses the largest rank count and, within it, the largest size in the
+    steps file. Left: comm_ms of every step, averaged over runs and ranks,
+    per broadcast scheme; with overlap it is only the time spent posting
+    and waiting for the next panels. Right: total comm_ms per run of every
+    rank, averaged over runs, so ranks that stall on the network stand out.
+    The gap between the two schemes is the communication the overlap hid.
+    
+    Args:
+        df_steps: DataFrame from load_steps(), or None
+    """
+    if df_steps is None or df_steps.empty:
+        return
+    d = df_steps[df_steps["ranks"] == df_steps["ranks"].max()]
+    d = d[d["size"] == d["size"].max()]
+    n, p = int(d["size"].iloc[0]), int(d["ranks"].iloc[0])
+    
+    fig, (ax_s, ax_r) = plt.subplots(1, 2, figsize=(12, 4.5))
+    kernels = sorted(d["kernel"].unique())
+    width = 0.8 / len(kernels)
+    
+    for i, (kernel, d_k) in enumerate(d.groupby("kernel")):
+        per_step = d_k.groupby("step")["comm_ms"].mean()
+        ax_s.plot(per_step.index, per_step.values, "o-", markersize=3, label=kernel)
+        
+        per_rank = d_k.groupby(["rank", "run_idx"])["comm_ms"].sum().groupby("rank").mean()
+        ax_r.bar(per_rank.index.astype(float) + (i - (len(kernels) - 1) / 2) * width,
+                 per_rank.values, width=width, label=kernel)
+    
+    ax_s.set_title(f"Exposed Communication per Step (n={n}, {p} ranks)")
+    ax_s.set_xlabel("SUMMA step")
+    ax_s.set_ylabel("comm (ms, mean over runs and ranks)")
+    ax_s.legend(fontsize=8)
+    ax_r.set_title("Exposed Communication per Rank")
+    ax_r.set_xlabel("Rank")
+    ax_r.set_ylabel("comm per run (ms)")
+    ax_r.legend(fontsize=8)
+    savefig("summa_overlap.png")
+
+
 # ==================== Main Entry Point ====================
 
 
@@ -460,14 +1325,36 @@ if __name__ == "__main__":
     summary = load_summary(SUMMARY_PATH)
     raw = load_raw(RAW_PATH)
     
+    # Cross-language charts compare the baseline kernel only
+    base_summary = baseline_only(summary)
+    base_raw = baseline_only(raw)
+    
+    # Per-size kernel charts compare one dense matrix per call
+    single = summary[(summary["batch"] == 1) & (summary["queue"] == 1) & (summary["density"] == 1.0)]
+    
     # Generate all plots
     print("Creating plots...")
-    plot_time_vs_size(summary)
-    plot_time_vs_size_loglog(summary)
-    plot_speedup_vs_fastest(summary)
-    plot_cpu_vs_size(summary)
-    plot_mem_vs_size(summary)
-    plot_boxplots_time_by_size(raw)
-    plot_efficiency_gflops(summary)
+    plot_time_vs_size(base_summary)
+    plot_time_vs_size_loglog(base_summary)
+    plot_speedup_vs_fastest(base_summary)
+    plot_cpu_vs_size(base_summary)
+    plot_mem_vs_size(base_summary)
+    plot_boxplots_time_by_size(base_raw)
+    plot_efficiency_gflops(base_summary)
+    plot_kernels_gflops(single)
+    plot_thread_scaling(single)
+    plot_accuracy_vs_speed(single)
+    plot_mixed_precision(single)
+    plot_batched_gflops(summary)
+    plot_gpu_offload(single)
+    plot_numa_placement(single)
+    plot_ooc_traffic(single)
+    plot_sparse_density(summary[(summary["batch"] == 1) & (summary["queue"] == 1)])
+    plot_pool_stream(summary[summary["batch"] == 1])
+    plot_verification(single)
+    plot_counters_vs_size(single)
+    plot_roofline(single)
+    plot_mpi_scaling(single)
+    plot_summa_overlap(load_steps(STEPS_PATH))
     
     print(f"\n✓ All figures saved to: {OUT_DIR}/")
\ No newline at end of file